@@ -0,0 +1,51 @@
+# CMake build for xerces-c
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# compression selection
+
+option(compression "Compressed input support (gzip, zstd)" OFF)
+
+set(compressions)
+set(COMPRESSION_LIBS)
+
+if(compression)
+  # gzip
+
+  find_package(ZLIB)
+  if(ZLIB_FOUND)
+    list(APPEND compressions gzip)
+    set(XERCES_USE_COMPRESSION_GZIP 1)
+    set(COMPRESSION_LIBS "${COMPRESSION_LIBS} -lz")
+  endif()
+
+  # zstd
+
+  find_path(ZSTD_INCLUDE_DIR zstd.h)
+  find_library(ZSTD_LIBRARY NAMES zstd zstd_static)
+  mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
+  if(ZSTD_INCLUDE_DIR AND ZSTD_LIBRARY)
+    list(APPEND compressions zstd)
+    set(XERCES_USE_COMPRESSION_ZSTD 1)
+    set(COMPRESSION_LIBS "${COMPRESSION_LIBS} -lzstd")
+  endif()
+endif(compression)
+
+if(compressions)
+  string(REPLACE ";" " " compression_summary "${compressions}")
+else()
+  set(compression_summary "none")
+endif()
@@ -34,6 +34,8 @@ check_function_exists(gettimeofday HAVE_GETTIMEOFDAY)
 check_function_exists(gmtime_r HAVE_GMTIME_R)
 check_function_exists(memmove HAVE_MEMMOVE)
 check_function_exists(memset HAVE_MEMSET)
+check_function_exists(mmap HAVE_MMAP)
+check_function_exists(madvise HAVE_MADVISE)
 check_function_exists(nl_langinfo HAVE_NL_LANGINFO)
 check_function_exists(setlocale HAVE_SETLOCALE)
 check_function_exists(localeconv HAVE_LOCALECONV)
@@ -37,6 +37,7 @@ check_include_file_cxx(stddef.h                    HAVE_STDDEF_H)
 check_include_file_cxx(stdlib.h                    HAVE_STDLIB_H)
 check_include_file_cxx(string.h                    HAVE_STRING_H)
 check_include_file_cxx(strings.h                   HAVE_STRINGS_H)
+check_include_file_cxx(sys/mman.h                  HAVE_SYS_MMAN_H)
 check_include_file_cxx(sys/param.h                 HAVE_SYS_PARAM_H)
 check_include_file_cxx(sys/socket.h                HAVE_SYS_SOCKET_H)
 check_include_file_cxx(sys/stat.h                  HAVE_SYS_STAT_H)
@@ -0,0 +1,45 @@
+# CMake build for xerces-c
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# memorymgr selection
+
+set(memorymgrs default threadcaching)
+
+string(REPLACE ";" "|" memorymgr_help "${memorymgrs}")
+set(memory-manager "default" CACHE STRING "Default memory manager (${memorymgr_help})")
+set(memorymgr "${memory-manager}")
+
+list(FIND memorymgrs "${memorymgr}" memorymgr_found)
+if(memorymgr_found EQUAL -1)
+  message(FATAL_ERROR "${memorymgr} memorymgr unavailable")
+endif()
+
+set(XERCES_USE_MEMORYMGR_THREADCACHING 0)
+if(memorymgr STREQUAL "threadcaching")
+  set(XERCES_USE_MEMORYMGR_THREADCACHING 1)
+endif()
+
+# Small objects that keep their memory manager can do without the XMemory
+# header, at the cost of no longer being deletable with delete
+
+option(headerless-objects "Allocate QName without the XMemory header" OFF)
+
+set(XERCES_HEADERLESS_OBJECTS 0)
+if(headerless-objects)
+  set(XERCES_HEADERLESS_OBJECTS 1)
+endif()
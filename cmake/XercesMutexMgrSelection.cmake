@@ -72,6 +72,7 @@ if(threads)
   thread_test(XERCES_HAVE_STD_THREAD)
   if(XERCES_HAVE_STD_THREAD)
     list(APPEND mutexmgrs standard)
+    set(HAVE_STD_THREAD 1)
   endif()
 
   if(TARGET Threads::Threads)
@@ -0,0 +1,58 @@
+dnl @synopsis XERCES_COMPRESSION_SELECTION
+dnl
+dnl Determines which compression formats are supported for input
+dnl
+dnl @category C
+dnl @license AllPermissive
+dnl
+dnl $Id$
+
+AC_DEFUN([XERCES_COMPRESSION_SELECTION],
+	[
+
+	compression=
+	COMPRESSION_LIBS=
+
+	######################################################
+	# gzip, through zlib
+	######################################################
+
+	AC_ARG_ENABLE([compression-gzip],
+		AS_HELP_STRING([--enable-compression-gzip],
+			[Enable gzip compressed input support (requires zlib)]),
+		[AS_IF([test x"$enableval" = xyes], [use_gzip=yes], [use_gzip=no])],
+		[use_gzip=no])
+
+	AS_IF([test x"$use_gzip" = xyes], [
+		AC_CHECK_HEADER([zlib.h],
+			[AC_CHECK_LIB([z], [inflate],
+				[compression="$compression gzip"
+				 COMPRESSION_LIBS="$COMPRESSION_LIBS -lz"
+				 AC_DEFINE([XERCES_USE_COMPRESSION_GZIP], 1, [Define to support gzip compressed input])])])
+	])
+
+	######################################################
+	# zstd
+	######################################################
+
+	AC_ARG_ENABLE([compression-zstd],
+		AS_HELP_STRING([--enable-compression-zstd],
+			[Enable zstd compressed input support (requires libzstd)]),
+		[AS_IF([test x"$enableval" = xyes], [use_zstd=yes], [use_zstd=no])],
+		[use_zstd=no])
+
+	AS_IF([test x"$use_zstd" = xyes], [
+		AC_CHECK_HEADER([zstd.h],
+			[AC_CHECK_LIB([zstd], [ZSTD_decompressStream],
+				[compression="$compression zstd"
+				 COMPRESSION_LIBS="$COMPRESSION_LIBS -lzstd"
+				 AC_DEFINE([XERCES_USE_COMPRESSION_ZSTD], 1, [Define to support zstd compressed input])])])
+	])
+
+	compression=`echo $compression`
+	AS_IF([test x"$compression" = x], [compression=none])
+	LIBS="${LIBS} ${COMPRESSION_LIBS}"
+	AC_SUBST([COMPRESSION_LIBS])
+
+	]
+)
@@ -0,0 +1,41 @@
+dnl @synopsis XERCES_MEMORYMGR_SELECTION
+dnl
+dnl Determines which MemoryManager XMLPlatformUtils::Initialize creates
+dnl when the application does not supply one
+dnl
+dnl @category C
+dnl @license AllPermissive
+dnl
+dnl $Id$
+
+AC_DEFUN([XERCES_MEMORYMGR_SELECTION],
+	[
+
+	AC_MSG_CHECKING([for which default memory manager to use])
+	AC_ARG_ENABLE([memorymgr-threadcaching],
+		AS_HELP_STRING([--enable-memorymgr-threadcaching],
+			[Make the thread-caching memory manager the default]),
+		[AS_IF([test x"$enableval" = xyes],
+			[memorymgr=threadcaching],
+			[memorymgr=default])],
+		[memorymgr=default])
+
+	AS_IF([test x"$memorymgr" = xthreadcaching],
+		[AC_DEFINE([XERCES_USE_MEMORYMGR_THREADCACHING], 1, [Define to make the thread-caching memory manager the default])])
+	AC_MSG_RESULT($memorymgr)
+
+	AC_MSG_CHECKING([whether to allocate small objects without the memory manager header])
+	AC_ARG_ENABLE([headerless-objects],
+		AS_HELP_STRING([--enable-headerless-objects],
+			[Allocate QName without the XMemory header]),
+		[AS_IF([test x"$enableval" = xyes],
+			[headerless_objects=yes],
+			[headerless_objects=no])],
+		[headerless_objects=no])
+
+	AS_IF([test x"$headerless_objects" = xyes],
+		[AC_DEFINE([XERCES_HEADERLESS_OBJECTS], 1, [Define to allocate QName without the XMemory header])])
+	AC_MSG_RESULT($headerless_objects)
+
+	]
+)
@@ -247,12 +247,17 @@ public:
       *       <li>SGXMLScanner: a scanner that can only perform XMLSchema validation</li>
       *       <li>DGXMLScanner: a scanner that can only perform DTD validation</li>
       *       <li>WFXMLScanner: a scanner that cannot perform any type validation, only well-formedness</li>
+      *       <li>NSXMLScanner: a namespace-aware scanner that, like WFXMLScanner, only checks well-formedness</li>
       *      </ul>
       *
       * "http://apache.org/xml/properties/parser-use-DOMDocument-from-Implementation"
       *     A string holding the capabilities of the DOM implementation to be used to create the DOMDocument
       *     resulting from the parse operation. For instance, "LS" or "Core"
       *
+      * "http://apache.org/xml/properties/reader-buffer-size"
+      *     A pointer to an XMLSize_t holding the size, in characters, of the character buffer used to
+      *     read each entity (default 16K). The raw byte buffer is three times that many bytes
+      *
       * "http://apache.org/xml/features/validation/schema"
       *     true
       *         Enable XMLSchema validation (note that also namespace processing should be enabled)
@@ -371,6 +376,13 @@ public:
       *     false (default)
       *         If a DTD is found, it will be used to validate the XML
       *
+      * "http://apache.org/xml/features/adaptive-reader-buffer"
+      *     true
+      *         Each entity reader starts out with small buffers and grows them up to the reader
+      *         buffer size as it finds the entity to be large
+      *     false (default)
+      *         Each entity reader uses buffers of the reader buffer size from the start
+      *
       * @return The pointer to the configuration object.
       * @since DOM Level 3
       */
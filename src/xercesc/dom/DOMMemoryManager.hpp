@@ -149,6 +149,49 @@ public:
     virtual XMLCh* cloneString(const XMLCh *src) = 0;
     //@}
 
+    //@{
+    // -----------------------------------------------------------------------
+    //  Pool statistics and sized release
+    // -----------------------------------------------------------------------
+    /**
+     * Returns the number of bytes the memory manager has obtained from the
+     * document's <code>MemoryManager</code>
+     *
+     * @return the size of the managed pool, or 0 if it is not tracked
+     */
+    virtual XMLSize_t getHeapSize() const { return 0; }
+
+    /**
+     * Returns the number of bytes that have been allocated from the managed pool
+     * and not released.  Released DOM objects are kept for reuse and still count
+     * as live.
+     *
+     * @return the number of bytes in use, or 0 if it is not tracked
+     */
+    virtual XMLSize_t getLiveSize() const { return 0; }
+
+    /**
+     * Returns the number of bytes of the managed pool that are neither in use nor
+     * available for reuse, such as the space left behind by strings that outgrew
+     * their storage.  The rest of the pool is free for new allocations.
+     *
+     * @return the number of bytes wasted, or 0 if it is not tracked
+     */
+    virtual XMLSize_t getWastedSize() const { return 0; }
+
+    /**
+     * Release a memory block obtained from <code>allocate(XMLSize_t)</code>.
+     * Small blocks are kept for later allocations of the same size, larger
+     * ones are given back to the document's <code>MemoryManager</code>.  A
+     * block is left in use if the size doesn't match its allocation.  The default
+     * implementation keeps the block in the pool until the document is released.
+     *
+     * @param oldBuffer the pointer to the memory block
+     * @param amount    the size the memory block was allocated with
+     */
+    virtual void release(void* /*oldBuffer*/, XMLSize_t /*amount*/) {}
+    //@}
+
 };
 
 XERCES_CPP_NAMESPACE_END
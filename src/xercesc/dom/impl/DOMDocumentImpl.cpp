@@ -95,6 +95,10 @@ DOMDocumentImpl::DOMDocumentImpl(DOMImplementation* domImpl, MemoryManager* cons
       fFreePtr(0),
       fFreeBytesRemaining(0),
       fHeapAllocSize(kInitialHeapAllocSize),
+      fFreeLists(0),
+      fHeapSize(0),
+      fLiveSize(0),
+      fFreeListSize(0),
       fRecycleNodePtr(0),
       fRecycleBufferPtr(0),
       fNodeListPool(0),
@@ -138,6 +142,10 @@ DOMDocumentImpl::DOMDocumentImpl(const XMLCh *fNamespaceURI,
       fFreePtr(0),
       fFreeBytesRemaining(0),
       fHeapAllocSize(kInitialHeapAllocSize),
+      fFreeLists(0),
+      fHeapSize(0),
+      fLiveSize(0),
+      fFreeListSize(0),
       fRecycleNodePtr(0),
       fRecycleBufferPtr(0),
       fNodeListPool(0),
@@ -834,31 +842,100 @@ void DOMDocumentImpl::setMemoryAllocationBlockSize(XMLSize_t size)
         fHeapAllocSize=size;
 }
 
-void DOMDocumentImpl::release(void* oldBuffer)
+XMLSize_t DOMDocumentImpl::getHeapSize() const
 {
-    // only release blocks that are stored in a block by itself
-    XMLSize_t sizeOfHeader = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(void *));
-    void** cursor = &fCurrentSingletonBlock;
-    while (*cursor != 0)
+    return fHeapSize;
+}
+
+XMLSize_t DOMDocumentImpl::getLiveSize() const
+{
+    return fLiveSize;
+}
+
+XMLSize_t DOMDocumentImpl::getWastedSize() const
+{
+    // whatever is neither in use nor ready to be handed out again: block
+    // headers, the unused ends of old blocks and abandoned blocks
+    return fHeapSize - fLiveSize - fFreeListSize - fFreeBytesRemaining;
+}
+
+void DOMDocumentImpl::release(void* oldBuffer, XMLSize_t amount)
+{
+    if (!oldBuffer)
+        return;
+
+    // only give back what was really handed out, whatever the caller says
+    const XMLSize_t sizeOfHeader = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(XMLSize_t));
+    char* block = (char*)oldBuffer - sizeOfHeader;
+    amount = XMLPlatformUtils::alignPointerForNewBlockAllocation(amount);
+    if (*(XMLSize_t*)block != amount)
+        return;
+
+    releaseBlock(block, sizeOfHeader + amount);
+}
+
+void DOMDocumentImpl::releaseBlock(void* oldBuffer, XMLSize_t amount)
+{
+    fLiveSize -= amount;
+
+    // a sub-allocated block goes on the free list of its size class
+    if (amount <= kMaxSubAllocationSize)
     {
-        void **nextBlock = (void **)(*cursor);
-        if ((char*)(*cursor) + sizeOfHeader == oldBuffer)
+        const XMLSize_t alignment = XMLPlatformUtils::alignPointerForNewBlockAllocation(1);
+        if (!fFreeLists)
         {
-            // found: deallocate and replace the pointer value with the next block
-            void* current = *cursor;
-            *cursor = *nextBlock;
-            fMemoryManager->deallocate(current);
-            break;
+            const XMLSize_t count = XMLPlatformUtils::alignPointerForNewBlockAllocation(kMaxSubAllocationSize) / alignment;
+            fFreeLists = (void**)allocateBlock(count * sizeof(void*));
+            for (XMLSize_t i = 0; i < count; i++)
+                fFreeLists[i] = 0;
         }
-        cursor = nextBlock;
+
+        void** freeList = &fFreeLists[amount / alignment - 1];
+        *(void**)oldBuffer = *freeList;
+        *freeList = oldBuffer;
+        fFreeListSize += amount;
+        return;
     }
+
+    XMLSize_t sizeOfHeader = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(SingletonBlockHeader));
+    SingletonBlockHeader* block = (SingletonBlockHeader*)((char*)oldBuffer - sizeOfHeader);
+
+    if (block->fPrev)
+        block->fPrev->fNext = block->fNext;
+    else
+        fCurrentSingletonBlock = block->fNext;
+    if (block->fNext)
+        block->fNext->fPrev = block->fPrev;
+
+    fHeapSize -= sizeOfHeader + amount;
+    fMemoryManager->deallocate(block);
+}
+
+void DOMDocumentImpl::abandon(XMLSize_t amount)
+{
+    // the block stays where it is, because somebody may still be looking at
+    // it, but it is no longer counted as in use
+    fLiveSize -= XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(XMLSize_t))
+               + XMLPlatformUtils::alignPointerForNewBlockAllocation(amount);
 }
 
 void* DOMDocumentImpl::allocate(XMLSize_t amount)
+{
+  //	Record the aligned size in front of the block, for release()
+  const XMLSize_t sizeOfHeader = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(XMLSize_t));
+  amount = XMLPlatformUtils::alignPointerForNewBlockAllocation(amount);
+
+  char* block = (char*)allocateBlock(sizeOfHeader + amount);
+  *(XMLSize_t*)block = amount;
+  return block + sizeOfHeader;
+}
+
+void* DOMDocumentImpl::allocateBlock(XMLSize_t amount)
 {
   //	Align the request size so that suballocated blocks
   //	beyond this one will be maintained at the same alignment.
   amount = XMLPlatformUtils::alignPointerForNewBlockAllocation(amount);
+  fLiveSize += amount;
 
   // If the request is for a largish block, hand it off to the system
   //   allocator.  The block still must be linked into a special list of
@@ -866,29 +943,36 @@ void* DOMDocumentImpl::allocate(XMLSize_t amount)
   if (amount > kMaxSubAllocationSize)
   {
     //	The size of the header we add to our raw blocks
-    XMLSize_t sizeOfHeader = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(void *));
+    XMLSize_t sizeOfHeader = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(SingletonBlockHeader));
 
     //	Try to allocate the block
-    void* newBlock = fMemoryManager->allocate(sizeOfHeader + amount);
+    SingletonBlockHeader* newBlock = (SingletonBlockHeader*)fMemoryManager->allocate(sizeOfHeader + amount);
+    fHeapSize += sizeOfHeader + amount;
 
-    //	Link it into the list beyond current block, as current block
-    //	is still being subdivided. If there is no current block
-    //	then track that we have no bytes to further divide.
+    //	Link it in at the head of the list
+    newBlock->fPrev = 0;
+    newBlock->fNext = fCurrentSingletonBlock;
     if (fCurrentSingletonBlock)
-    {
-      *(void **)newBlock = *(void **)fCurrentSingletonBlock;
-      *(void **)fCurrentSingletonBlock = newBlock;
-    }
-    else
-    {
-      *(void **)newBlock = 0;
-      fCurrentSingletonBlock = newBlock;
-    }
+      fCurrentSingletonBlock->fPrev = newBlock;
+    fCurrentSingletonBlock = newBlock;
 
     void *retPtr = (char*)newBlock + sizeOfHeader;
     return retPtr;
   }
 
+  //	Reuse a released block of the same size, if there is one.
+  if (fFreeLists && amount != 0)
+  {
+    void** freeList = &fFreeLists[amount / XMLPlatformUtils::alignPointerForNewBlockAllocation(1) - 1];
+    if (*freeList)
+    {
+      void *retPtr = *freeList;
+      *freeList = *(void**)retPtr;
+      fFreeListSize -= amount;
+      return retPtr;
+    }
+  }
+
   //	It's a normal (sub-allocatable) request.
   //	Are we out of room in our current block?
   if (amount > fFreeBytesRemaining)
@@ -900,6 +984,7 @@ void* DOMDocumentImpl::allocate(XMLSize_t amount)
     // Get a new block from the system allocator.
     void* newBlock;
     newBlock = fMemoryManager->allocate(fHeapAllocSize);
+    fHeapSize += fHeapAllocSize;
 
     *(void **)newBlock = fCurrentBlock;
     fCurrentBlock = newBlock;
@@ -929,10 +1014,12 @@ void DOMDocumentImpl::deleteHeap()
     }
     while (fCurrentSingletonBlock != 0)
     {
-        void *nextBlock = *(void **)fCurrentSingletonBlock;
+        SingletonBlockHeader *nextBlock = fCurrentSingletonBlock->fNext;
         fMemoryManager->deallocate(fCurrentSingletonBlock);
         fCurrentSingletonBlock = nextBlock;
     }
+    fFreeLists = 0;
+    fHeapSize = fLiveSize = fFreeListSize = 0;
 }
 
 
@@ -1492,19 +1579,24 @@ DOMBuffer* DOMDocumentImpl::popBuffer(XMLSize_t nMinSize)
     for(XMLSize_t index=fRecycleBufferPtr->size()-1;index>0;index--)
         if(fRecycleBufferPtr->elementAt(index)->getCapacity()>=nMinSize)
             return fRecycleBufferPtr->popAt(index);
-    // if we didn't find a buffer big enough, get the last one
-    return fRecycleBufferPtr->pop();
+    // if we didn't find a buffer big enough, get the last one and grow it;
+    // its node has been released, so the old storage can be released too
+    DOMBuffer* buffer = fRecycleBufferPtr->pop();
+    buffer->reset();
+    if (buffer->getCapacity() < nMinSize)
+        buffer->expandCapacity(nMinSize, true);
+    return buffer;
 }
 
 
 void * DOMDocumentImpl::allocate(XMLSize_t amount, DOMMemoryManager::NodeObjectType type)
 {
     if (!fRecycleNodePtr)
-        return allocate(amount);
+        return allocateBlock(amount);
 
     DOMNodePtr* ptr = fRecycleNodePtr->operator[](type);
     if (!ptr || ptr->empty())
-        return allocate(amount);
+        return allocateBlock(amount);
 
     return (void*) ptr->pop();
 
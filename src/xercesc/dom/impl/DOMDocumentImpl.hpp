@@ -163,10 +163,15 @@ public:
     // Add all functions that are pure virtual in DOMMemoryManager
     virtual XMLSize_t getMemoryAllocationBlockSize() const;
     virtual void setMemoryAllocationBlockSize(XMLSize_t size);
+    virtual XMLSize_t getHeapSize() const;
+    virtual XMLSize_t getLiveSize() const;
+    virtual XMLSize_t getWastedSize() const;
     virtual void* allocate(XMLSize_t amount);
     virtual void* allocate(XMLSize_t amount, DOMMemoryManager::NodeObjectType type);
-    // try to remove the block from the list of allocated memory
-    virtual void release(void* oldBuffer);
+    // return a block obtained from allocate(amount) to the system, if it was
+    // allocated on its own, or to the free list of its size class, if it was
+    // sub-allocated; a size that doesn't match the allocation is ignored
+    virtual void release(void* oldBuffer, XMLSize_t amount);
     virtual void release(DOMNode* object, DOMMemoryManager::NodeObjectType type);
     virtual XMLCh* cloneString(const XMLCh *src);
 
@@ -270,6 +275,9 @@ public:
     const XMLCh*                 getPooledString(const XMLCh*);
     const XMLCh*                 getPooledNString(const XMLCh*, XMLSize_t);
     void                         deleteHeap();
+    void                         abandon(XMLSize_t amount);
+    // a block without a recorded size, which can't be given to release()
+    void*                        allocateBlock(XMLSize_t amount);
     void                         releaseDocNotifyUserData(DOMNode* object);
     void                         releaseBuffer(DOMBuffer* buffer);
     DOMBuffer*                   popBuffer(XMLSize_t nMinSize);
@@ -289,6 +297,8 @@ protected:
     virtual DOMNode*             importNode(const DOMNode *source, bool deep, bool cloningNode);
 
 private:
+    void                         releaseBlock(void* block, XMLSize_t amount);
+
     // -----------------------------------------------------------------------
     // Unimplemented constructors and operators
     // -----------------------------------------------------------------------
@@ -316,22 +326,45 @@ protected:
     //   sub-allocated for individual allocations of nodes, strings, etc.
     //   The big blocks form a linked list, allowing them to be located for deletion.
     //
-    //   There is no provision for deleting suballocated blocks, other than
-    //     deleting the entire heap when the document is deleted.
+    //   Sub-allocated blocks are never returned to the system, other than by
+    //     deleting the entire heap when the document is deleted.  Released ones
+    //     are kept on a free list per size class, one class for each multiple
+    //     of the alignment up to the sub-allocation limit, and are handed out
+    //     again before the current big block is carved any further.
     //
-    //   There is no header on individual sub-allocated blocks.
+    //   There is no header on node objects and other objects placed on the
+    //    heap with operator new.  Other blocks carry their aligned size just
+    //    before the returned pointer, so that a sized release can be checked
+    //    against the allocation.
     //   The header on big blocks consists only of a single back pointer to
     //    the previously allocated big block (our linked list of big blocks)
     //
+    //   Requests larger than the sub-allocation limit get a block of their own.
+    //   These singleton blocks form a doubly linked list through their headers,
+    //    so that one can be unlinked and returned to the system in constant time.
+    //
     //
     //   revisit - this heap should be encapsulated into its own
     //                  class, rather than hanging naked on Document.
     //
+    struct SingletonBlockHeader
+    {
+        SingletonBlockHeader*   fPrev;
+        SingletonBlockHeader*   fNext;
+    };
+
     void*                 fCurrentBlock;
-    void*                 fCurrentSingletonBlock;
+    SingletonBlockHeader* fCurrentSingletonBlock;
     char*                 fFreePtr;
     XMLSize_t             fFreeBytesRemaining,
                           fHeapAllocSize;
+    void**                fFreeLists;
+
+    // Heap statistics: the bytes obtained from the memory manager, the bytes
+    //   handed out and not yet released, and the bytes on the free lists
+    XMLSize_t             fHeapSize,
+                          fLiveSize,
+                          fFreeListSize;
 
     // To recycle the DOMNode pointer
     RefArrayOf<DOMNodePtr>* fRecycleNodePtr;
@@ -391,7 +424,7 @@ inline const XMLCh*  DOMDocumentImpl::getPooledString(const XMLCh *in)
   // account for the trailing null.
   //
   XMLSize_t sizeToAllocate = sizeof(DOMStringPoolEntry) + n*sizeof(XMLCh);
-  *pspe = spe = (DOMStringPoolEntry *)allocate(sizeToAllocate);
+  *pspe = spe = (DOMStringPoolEntry *)allocateBlock(sizeToAllocate);
   spe->fLength = n;
   spe->fNext = 0;
   XMLString::copyString((XMLCh*)spe->fString, in);
@@ -424,7 +457,7 @@ inline const XMLCh* DOMDocumentImpl::getPooledNString(const XMLCh *in, XMLSize_t
   // account for the trailing null.
   //
   XMLSize_t sizeToAllocate = sizeof(DOMStringPoolEntry) + n*sizeof(XMLCh);
-  *pspe = spe = (DOMStringPoolEntry *)allocate(sizeToAllocate);
+  *pspe = spe = (DOMStringPoolEntry *)allocateBlock(sizeToAllocate);
   spe->fLength = n;
   spe->fNext = 0;
   XMLString::copyNString((XMLCh*)spe->fString, in, n);
@@ -477,7 +510,7 @@ inline void * operator new(size_t amt, XERCES_CPP_NAMESPACE_QUALIFIER DOMDocumen
 
 inline void * operator new(size_t amt, XERCES_CPP_NAMESPACE_QUALIFIER DOMDocumentImpl *doc)
 {
-    void* p = doc->allocate(amt);
+    void* p = doc->allocateBlock(amt);
     return p;
 }
 
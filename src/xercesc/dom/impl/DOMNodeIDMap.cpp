@@ -221,8 +221,9 @@ void DOMNodeIDMap::growTable()
             add(oldTable[i]);
     }
 
-    // delete [] oldTable;   (The document owns the storage.  The old table will just
-    //                        need to leak until until the document is discarded.)
+    // The document owns the storage.  A table too small to have a block of its
+    // own just leaks until the document is discarded.
+    ((DOMDocumentImpl *)fDoc)->release(oldTable, sizeof(DOMAttr*) * oldSize);
 
 }
 
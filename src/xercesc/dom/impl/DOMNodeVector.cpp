@@ -81,7 +81,9 @@ void DOMNodeVector::checkSpace() {
         for (XMLSize_t i=0; i<allocatedSize; i++) {
             newData[i] = data[i];
         }
-        // delete [] data;  // revisit.  Can't delete!  Recycle?
+        // A vector too small to have a block of its own leaks until the
+        // document is discarded.
+        ((DOMDocumentImpl *)doc)->release(data, sizeof(DOMNode*) * allocatedSize);
         allocatedSize = newAllocatedSize;
         data = newData;
     }
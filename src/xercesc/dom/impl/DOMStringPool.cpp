@@ -58,7 +58,9 @@ void DOMBuffer::expandCapacity(const XMLSize_t extraNeeded, bool releasePrevious
     // (e.g. if the DOM node is being created by the parser). Otherwise leave the old 
     // buffer in document heap; yes, this is a leak, but live with it!
     if (releasePrevious)
-        fDoc->release(fBuffer);
+        fDoc->release(fBuffer, (fCapacity+1)*sizeof(XMLCh));
+    else
+        fDoc->abandon((fCapacity+1)*sizeof(XMLCh));
     // store new stuff
     fBuffer = newBuf;
     fCapacity = newCap;
@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#include <xercesc/framework/ArenaMemoryManager.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+// ---------------------------------------------------------------------------
+//  Local const data
+//
+//  gMinBlockSize
+//      Smaller block sizes passed to the constructor are rounded up to this.
+// ---------------------------------------------------------------------------
+static const XMLSize_t gMinBlockSize = 256;
+
+
+// ---------------------------------------------------------------------------
+//  ArenaMemoryManager: Constructors and Destructor
+// ---------------------------------------------------------------------------
+ArenaMemoryManager::ArenaMemoryManager(const XMLSize_t          blockSize
+                                       , MemoryManager* const   manager) :
+    fBlockSize(blockSize < gMinBlockSize ? gMinBlockSize : blockSize)
+    , fBlocks(0)
+    , fLargeBlocks(0)
+    , fFreeBlocks(0)
+    , fFreeLargeBlocks(0)
+    , fCurrent(0)
+    , fEnd(0)
+    , fUsedSize(0)
+    , fReservedSize(0)
+    , fMemoryManager(manager)
+{
+}
+
+ArenaMemoryManager::~ArenaMemoryManager()
+{
+    release();
+}
+
+
+// ---------------------------------------------------------------------------
+//  ArenaMemoryManager: Implementation of the MemoryManager interface
+// ---------------------------------------------------------------------------
+MemoryManager* ArenaMemoryManager::getExceptionMemoryManager()
+{
+    return fMemoryManager->getExceptionMemoryManager();
+}
+
+void* ArenaMemoryManager::allocate(XMLSize_t size)
+{
+    // Every pointer handed out has to be suitably aligned (and distinct),
+    // so round the size up to the platform block alignment.
+    //
+    size = XMLPlatformUtils::alignPointerForNewBlockAllocation(size ? size : 1);
+
+    if (size > fBlockSize / 4)
+        return allocateLarge(size);
+
+    if ((XMLSize_t)(fEnd - fCurrent) < size)
+    {
+        Block* block = fFreeBlocks;
+        if (block)
+            fFreeBlocks = block->fNext;
+        else
+            block = newBlock(fBlockSize - XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(Block)));
+
+        block->fNext = fBlocks;
+        fBlocks = block;
+
+        fCurrent = (char*)block + XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(Block));
+        fEnd = fCurrent + block->fSize;
+    }
+
+    void* p = fCurrent;
+    fCurrent += size;
+    fUsedSize += size;
+    return p;
+}
+
+void ArenaMemoryManager::deallocate(void*)
+{
+}
+
+
+// ---------------------------------------------------------------------------
+//  ArenaMemoryManager: Arena methods
+// ---------------------------------------------------------------------------
+void ArenaMemoryManager::reset()
+{
+    while (fBlocks)
+    {
+        Block* block = fBlocks;
+        fBlocks = block->fNext;
+        block->fNext = fFreeBlocks;
+        fFreeBlocks = block;
+    }
+
+    while (fLargeBlocks)
+    {
+        Block* block = fLargeBlocks;
+        fLargeBlocks = block->fNext;
+        block->fNext = fFreeLargeBlocks;
+        fFreeLargeBlocks = block;
+    }
+
+    fCurrent = 0;
+    fEnd = 0;
+    fUsedSize = 0;
+}
+
+void ArenaMemoryManager::release()
+{
+    reset();
+    releaseList(fFreeBlocks);
+    releaseList(fFreeLargeBlocks);
+}
+
+
+// ---------------------------------------------------------------------------
+//  ArenaMemoryManager: Private helper methods
+// ---------------------------------------------------------------------------
+void* ArenaMemoryManager::allocateLarge(const XMLSize_t size)
+{
+    // Reuse the smallest kept block that is big enough. A repeated workload
+    // makes the same requests in the same order, so this always finds an
+    // exact match for it.
+    //
+    Block** best = 0;
+    for (Block** link = &fFreeLargeBlocks; *link; link = &(*link)->fNext)
+    {
+        if ((*link)->fSize >= size && (!best || (*link)->fSize < (*best)->fSize))
+        {
+            best = link;
+            if ((*link)->fSize == size)
+                break;
+        }
+    }
+
+    Block* block;
+    if (best)
+    {
+        block = *best;
+        *best = block->fNext;
+    }
+    else
+        block = newBlock(size);
+
+    block->fNext = fLargeBlocks;
+    fLargeBlocks = block;
+
+    fUsedSize += size;
+    return (char*)block + XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(Block));
+}
+
+ArenaMemoryManager::Block* ArenaMemoryManager::newBlock(const XMLSize_t size)
+{
+    const XMLSize_t total = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(Block)) + size;
+
+    Block* block = (Block*)fMemoryManager->allocate(total);
+    block->fNext = 0;
+    block->fSize = size;
+    fReservedSize += total;
+    return block;
+}
+
+void ArenaMemoryManager::releaseList(Block*& list)
+{
+    while (list)
+    {
+        Block* block = list;
+        list = block->fNext;
+        fReservedSize -= XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(Block)) + block->fSize;
+        fMemoryManager->deallocate(block);
+    }
+}
+
+XERCES_CPP_NAMESPACE_END
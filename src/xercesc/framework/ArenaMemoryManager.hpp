@@ -0,0 +1,237 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_ARENAMEMORYMANAGER_HPP)
+#define XERCESC_INCLUDE_GUARD_ARENAMEMORYMANAGER_HPP
+
+#include <xercesc/framework/MemoryManager.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+/**
+  * Arena memory manager
+  *
+  * <p>This memory manager hands out memory by bumping a pointer through
+  * large blocks obtained from a parent memory manager.  deallocate() does
+  * nothing; all of the memory is reclaimed at once by reset().  Blocks are
+  * kept across resets, so once a workload has been seen, repeating it does
+  * not allocate from the parent at all.
+  * </p>
+  *
+  * <p>It is intended for request-scoped parsing: create a parser with the
+  * arena, parse one document, delete the parser (and anything it created,
+  * such as an adopted DOM document), then call reset() before the next
+  * document.  A parser keeps its tables in its memory manager between
+  * parses, so the arena must not be reset while a parser or any object
+  * allocated from it is still alive.
+  * </p>
+  *
+  * <p>The arena is not thread-safe.  Memory used for exceptions comes from
+  * the parent memory manager so that it outlives a reset.
+  * </p>
+  */
+
+class XMLUTIL_EXPORT ArenaMemoryManager : public MemoryManager
+{
+public:
+
+    /** @name Constructor */
+    //@{
+
+    /**
+      * Constructor
+      *
+      * @param blockSize The size of the blocks requested from the parent
+      *                  memory manager.  Requests larger than a quarter of
+      *                  this size get a block of their own.
+      * @param manager   The parent memory manager
+      */
+    ArenaMemoryManager
+    (
+        const XMLSize_t             blockSize = 64 * 1024
+        , MemoryManager* const      manager = XMLPlatformUtils::fgMemoryManager
+    );
+    //@}
+
+    /** @name Destructor */
+    //@{
+
+    /**
+      * Destructor.  Returns all blocks to the parent memory manager.
+      */
+    virtual ~ArenaMemoryManager();
+    //@}
+
+
+    /**
+      * This method is called to obtain the memory manager that should be
+      * used to allocate memory used in exceptions.
+      *
+      * @return The parent memory manager
+      */
+    virtual MemoryManager* getExceptionMemoryManager();
+
+
+    /** @name The virtual methods in MemoryManager */
+    //@{
+
+    /**
+      * This method allocates requested memory from the current block.
+      *
+      * @param size The requested memory size
+      *
+      * @return A pointer to the allocated memory
+      */
+    virtual void* allocate(XMLSize_t size);
+
+    /**
+      * This method does nothing; the memory is reclaimed by reset().
+      *
+      * @param p The pointer to the allocated memory
+      */
+    virtual void deallocate(void* p);
+
+    //@}
+
+    /** @name Arena methods */
+    //@{
+
+    /**
+      * Reclaims everything allocated since the previous reset.  The blocks
+      * are kept for reuse.  All memory handed out by the arena becomes
+      * invalid.
+      */
+    void reset();
+
+    /**
+      * Like reset(), but also returns all blocks to the parent memory
+      * manager.
+      */
+    void release();
+
+    /**
+      * Returns the number of bytes handed out since the last reset,
+      * including alignment padding.
+      */
+    XMLSize_t getUsedSize() const;
+
+    /**
+      * Returns the number of bytes currently held from the parent memory
+      * manager.
+      */
+    XMLSize_t getReservedSize() const;
+
+    /**
+      * Returns the size of the blocks requested from the parent memory
+      * manager.
+      */
+    XMLSize_t getBlockSize() const;
+
+    //@}
+
+private:
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    ArenaMemoryManager(const ArenaMemoryManager&);
+    ArenaMemoryManager& operator=(const ArenaMemoryManager&);
+
+    // -----------------------------------------------------------------------
+    //  Private data types
+    //
+    //  Block
+    //      The header at the start of every block obtained from the parent.
+    //      fSize is the usable size that follows the (aligned) header.
+    // -----------------------------------------------------------------------
+    struct Block
+    {
+        Block*      fNext;
+        XMLSize_t   fSize;
+    };
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    void* allocateLarge(const XMLSize_t size);
+    Block* newBlock(const XMLSize_t size);
+    void releaseList(Block*& list);
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fBlockSize
+    //      The size of a regular block, including its header.
+    //
+    //  fBlocks
+    //  fLargeBlocks
+    //      The regular and the dedicated blocks in use since the last reset.
+    //      The head of fBlocks is the block being carved up.
+    //
+    //  fFreeBlocks
+    //  fFreeLargeBlocks
+    //      Blocks kept by reset() for reuse.  A dedicated block is reused for
+    //      the smallest request it can hold.
+    //
+    //  fCurrent
+    //  fEnd
+    //      The unused part of the head of fBlocks.
+    //
+    //  fUsedSize
+    //  fReservedSize
+    //      Statistics returned by getUsedSize() and getReservedSize().
+    //
+    //  fMemoryManager
+    //      The parent memory manager.
+    // -----------------------------------------------------------------------
+    XMLSize_t       fBlockSize;
+    Block*          fBlocks;
+    Block*          fLargeBlocks;
+    Block*          fFreeBlocks;
+    Block*          fFreeLargeBlocks;
+    char*           fCurrent;
+    char*           fEnd;
+    XMLSize_t       fUsedSize;
+    XMLSize_t       fReservedSize;
+    MemoryManager*  fMemoryManager;
+};
+
+// ---------------------------------------------------------------------------
+//  ArenaMemoryManager: Getter methods
+// ---------------------------------------------------------------------------
+inline XMLSize_t ArenaMemoryManager::getUsedSize() const
+{
+    return fUsedSize;
+}
+
+inline XMLSize_t ArenaMemoryManager::getReservedSize() const
+{
+    return fReservedSize;
+}
+
+inline XMLSize_t ArenaMemoryManager::getBlockSize() const
+{
+    return fBlockSize;
+}
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_COMPRESSEDFILEINPUTSOURCE_HPP)
+#define XERCESC_INCLUDE_GUARD_COMPRESSEDFILEINPUTSOURCE_HPP
+
+#include <xercesc/framework/LocalFileInputSource.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+class BinInputStream;
+
+/**
+ *  This class is a derivative of the LocalFileInputSource class, for local
+ *  files that may be compressed. The stream it creates decompresses the file
+ *  as the parser reads it, so the file never has to be decompressed to disk
+ *  or into memory first.
+ *
+ *  The compression format is detected from the first bytes of the file.
+ *  gzip files are always supported, and zstd files when the library was
+ *  built with zstd. Files that aren't compressed are read as they are, so
+ *  this input source can be used for any local file.
+ *
+ *  The file is found in the same way as for LocalFileInputSource.
+ */
+class XMLPARSER_EXPORT CompressedFileInputSource : public LocalFileInputSource
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    /** @name Constructors */
+    //@{
+
+    /**
+      * This constructor takes an explicit base path and a possibly relative
+      * path, as the LocalFileInputSource constructor of the same form does.
+      *
+      * @param  basePath    The base path from which the passed relative path
+      *                     will be based, if the relative part is indeed
+      *                     relative.
+      *
+      * @param  relativePath    The relative part of the path. It can actually
+      *                         be fully qualified, in which case it is taken
+      *                         as is.
+      *
+      * @param  manager    Pointer to the memory manager to be used to
+      *                    allocate objects.
+      *
+      * @exception XMLException If the path is relative and doesn't properly
+      *            resolve to a file.
+      */
+    CompressedFileInputSource
+    (
+        const   XMLCh* const   basePath
+        , const XMLCh* const   relativePath
+        , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager
+    );
+
+    /**
+      * This constructor takes a single parameter which is the fully qualified
+      * or relative path, as the LocalFileInputSource constructor of the same
+      * form does.
+      *
+      * @param  filePath    The relative or fully qualified path.
+      *
+      * @param  manager     Pointer to the memory manager to be used to
+      *                     allocate objects.
+      *
+      * @exception XMLException If the path is relative and doesn't properly
+      *            resolve to a file.
+      */
+    CompressedFileInputSource
+    (
+        const   XMLCh* const   filePath
+        , MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager
+    );
+    //@}
+
+    /** @name Destructor */
+    //@{
+    ~CompressedFileInputSource();
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Virtual input source interface
+    // -----------------------------------------------------------------------
+
+    /** @name Virtual methods */
+    //@{
+    /**
+    * This method will return a binary input stream derivative that will
+    * parse from the local file indicated by the system id, decompressing
+    * it if it is compressed.
+    *
+    * @return A dynamically allocated binary input stream derivative that
+    *         can parse from the file indicated by the system id.
+    */
+    virtual BinInputStream* makeStream() const;
+    //@}
+
+private:
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    CompressedFileInputSource(const CompressedFileInputSource&);
+    CompressedFileInputSource& operator=(const CompressedFileInputSource&);
+};
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
@@ -84,6 +84,8 @@ LocalFileInputSource::LocalFileInputSource( const XMLCh* const basePath
                                           , const XMLCh* const relativePath
                                           , MemoryManager* const manager)
     : InputSource(manager)
+    , fMapFile(false)
+    , fMapHugePages(false)
 {
     //
     //  If the relative part is really relative, then weave it together
@@ -109,6 +111,8 @@ LocalFileInputSource::LocalFileInputSource( const XMLCh* const basePath
 LocalFileInputSource::LocalFileInputSource(const XMLCh* const filePath,
                                            MemoryManager* const manager)
     : InputSource(manager)
+    , fMapFile(false)
+    , fMapHugePages(false)
 {
 
     //
@@ -165,6 +169,10 @@ BinInputStream* LocalFileInputSource::makeStream() const
         delete retStrm;
         return 0;
     }
+
+    // If the file can't be mapped, it is just read
+    if (fMapFile)
+        retStrm->mapFile(fMapHugePages);
     return retStrm;
 }
 
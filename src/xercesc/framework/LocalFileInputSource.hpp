@@ -138,6 +138,66 @@ public :
     virtual BinInputStream* makeStream() const;
 
     //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Getter methods
+    // -----------------------------------------------------------------------
+
+    /** @name Getter methods */
+    //@{
+
+    /**
+      * Get the flag that indicates if the file should be memory mapped.
+      *
+      * @return True if the stream maps the file into memory.
+      * @see #setMapFile
+      */
+    bool getMapFile() const;
+
+    /**
+      * Get the flag that indicates if huge pages are asked for when the
+      * file is memory mapped.
+      *
+      * @return True if huge pages are asked for.
+      * @see #setMapHugePages
+      */
+    bool getMapHugePages() const;
+
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Setter methods
+    // -----------------------------------------------------------------------
+
+    /** @name Setter methods */
+    //@{
+
+    /**
+      * Indicates if the stream should map the whole file into memory, read
+      * only, instead of reading it through the file manager. The parser then
+      * transcodes (or, for UTF-16 in the native byte order, scans) the data
+      * straight from the mapping, which saves a copy of every byte of large
+      * files. If the file manager can't map the file, it is read as usual.
+      *
+      * @param  newState True to map the file into memory. (Default: false)
+      * @see #getMapFile
+      */
+    void setMapFile(const bool newState);
+
+    /**
+      * Indicates if the system should be asked to back the mapping with huge
+      * pages, when the file is memory mapped. This is only a hint, which is
+      * ignored where it is not supported.
+      *
+      * @param  newState True to ask for huge pages. (Default: false)
+      * @see #getMapHugePages
+      */
+    void setMapHugePages(const bool newState);
+
+    //@}
+
 private:
     // -----------------------------------------------------------------------
     //  Unimplemented constructors and operators
@@ -145,8 +205,46 @@ private:
     LocalFileInputSource(const LocalFileInputSource&);
     LocalFileInputSource& operator=(const LocalFileInputSource&);
 
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fMapFile
+    //      Indicates if the stream maps the file into memory.
+    //
+    //  fMapHugePages
+    //      Indicates if huge pages are asked for when mapping the file.
+    // -----------------------------------------------------------------------
+    bool    fMapFile;
+    bool    fMapHugePages;
 };
 
+
+// ---------------------------------------------------------------------------
+//  LocalFileInputSource: Getter methods
+// ---------------------------------------------------------------------------
+inline bool LocalFileInputSource::getMapFile() const
+{
+    return fMapFile;
+}
+
+inline bool LocalFileInputSource::getMapHugePages() const
+{
+    return fMapHugePages;
+}
+
+// ---------------------------------------------------------------------------
+//  LocalFileInputSource: Setter methods
+// ---------------------------------------------------------------------------
+inline void LocalFileInputSource::setMapFile(const bool newState)
+{
+    fMapFile = newState;
+}
+
+inline void LocalFileInputSource::setMapHugePages(const bool newState)
+{
+    fMapHugePages = newState;
+}
+
 XERCES_CPP_NAMESPACE_END
 
 #endif
@@ -165,7 +165,7 @@ void XMLAttr::setValue(const XMLCh* const newValue)
 // ---------------------------------------------------------------------------
 void XMLAttr::cleanUp()
 {
-    delete fAttName;
+    deleteOwnedObject(fAttName);
     fMemoryManager->deallocate(fValue); //delete [] fValue;
 }
 
@@ -23,7 +23,7 @@
 // ---------------------------------------------------------------------------
 //  Includes
 // ---------------------------------------------------------------------------
-//#include <string.h>
+#include <string.h>
 #include <xercesc/framework/XMLBufferMgr.hpp>
 #include <xercesc/util/RuntimeException.hpp>
 
@@ -34,14 +34,17 @@ XERCES_CPP_NAMESPACE_BEGIN
 // ---------------------------------------------------------------------------
 XMLBufferMgr::XMLBufferMgr(MemoryManager* const manager) :
 
-    fBufCount(32)
+    fBufCount(0)
+    , fBufCapacity(32)
     , fMemoryManager(manager)
     , fBufList(0)
+    , fFreeList(0)
+    , fFreeCount(0)
+    , fBidCount(0)
 {
-    // Allocate the buffer list and zero it out
-    fBufList = (XMLBuffer**) fMemoryManager->allocate(fBufCount * sizeof(XMLBuffer*)); // new XMLBuffer*[fBufCount];
-    for (XMLSize_t index = 0; index < fBufCount; index++)
-        fBufList[index] = 0;
+    // Allocate the buffer and free lists, which start out empty
+    fBufList = (XMLBuffer**) fMemoryManager->allocate(fBufCapacity * sizeof(XMLBuffer*)); // new XMLBuffer*[fBufCapacity];
+    fFreeList = (XMLBuffer**) fMemoryManager->allocate(fBufCapacity * sizeof(XMLBuffer*));
 }
 
 XMLBufferMgr::~XMLBufferMgr()
@@ -50,8 +53,9 @@ XMLBufferMgr::~XMLBufferMgr()
     for (XMLSize_t index = 0; index < fBufCount; index++)
         delete fBufList[index];
 
-    // And then the buffer list
+    // And then the lists
     fMemoryManager->deallocate(fBufList); //delete [] fBufList;
+    fMemoryManager->deallocate(fFreeList);
 }
 
 
@@ -60,55 +64,72 @@ XMLBufferMgr::~XMLBufferMgr()
 // ---------------------------------------------------------------------------
 XMLBuffer& XMLBufferMgr::bidOnBuffer()
 {
-    //
-    //  Look for a buffer that is not in use. If we hit a null entry, then
-    //  we have to add one.
-    //
-    for (XMLSize_t index = 0; index < fBufCount; index++)
+    fBidCount++;
+
+    // If there is a free buffer, then reset it and take it
+    if (fFreeCount)
     {
-        // No more buffers available, so create one and take it
-        if (!fBufList[index])
-        {
-            fBufList[index] = new (fMemoryManager) XMLBuffer(1023, fMemoryManager);
-            fBufList[index]->setInUse(true);
-            return *fBufList[index];
-        }
-
-        //
-        //  There's one here, so see if its use. If not, mark it, reset it,
-        //  and take it
-        //
-        if (!fBufList[index]->getInUse())
-        {
-            fBufList[index]->reset();
-            fBufList[index]->setInUse(true);
-            return *(fBufList[index]);
-        }
+        XMLBuffer* buf = fFreeList[--fFreeCount];
+        buf->reset();
+        buf->setInUse(true);
+        return *buf;
     }
 
-    // We did not find one, so freak out
-    ThrowXMLwithMemMgr(RuntimeException, XMLExcepts::BufMgr_NoMoreBuffers, fMemoryManager);
+    // They are all in use, so create one and take it
+    if (fBufCount == fBufCapacity)
+        expandLists();
 
-    // NOTE: Dummy return to make some compilers happy. Never really gets called!
-    return *fBufList[0];
+    XMLBuffer* buf = new (fMemoryManager) XMLBuffer(1023, fMemoryManager);
+    fBufList[fBufCount++] = buf;
+    buf->setInUse(true);
+    return *buf;
 }
 
 
 void XMLBufferMgr::releaseBuffer(XMLBuffer& toRelease)
 {
-    // Look for this buffer in the list
-    for (XMLSize_t index = 0; index < fBufCount; index++)
+    //
+    //  A buffer that isn't in use has already been released, and one that
+    //  isn't in our list came from another pool (or from none), so neither
+    //  belongs on our free list.
+    //
+    if (!toRelease.getInUse() || !isInPool(&toRelease))
+        ThrowXMLwithMemMgr(RuntimeException, XMLExcepts::BufMgr_BufferNotInPool, fMemoryManager);
+
+    putOnFreeList(toRelease);
+}
+
+
+// ---------------------------------------------------------------------------
+//  Private helper methods
+// ---------------------------------------------------------------------------
+bool XMLBufferMgr::isInPool(const XMLBuffer* const toFind) const
+{
+    // Search from the end, since the newest buffers are the busiest ones
+    XMLSize_t index = fBufCount;
+    while (index > 0)
     {
-        if (fBufList[index] == &toRelease)
-        {
-            // Unmark it
-            toRelease.setInUse(false);
-            return;
-        }
+        if (fBufList[--index] == toFind)
+            return true;
     }
+    return false;
+}
 
-    // It was not a legal buffer
-    ThrowXMLwithMemMgr(RuntimeException, XMLExcepts::BufMgr_BufferNotInPool, fMemoryManager);
+void XMLBufferMgr::expandLists()
+{
+    // Double the capacity, and move the lists over
+    const XMLSize_t newCapacity = fBufCapacity * 2;
+    XMLBuffer** newBufList = (XMLBuffer**) fMemoryManager->allocate(newCapacity * sizeof(XMLBuffer*));
+    XMLBuffer** newFreeList = (XMLBuffer**) fMemoryManager->allocate(newCapacity * sizeof(XMLBuffer*));
+
+    memcpy(newBufList, fBufList, fBufCount * sizeof(XMLBuffer*));
+    memcpy(newFreeList, fFreeList, fFreeCount * sizeof(XMLBuffer*));
+
+    fMemoryManager->deallocate(fBufList);
+    fMemoryManager->deallocate(fFreeList);
+    fBufList = newBufList;
+    fFreeList = newFreeList;
+    fBufCapacity = newCapacity;
 }
 
 XERCES_CPP_NAMESPACE_END
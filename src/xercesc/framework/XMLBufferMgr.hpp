@@ -35,6 +35,10 @@ class XMLBufBid;
  *  provide a pool of buffers which can be temporarily used and then put
  *  back into the pool. This provides a good compromise between performance
  *  and easier maintenance.
+ *
+ *  Released buffers are kept on a free list, so that bidding on and releasing
+ *  a buffer take constant time. The pool grows whenever all of its buffers
+ *  are in use, so there is no limit on how many can be in use at once.
  */
 class XMLPARSER_EXPORT XMLBufferMgr : public XMemory
 {
@@ -63,9 +67,29 @@ public :
     // -----------------------------------------------------------------------
     //  Getter methods
     // -----------------------------------------------------------------------
+
+    /** @name Getter methods */
+    //@{
+    /**
+      * Returns the number of buffers in the pool.
+      *
+      * Since a buffer is only added when all of the others are in use, this
+      * is also the largest number of buffers that have been in use at once,
+      * which makes it the pool's high-water mark.
+      */
     XMLSize_t getBufferCount() const;
+
+    /**
+      * Returns the number of buffers in the pool that are not in use.
+      */
     XMLSize_t getAvailableBufferCount() const;
 
+    /**
+      * Returns the number of times a buffer has been bid on.
+      */
+    XMLSize_t getBidCount() const;
+    //@}
+
 private :
     // -----------------------------------------------------------------------
     //  Unimplemented constructors and operators
@@ -73,19 +97,44 @@ private :
     XMLBufferMgr(const XMLBufferMgr&);
     XMLBufferMgr& operator=(const XMLBufferMgr&);
 
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    void expandLists();
+    bool isInPool(const XMLBuffer* const toFind) const;
+    void putOnFreeList(XMLBuffer& toRelease);
+
+    // -----------------------------------------------------------------------
+    //  Declare our friends
+    // -----------------------------------------------------------------------
+    friend class XMLBufBid;
+
     // -----------------------------------------------------------------------
     //  Private data members
     //
     //  fBufCount
-    //      The count of buffers that have been allocated so far.
+    //  fBufCapacity
+    //      The count of buffers that have been allocated so far, and the
+    //      number that fBufList and fFreeList have room for.
+    //
+    //  fBufList
+    //      The list of pointers to all of the buffers, which we own.
+    //
+    //  fFreeList
+    //  fFreeCount
+    //      The buffers that are not in use, of which the last one released
+    //      is at the end and is the next one handed out.
     //
-    //  fBufList;
-    //      The list of pointers to buffers that are loaned out. There will
-    //      never be a lot of them, so a flat list is good enough.
+    //  fBidCount
+    //      The number of times a buffer has been bid on.
     // -----------------------------------------------------------------------
     XMLSize_t       fBufCount;
+    XMLSize_t       fBufCapacity;
     MemoryManager*  fMemoryManager;
     XMLBuffer**     fBufList;
+    XMLBuffer**     fFreeList;
+    XMLSize_t       fFreeCount;
+    XMLSize_t       fBidCount;
 };
 
 inline XMLSize_t XMLBufferMgr::getBufferCount() const
@@ -95,13 +144,19 @@ inline XMLSize_t XMLBufferMgr::getBufferCount() const
 
 inline XMLSize_t XMLBufferMgr::getAvailableBufferCount() const
 {
-    XMLSize_t available = fBufCount;
-    for (XMLSize_t index = 0; index < fBufCount && fBufList[index]; index++)
-    {
-        if (fBufList[index]->getInUse())
-            --available;
-    }
-    return available;
+    return fFreeCount;
+}
+
+inline XMLSize_t XMLBufferMgr::getBidCount() const
+{
+    return fBidCount;
+}
+
+inline void XMLBufferMgr::putOnFreeList(XMLBuffer& toRelease)
+{
+    // Unmark it and put it on the free list, which always has room for it
+    toRelease.setInUse(false);
+    fFreeList[fFreeCount++] = &toRelease;
 }
 
 
@@ -125,7 +180,14 @@ public :
 
     ~XMLBufBid()
     {
-        fMgr->releaseBuffer(fBuffer);
+        //
+        //  The buffer came from fMgr's bidOnBuffer(), so it is in the pool
+        //  and there is no need to search for it. Don't use releaseBuffer(),
+        //  which throws, since we may be running during stack unwinding. If
+        //  it was already released by hand, there is nothing to do.
+        //
+        if (fBuffer.getInUse())
+            fMgr->putOnFreeList(fBuffer);
     }
 
 
@@ -50,7 +50,7 @@ const XMLCh         XMLElementDecl::fgPCDataElemName[] =
 // ---------------------------------------------------------------------------
 XMLElementDecl::~XMLElementDecl()
 {
-    delete fElementName;
+    deleteOwnedObject(fElementName);
 }
 
 // ---------------------------------------------------------------------------
@@ -83,7 +83,7 @@ XMLElementDecl::setElementName(const QName* const    elementName)
     if (fElementName)
         fElementName->setValues(*elementName);
     else
-        fElementName = new (fMemoryManager) QName(*elementName);
+        fElementName = new (fMemoryManager) QName(*elementName, fMemoryManager);
 }
 
 // ---------------------------------------------------------------------------
@@ -0,0 +1,227 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#include <xercesc/internal/AttrNameSet.hpp>
+#include <xercesc/framework/MemoryManager.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+// ---------------------------------------------------------------------------
+//  AttrNameSet: Constructors and Destructor
+// ---------------------------------------------------------------------------
+AttrNameSet::AttrNameSet(MemoryManager* const manager) :
+    fList(0)
+    , fListCapacity(kLinearMax * 2)
+    , fCount(0)
+    , fTable(0)
+    , fTableSize(0)
+    , fGeneration(0)
+    , fMemoryManager(manager)
+{
+    fList = (NameEntry*) fMemoryManager->allocate
+    (
+        fListCapacity * sizeof(NameEntry)
+    );
+}
+
+AttrNameSet::~AttrNameSet()
+{
+    fMemoryManager->deallocate(fList);
+    fMemoryManager->deallocate(fTable);
+}
+
+
+// ---------------------------------------------------------------------------
+//  AttrNameSet: Getter methods
+// ---------------------------------------------------------------------------
+bool AttrNameSet::containsKey(const XMLCh* const name, const unsigned int uriId) const
+{
+    if (fCount <= kLinearMax)
+        return findInList(name, uriId);
+
+    return (findSlot(name, uriId, hashName(name, uriId))->fGeneration == fGeneration);
+}
+
+
+// ---------------------------------------------------------------------------
+//  AttrNameSet: Putters
+// ---------------------------------------------------------------------------
+bool AttrNameSet::putIfNotPresent(const XMLCh* const name, const unsigned int uriId)
+{
+    if (fCount <= kLinearMax)
+    {
+        if (findInList(name, uriId))
+            return false;
+
+        // Once there are too many names to compare, switch to the table
+        addToList(name, uriId);
+        if (fCount > kLinearMax)
+            buildTable();
+        return true;
+    }
+
+    const XMLSize_t hashVal = hashName(name, uriId);
+    TableSlot* slot = findSlot(name, uriId, hashVal);
+    if (slot->fGeneration == fGeneration)
+        return false;
+
+    addToList(name, uriId);
+    if (fCount * 2 > fTableSize)
+    {
+        buildTable();
+    }
+    else
+    {
+        slot->fGeneration = fGeneration;
+        slot->fURIId = uriId;
+        slot->fHash = hashVal;
+        slot->fName = name;
+    }
+    return true;
+}
+
+
+// ---------------------------------------------------------------------------
+//  AttrNameSet: Private helper methods
+// ---------------------------------------------------------------------------
+bool AttrNameSet::findInList(const XMLCh* const name, const unsigned int uriId) const
+{
+    for (XMLSize_t index = 0; index < fCount; index++)
+    {
+        if ((fList[index].fURIId == uriId)
+        &&  XMLString::equals(fList[index].fName, name))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+//  Returns the slot that holds the name, or else the empty slot where it
+//  would go. There is always an empty slot, since the table is kept at most
+//  half full.
+//
+AttrNameSet::TableSlot*
+AttrNameSet::findSlot(  const XMLCh* const      name
+                      , const unsigned int    uriId
+                      , const XMLSize_t       hashVal) const
+{
+    const XMLSize_t mask = fTableSize - 1;
+    XMLSize_t index = hashVal & mask;
+    while (true)
+    {
+        TableSlot* slot = &fTable[index];
+        if (slot->fGeneration != fGeneration)
+            return slot;
+
+        if ((slot->fHash == hashVal)
+        &&  (slot->fURIId == uriId)
+        &&  XMLString::equals(slot->fName, name))
+        {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+void AttrNameSet::addToList(const XMLCh* const name, const unsigned int uriId)
+{
+    if (fCount == fListCapacity)
+    {
+        const XMLSize_t newCapacity = fListCapacity * 2;
+        NameEntry* newList = (NameEntry*) fMemoryManager->allocate
+        (
+            newCapacity * sizeof(NameEntry)
+        );
+        memcpy(newList, fList, fCount * sizeof(NameEntry));
+        fMemoryManager->deallocate(fList);
+        fList = newList;
+        fListCapacity = newCapacity;
+    }
+
+    fList[fCount].fName = name;
+    fList[fCount].fURIId = uriId;
+    fCount++;
+}
+
+//
+//  Puts all of the names into the table under a new generation, first
+//  growing the table if it would be more than half full. Any slots left
+//  from earlier elements are stale once the generation moves on.
+//
+void AttrNameSet::buildTable()
+{
+    XMLSize_t newSize = fTableSize ? fTableSize : (XMLSize_t)kInitTableSize;
+    while (fCount * 2 > newSize)
+        newSize *= 2;
+
+    if (newSize != fTableSize)
+    {
+        TableSlot* newTable = (TableSlot*) fMemoryManager->allocate
+        (
+            newSize * sizeof(TableSlot)
+        );
+        fMemoryManager->deallocate(fTable);
+        fTable = newTable;
+        fTableSize = newSize;
+        memset(fTable, 0, fTableSize * sizeof(TableSlot));
+        fGeneration = 0;
+    }
+
+    // If the generation wraps around, the old stamps can't be told apart
+    fGeneration++;
+    if (!fGeneration)
+    {
+        memset(fTable, 0, fTableSize * sizeof(TableSlot));
+        fGeneration = 1;
+    }
+
+    for (XMLSize_t index = 0; index < fCount; index++)
+    {
+        const XMLSize_t hashVal = hashName(fList[index].fName, fList[index].fURIId);
+        TableSlot* slot = findSlot(fList[index].fName, fList[index].fURIId, hashVal);
+        slot->fGeneration = fGeneration;
+        slot->fURIId = fList[index].fURIId;
+        slot->fHash = hashVal;
+        slot->fName = fList[index].fName;
+    }
+}
+
+//
+//  The table size is a power of two, so the low bits of the hash must depend
+//  on all of the characters. This is FNV-1a, with the high bits folded in.
+//
+XMLSize_t AttrNameSet::hashName(const XMLCh* const name, const unsigned int uriId)
+{
+    XMLSize_t hashVal = 2166136261u ^ uriId;
+    for (const XMLCh* curCh = name; *curCh; curCh++)
+        hashVal = (hashVal ^ *curCh) * 16777619u;
+    return hashVal ^ (hashVal >> 16);
+}
+
+XERCES_CPP_NAMESPACE_END
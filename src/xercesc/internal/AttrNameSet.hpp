@@ -0,0 +1,179 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_ATTRNAMESET_HPP)
+#define XERCESC_INCLUDE_GUARD_ATTRNAMESET_HPP
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMemory.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+//
+//  The scanners use this to find duplicate attributes in a start tag. It
+//  holds the names of the attributes seen so far, each a name and a URI id,
+//  and is emptied for every element.
+//
+//  Most elements have a few attributes, and for those it is quickest to just
+//  compare each new name with the ones already there. Once an element has
+//  more than a few, the names are also put into an open addressed hash table,
+//  so that elements with thousands of attributes don't take quadratic time.
+//  The table is kept from one element to the next and its slots are stamped
+//  with a generation number, which removeAll() bumps instead of clearing the
+//  table. So emptying the set takes constant time however large it has grown.
+//
+//  The set only holds on to the name pointers, so the names must stay put
+//  until the set is emptied.
+//
+class XMLPARSER_EXPORT AttrNameSet : public XMemory
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    AttrNameSet(MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
+    ~AttrNameSet();
+
+
+    // -----------------------------------------------------------------------
+    //  Getter methods
+    // -----------------------------------------------------------------------
+    bool containsKey(const XMLCh* const name, const unsigned int uriId) const;
+    XMLSize_t getCount() const;
+
+
+    // -----------------------------------------------------------------------
+    //  Putters
+    // -----------------------------------------------------------------------
+    bool putIfNotPresent(const XMLCh* const name, const unsigned int uriId);
+    void removeAll();
+
+
+private :
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    AttrNameSet(const AttrNameSet&);
+    AttrNameSet& operator=(const AttrNameSet&);
+
+
+    // -----------------------------------------------------------------------
+    //  Private class types
+    //
+    //  Constants
+    //      kLinearMax is the number of names that are only compared one by
+    //      one. kInitTableSize is the size of the hash table when it is first
+    //      needed; it is always a power of two.
+    //
+    //  NameEntry
+    //      The names in the set, in the order they were put in.
+    //
+    //  TableSlot
+    //      A slot of the hash table. It is in use if its generation is the
+    //      current one. The hash of the name is kept to skip most string
+    //      comparisons and to rebuild the table when it grows.
+    // -----------------------------------------------------------------------
+    enum Constants
+    {
+        kLinearMax        = 16
+        , kInitTableSize  = 64
+    };
+
+    struct NameEntry
+    {
+        const XMLCh*    fName;
+        unsigned int    fURIId;
+    };
+
+    struct TableSlot
+    {
+        unsigned int    fGeneration;
+        unsigned int    fURIId;
+        XMLSize_t       fHash;
+        const XMLCh*    fName;
+    };
+
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    bool findInList(const XMLCh* const name, const unsigned int uriId) const;
+    TableSlot* findSlot
+    (
+        const XMLCh* const      name
+        , const unsigned int    uriId
+        , const XMLSize_t       hashVal
+    )   const;
+    void addToList(const XMLCh* const name, const unsigned int uriId);
+    void buildTable();
+    static XMLSize_t hashName(const XMLCh* const name, const unsigned int uriId);
+
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fList
+    //  fListCapacity
+    //  fCount
+    //      The names in the set, the number of them that fList has room for
+    //      and the number of them that it holds.
+    //
+    //  fTable
+    //  fTableSize
+    //      The hash table. It only holds the names of the set once there are
+    //      more than kLinearMax of them; until then its contents are stale.
+    //      It is kept at most half full.
+    //
+    //  fGeneration
+    //      The generation of the slots of fTable that are in use. It is
+    //      bumped each time the table is filled from fList.
+    // -----------------------------------------------------------------------
+    NameEntry*              fList;
+    XMLSize_t               fListCapacity;
+    XMLSize_t               fCount;
+    TableSlot*              fTable;
+    XMLSize_t               fTableSize;
+    unsigned int            fGeneration;
+    MemoryManager* const    fMemoryManager;
+};
+
+
+// ---------------------------------------------------------------------------
+//  AttrNameSet: Getter methods
+// ---------------------------------------------------------------------------
+inline XMLSize_t AttrNameSet::getCount() const
+{
+    return fCount;
+}
+
+
+// ---------------------------------------------------------------------------
+//  AttrNameSet: Putters
+// ---------------------------------------------------------------------------
+inline void AttrNameSet::removeAll()
+{
+    // The table is left as it is; it is refilled with a new generation
+    fCount = 0;
+}
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
@@ -2202,7 +2202,7 @@ void DGXMLScanner::commonInit()
     (
         131, false, fMemoryManager
     );
-    fUndeclaredAttrRegistry = new (fMemoryManager) Hash2KeysSetOf<StringHasher>(7, fMemoryManager);
+    fUndeclaredAttrRegistry = new (fMemoryManager) AttrNameSet(fMemoryManager);
 
     if (fValidator)
     {
@@ -2445,6 +2445,7 @@ void DGXMLScanner::scanReset(const InputSource& src)
 
     // Reset some status flags
     fInException = false;
+    fSkipLevel = 0;
     fStandalone = false;
     fErrorCount = 0;
     fHasNoDTD = true;
@@ -2647,41 +2648,19 @@ void DGXMLScanner::scanAttrListforNameSpaces(RefVectorOf<XMLAttr>* theAttrList,
 
     fAttrNSList->removeAllElements();
 
-     // Decide if to use hash table to do duplicate checking
-    bool toUseHashTable = false;
-
-	setAttrDupChkRegistry(attCount, toUseHashTable);
+    fAttrDupChkRegistry->removeAll();
     for (XMLSize_t index = 0; index < attCount; index++)
     {
         // check for duplicate namespace attributes:
         // by checking for qualified names with the same local part and with prefixes
         // which have been bound to namespace names that are identical.
         XMLAttr* curAttr = theAttrList->elementAt(index);
-        if (!toUseHashTable)
-        {
-            XMLAttr* loopAttr;
-            for (XMLSize_t attrIndex=0; attrIndex < index; attrIndex++) {
-                loopAttr = theAttrList->elementAt(attrIndex);
-                if (loopAttr->getURIId() == curAttr->getURIId() &&
-                    XMLString::equals(loopAttr->getName(), curAttr->getName())) {
-                    emitError(
-                        XMLErrs::AttrAlreadyUsedInSTag, curAttr->getName()
-                        , elemDecl->getFullName()
-                    );
-                }
-            }
-        }
-        else
+        if (!fAttrDupChkRegistry->putIfNotPresent(curAttr->getName(), curAttr->getURIId()))
         {
-            if (fAttrDupChkRegistry->containsKey((void*)curAttr->getName(), curAttr->getURIId()))
-            {
-                emitError(
-                    XMLErrs::AttrAlreadyUsedInSTag
-                    , curAttr->getName(), elemDecl->getFullName()
-                );
-            }
-
-            fAttrDupChkRegistry->put((void*)curAttr->getName(), curAttr->getURIId(), curAttr);
+            emitError(
+                XMLErrs::AttrAlreadyUsedInSTag
+                , curAttr->getName(), elemDecl->getFullName()
+            );
         }
     }
 }
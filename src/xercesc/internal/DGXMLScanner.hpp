@@ -25,7 +25,6 @@
 #include <xercesc/internal/XMLScanner.hpp>
 #include <xercesc/util/ValueVectorOf.hpp>
 #include <xercesc/util/NameIdPool.hpp>
-#include <xercesc/util/Hash2KeysSetOf.hpp>
 #include <xercesc/validators/common/Grammar.hpp>
 
 XERCES_CPP_NAMESPACE_BEGIN
@@ -174,7 +173,7 @@ private :
     NameIdPool<DTDElementDecl>* fDTDElemNonDeclPool;
     unsigned int                fElemCount;
     RefHashTableOf<unsigned int, PtrHasher>* fAttDefRegistry;
-    Hash2KeysSetOf<StringHasher>*            fUndeclaredAttrRegistry;
+    AttrNameSet*                             fUndeclaredAttrRegistry;
 };
 
 inline const XMLCh* DGXMLScanner::getName() const
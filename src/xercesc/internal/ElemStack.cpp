@@ -31,6 +31,15 @@
 
 XERCES_CPP_NAMESPACE_BEGIN
 
+// ---------------------------------------------------------------------------
+//  Local const data
+//
+//  kUnboundURI
+//      The URI id held in the binding tables for a prefix that isn't mapped.
+// ---------------------------------------------------------------------------
+static const unsigned int kUnboundURI = 0xFFFFFFFF;
+
+
 // ---------------------------------------------------------------------------
 //  ElemStack: Constructors and Destructor
 // ---------------------------------------------------------------------------
@@ -40,6 +49,11 @@ ElemStack::ElemStack(MemoryManager* const manager) :
     , fGlobalPoolId(0)
     , fPrefixPool(109, manager)
     , fGlobalNamespaces(0)
+    , fBindings(0)
+    , fBindingCapacity(0)
+    , fUndoLog(0)
+    , fUndoCapacity(0)
+    , fUndoCount(0)
     , fStack(0)
     , fStackCapacity(32)
     , fStackTop(0)
@@ -87,6 +101,8 @@ ElemStack::~ElemStack()
 
     // Delete the stack array itself now
     fMemoryManager->deallocate(fStack);//delete [] fStack;
+    fMemoryManager->deallocate(fBindings);
+    fMemoryManager->deallocate(fUndoLog);
     delete fNamespaceMap;
 }
 
@@ -176,6 +192,9 @@ const ElemStack::StackElem* ElemStack::popTop()
         ThrowXMLwithMemMgr(EmptyStackException, XMLExcepts::ElemStack_StackUnderflow, fMemoryManager);
 
     fStackTop--;
+
+    // The prefixes mapped by this element go back out of scope
+    unbindPrefixes(fStack[fStackTop]->fMapCount);
     return fStack[fStackTop];
 }
 
@@ -336,6 +355,9 @@ void ElemStack::addPrefix(  const   XMLCh* const    prefixToAdd
     else
         curRow->fMap[curRow->fMapCount].fURIId = uriId;
 
+    // And make it the prefix's current mapping
+    bindPrefix(prefId, curRow->fMap[curRow->fMapCount].fURIId);
+
     // Bump the map count now
     curRow->fMapCount++;
 }
@@ -343,15 +365,29 @@ void ElemStack::addPrefix(  const   XMLCh* const    prefixToAdd
 
 unsigned int ElemStack::mapPrefixToURI( const   XMLCh* const    prefixToMap
                                         ,       bool&           unknown) const
+{
+    //
+    //  Map the prefix to its unique id, from the prefix string pool, and
+    //  then map that id.
+    //
+    return mapPrefixIdToURI
+    (
+        (!prefixToMap || !*prefixToMap)?fGlobalPoolId : fPrefixPool.getId(prefixToMap)
+        , unknown
+    );
+}
+
+//
+//  The prefix pool is never flushed, so a caller can hold on to the id of a
+//  prefix it maps often and skip hashing the prefix string each time. An id
+//  of zero is not a valid prefix, so its a failure.
+//
+unsigned int ElemStack::mapPrefixIdToURI(const  unsigned int    prefixId
+                                        ,       bool&           unknown) const
 {
     // Assume we find it
     unknown = false;
 
-    //
-    //  Map the prefix to its unique id, from the prefix string pool. If its
-    //  not a valid prefix, then its a failure.
-    //
-    unsigned int prefixId = (!prefixToMap || !*prefixToMap)?fGlobalPoolId : fPrefixPool.getId(prefixToMap);
     if (prefixId == 0)
     {
         unknown = true;
@@ -367,21 +403,12 @@ unsigned int ElemStack::mapPrefixToURI( const   XMLCh* const    prefixToMap
         return fXMLNSNamespaceId;
 
     //
-    //  Start at the stack top and work backwards until we come to some
-    //  element that mapped this prefix.
+    //  The binding table holds the mapping made by the innermost element
+    //  on the stack that mapped this prefix, if any did.
     //
-    for (XMLSize_t index = fStackTop; index > 0; index--)
-    {
-        // Get a convenience pointer to the current element
-        StackElem* curRow = fStack[index-1];
+    if ((prefixId < fBindingCapacity) && (fBindings[prefixId] != kUnboundURI))
+        return fBindings[prefixId];
 
-        // Search the map at this level for the passed prefix
-        for (XMLSize_t mapIndex = 0; mapIndex < curRow->fMapCount; mapIndex++)
-        {
-            if (curRow->fMap[mapIndex].fPrefId == prefixId)
-                return curRow->fMap[mapIndex].fURIId;
-        }
-    }
     //  If the prefix wasn't found, try in the global namespaces
     if(fGlobalNamespaces)
     {
@@ -397,7 +424,7 @@ unsigned int ElemStack::mapPrefixToURI( const   XMLCh* const    prefixToMap
     //  global namespace id. This can be overridden, but no one has or we
     //  would have not gotten here.
     //
-    if (!*prefixToMap)
+    if (prefixId == fGlobalPoolId)
         return fEmptyNamespaceId;
 
     // Oh well, don't have a clue so return the unknown id
@@ -450,8 +477,9 @@ void ElemStack::reset(  const   unsigned int    emptyId
         fGlobalNamespaces = 0;
     }
 
-    // Reset the stack top to clear the stack
+    // Reset the stack top to clear the stack, and drop all of its mappings
     fStackTop = 0;
+    unbindPrefixes(fUndoCount);
 
     // if first time, put in the standard prefixes
     if (fXMLPoolId == 0) {
@@ -501,6 +529,66 @@ void ElemStack::expandMap(StackElem* const toExpand)
     toExpand->fMapCapacity = newCapacity;
 }
 
+//
+//  Makes uriId the current mapping of the prefix, remembering the one it
+//  replaces in the undo log.
+//
+void ElemStack::bindPrefix(const unsigned int prefId, const unsigned int uriId)
+{
+    if (prefId >= fBindingCapacity)
+    {
+        const XMLSize_t newCapacity = (prefId + 1 > fBindingCapacity * 2) ?
+                                      (XMLSize_t)prefId + 1 + 16 :
+                                      fBindingCapacity * 2;
+        unsigned int* newBindings = (unsigned int*) fMemoryManager->allocate
+        (
+            newCapacity * sizeof(unsigned int)
+        );
+
+        // The new part starts out unbound
+        memcpy(newBindings, fBindings, fBindingCapacity * sizeof(unsigned int));
+        for (XMLSize_t index = fBindingCapacity; index < newCapacity; index++)
+            newBindings[index] = kUnboundURI;
+
+        fMemoryManager->deallocate(fBindings);
+        fBindings = newBindings;
+        fBindingCapacity = newCapacity;
+    }
+
+    if (fUndoCount == fUndoCapacity)
+    {
+        const XMLSize_t newCapacity = fUndoCapacity ? fUndoCapacity * 2 : 16;
+        PrefMapElem* newLog = (PrefMapElem*) fMemoryManager->allocate
+        (
+            newCapacity * sizeof(PrefMapElem)
+        );
+        memcpy(newLog, fUndoLog, fUndoCount * sizeof(PrefMapElem));
+
+        fMemoryManager->deallocate(fUndoLog);
+        fUndoLog = newLog;
+        fUndoCapacity = newCapacity;
+    }
+
+    fUndoLog[fUndoCount].fPrefId = prefId;
+    fUndoLog[fUndoCount].fURIId = fBindings[prefId];
+    fUndoCount++;
+
+    fBindings[prefId] = uriId;
+}
+
+//
+//  Undoes the last count prefix mappings, latest first, so that a prefix
+//  mapped more than once ends up with the mapping it had before all of them.
+//
+void ElemStack::unbindPrefixes(const XMLSize_t count)
+{
+    for (XMLSize_t index = 0; index < count; index++)
+    {
+        fUndoCount--;
+        fBindings[fUndoLog[fUndoCount].fPrefId] = fUndoLog[fUndoCount].fURIId;
+    }
+}
+
 void ElemStack::expandStack()
 {
     // Expand the capacity by 25% and allocate a new buffer
@@ -549,6 +637,9 @@ WFElemStack::WFElemStack(MemoryManager* const manager) :
     , fXMLNSPoolId(0)
     , fMapCapacity(0)
     , fMap(0)
+    , fPrevURIs(0)
+    , fBindings(0)
+    , fBindingCapacity(0)
     , fStack(0)
     , fPrefixPool(109, manager)
     , fMemoryManager(manager)
@@ -579,6 +670,8 @@ WFElemStack::~WFElemStack()
 
     if (fMap)
         fMemoryManager->deallocate(fMap);//delete [] fMap;
+    fMemoryManager->deallocate(fPrevURIs);
+    fMemoryManager->deallocate(fBindings);
 
     // Delete the stack array itself now
     fMemoryManager->deallocate(fStack);//delete [] fStack;
@@ -671,6 +764,13 @@ const WFElemStack::StackElem* WFElemStack::popTop()
         ThrowXMLwithMemMgr(EmptyStackException, XMLExcepts::ElemStack_StackUnderflow, fMemoryManager);
 
     fStackTop--;
+
+    // The prefixes mapped by this element go back out of scope
+    unbindPrefixes
+    (
+        fStack[fStackTop]->fTopPrefix
+        , fStackTop ? fStack[fStackTop - 1]->fTopPrefix : -1
+    );
     return fStack[fStackTop];
 }
 
@@ -742,6 +842,29 @@ void WFElemStack::addPrefix(  const   XMLCh* const    prefixToAdd
     else
         fMap[curRow->fTopPrefix + 1].fURIId = uriId;
 
+    // And make it the prefix's current mapping, remembering the old one
+    if (prefId >= fBindingCapacity)
+    {
+        const XMLSize_t newCapacity = (prefId + 1 > fBindingCapacity * 2) ?
+                                      (XMLSize_t)prefId + 1 + 16 :
+                                      fBindingCapacity * 2;
+        unsigned int* newBindings = (unsigned int*) fMemoryManager->allocate
+        (
+            newCapacity * sizeof(unsigned int)
+        );
+
+        // The new part starts out unbound
+        memcpy(newBindings, fBindings, fBindingCapacity * sizeof(unsigned int));
+        for (XMLSize_t index = fBindingCapacity; index < newCapacity; index++)
+            newBindings[index] = kUnboundURI;
+
+        fMemoryManager->deallocate(fBindings);
+        fBindings = newBindings;
+        fBindingCapacity = newCapacity;
+    }
+    fPrevURIs[curRow->fTopPrefix + 1] = fBindings[prefId];
+    fBindings[prefId] = fMap[curRow->fTopPrefix + 1].fURIId;
+
     // Bump the map count now
     curRow->fTopPrefix++;
 }
@@ -774,16 +897,11 @@ unsigned int WFElemStack::mapPrefixToURI( const   XMLCh* const    prefixToMap
         return fXMLNSNamespaceId;
 
     //
-    //  Start at the stack top and work backwards until we come to some
-    //  element that mapped this prefix.
+    //  The binding table holds the mapping made by the innermost element
+    //  on the stack that mapped this prefix, if any did.
     //
-    //  Get a convenience pointer to the stack top row
-    StackElem* curRow = fStack[fStackTop - 1];
-    for (int mapIndex = curRow->fTopPrefix; mapIndex >=0; mapIndex--)
-    {
-        if (fMap[mapIndex].fPrefId == prefixId)
-            return fMap[mapIndex].fURIId;
-    }
+    if ((prefixId < fBindingCapacity) && (fBindings[prefixId] != kUnboundURI))
+        return fBindings[prefixId];
 
     //
     //  If the prefix is an empty string, then we will return the special
@@ -807,7 +925,9 @@ void WFElemStack::reset(  const   unsigned int    emptyId
                           , const unsigned int    xmlId
                           , const unsigned int    xmlNSId)
 {
-    // Reset the stack top to clear the stack
+    // Drop all of the stack's mappings, and reset the stack top to clear it
+    if (fStackTop)
+        unbindPrefixes(fStack[fStackTop - 1]->fTopPrefix, -1);
     fStackTop = 0;
 
     // if first time, put in the standard prefixes
@@ -847,16 +967,35 @@ void WFElemStack::expandMap()
     //  since this is a by value map and the current map index controls what
     //  is relevant.
     //
+    unsigned int* newPrevURIs = (unsigned int*) fMemoryManager->allocate
+    (
+        newCapacity * sizeof(unsigned int)
+    );
+
     if (fMapCapacity) {
 
         memcpy(newMap, fMap, fMapCapacity * sizeof(PrefMapElem));
+        memcpy(newPrevURIs, fPrevURIs, fMapCapacity * sizeof(unsigned int));
         fMemoryManager->deallocate(fMap);//delete [] fMap;
+        fMemoryManager->deallocate(fPrevURIs);
     }
 
     fMap = newMap;
+    fPrevURIs = newPrevURIs;
     fMapCapacity = newCapacity;
 }
 
+//
+//  Undoes the prefix mappings in fMap from topPrefix down to newTopPrefix,
+//  latest first, so that a prefix mapped more than once ends up with the
+//  mapping it had before all of them.
+//
+void WFElemStack::unbindPrefixes(const int topPrefix, const int newTopPrefix)
+{
+    for (int mapIndex = topPrefix; mapIndex > newTopPrefix; mapIndex--)
+        fBindings[fMap[mapIndex].fPrefId] = fPrevURIs[mapIndex];
+}
+
 void WFElemStack::expandStack()
 {
     // Expand the capacity by 25% and allocate a new buffer
@@ -192,6 +192,11 @@ public :
         const   XMLCh* const    prefixToMap
         ,       bool&           unknown
     )   const;
+    unsigned int mapPrefixIdToURI
+    (
+        const   unsigned int    prefixId
+        ,       bool&           unknown
+    )   const;
     ValueVectorOf<PrefMapElem*>* getNamespaceMap() const;
     unsigned int getPrefixId(const XMLCh* const prefix) const;
     const XMLCh* getPrefixForId(unsigned int prefId) const;
@@ -200,6 +205,7 @@ public :
     //  Miscellaneous methods
     // -----------------------------------------------------------------------
     bool isEmpty() const;
+    XMLSize_t getLevel() const;
     void reset
     (
         const   unsigned int    emptyId
@@ -223,6 +229,8 @@ private :
     // -----------------------------------------------------------------------
     void expandMap(StackElem* const toExpand);
     void expandStack();
+    void bindPrefix(const unsigned int prefId, const unsigned int uriId);
+    void unbindPrefixes(const XMLSize_t count);
 
 
     // -----------------------------------------------------------------------
@@ -246,6 +254,20 @@ private :
     //  fGlobalNamespaces
     //      This object contains the namespace bindings that are globally valid 
     //
+    //  fBindings
+    //  fBindingCapacity
+    //      The URI id that each prefix is currently mapped to by the elements
+    //      on the stack, indexed by the prefix's id in fPrefixPool, so that
+    //      a prefix is mapped without searching the stack. Prefixes that no
+    //      element on the stack maps hold kUnboundURI.
+    //
+    //  fUndoLog
+    //  fUndoCapacity
+    //  fUndoCount
+    //      For each prefix mapping made by the elements on the stack, in
+    //      order, the prefix's id and the URI id it was mapped to before. When
+    //      an element is popped, its mappings are undone from the end of this.
+    //
     //  fStack
     //  fStackCapacity
     //  fStackTop
@@ -271,6 +293,11 @@ private :
     unsigned int                 fGlobalPoolId;
     XMLStringPool                fPrefixPool;
     StackElem*                   fGlobalNamespaces;
+    unsigned int*                fBindings;
+    XMLSize_t                    fBindingCapacity;
+    PrefMapElem*                 fUndoLog;
+    XMLSize_t                    fUndoCapacity;
+    XMLSize_t                    fUndoCount;
     StackElem**                  fStack;
     XMLSize_t                    fStackCapacity;
     XMLSize_t                    fStackTop;
@@ -399,6 +426,7 @@ private :
     // -----------------------------------------------------------------------
     void expandMap();
     void expandStack();
+    void unbindPrefixes(const int topPrefix, const int newTopPrefix);
 
 
     // -----------------------------------------------------------------------
@@ -439,6 +467,20 @@ private :
     //      These are the URI ids for the special URIs that are assigned to
     //      the 'xml' and 'xmlns' namespaces. And also its prefix pool id,
     //      which is stored here for fast access.
+    //
+    //  fMap
+    //  fMapCapacity
+    //  fPrevURIs
+    //      The prefix mappings made by the elements on the stack, in order.
+    //      Each element's fTopPrefix is the index of the last one in scope
+    //      for it. fPrevURIs holds, for each of them, the URI id that the
+    //      prefix was mapped to before, so that it can be undone.
+    //
+    //  fBindings
+    //  fBindingCapacity
+    //      The URI id that each prefix is currently mapped to, indexed by
+    //      the prefix's id in fPrefixPool, so that a prefix is mapped without
+    //      searching fMap. Prefixes that aren't mapped hold kUnboundURI.
     // -----------------------------------------------------------------------
     unsigned int    fEmptyNamespaceId;
     unsigned int    fGlobalPoolId;
@@ -451,6 +493,9 @@ private :
     unsigned int    fXMLNSPoolId;
     XMLSize_t       fMapCapacity;
     PrefMapElem*    fMap;
+    unsigned int*   fPrevURIs;
+    unsigned int*   fBindings;
+    XMLSize_t       fBindingCapacity;
     StackElem**     fStack;
     XMLStringPool   fPrefixPool;
     MemoryManager*  fMemoryManager;
@@ -465,6 +510,11 @@ inline bool ElemStack::isEmpty() const
     return (fStackTop == 0);
 }
 
+inline XMLSize_t ElemStack::getLevel() const
+{
+    return fStackTop;
+}
+
 inline bool ElemStack::getValidationFlag()
 {
     return fStack[fStackTop-1]->fValidationFlag;
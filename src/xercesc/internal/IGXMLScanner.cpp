@@ -75,6 +75,7 @@ IGXMLScanner::IGXMLScanner( XMLValidator* const  valToAdopt
     , fICHandler(0)
     , fLocationPairs(0)
     , fDTDElemNonDeclPool(0)
+    , fDTDElemNonDeclStack(0)
     , fSchemaElemNonDeclPool(0)
     , fElemCount(0)
     , fAttDefRegistry(0)
@@ -128,6 +129,7 @@ IGXMLScanner::IGXMLScanner( XMLDocumentHandler* const docHandler
     , fICHandler(0)
     , fLocationPairs(0)
     , fDTDElemNonDeclPool(0)
+    , fDTDElemNonDeclStack(0)
     , fSchemaElemNonDeclPool(0)
     , fElemCount(0)
     , fAttDefRegistry(0)
@@ -519,7 +521,7 @@ void IGXMLScanner::commonInit()
 
     //  And we need one for the raw attribute scan. This just stores key/
     //  value string pairs (prior to any processing.)
-    fRawAttrList = new (fMemoryManager) RefVectorOf<KVStringPair>(32, true, fMemoryManager);
+    fRawAttrList = new (fMemoryManager) RefVectorOf<RawAttr>(32, true, fMemoryManager);
     fRawAttrColonList = (int*) fMemoryManager->allocate
     (
         fRawAttrColonListSize * sizeof(int)
@@ -538,12 +540,13 @@ void IGXMLScanner::commonInit()
     fLocationPairs = new (fMemoryManager) ValueVectorOf<XMLCh*>(8, fMemoryManager);
     // create pools for undeclared elements
     fDTDElemNonDeclPool = new (fMemoryManager) NameIdPool<DTDElementDecl>(29, 128, fMemoryManager);
+    fDTDElemNonDeclStack = new (fMemoryManager) RefVectorOf<DTDElementDecl>(16, true, fMemoryManager);
     fSchemaElemNonDeclPool = new (fMemoryManager) RefHash3KeysIdPool<SchemaElementDecl>(29, true, 128, fMemoryManager);
     fAttDefRegistry = new (fMemoryManager) RefHashTableOf<unsigned int, PtrHasher>
     (
         131, false, fMemoryManager
     );
-    fUndeclaredAttrRegistry = new (fMemoryManager) Hash2KeysSetOf<StringHasher>(7, fMemoryManager);
+    fUndeclaredAttrRegistry = new (fMemoryManager) AttrNameSet(fMemoryManager);
     fPSVIAttrList = new (fMemoryManager) PSVIAttributeList(fMemoryManager);
 
     fSchemaInfoList = new (fMemoryManager) RefHash2KeysTableOf<SchemaInfo>(29, fMemoryManager);
@@ -565,6 +568,7 @@ void IGXMLScanner::cleanUp()
     delete fICHandler;
     delete fLocationPairs;
     delete fDTDElemNonDeclPool;
+    delete fDTDElemNonDeclStack;
     delete fSchemaElemNonDeclPool;
     delete fAttDefRegistry;
     delete fUndeclaredAttrRegistry;
@@ -582,16 +586,16 @@ void IGXMLScanner::cleanUp()
 //  This method is called from scanStartTag() to handle the very raw initial
 //  scan of the attributes. It just fills in the passed collection with
 //  key/value pairs for each attribute. No processing is done on them at all.
+//  The names and values are scanned straight into the elements of the
+//  collection, which are reused from one call to the next.
 XMLSize_t
 IGXMLScanner::rawAttrScan(const   XMLCh* const                elemName
-                          ,       RefVectorOf<KVStringPair>&  toFill
+                          ,       RefVectorOf<RawAttr>&       toFill
                           ,       bool&                       isEmpty)
 {
-    //  Keep up with how many attributes we've seen so far, and how many
-    //  elements are available in the vector. This way we can reuse old
-    //  elements until we run out and then expand it.
+    //  Keep up with how many attributes we've seen so far. We reuse the
+    //  old elements of the vector until we run out and then expand it.
     XMLSize_t attCount = 0;
-    XMLSize_t curVecSize = toFill.size();
 
     // Assume it is not empty
     isEmpty = false;
@@ -631,20 +635,27 @@ IGXMLScanner::rawAttrScan(const   XMLCh* const                elemName
         //  the special case checks.
         if (!fReaderMgr.getCurrentReader()->isSpecialStartTagChar(nextCh))
         {
+            //  Get the element to scan this attribute into. If we have not
+            //  filled the passed collection up yet, then we use the next
+            //  element. Else we add a new one.
+            if (attCount >= toFill.size())
+                toFill.addElement(new (fMemoryManager) RawAttr(fMemoryManager));
+            RawAttr* curAttr = toFill.elementAt(attCount);
+
             //  Assume it's going to be an attribute, so get a name from
             //  the input.
             int colonPosition;
-            if (!fReaderMgr.getQName(fAttNameBuf, &colonPosition))
+            if (!fReaderMgr.getQName(curAttr->fName, &colonPosition))
             {
-                if (fAttNameBuf.isEmpty())
+                if (curAttr->fName.isEmpty())
                     emitError(XMLErrs::ExpectedAttrName);
                 else
-                    emitError(XMLErrs::InvalidAttrName, fAttNameBuf.getRawBuffer());
+                    emitError(XMLErrs::InvalidAttrName, curAttr->fName.getRawBuffer());
                 fReaderMgr.skipPastChar(chCloseAngle);
                 return attCount;
             }
 
-            const XMLCh* curAttNameBuf = fAttNameBuf.getRawBuffer();
+            const XMLCh* curAttNameBuf = curAttr->fName.getRawBuffer();
 
             // And next must be an equal sign
             if (!scanEq())
@@ -688,7 +699,7 @@ IGXMLScanner::rawAttrScan(const   XMLCh* const                elemName
             //  Next should be the quoted attribute value. We just do a simple
             //  and stupid scan of this value. The only thing we do here
             //  is to expand entity references.
-            if (!basicAttrValueScan(curAttNameBuf, fAttValueBuf))
+            if (!basicAttrValueScan(curAttNameBuf, curAttr->fValue))
             {
                 static const XMLCh tmpList[] =
                 {
@@ -722,34 +733,6 @@ IGXMLScanner::rawAttrScan(const   XMLCh* const                elemName
                 }
             }
 
-            //  And now lets add it to the passed collection. If we have not
-            //  filled it up yet, then we use the next element. Else we add
-            //  a new one.
-            KVStringPair* curPair = 0;
-            if (attCount >= curVecSize)
-            {
-                curPair = new (fMemoryManager) KVStringPair
-                (
-                    curAttNameBuf
-                    , fAttNameBuf.getLen()
-                    , fAttValueBuf.getRawBuffer()
-                    , fAttValueBuf.getLen()
-                    , fMemoryManager
-                );
-                toFill.addElement(curPair);
-            }
-             else
-            {
-                curPair = toFill.elementAt(attCount);
-                curPair->set
-                (
-                    curAttNameBuf,
-                    fAttNameBuf.getLen(),
-                    fAttValueBuf.getRawBuffer(),
-                    fAttValueBuf.getLen()
-                );
-            }
-
             if (attCount >= fRawAttrColonListSize) {
                 resizeRawAttrColonList();
             }
@@ -1591,14 +1574,26 @@ bool IGXMLScanner::scanStartTag(bool& gotData)
         // used with or without namespaces, but schemas cannot be used without
         // namespaces.
         wasAdded = true;
-        elemDecl = new (fMemoryManager) DTDElementDecl
-        (
-            rawQName
-            , fEmptyNamespaceId
-            , DTDElementDecl::Any
-            , fMemoryManager
-        );
-        elemDecl->setId(fDTDElemNonDeclPool->put((DTDElementDecl*)elemDecl));
+        if (fValidate)
+        {
+            elemDecl = new (fMemoryManager) DTDElementDecl
+            (
+                rawQName
+                , fEmptyNamespaceId
+                , DTDElementDecl::Any
+                , fMemoryManager
+            );
+            elemDecl->setId(fDTDElemNonDeclPool->put((DTDElementDecl*)elemDecl));
+        }
+        else
+        {
+            elemDecl = getNonDeclElemDecl
+            (
+                rawQName
+                , fEmptyNamespaceId
+                , fElemStack.getLevel()
+            );
+        }
     }
 
     //  We do something different here according to whether we found the
@@ -2383,10 +2378,15 @@ bool IGXMLScanner::scanStartTagNS(bool& gotData)
     if (!elemDecl) {
 
         if (fGrammarType == Grammar::DTDGrammarType) {
-            elemDecl = new (fMemoryManager) DTDElementDecl(
-                qnameRawBuf, uriId, DTDElementDecl::Any, fMemoryManager
-            );
-            elemDecl->setId(fDTDElemNonDeclPool->put((DTDElementDecl*)elemDecl));
+            if (fValidate) {
+                elemDecl = new (fMemoryManager) DTDElementDecl(
+                    qnameRawBuf, uriId, DTDElementDecl::Any, fMemoryManager
+                );
+                elemDecl->setId(fDTDElemNonDeclPool->put((DTDElementDecl*)elemDecl));
+            }
+            else {
+                elemDecl = getNonDeclElemDecl(qnameRawBuf, uriId, elemDepth);
+            }
         }
         else if (fGrammarType == Grammar::SchemaGrammarType)  {
             elemDecl = new (fMemoryManager) SchemaElementDecl(
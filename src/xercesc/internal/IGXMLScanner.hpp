@@ -23,11 +23,9 @@
 #define XERCESC_INCLUDE_GUARD_IGXMLSCANNER_HPP
 
 #include <xercesc/internal/XMLScanner.hpp>
-#include <xercesc/util/KVStringPair.hpp>
 #include <xercesc/util/NameIdPool.hpp>
 #include <xercesc/util/RefHash2KeysTableOf.hpp>
 #include <xercesc/util/RefHash3KeysIdPool.hpp>
-#include <xercesc/util/Hash2KeysSetOf.hpp>
 #include <xercesc/validators/common/Grammar.hpp>
 #include <xercesc/validators/schema/SchemaInfo.hpp>
 #include <xercesc/validators/schema/SchemaElementDecl.hpp>
@@ -120,6 +118,31 @@ private :
     virtual InputSource* resolveSystemId(const XMLCh* const sysId
                                         ,const XMLCh* const pubId);
 
+    // -----------------------------------------------------------------------
+    //  Private class types
+    //
+    //  RawAttr
+    //      The name and value of an attribute, as found by the raw scan of a
+    //      start tag. They are scanned straight into its buffers, which are
+    //      kept for the next start tag, so that nothing is copied or
+    //      allocated to hold them once the buffers are big enough.
+    // -----------------------------------------------------------------------
+    class RawAttr : public XMemory
+    {
+    public :
+        RawAttr(MemoryManager* const manager);
+
+        const XMLCh* getKey() const;
+        const XMLCh* getValue() const;
+
+        XMLBuffer   fName;
+        XMLBuffer   fValue;
+
+    private :
+        RawAttr(const RawAttr&);
+        RawAttr& operator=(const RawAttr&);
+    };
+
     // -----------------------------------------------------------------------
     //  Private helper methods
     // -----------------------------------------------------------------------
@@ -128,7 +151,7 @@ private :
 
     XMLSize_t buildAttList
     (
-        const   RefVectorOf<KVStringPair>&  providedAttrs
+        const   RefVectorOf<RawAttr>&       providedAttrs
         , const XMLSize_t                   attCount
         ,       XMLElementDecl*             elemDecl
         ,       RefVectorOf<XMLAttr>&       toFill
@@ -158,6 +181,12 @@ private :
         , const int             colonPosition
     );
     void scanRawAttrListforNameSpaces(XMLSize_t attCount);
+    XMLElementDecl* getNonDeclElemDecl
+    (
+        const   XMLCh* const    qName
+        , const unsigned int    uriId
+        , const XMLSize_t       depth
+    );
     void parseSchemaLocation(const XMLCh* const schemaLocationStr, bool ignoreLoadSchema = false);
     void resolveSchemaGrammar(const XMLCh* const loc, const XMLCh* const uri, bool ignoreLoadSchema = false);
     bool switchGrammar(const XMLCh* const newGrammarNameSpace);
@@ -184,7 +213,7 @@ private :
     XMLSize_t rawAttrScan
     (
         const   XMLCh* const                elemName
-        ,       RefVectorOf<KVStringPair>&  toFill
+        ,       RefVectorOf<RawAttr>&       toFill
         ,       bool&                       isEmpty
     );
     bool scanAttValue
@@ -222,7 +251,8 @@ private :
     //  fRawAttrList
     //      During the initial scan of the attributes we can only do a raw
     //      scan for key/value pairs. So this vector is used to store them
-    //      until they can be processed (and put into fAttrList.)
+    //      until they can be processed (and put into fAttrList.) Its
+    //      elements are reused from one start tag to the next.
     //
     //  fDTDValidator
     //      The DTD validator instance.
@@ -241,6 +271,10 @@ private :
     //
     // fDTDElemNonDeclPool
     //      registry of "faulted-in" DTD element decls
+    // fDTDElemNonDeclStack
+    //      decls for undeclared DTD elements when not validating, one per
+    //      element depth. They are renamed for each element that uses them
+    //      and are kept from one document to the next.
     // fSchemaElemNonDeclPool
     //      registry for elements without decls in the grammar
     // fElemCount
@@ -266,7 +300,7 @@ private :
     unsigned int*                           fElemState;
     unsigned int*                           fElemLoopState;
     XMLBuffer                               fContent;
-    RefVectorOf<KVStringPair>*              fRawAttrList;
+    RefVectorOf<RawAttr>*                   fRawAttrList;
     unsigned int                            fRawAttrColonListSize;
     int*                                    fRawAttrColonList;
     DTDValidator*                           fDTDValidator;
@@ -275,10 +309,11 @@ private :
     IdentityConstraintHandler*              fICHandler;
     ValueVectorOf<XMLCh*>*                  fLocationPairs;
     NameIdPool<DTDElementDecl>*             fDTDElemNonDeclPool;
+    RefVectorOf<DTDElementDecl>*            fDTDElemNonDeclStack;
     RefHash3KeysIdPool<SchemaElementDecl>*  fSchemaElemNonDeclPool;
     unsigned int                            fElemCount;
     RefHashTableOf<unsigned int, PtrHasher>*fAttDefRegistry;
-    Hash2KeysSetOf<StringHasher>*           fUndeclaredAttrRegistry;
+    AttrNameSet*                            fUndeclaredAttrRegistry;
     PSVIAttributeList *                     fPSVIAttrList;
     XSModel*                                fModel;
     PSVIElement*                            fPSVIElement;
@@ -288,6 +323,25 @@ private :
     RefHash2KeysTableOf<SchemaInfo>*        fCachedSchemaInfoList;
 };
 
+// ---------------------------------------------------------------------------
+//  IGXMLScanner::RawAttr: Constructors and getter methods
+// ---------------------------------------------------------------------------
+inline IGXMLScanner::RawAttr::RawAttr(MemoryManager* const manager) :
+    fName(63, manager)
+    , fValue(63, manager)
+{
+}
+
+inline const XMLCh* IGXMLScanner::RawAttr::getKey() const
+{
+    return fName.getRawBuffer();
+}
+
+inline const XMLCh* IGXMLScanner::RawAttr::getValue() const
+{
+    return fValue.getRawBuffer();
+}
+
 inline const XMLCh* IGXMLScanner::getName() const
 {
     return XMLUni::fgIGXMLScanner;
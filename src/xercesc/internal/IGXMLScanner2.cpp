@@ -73,7 +73,7 @@ inline XMLAttDefList& getAttDefList(bool              isSchemaGrammar
 //  which we will get any defaulted or fixed attribute defs and add those
 //  in as well.
 XMLSize_t
-IGXMLScanner::buildAttList(const  RefVectorOf<KVStringPair>&  providedAttrs
+IGXMLScanner::buildAttList(const  RefVectorOf<RawAttr>&       providedAttrs
                           , const XMLSize_t                   attCount
                           ,       XMLElementDecl*             elemDecl
                           ,       RefVectorOf<XMLAttr>&       toFill)
@@ -119,14 +119,8 @@ IGXMLScanner::buildAttList(const  RefVectorOf<KVStringPair>&  providedAttrs
     XMLBufBid bbNormal(&fBufMgr);
     XMLBuffer& normBuf = bbNormal.getBuffer();
 
-    //
-    // Decide if to use hash table to do duplicate checking
-    //
-    bool toUseHashTable = false;
-    if (fGrammarType == Grammar::DTDGrammarType)
-    {
-        setAttrDupChkRegistry(attCount, toUseHashTable);
-    }
+    // Start afresh on the names used to check for duplicate attributes
+    fAttrDupChkRegistry->removeAll();
 
     XMLBufBid bbPrefix(&fBufMgr);
     XMLBuffer& prefixBuf = bbPrefix.getBuffer();
@@ -139,7 +133,7 @@ IGXMLScanner::buildAttList(const  RefVectorOf<KVStringPair>&  providedAttrs
     {
         PSVIItem::VALIDITY_STATE attrValid = PSVIItem::VALIDITY_VALID;
         PSVIItem::ASSESSMENT_TYPE attrAssessed = PSVIItem::VALIDATION_FULL;
-        const KVStringPair* curPair = providedAttrs.elementAt(index);
+        const RawAttr* curPair = providedAttrs.elementAt(index);
 
         //  We have to split the name into its prefix and name parts. Then
         //  we map the prefix to its URI.
@@ -695,33 +689,14 @@ IGXMLScanner::buildAttList(const  RefVectorOf<KVStringPair>&  providedAttrs
         // by checking for qualified names with the same local part and with prefixes
         // which have been bound to namespace names that are identical.
         if (fGrammarType == Grammar::DTDGrammarType) {
-            if (!toUseHashTable)
+            if (!fAttrDupChkRegistry->putIfNotPresent(suffPtr, uriId))
             {
-                for (XMLSize_t attrIndex=0; attrIndex < retCount; attrIndex++) {
-                    curAttr = toFill.elementAt(attrIndex);
-                    if (uriId == curAttr->getURIId() &&
-                        XMLString::equals(suffPtr, curAttr->getName())) {
-                        emitError
-                        (
-
-                         XMLErrs::AttrAlreadyUsedInSTag
-                        , curAttr->getName()
-                        , elemDecl->getFullName()
-                        );
-                    }
-                }
-            }
-            else
-            {
-                if (fAttrDupChkRegistry->containsKey((void*)suffPtr, uriId))
-                {
-                    emitError
-                        (
-                        XMLErrs::AttrAlreadyUsedInSTag
-                        , suffPtr
-                        , elemDecl->getFullName()
-                        );
-                }
+                emitError
+                (
+                    XMLErrs::AttrAlreadyUsedInSTag
+                    , suffPtr
+                    , elemDecl->getFullName()
+                );
             }
         }
 
@@ -753,11 +728,6 @@ IGXMLScanner::buildAttList(const  RefVectorOf<KVStringPair>&  providedAttrs
             curAttr->setSpecified(true);
         }
 
-        if (toUseHashTable)
-        {
-            fAttrDupChkRegistry->put((void*)suffPtr, uriId, curAttr);
-        }
-
         if(psviAttr)
             psviAttr->setValue(curAttr->getValue());
 
@@ -1250,6 +1220,7 @@ void IGXMLScanner::scanReset(const InputSource& src)
 
     // Reset some status flags
     fInException = false;
+    fSkipLevel = 0;
     fStandalone = false;
     fErrorCount = 0;
     fHasNoDTD = true;
@@ -1593,6 +1564,29 @@ void IGXMLScanner::updateNSMap(const  XMLCh* const    attrName
     );
 }
 
+//  When we are not validating, an element that is not declared in the DTD
+//  needs a decl only to carry its name to the element stack and the
+//  handlers, neither of which holds on to it once the element ends. So
+//  rather than fault a new decl into the pool for each distinct name, all
+//  of the elements at a given depth share one decl, which is just renamed.
+XMLElementDecl* IGXMLScanner::getNonDeclElemDecl(const  XMLCh* const    qName
+                                                , const unsigned int    uriId
+                                                , const XMLSize_t       depth)
+{
+    // The elements above this one may have been declared, so fill in to here
+    while (fDTDElemNonDeclStack->size() <= depth)
+    {
+        fDTDElemNonDeclStack->addElement
+        (
+            new (fMemoryManager) DTDElementDecl(fMemoryManager)
+        );
+    }
+
+    DTDElementDecl* elemDecl = fDTDElemNonDeclStack->elementAt(depth);
+    elemDecl->setElementName(qName, uriId);
+    return elemDecl;
+}
+
 void IGXMLScanner::scanRawAttrListforNameSpaces(XMLSize_t attCount)
 {
     //  Make an initial pass through the list and find any xmlns attributes or
@@ -1602,7 +1596,7 @@ void IGXMLScanner::scanRawAttrListforNameSpaces(XMLSize_t attCount)
     for (XMLSize_t index = 0; index < attCount; index++)
     {
         // each attribute has the prefix:suffix="value"
-        const KVStringPair* curPair = fRawAttrList->elementAt(index);
+        const RawAttr* curPair = fRawAttrList->elementAt(index);
         const XMLCh* rawPtr = curPair->getKey();
 
         //  If either the key begins with "xmlns:" or its just plain
@@ -1627,7 +1621,7 @@ void IGXMLScanner::scanRawAttrListforNameSpaces(XMLSize_t attCount)
         for (XMLSize_t index = 0; index < attCount; index++)
         {
             // each attribute has the prefix:suffix="value"
-            const KVStringPair* curPair = fRawAttrList->elementAt(index);
+            const RawAttr* curPair = fRawAttrList->elementAt(index);
             const XMLCh* rawPtr = curPair->getKey();
             const XMLCh* prefPtr = XMLUni::fgZeroLenString;
             int   colonInd = fRawAttrColonList[index];
@@ -1656,7 +1650,7 @@ void IGXMLScanner::scanRawAttrListforNameSpaces(XMLSize_t attCount)
         // loaded (JIRA XERCESC-1937)
         for (XMLSize_t index = 0; index < attCount; index++)
         {
-            const KVStringPair* curPair = fRawAttrList->elementAt(index);
+            const RawAttr* curPair = fRawAttrList->elementAt(index);
             const XMLCh* rawPtr = curPair->getKey();
             const XMLCh* prefPtr = XMLUni::fgZeroLenString;
             int   colonInd = fRawAttrColonList[index];
@@ -0,0 +1,118 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+  * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#include <xercesc/internal/NSXMLScanner.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+// ---------------------------------------------------------------------------
+//  NSXMLScanner: Constructors and Destructor
+// ---------------------------------------------------------------------------
+NSXMLScanner::NSXMLScanner( XMLValidator* const  valToAdopt
+                          , GrammarResolver* const grammarResolver
+                          , MemoryManager* const manager) :
+
+    WFXMLScanner(valToAdopt, grammarResolver, manager)
+    , fElemPrefixIds(0)
+{
+    // Duplicate attributes are found once their prefixes are mapped
+    fCheckAttrQNames = false;
+    fElemPrefixIds = new (fMemoryManager) ValueVectorOf<unsigned int>(32, fMemoryManager);
+}
+
+NSXMLScanner::NSXMLScanner( XMLDocumentHandler* const docHandler
+                          , DocTypeHandler* const     docTypeHandler
+                          , XMLEntityHandler* const   entityHandler
+                          , XMLErrorReporter* const   errHandler
+                          , XMLValidator* const       valToAdopt
+                          , GrammarResolver* const    grammarResolver
+                          , MemoryManager* const      manager) :
+
+    WFXMLScanner(docHandler, docTypeHandler, entityHandler, errHandler, valToAdopt, grammarResolver, manager)
+    , fElemPrefixIds(0)
+{
+    fCheckAttrQNames = false;
+    fElemPrefixIds = new (fMemoryManager) ValueVectorOf<unsigned int>(32, fMemoryManager);
+}
+
+NSXMLScanner::~NSXMLScanner()
+{
+    delete fElemPrefixIds;
+}
+
+
+// ---------------------------------------------------------------------------
+//  NSXMLScanner: XMLScanner virtual methods
+// ---------------------------------------------------------------------------
+void NSXMLScanner::scanReset(const InputSource& src)
+{
+    // This scanner always does namespaces
+    fDoNamespaces = true;
+
+    WFXMLScanner::scanReset(src);
+}
+
+
+// ---------------------------------------------------------------------------
+//  NSXMLScanner: WFXMLScanner virtual methods
+// ---------------------------------------------------------------------------
+
+//  This does what resolvePrefix() does for an element's prefix, but maps
+//  the prefix by the id cached for the decl's depth. Until the prefix is
+//  in the prefix pool it is not bound, so it goes the long way around,
+//  which reports the error.
+unsigned int NSXMLScanner::resolveElemPrefix(const  XMLElementDecl* const   elemDecl
+                                             , const XMLSize_t               elemDepth
+                                             , const bool                    newName)
+{
+    while (fElemPrefixIds->size() <= elemDepth)
+        fElemPrefixIds->addElement(0);
+
+    const XMLCh* prefix = elemDecl->getElementName()->getPrefix();
+    unsigned int& prefixId = fElemPrefixIds->elementAt(elemDepth);
+    if (newName || !prefixId)
+    {
+        prefixId = fElemStack.getPrefixId(prefix);
+        if (!prefixId)
+            return resolvePrefix(prefix, ElemStack::Mode_Element);
+    }
+
+    bool unknown;
+    const unsigned int uriId = fElemStack.mapPrefixIdToURI(prefixId, unknown);
+
+    // If it was unknown, then the URI was faked in but we have to issue an error
+    if (unknown)
+        emitError(XMLErrs::UnknownPrefix, prefix);
+
+    // In XML 1.1 an empty namespace is okay unless we are trying to use it
+    if (*prefix &&
+        fXMLVersion != XMLReader::XMLV1_0 &&
+        uriId == fEmptyNamespaceId)
+        emitError(XMLErrs::UnknownPrefix, prefix);
+
+    return uriId;
+}
+
+XERCES_CPP_NAMESPACE_END
@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_NSXMLSCANNER_HPP)
+#define XERCESC_INCLUDE_GUARD_NSXMLSCANNER_HPP
+
+#include <xercesc/internal/WFXMLScanner.hpp>
+#include <xercesc/util/ValueVectorOf.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+
+//  This is a non-validating, namespace-aware scanner. It is a WFXMLScanner
+//  that always does namespaces, whatever the parser's setting, and only
+//  changes how start tags are mapped. The element decl for each depth
+//  remembers the id of its prefix, so a start tag with the same name as the
+//  last one at its depth has its URI mapped without hashing the prefix, and
+//  duplicate attributes are only checked once their prefixes are mapped.
+class XMLPARSER_EXPORT NSXMLScanner : public WFXMLScanner
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    NSXMLScanner
+    (
+        XMLValidator* const       valToAdopt
+        , GrammarResolver* const  grammarResolver
+        , MemoryManager* const    manager = XMLPlatformUtils::fgMemoryManager
+    );
+    NSXMLScanner
+    (
+        XMLDocumentHandler* const docHandler
+        , DocTypeHandler* const   docTypeHandler
+        , XMLEntityHandler* const entityHandler
+        , XMLErrorReporter* const errReporter
+        , XMLValidator* const     valToAdopt
+        , GrammarResolver* const  grammarResolver
+        , MemoryManager* const    manager = XMLPlatformUtils::fgMemoryManager
+    );
+    virtual ~NSXMLScanner();
+
+    // -----------------------------------------------------------------------
+    //  XMLScanner public virtual methods
+    // -----------------------------------------------------------------------
+    virtual const XMLCh* getName() const;
+
+protected :
+    // -----------------------------------------------------------------------
+    //  XMLScanner virtual methods
+    // -----------------------------------------------------------------------
+    virtual void scanReset(const InputSource& src);
+
+    // -----------------------------------------------------------------------
+    //  WFXMLScanner virtual methods
+    // -----------------------------------------------------------------------
+    virtual unsigned int resolveElemPrefix
+    (
+        const   XMLElementDecl* const   elemDecl
+        , const XMLSize_t               elemDepth
+        , const bool                    newName
+    );
+
+private :
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    NSXMLScanner();
+    NSXMLScanner(const NSXMLScanner&);
+    NSXMLScanner& operator=(const NSXMLScanner&);
+
+    // -----------------------------------------------------------------------
+    //  Data members
+    //
+    //  fElemPrefixIds
+    //      The prefix pool id of the prefix of the element decl for each
+    //      depth. It is zero until the prefix is first mapped, and again
+    //      whenever the decl is renamed.
+    // -----------------------------------------------------------------------
+    ValueVectorOf<unsigned int>*       fElemPrefixIds;
+};
+
+inline const XMLCh* NSXMLScanner::getName() const
+{
+    return XMLUni::fgNSXMLScanner;
+}
+
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
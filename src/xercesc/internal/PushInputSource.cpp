@@ -0,0 +1,654 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#include <xercesc/internal/PushInputSource.hpp>
+#include <xercesc/internal/ReaderMgr.hpp>
+#include <xercesc/internal/XMLScanner.hpp>
+#include <xercesc/framework/XMLRecognizer.hpp>
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+// ---------------------------------------------------------------------------
+//  Local static data
+// ---------------------------------------------------------------------------
+static const XMLSize_t  gInitBufSize = 4096;
+
+//
+//  The markup declaration openers that we have to tell apart after a '<!'.
+//  Anything else is lexed up to the next '>'.
+//
+static const char       gCommentOpen[] = "<!--";
+static const char       gCDataOpen[] = "<![CDATA[";
+static const char       gDocTypeOpen[] = "<!DOCTYPE";
+
+
+// ---------------------------------------------------------------------------
+//  Local helper methods
+// ---------------------------------------------------------------------------
+static inline bool isXMLSpace(const XMLByte toCheck)
+{
+    return (toCheck == 0x20) || (toCheck == 0x09)
+        || (toCheck == 0x0A) || (toCheck == 0x0D);
+}
+
+
+// ---------------------------------------------------------------------------
+//  The stream that the main entity's reader pulls the pushed bytes through.
+//  It just hands on whatever its source has that the reader hasn't seen.
+// ---------------------------------------------------------------------------
+class PushBinInputStream : public BinInputStream
+{
+public :
+    PushBinInputStream(PushInputSource* const source) :
+
+        fSource(source)
+    {
+    }
+
+    ~PushBinInputStream()
+    {
+    }
+
+    XMLFilePos curPos() const
+    {
+        return fSource->getReadPos();
+    }
+
+    XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead)
+    {
+        return fSource->readBytes(toFill, maxToRead);
+    }
+
+    const XMLCh* getContentType() const
+    {
+        return 0;
+    }
+
+private :
+    PushBinInputStream(const PushBinInputStream&);
+    PushBinInputStream& operator=(const PushBinInputStream&);
+
+    PushInputSource* fSource;
+};
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Constructors and Destructor
+// ---------------------------------------------------------------------------
+PushInputSource::PushInputSource(MemoryManager* const manager) :
+
+    InputSource(XMLUni::fgZeroLenString, manager)
+    , fBuffer(0)
+    , fBufSize(0)
+    , fBufLen(0)
+    , fBufBase(0)
+    , fReadPos(0)
+    , fTokenStart(0)
+    , fScanPos(0)
+    , fTokenType(Token_None)
+    , fQuote(0)
+    , fSafeEnd(0)
+    , fBOMLen(0)
+    , fDepth(0)
+    , fEncodingSensed(false)
+    , fIncremental(false)
+    , fRootSeen(false)
+    , fStopped(false)
+    , fEndOfInput(false)
+    , fScanState(Scan_Prolog)
+    , fScanToken()
+    , fCalculateSrcOfs(false)
+{
+}
+
+PushInputSource::~PushInputSource()
+{
+    getMemoryManager()->deallocate(fBuffer);
+}
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Virtual input source interface
+// ---------------------------------------------------------------------------
+BinInputStream* PushInputSource::makeStream() const
+{
+    //
+    //  The stream reads from our buffer, which the parser keeps filling
+    //  while the reader that owns the stream is alive.
+    //
+    return new (getMemoryManager()) PushBinInputStream(const_cast<PushInputSource*>(this));
+}
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Push methods
+// ---------------------------------------------------------------------------
+void PushInputSource::appendBytes(const XMLByte* const bytes, const XMLSize_t count)
+{
+    // If the scan already ended on an error, then there's no point
+    if (fScanState == Scan_Done)
+        return;
+
+    //
+    //  Drop the bytes that both the reader and the lexer are done with.
+    //  That leaves the incomplete token at the end, plus anything that
+    //  the reader has not pulled in yet.
+    //
+    const XMLFilePos keepFrom = (fReadPos < fTokenStart) ? fReadPos : fTokenStart;
+    if (keepFrom > fBufBase)
+    {
+        const XMLSize_t dropCount = (XMLSize_t)(keepFrom - fBufBase);
+        fBufLen -= dropCount;
+        memmove(fBuffer, fBuffer + dropCount, fBufLen);
+        fBufBase = keepFrom;
+    }
+
+    if (fBufLen + count > fBufSize)
+    {
+        XMLSize_t newSize = fBufSize ? fBufSize * 2 : gInitBufSize;
+        while (newSize < fBufLen + count)
+            newSize *= 2;
+
+        XMLByte* newBuffer = (XMLByte*) getMemoryManager()->allocate
+        (
+            newSize * sizeof(XMLByte)
+        );
+        if (fBufLen)
+            memcpy(newBuffer, fBuffer, fBufLen);
+        getMemoryManager()->deallocate(fBuffer);
+        fBuffer = newBuffer;
+        fBufSize = newSize;
+    }
+
+    if (count)
+    {
+        memcpy(fBuffer + fBufLen, bytes, count);
+        fBufLen += count;
+    }
+
+    scanTokens();
+}
+
+void PushInputSource::setEndOfInput()
+{
+    fEndOfInput = true;
+}
+
+//
+//  Scans as far as the bytes we have allow. It starts the scan once the
+//  root element's start tag is here, since the scanner does the whole prolog
+//  in one go, and then takes a token at a time while each next token is
+//  complete. Once the end of input is set it goes on to the end.
+//
+void PushInputSource::scanAvailable(XMLScanner* const scanner)
+{
+    if (fScanState == Scan_Prolog)
+    {
+        if (!fEndOfInput && !fRootSeen)
+            return;
+
+        fCalculateSrcOfs = scanner->getCalculateSrcOfs();
+        scanner->setCalculateSrcOfs(true);
+
+        //
+        //  Until scanFirst() hands back a good token, there is nothing for
+        //  endScan() to reset if it fails or throws.
+        //
+        fScanState = Scan_Done;
+        if (!scanner->scanFirst(*this, fScanToken))
+            return;
+        fScanState = Scan_Content;
+    }
+
+    while ((fScanState == Scan_Content) && isReadyForNext(scanner))
+    {
+        if (!scanner->scanNext(fScanToken))
+            fScanState = Scan_Done;
+    }
+}
+
+//
+//  Puts the scanner back the way we found it. If the scan is still going,
+//  the reader that is reading from us has to be dropped now.
+//
+void PushInputSource::endScan(XMLScanner* const scanner)
+{
+    if (fScanState == Scan_Prolog)
+        return;
+
+    if (fScanState == Scan_Content)
+        scanner->scanReset(fScanToken);
+
+    scanner->setCalculateSrcOfs(fCalculateSrcOfs);
+    fScanState = Scan_Done;
+}
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Stream methods
+// ---------------------------------------------------------------------------
+XMLSize_t PushInputSource::readBytes(       XMLByte* const  toFill
+                                    , const XMLSize_t       maxToRead)
+{
+    const XMLSize_t bytesLeft = (XMLSize_t)(fBufBase + fBufLen - fReadPos);
+    const XMLSize_t count = (maxToRead < bytesLeft) ? maxToRead : bytesLeft;
+
+    if (count)
+    {
+        memcpy(toFill, fBuffer + (XMLSize_t)(fReadPos - fBufBase), count);
+        fReadPos += count;
+    }
+    return count;
+}
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Private helper methods
+// ---------------------------------------------------------------------------
+
+//
+//  Looks for the passed ASCII string at or after the passed offset. If it is
+//  found, offset is set to just past it.
+//
+bool PushInputSource::findString(const  char* const     toFind
+                                , const XMLSize_t       length
+                                , const XMLFilePos      from
+                                ,       XMLFilePos&     offset) const
+{
+    const XMLFilePos bufEnd = fBufBase + fBufLen;
+    if (from + length > bufEnd)
+        return false;
+
+    const XMLByte* curPtr = fBuffer + (XMLSize_t)(from - fBufBase);
+    const XMLByte* const lastPtr = fBuffer + fBufLen - length;
+    while (curPtr <= lastPtr)
+    {
+        curPtr = (const XMLByte*)memchr(curPtr, toFind[0], lastPtr - curPtr + 1);
+        if (!curPtr)
+            return false;
+
+        if (!memcmp(curPtr, toFind, length))
+        {
+            offset = fBufBase + (curPtr - fBuffer) + length;
+            return true;
+        }
+        curPtr++;
+    }
+    return false;
+}
+
+//
+//  Looks for the terminator of the current token from where we left off
+//  last time. If its not there, then we remember where to start next time,
+//  backing up enough to catch a terminator that is split across chunks.
+//
+bool PushInputSource::findTerminator(const  char* const     toFind
+                                    , const XMLSize_t       length
+                                    ,       XMLFilePos&     offset)
+{
+    if (findString(toFind, length, fScanPos, offset))
+        return true;
+
+    const XMLFilePos bufEnd = fBufBase + fBufLen;
+    if (bufEnd >= fScanPos + length)
+        fScanPos = bufEnd - (length - 1);
+    return false;
+}
+
+//
+//  The DOCTYPE is the one token whose end depends on what is inside it,
+//  since the internal subset can hold quoted literals, comments and PIs
+//  that contain '>' and ']'. It only shows up once, so we just look at it
+//  from the start each time.
+//
+bool PushInputSource::findDocTypeEnd(XMLFilePos& offset) const
+{
+    const XMLFilePos bufEnd = fBufBase + fBufLen;
+
+    bool inSubset = false;
+    XMLByte quote = 0;
+    XMLFilePos curPos = fTokenStart + (sizeof(gDocTypeOpen) - 1);
+    while (curPos < bufEnd)
+    {
+        const XMLByte curByte = byteAt(curPos);
+
+        if (quote)
+        {
+            if (curByte == quote)
+                quote = 0;
+        }
+         else if ((curByte == chDoubleQuote) || (curByte == chSingleQuote))
+        {
+            quote = curByte;
+        }
+         else if (inSubset)
+        {
+            if (curByte == chCloseSquare)
+            {
+                inSubset = false;
+            }
+             else if (curByte == chOpenAngle)
+            {
+                if (curPos + 4 > bufEnd)
+                    return false;
+
+                XMLFilePos endPos;
+                if (byteAt(curPos + 1) == chQuestion)
+                {
+                    if (!findString("?>", 2, curPos + 2, endPos))
+                        return false;
+                    curPos = endPos;
+                    continue;
+                }
+
+                if (!memcmp(fBuffer + (XMLSize_t)(curPos - fBufBase), gCommentOpen, 4))
+                {
+                    if (!findString("-->", 3, curPos + 4, endPos))
+                        return false;
+                    curPos = endPos;
+                    continue;
+                }
+            }
+        }
+         else if (curByte == chOpenSquare)
+        {
+            inSubset = true;
+        }
+         else if (curByte == chCloseAngle)
+        {
+            offset = curPos + 1;
+            return true;
+        }
+        curPos++;
+    }
+    return false;
+}
+
+//
+//  Looks for the end of the current token. isEmpty is set for start tags
+//  which end with '/>'.
+//
+bool PushInputSource::findTokenEnd(XMLFilePos& offset, bool& isEmpty)
+{
+    const XMLFilePos bufEnd = fBufBase + fBufLen;
+
+    switch(fTokenType)
+    {
+        case Token_Space :
+            for (; fScanPos < bufEnd; fScanPos++)
+            {
+                if (!isXMLSpace(byteAt(fScanPos)))
+                {
+                    offset = fScanPos;
+                    return true;
+                }
+            }
+            return false;
+
+        case Token_CharData :
+        {
+            // This ends at, but does not include, the next markup
+            if (!findTerminator("<", 1, offset))
+                return false;
+            offset--;
+            return true;
+        }
+
+        case Token_PI :
+            return findTerminator("?>", 2, offset);
+
+        case Token_Comment :
+            return findTerminator("-->", 3, offset);
+
+        case Token_CData :
+            return findTerminator("]]>", 3, offset);
+
+        case Token_DocType :
+            return findDocTypeEnd(offset);
+
+        case Token_Decl :
+        case Token_EndTag :
+            return findTerminator(">", 1, offset);
+
+        case Token_StartTag :
+            for (; fScanPos < bufEnd; fScanPos++)
+            {
+                const XMLByte curByte = byteAt(fScanPos);
+                if (fQuote)
+                {
+                    if (curByte == fQuote)
+                        fQuote = 0;
+                }
+                 else if ((curByte == chDoubleQuote) || (curByte == chSingleQuote))
+                {
+                    fQuote = curByte;
+                }
+                 else if (curByte == chCloseAngle)
+                {
+                    isEmpty = (byteAt(fScanPos - 1) == chForwardSlash);
+                    offset = fScanPos + 1;
+                    return true;
+                }
+            }
+            return false;
+
+        default :
+            break;
+    }
+    return false;
+}
+
+//
+//  The scanner can take the next token as long as the main entity's reader
+//  is before the end of the last complete token. If the scanner is inside
+//  an entity then the main entity's reader has not moved, but the entity
+//  can end at any point and leave the scanner in the main entity, so that
+//  still holds.
+//
+bool PushInputSource::isReadyForNext(const XMLScanner* const scanner) const
+{
+    // Once there is no more input, the scanner can see the real end
+    if (fEndOfInput)
+        return true;
+
+    const XMLReader* primary = scanner->getReaderMgr()->getPrimaryReader();
+    if (!primary || !primary->getSrcOfsSupported())
+        return false;
+
+    return (fBOMLen + primary->getSrcOffset() < fSafeEnd);
+}
+
+//
+//  Works out what sort of token starts at fTokenStart. Returns false if
+//  there aren't enough bytes yet to tell, or if we've hit something that
+//  the scanner will not get past before the end of input.
+//
+bool PushInputSource::senseToken()
+{
+    const XMLFilePos bufEnd = fBufBase + fBufLen;
+    if (fTokenStart >= bufEnd)
+        return false;
+
+    const XMLByte firstByte = byteAt(fTokenStart);
+    if (firstByte != chOpenAngle)
+    {
+        if (fRootSeen)
+        {
+            fTokenType = Token_CharData;
+        }
+         else if (isXMLSpace(firstByte))
+        {
+            fTokenType = Token_Space;
+        }
+         else
+        {
+            // Its not well formed, so leave it to the scanner at the end
+            fStopped = true;
+            return false;
+        }
+        fScanPos = fTokenStart + 1;
+        return true;
+    }
+
+    if (fTokenStart + 1 >= bufEnd)
+        return false;
+
+    const XMLByte secondByte = byteAt(fTokenStart + 1);
+    if (secondByte == chQuestion)
+    {
+        fTokenType = Token_PI;
+        fScanPos = fTokenStart + 2;
+    }
+     else if (secondByte == chForwardSlash)
+    {
+        fTokenType = Token_EndTag;
+        fScanPos = fTokenStart + 2;
+    }
+     else if (secondByte == chBang)
+    {
+        //
+        //  See if we have one of the declarations we have to look into.
+        //  If what we have so far could still be one of them, then wait
+        //  for more.
+        //
+        static const char* const openers[] =
+        {
+            gCommentOpen, gCDataOpen, gDocTypeOpen
+        };
+        static const TokenTypes openerTypes[] =
+        {
+            Token_Comment, Token_CData, Token_DocType
+        };
+
+        const XMLSize_t bytesAvail = (XMLSize_t)(bufEnd - fTokenStart);
+        const XMLByte* const tokenPtr = fBuffer + (XMLSize_t)(fTokenStart - fBufBase);
+
+        TokenTypes tokenType = Token_Decl;
+        XMLSize_t openLen = 2;
+        for (unsigned int index = 0; index < 3; index++)
+        {
+            const XMLSize_t curLen = strlen(openers[index]);
+            if (bytesAvail < curLen)
+            {
+                if (!memcmp(tokenPtr, openers[index], bytesAvail))
+                    return false;
+            }
+             else if (!memcmp(tokenPtr, openers[index], curLen))
+            {
+                tokenType = openerTypes[index];
+                openLen = curLen;
+                break;
+            }
+        }
+        fTokenType = tokenType;
+        fScanPos = fTokenStart + openLen;
+    }
+     else
+    {
+        fTokenType = Token_StartTag;
+        fScanPos = fTokenStart + 1;
+        fQuote = 0;
+    }
+    return true;
+}
+
+//
+//  Moves the lexer over any tokens that have been completed by the bytes
+//  that just came in.
+//
+void PushInputSource::scanTokens()
+{
+    if (!fEncodingSensed)
+    {
+        //
+        //  We need enough bytes to see UTF-16 and UCS-4, which we can't lex.
+        //  The probe only recognizes them without a BOM if it can see the
+        //  whole of the encoded '<?xml ' prefix, so wait for the longest one.
+        //  If the end of input comes first, the scanner just deals with
+        //  what is there at that point.
+        //
+        if (fBufLen < XMLRecognizer::fgUCS4PreLen)
+            return;
+
+        fEncodingSensed = true;
+        const XMLRecognizer::Encodings encoding =
+            XMLRecognizer::basicEncodingProbe(fBuffer, fBufLen);
+        fIncremental = (encoding == XMLRecognizer::UTF_8)
+                    || (encoding == XMLRecognizer::US_ASCII);
+
+        if (!memcmp(fBuffer, XMLRecognizer::fgUTF8BOM, XMLRecognizer::fgUTF8BOMLen))
+            fBOMLen = XMLRecognizer::fgUTF8BOMLen;
+
+        fTokenStart = fBOMLen;
+        fSafeEnd = fBOMLen;
+    }
+
+    if (!fIncremental)
+        return;
+
+    while (!fStopped)
+    {
+        if ((fTokenType == Token_None) && !senseToken())
+            return;
+
+        XMLFilePos tokenEnd = 0;
+        bool isEmpty = false;
+        if (!findTokenEnd(tokenEnd, isEmpty))
+            return;
+
+        if (fTokenType == Token_StartTag)
+        {
+            fRootSeen = true;
+            if (!isEmpty)
+                fDepth++;
+            else if (!fDepth)
+                fStopped = true;
+        }
+         else if (fTokenType == Token_EndTag)
+        {
+            if (fDepth <= 1)
+                fStopped = true;
+            else
+                fDepth--;
+        }
+
+        //
+        //  If that ended the root element, then the scanner will go on to
+        //  the end of input, so that token has to wait for finish().
+        //
+        if (fStopped)
+            return;
+
+        fTokenStart = tokenEnd;
+        fSafeEnd = tokenEnd;
+        fTokenType = Token_None;
+    }
+}
+
+XERCES_CPP_NAMESPACE_END
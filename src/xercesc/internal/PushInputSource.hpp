@@ -0,0 +1,253 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_PUSHINPUTSOURCE_HPP)
+#define XERCESC_INCLUDE_GUARD_PUSHINPUTSOURCE_HPP
+
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/framework/XMLPScanToken.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+class BinInputStream;
+class XMLScanner;
+
+//
+//  This class is the input source behind the push parsing methods of the
+//  parsers (feed() and finish().) The application hands it the document a
+//  chunk at a time and the scanner reads those bytes through the stream
+//  that makeStream() returns.
+//
+//  The scanner is a recursive descent parser that cannot be suspended in
+//  the middle of a token, and its readers take a stream that returns no
+//  bytes as the end of the entity. So this class runs a small lexer over
+//  the raw bytes as they arrive, which finds the end of the last complete
+//  markup or character data token. The parser only asks the scanner for
+//  the next token when the main entity's reader is positioned before that
+//  point, so the scanner never runs out of bytes before finish() is called.
+//  It drives the scanner through the progressive scan methods, so that the
+//  parsers only have to hand it the scanner. Only the bytes of the incomplete
+//  token at the end (and any that the reader has not pulled in yet) are kept.
+//
+//  The lexer works on the bytes themselves, so this is only done when the
+//  document is in an encoding in which the markup characters are single
+//  ASCII bytes (which is what we sense for US-ASCII, UTF-8 and the 8 bit
+//  and multi-byte encodings which are supersets of ASCII.) For UTF-16,
+//  UCS-4 and EBCDIC documents, all of the input is held until finish().
+//
+class XMLPARSER_EXPORT PushInputSource : public InputSource
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    PushInputSource(MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
+    ~PushInputSource();
+
+
+    // -----------------------------------------------------------------------
+    //  Virtual input source interface
+    // -----------------------------------------------------------------------
+    BinInputStream* makeStream() const;
+
+
+    // -----------------------------------------------------------------------
+    //  Push methods
+    // -----------------------------------------------------------------------
+    void appendBytes
+    (
+        const   XMLByte* const  bytes
+        , const XMLSize_t       count
+    );
+    void setEndOfInput();
+    void scanAvailable(XMLScanner* const scanner);
+    void endScan(XMLScanner* const scanner);
+
+
+    // -----------------------------------------------------------------------
+    //  Stream methods
+    // -----------------------------------------------------------------------
+    XMLFilePos getReadPos() const;
+    XMLSize_t readBytes
+    (
+                XMLByte* const  toFill
+        , const XMLSize_t       maxToRead
+    );
+
+
+private :
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    PushInputSource(const PushInputSource&);
+    PushInputSource& operator=(const PushInputSource&);
+
+
+    // -----------------------------------------------------------------------
+    //  Private class types
+    // -----------------------------------------------------------------------
+    enum ScanStates
+    {
+        Scan_Prolog
+        , Scan_Content
+        , Scan_Done
+    };
+
+    enum TokenTypes
+    {
+        Token_None
+        , Token_Space
+        , Token_CharData
+        , Token_PI
+        , Token_Comment
+        , Token_CData
+        , Token_DocType
+        , Token_Decl
+        , Token_EndTag
+        , Token_StartTag
+    };
+
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    XMLByte byteAt(const XMLFilePos offset) const;
+    bool findString
+    (
+        const   char* const     toFind
+        , const XMLSize_t       length
+        , const XMLFilePos      from
+        ,       XMLFilePos&     offset
+    )   const;
+    bool findDocTypeEnd(XMLFilePos& offset) const;
+    bool findTerminator
+    (
+        const   char* const     toFind
+        , const XMLSize_t       length
+        ,       XMLFilePos&     offset
+    );
+    bool findTokenEnd(XMLFilePos& offset, bool& isEmpty);
+    bool isReadyForNext(const XMLScanner* const scanner) const;
+    bool senseToken();
+    void scanTokens();
+
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fBuffer
+    //  fBufSize
+    //  fBufLen
+    //  fBufBase
+    //      The bytes we are holding on to, the allocated size of the buffer
+    //      and how many bytes are in it, and the offset in the document of
+    //      the first of them. Bytes are dropped from the front once both
+    //      the reader and the lexer are past them.
+    //
+    //  fReadPos
+    //      The offset of the next byte the reader will get from our stream.
+    //
+    //  fTokenStart
+    //  fScanPos
+    //  fTokenType
+    //  fQuote
+    //      The lexer's state. The start and type of the token that we have
+    //      not seen the end of yet, where to resume looking for its end, and
+    //      for start tags whether we are inside a quoted attribute value.
+    //
+    //  fSafeEnd
+    //      The end of the last complete token. The scanner can go on as long
+    //      as the main entity's reader is before this offset.
+    //
+    //  fBOMLen
+    //      The length of any UTF-8 byte order mark. The reader does not count
+    //      it in its source offsets.
+    //
+    //  fDepth
+    //      The element depth at fTokenStart. Once the root element ends, the
+    //      scanner will want to see the end of input, so we stop there.
+    //
+    //  fEncodingSensed
+    //  fIncremental
+    //      Whether we've looked at the first bytes yet, and if so whether the
+    //      encoding lets us find tokens by looking at the raw bytes.
+    //
+    //  fRootSeen
+    //  fStopped
+    //      Whether the root element start tag is complete (so the prolog can
+    //      be scanned), and whether the lexer has gone as far as it can go
+    //      before the end of input.
+    //
+    //  fEndOfInput
+    //      Set when there are no more bytes coming, at which point the
+    //      scanner can run to the end.
+    //
+    //  fScanState
+    //  fScanToken
+    //  fCalculateSrcOfs
+    //      Where the scanner is in the document, the token for its scanNext()
+    //      calls, and the scanner's own source offset setting. We need the
+    //      source offsets turned on while we drive it and put this back when
+    //      the scan ends.
+    // -----------------------------------------------------------------------
+    XMLByte*            fBuffer;
+    XMLSize_t           fBufSize;
+    XMLSize_t           fBufLen;
+    XMLFilePos          fBufBase;
+    XMLFilePos          fReadPos;
+    XMLFilePos          fTokenStart;
+    XMLFilePos          fScanPos;
+    TokenTypes          fTokenType;
+    XMLByte             fQuote;
+    XMLFilePos          fSafeEnd;
+    XMLSize_t           fBOMLen;
+    XMLSize_t           fDepth;
+    bool                fEncodingSensed;
+    bool                fIncremental;
+    bool                fRootSeen;
+    bool                fStopped;
+    bool                fEndOfInput;
+    ScanStates          fScanState;
+    XMLPScanToken       fScanToken;
+    bool                fCalculateSrcOfs;
+};
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Stream methods
+// ---------------------------------------------------------------------------
+inline XMLFilePos PushInputSource::getReadPos() const
+{
+    return fReadPos;
+}
+
+
+// ---------------------------------------------------------------------------
+//  PushInputSource: Private helper methods
+// ---------------------------------------------------------------------------
+inline XMLByte PushInputSource::byteAt(const XMLFilePos offset) const
+{
+    return fBuffer[offset - fBufBase];
+}
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
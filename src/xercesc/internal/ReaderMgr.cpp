@@ -23,6 +23,7 @@
 //  Includes
 // ---------------------------------------------------------------------------
 #include <xercesc/util/BinMemInputStream.hpp>
+#include <xercesc/util/BinReadAheadInputStream.hpp>
 #include <xercesc/util/Janitor.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/RuntimeException.hpp>
@@ -59,6 +60,9 @@ ReaderMgr::ReaderMgr(MemoryManager* const manager) :
     , fThrowEOE(false)
     , fXMLVersion(XMLReader::XMLV1_0)
     , fStandardUriConformant(false)
+    , fReaderBufferSize(XMLReader::kDefaultCharBufSize)
+    , fAdaptiveReaderBuffer(false)
+    , fReadAhead(false)
     , fMemoryManager(manager)
 {
 }
@@ -288,6 +292,24 @@ void ReaderMgr::skipQuotedString(const XMLCh quoteCh)
 }
 
 
+//
+//  Unlike skipToChar(), this leaves the char that it finds to be read next.
+//  It returns false if there isn't one before the end of input. The chars
+//  are skipped in bulk by the readers, so this is the fast way over content
+//  that is not going to be looked at.
+//
+bool ReaderMgr::skipUpToChar(const XMLCh toSkipTo)
+{
+    while (!fCurReader->skipToChar(toSkipTo))
+    {
+        // This reader ran out, so move down to the next one if there is one
+        if (!peekNextChar())
+            return false;
+    }
+    return true;
+}
+
+
 XMLCh ReaderMgr::skipUntilIn(const XMLCh* const listToSkip)
 {
     XMLCh nextCh;
@@ -380,6 +402,26 @@ XMLReader* ReaderMgr::createReader( const   InputSource&        src
     if (!newStream)
         return 0;
 
+    //
+    //  If asked to, read ahead from the stream while we parse. This is only
+    //  done for local files (compressed or not), whose reads always return.
+    //  Destroying the reader waits for the read in progress, so a source
+    //  that can block until someone else sends data, such as a pipe or a
+    //  network connection, could hold up the end of the parse forever.
+    //
+    if (fReadAhead && dynamic_cast<const LocalFileInputSource*>(&src))
+    {
+        Janitor<BinInputStream> rawStreamJanitor(newStream);
+        newStream = new (fMemoryManager) BinReadAheadInputStream
+        (
+            newStream
+            , BinReadAheadInputStream::kDefaultBlockSize
+            , BinReadAheadInputStream::kDefaultBlockCount
+            , fMemoryManager
+        );
+        rawStreamJanitor.orphan();
+    }
+
     Janitor<BinInputStream>   streamJanitor(newStream);
 
     //
@@ -415,6 +457,8 @@ XMLReader* ReaderMgr::createReader( const   InputSource&        src
                 , calcSrcOfs
                 , lowWaterMark
                 , fXMLVersion
+                , fReaderBufferSize
+                , fAdaptiveReaderBuffer
                 , fMemoryManager
                 );
         }
@@ -432,6 +476,8 @@ XMLReader* ReaderMgr::createReader( const   InputSource&        src
                 , calcSrcOfs
                 , lowWaterMark
                 , fXMLVersion
+                , fReaderBufferSize
+                , fAdaptiveReaderBuffer
                 , fMemoryManager
                 );
         }
@@ -738,8 +784,32 @@ ReaderMgr::createIntEntReader(  const   XMLCh* const        sysId
                                 ,       XMLSize_t           lowWaterMark)
 {
     //
-    //  This one is easy, we just create an input stream for the data and
-    //  provide a few extra goodies.
+    //  Unless we have to make our own copy of the data, or a PE must get
+    //  its leading and trailing spaces faked in, the reader can just scan
+    //  the internalized value in place. This saves setting up a stream,
+    //  buffers and a transcoder for every entity reference.
+    //
+    if (!copyBuf && !((type == XMLReader::Type_PE) && (refFrom == XMLReader::RefFrom_NonLiteral)))
+    {
+        XMLReader* retVal = new (fMemoryManager) XMLReader
+        (
+            sysId
+            , dataBuf
+            , dataLen
+            , refFrom
+            , type
+            , calcSrcOfs
+            , fXMLVersion
+            , fMemoryManager
+        );
+
+        retVal->setReaderNum(fNextReaderNum++);
+        return retVal;
+    }
+
+    //
+    //  Otherwise, we just create an input stream for the data and provide
+    //  a few extra goodies.
     //
     //  NOTE: We use a special encoding string that will be recognized
     //  as a 'do nothing' transcoder for the already internalized XMLCh
@@ -769,6 +839,8 @@ ReaderMgr::createIntEntReader(  const   XMLCh* const        sysId
         , calcSrcOfs
         , lowWaterMark
         , fXMLVersion
+        , fReaderBufferSize
+        , fAdaptiveReaderBuffer
         , fMemoryManager
     );
 
@@ -822,6 +894,17 @@ XMLSize_t ReaderMgr::getReaderDepth() const
     return retVal;
 }
 
+const XMLReader* ReaderMgr::getPrimaryReader() const
+{
+    //
+    //  The main entity's reader is at the bottom of the reader stack if
+    //  any entities have been pushed over it, else it is the current one.
+    //
+    if (fReaderStack && !fReaderStack->empty())
+        return fReaderStack->elementAt(0);
+    return fCurReader;
+}
+
 void ReaderMgr::getLastExtEntityInfo(LastExtEntityInfo& lastInfo) const
 {
     //
@@ -92,6 +92,7 @@ public :
     void skipPastSpaces(bool& skippedSomething, bool inDecl = false);
     void skipPastSpaces();
     void skipToChar(const XMLCh toSkipTo);
+    bool skipUpToChar(const XMLCh toSkipTo);
     bool skippedChar(const XMLCh toSkip);
     bool skippedSpace();
     bool skippedString(const XMLCh* const toSkip);
@@ -172,10 +173,14 @@ public :
     const XMLReader* getCurrentReader() const;
     XMLReader* getCurrentReader();
     XMLSize_t getCurrentReaderNum() const;
+    const XMLReader* getPrimaryReader() const;
     XMLSize_t getReaderDepth() const;
     void getLastExtEntityInfo(LastExtEntityInfo& lastInfo) const;
     XMLFilePos getSrcOffset() const;
     bool getThrowEOE() const;
+    const XMLSize_t& getReaderBufferSize() const;
+    bool getAdaptiveReaderBuffer() const;
+    bool getReadAhead() const;
 
 
     // -----------------------------------------------------------------------
@@ -185,6 +190,9 @@ public :
     void setThrowEOE(const bool newValue);
     void setXMLVersion(const XMLReader::XMLVersion version);
     void setStandardUriConformant(const bool newValue);
+    void setReaderBufferSize(const XMLSize_t newValue);
+    void setAdaptiveReaderBuffer(const bool newValue);
+    void setReadAhead(const bool newValue);
 
     // -----------------------------------------------------------------------
     //  Implement the SAX Locator interface
@@ -251,6 +259,16 @@ private :
     //
     //  fStandardUriConformant
     //      This flag controls whether we force conformant URI
+    //
+    //  fReaderBufferSize
+    //  fAdaptiveReaderBuffer
+    //      The character buffer size that each new reader should use, and
+    //      whether readers should start small and grow their buffers up to
+    //      that size as they find the source to be large.
+    //
+    //  fReadAhead
+    //      This flag controls whether local files are read ahead on a
+    //      background thread while they are parsed.
     // -----------------------------------------------------------------------
     XMLEntityDecl*              fCurEntity;
     XMLReader*                  fCurReader;
@@ -261,6 +279,9 @@ private :
     bool                        fThrowEOE;
     XMLReader::XMLVersion       fXMLVersion;
     bool                        fStandardUriConformant;
+    XMLSize_t                   fReaderBufferSize;
+    bool                        fAdaptiveReaderBuffer;
+    bool                        fReadAhead;
     MemoryManager*              fMemoryManager;
 };
 
@@ -321,6 +342,21 @@ inline bool ReaderMgr::getThrowEOE() const
     return fThrowEOE;
 }
 
+inline const XMLSize_t& ReaderMgr::getReaderBufferSize() const
+{
+    return fReaderBufferSize;
+}
+
+inline bool ReaderMgr::getAdaptiveReaderBuffer() const
+{
+    return fAdaptiveReaderBuffer;
+}
+
+inline bool ReaderMgr::getReadAhead() const
+{
+    return fReadAhead;
+}
+
 inline XMLFilePos ReaderMgr::getSrcOffset() const
 {
     return fCurReader? fCurReader->getSrcOffset() : 0;
@@ -347,6 +383,21 @@ inline void ReaderMgr::setStandardUriConformant(const bool newValue)
     fStandardUriConformant = newValue;
 }
 
+inline void ReaderMgr::setReaderBufferSize(const XMLSize_t newValue)
+{
+    fReaderBufferSize = newValue;
+}
+
+inline void ReaderMgr::setAdaptiveReaderBuffer(const bool newValue)
+{
+    fAdaptiveReaderBuffer = newValue;
+}
+
+inline void ReaderMgr::setReadAhead(const bool newValue)
+{
+    fReadAhead = newValue;
+}
+
 inline bool ReaderMgr::skippedString(const XMLCh* const toSkip)
 {
     return fCurReader->skippedString(toSkip);
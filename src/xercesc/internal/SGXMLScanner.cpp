@@ -1978,7 +1978,7 @@ void SGXMLScanner::commonInit()
     (
         131, false, fMemoryManager
     );
-    fUndeclaredAttrRegistry = new (fMemoryManager) Hash2KeysSetOf<StringHasher>(7, fMemoryManager);
+    fUndeclaredAttrRegistry = new (fMemoryManager) AttrNameSet(fMemoryManager);
     fPSVIAttrList = new (fMemoryManager) PSVIAttributeList(fMemoryManager);
 
     fSchemaInfoList = new (fMemoryManager) RefHash2KeysTableOf<SchemaInfo>(29, fMemoryManager);
@@ -3125,6 +3125,7 @@ void SGXMLScanner::scanReset(const InputSource& src)
 
     // Reset some status flags
     fInException = false;
+    fSkipLevel = 0;
     fStandalone = false;
     fErrorCount = 0;
     fHasNoDTD = true;
@@ -0,0 +1,567 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#if HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <xercesc/internal/ThreadCachingMemoryManager.hpp>
+#include <xercesc/util/OutOfMemoryException.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <new>
+
+#if defined(HAVE_STD_THREAD) && !defined(XERCES_USE_MUTEXMGR_NOTHREAD)
+#define XERCES_THREAD_CACHES 1
+#include <atomic>
+#include <mutex>
+#endif
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+// ---------------------------------------------------------------------------
+//  Local const data
+//
+//  gClassSizes
+//      The size classes.  They go up in steps of 16 bytes to 256, which
+//      covers the parser's small objects (with their memory manager header)
+//      and most name and value strings, then in steps of 64 and 128 bytes
+//      to gMaxSmallSize.  sizeClass() below depends on this layout.
+//
+//  gSlabSize
+//      The size of the slabs that small blocks are carved out of.
+//
+//  gMaxSlots
+//      The number of memory managers a thread keeps a cache for at once.
+// ---------------------------------------------------------------------------
+static const XMLSize_t gClassSizes[] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256
+    , 320, 384, 448, 512
+    , 640, 768, 896, 1024
+};
+static const unsigned int gClassCount = sizeof(gClassSizes) / sizeof(gClassSizes[0]);
+static const XMLSize_t gMaxSmallSize = 1024;
+static const XMLSize_t gSlabSize = 64 * 1024;
+
+
+// ---------------------------------------------------------------------------
+//  Local data types
+//
+//  CachedBlockHeader
+//      Precedes every block handed out.  fOwner is the cache the block
+//      belongs to, or 0 for a large block.
+//
+//  CachedFreeBlock
+//      The link stored in a free block, after its header.
+//
+//  CachedSlab
+//      The link at the start of every slab, so that they can be released.
+// ---------------------------------------------------------------------------
+class ThreadCache;
+
+struct CachedBlockHeader
+{
+    ThreadCache*    fOwner;
+    unsigned int    fClass;
+};
+
+struct CachedFreeBlock
+{
+    CachedFreeBlock*    fNext;
+};
+
+struct CachedSlab
+{
+    CachedSlab*     fNext;
+};
+
+static const XMLSize_t gHeaderSize = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(CachedBlockHeader));
+static const XMLSize_t gSlabHeaderSize = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(CachedSlab));
+
+
+// ---------------------------------------------------------------------------
+//  Statistics counters
+//
+//  Each counter is only written by the thread that owns the cache it is
+//  in, so it does not need an atomic increment; it is atomic so that
+//  getStatistics() can read it from another thread.
+// ---------------------------------------------------------------------------
+#if defined(XERCES_THREAD_CACHES)
+typedef std::atomic<XMLSize_t> CacheCounter;
+
+static inline void addToCounter(CacheCounter& counter, const XMLSize_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static inline XMLSize_t readCounter(const CacheCounter& counter)
+{
+    return counter.load(std::memory_order_relaxed);
+}
+#else
+typedef XMLSize_t CacheCounter;
+
+static inline void addToCounter(CacheCounter& counter, const XMLSize_t value)
+{
+    counter += value;
+}
+
+static inline XMLSize_t readCounter(const CacheCounter& counter)
+{
+    return counter;
+}
+#endif
+
+
+// ---------------------------------------------------------------------------
+//  ThreadCache
+//
+//  The free lists of one thread.  Only that thread touches fFree, fCurrent,
+//  fEnd and fSlabs; other threads push the blocks they free onto
+//  fRemoteFree, which the owner takes over in one go when it runs out.
+//  fActive says whether a thread is using the cache, and is guarded by the
+//  heap's mutex.
+// ---------------------------------------------------------------------------
+class ThreadCache
+{
+public:
+    ThreadCache() :
+        fCurrent(0)
+        , fEnd(0)
+        , fSlabs(0)
+        , fNext(0)
+        , fAllocations(0)
+        , fLargeAllocations(0)
+        , fDeallocations(0)
+        , fRemoteDeallocations(0)
+        , fSlabSize(0)
+#if defined(XERCES_THREAD_CACHES)
+        , fRemoteFree(0)
+        , fActive(false)
+#endif
+    {
+        for (unsigned int index = 0; index < gClassCount; index++)
+            fFree[index] = 0;
+    }
+
+    ~ThreadCache()
+    {
+        while (fSlabs)
+        {
+            CachedSlab* slab = fSlabs;
+            fSlabs = slab->fNext;
+            ::operator delete(slab);
+        }
+    }
+
+    CachedFreeBlock*    fFree[gClassCount];
+    char*               fCurrent;
+    char*               fEnd;
+    CachedSlab*         fSlabs;
+    ThreadCache*        fNext;
+
+    CacheCounter        fAllocations;
+    CacheCounter        fLargeAllocations;
+    CacheCounter        fDeallocations;
+    CacheCounter        fRemoteDeallocations;
+    CacheCounter        fSlabSize;
+
+#if defined(XERCES_THREAD_CACHES)
+    std::atomic<CachedFreeBlock*>   fRemoteFree;
+    bool                            fActive;
+#endif
+
+private:
+    ThreadCache(const ThreadCache&);
+    ThreadCache& operator=(const ThreadCache&);
+};
+
+
+// ---------------------------------------------------------------------------
+//  ThreadCachingHeap
+//
+//  All of the caches of one memory manager.  fId identifies the heap in the
+//  threads' cache slots, which can outlive it.
+// ---------------------------------------------------------------------------
+class ThreadCachingHeap
+{
+public:
+    ThreadCachingHeap() :
+        fCaches(0)
+#if defined(XERCES_THREAD_CACHES)
+        , fId(0)
+        , fNextLive(0)
+#endif
+    {
+    }
+
+    ~ThreadCachingHeap()
+    {
+        while (fCaches)
+        {
+            ThreadCache* cache = fCaches;
+            fCaches = cache->fNext;
+            delete cache;
+        }
+    }
+
+    ThreadCache*            fCaches;
+
+#if defined(XERCES_THREAD_CACHES)
+    unsigned long long      fId;
+    ThreadCachingHeap*      fNextLive;
+    mutable std::mutex      fMutex;
+#endif
+
+private:
+    ThreadCachingHeap(const ThreadCachingHeap&);
+    ThreadCachingHeap& operator=(const ThreadCachingHeap&);
+};
+
+
+#if defined(XERCES_THREAD_CACHES)
+
+// ---------------------------------------------------------------------------
+//  The heaps that are alive.  A thread that exits releases its caches, but
+//  only those of heaps that are still on this list.
+// ---------------------------------------------------------------------------
+static std::mutex& liveHeapsMutex()
+{
+    static std::mutex liveMutex;
+    return liveMutex;
+}
+
+static ThreadCachingHeap*   gLiveHeaps = 0;
+static unsigned long long   gNextHeapId = 0;
+
+static void releaseCache(const unsigned long long heapId, ThreadCache* const cache)
+{
+    std::lock_guard<std::mutex> liveLock(liveHeapsMutex());
+    for (ThreadCachingHeap* heap = gLiveHeaps; heap; heap = heap->fNextLive)
+    {
+        if (heap->fId == heapId)
+        {
+            std::lock_guard<std::mutex> lock(heap->fMutex);
+            cache->fActive = false;
+            break;
+        }
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+//  ThreadCacheSlots
+//
+//  The caches the current thread is using, most recently attached last.
+// ---------------------------------------------------------------------------
+static const unsigned int gMaxSlots = 4;
+
+class ThreadCacheSlots
+{
+public:
+    ThreadCacheSlots() : fCount(0)
+    {
+    }
+
+    ~ThreadCacheSlots()
+    {
+        while (fCount)
+            release(0);
+    }
+
+    ThreadCache* find(const unsigned long long heapId) const
+    {
+        for (unsigned int index = 0; index < fCount; index++)
+        {
+            if (fHeapIds[index] == heapId)
+                return fCaches[index];
+        }
+        return 0;
+    }
+
+    void release(const unsigned int index)
+    {
+        releaseCache(fHeapIds[index], fCaches[index]);
+        for (unsigned int next = index + 1; next < fCount; next++)
+        {
+            fHeapIds[next - 1] = fHeapIds[next];
+            fCaches[next - 1] = fCaches[next];
+        }
+        fCount--;
+    }
+
+    unsigned long long  fHeapIds[gMaxSlots];
+    ThreadCache*        fCaches[gMaxSlots];
+    unsigned int        fCount;
+};
+
+static thread_local ThreadCacheSlots gThreadSlots;
+
+static ThreadCache* attachCache(ThreadCachingHeap* const heap)
+{
+    ThreadCacheSlots& slots = gThreadSlots;
+    if (slots.fCount == gMaxSlots)
+        slots.release(0);
+
+    ThreadCache* cache = 0;
+    {
+        std::lock_guard<std::mutex> lock(heap->fMutex);
+        for (cache = heap->fCaches; cache; cache = cache->fNext)
+        {
+            if (!cache->fActive)
+                break;
+        }
+
+        if (!cache)
+        {
+            try
+            {
+                cache = new ThreadCache();
+            }
+            catch(...)
+            {
+                throw OutOfMemoryException();
+            }
+            cache->fNext = heap->fCaches;
+            heap->fCaches = cache;
+        }
+        cache->fActive = true;
+    }
+
+    slots.fHeapIds[slots.fCount] = heap->fId;
+    slots.fCaches[slots.fCount] = cache;
+    slots.fCount++;
+    return cache;
+}
+
+#endif
+
+
+// ---------------------------------------------------------------------------
+//  Local helper functions
+// ---------------------------------------------------------------------------
+static inline ThreadCache* getCache(ThreadCachingHeap* const heap)
+{
+#if defined(XERCES_THREAD_CACHES)
+    ThreadCache* cache = gThreadSlots.find(heap->fId);
+    return cache ? cache : attachCache(heap);
+#else
+    return heap->fCaches;
+#endif
+}
+
+static inline unsigned int sizeClass(const XMLSize_t size)
+{
+    if (size <= 256)
+        return size ? (unsigned int)((size - 1) >> 4) : 0;
+    if (size <= 512)
+        return 16 + (unsigned int)((size - 257) >> 6);
+    return 20 + (unsigned int)((size - 513) >> 7);
+}
+
+static void* allocateFromSystem(const XMLSize_t size)
+{
+    void* memptr;
+    try {
+        memptr = ::operator new(size);
+    }
+    catch(...) {
+        throw OutOfMemoryException();
+    }
+    if (memptr == NULL)
+        throw OutOfMemoryException();
+    return memptr;
+}
+
+
+// ---------------------------------------------------------------------------
+//  ThreadCachingMemoryManager: Constructors and Destructor
+// ---------------------------------------------------------------------------
+ThreadCachingMemoryManager::ThreadCachingMemoryManager() :
+    fHeap(0)
+{
+    fHeap = new ThreadCachingHeap();
+
+#if defined(XERCES_THREAD_CACHES)
+    std::lock_guard<std::mutex> liveLock(liveHeapsMutex());
+    fHeap->fId = ++gNextHeapId;
+    fHeap->fNextLive = gLiveHeaps;
+    gLiveHeaps = fHeap;
+#else
+    fHeap->fCaches = new ThreadCache();
+#endif
+}
+
+ThreadCachingMemoryManager::~ThreadCachingMemoryManager()
+{
+#if defined(XERCES_THREAD_CACHES)
+    {
+        std::lock_guard<std::mutex> liveLock(liveHeapsMutex());
+        for (ThreadCachingHeap** link = &gLiveHeaps; *link; link = &(*link)->fNextLive)
+        {
+            if (*link == fHeap)
+            {
+                *link = fHeap->fNextLive;
+                break;
+            }
+        }
+    }
+#endif
+
+    delete fHeap;
+}
+
+
+// ---------------------------------------------------------------------------
+//  ThreadCachingMemoryManager: Implementation of the MemoryManager interface
+// ---------------------------------------------------------------------------
+MemoryManager* ThreadCachingMemoryManager::getExceptionMemoryManager()
+{
+    return this;
+}
+
+void* ThreadCachingMemoryManager::allocate(XMLSize_t size)
+{
+    ThreadCache* cache = getCache(fHeap);
+    addToCounter(cache->fAllocations, 1);
+
+    if (size > gMaxSmallSize)
+    {
+        CachedBlockHeader* header = (CachedBlockHeader*)allocateFromSystem(gHeaderSize + size);
+        header->fOwner = 0;
+        header->fClass = gClassCount;
+        addToCounter(cache->fLargeAllocations, 1);
+        return (char*)header + gHeaderSize;
+    }
+
+    const unsigned int sizeCls = sizeClass(size);
+    CachedFreeBlock* block = cache->fFree[sizeCls];
+
+#if defined(XERCES_THREAD_CACHES)
+    // Take back whatever other threads have freed before carving more
+    if (!block && cache->fRemoteFree.load(std::memory_order_relaxed))
+    {
+        CachedFreeBlock* remote = cache->fRemoteFree.exchange(0, std::memory_order_acquire);
+        while (remote)
+        {
+            CachedFreeBlock* next = remote->fNext;
+            const unsigned int remoteCls = ((CachedBlockHeader*)((char*)remote - gHeaderSize))->fClass;
+            remote->fNext = cache->fFree[remoteCls];
+            cache->fFree[remoteCls] = remote;
+            remote = next;
+        }
+        block = cache->fFree[sizeCls];
+    }
+#endif
+
+    if (block)
+    {
+        cache->fFree[sizeCls] = block->fNext;
+        return block;
+    }
+
+    const XMLSize_t blockSize = gHeaderSize + gClassSizes[sizeCls];
+    if ((XMLSize_t)(cache->fEnd - cache->fCurrent) < blockSize)
+    {
+        CachedSlab* slab = (CachedSlab*)allocateFromSystem(gSlabSize);
+        slab->fNext = cache->fSlabs;
+        cache->fSlabs = slab;
+        addToCounter(cache->fSlabSize, gSlabSize);
+
+        cache->fCurrent = (char*)slab + gSlabHeaderSize;
+        cache->fEnd = (char*)slab + gSlabSize;
+    }
+
+    CachedBlockHeader* header = (CachedBlockHeader*)cache->fCurrent;
+    cache->fCurrent += blockSize;
+    header->fOwner = cache;
+    header->fClass = sizeCls;
+    return (char*)header + gHeaderSize;
+}
+
+void ThreadCachingMemoryManager::deallocate(void* p)
+{
+    if (!p)
+        return;
+
+    ThreadCache* cache = getCache(fHeap);
+    addToCounter(cache->fDeallocations, 1);
+
+    CachedBlockHeader* header = (CachedBlockHeader*)((char*)p - gHeaderSize);
+    ThreadCache* owner = header->fOwner;
+    CachedFreeBlock* block = (CachedFreeBlock*)p;
+
+    if (!owner)
+    {
+        ::operator delete(header);
+    }
+    else if (owner == cache)
+    {
+        block->fNext = cache->fFree[header->fClass];
+        cache->fFree[header->fClass] = block;
+    }
+#if defined(XERCES_THREAD_CACHES)
+    else
+    {
+        CachedFreeBlock* head = owner->fRemoteFree.load(std::memory_order_relaxed);
+        do
+        {
+            block->fNext = head;
+        }
+        while (!owner->fRemoteFree.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+        addToCounter(cache->fRemoteDeallocations, 1);
+    }
+#endif
+}
+
+
+// ---------------------------------------------------------------------------
+//  ThreadCachingMemoryManager: Statistics
+// ---------------------------------------------------------------------------
+void ThreadCachingMemoryManager::getStatistics(Statistics& stats) const
+{
+    stats.fAllocations = 0;
+    stats.fLargeAllocations = 0;
+    stats.fDeallocations = 0;
+    stats.fRemoteDeallocations = 0;
+    stats.fThreadCaches = 0;
+    stats.fSlabSize = 0;
+
+#if defined(XERCES_THREAD_CACHES)
+    std::lock_guard<std::mutex> lock(fHeap->fMutex);
+#endif
+    for (const ThreadCache* cache = fHeap->fCaches; cache; cache = cache->fNext)
+    {
+        stats.fAllocations += readCounter(cache->fAllocations);
+        stats.fLargeAllocations += readCounter(cache->fLargeAllocations);
+        stats.fDeallocations += readCounter(cache->fDeallocations);
+        stats.fRemoteDeallocations += readCounter(cache->fRemoteDeallocations);
+        stats.fSlabSize += readCounter(cache->fSlabSize);
+        stats.fThreadCaches++;
+    }
+}
+
+XERCES_CPP_NAMESPACE_END
@@ -0,0 +1,165 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_THREADCACHINGMEMORYMANAGER_HPP)
+#define XERCESC_INCLUDE_GUARD_THREADCACHINGMEMORYMANAGER_HPP
+
+#include <xercesc/framework/MemoryManager.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+class ThreadCachingHeap;
+
+/**
+  * Thread-caching memory manager
+  *
+  * <p>This memory manager is an alternative to MemoryManagerImpl for
+  *    heavily multi-threaded applications.  Requests of up to 1024 bytes
+  *    are rounded up to one of a set of size classes, which are finest
+  *    below 256 bytes where most of the parser's objects and strings fall,
+  *    and are served from free lists private to the calling thread, so
+  *    threads do not contend with each other.  Memory freed by a thread
+  *    other than the one that allocated it is handed back to the owning
+  *    thread's cache through a lock-free list.  Larger requests go to the
+  *    global new and delete operators.
+  * </p>
+  *
+  * <p>Small blocks are carved out of 64KB slabs, which are only returned
+  *    to the system when the memory manager is deleted.  The cache of a
+  *    thread that exits is taken over by the next thread that needs one.
+  * </p>
+  *
+  * <p>It can be passed to XMLPlatformUtils::Initialize(), or made the
+  *    default memory manager when building the library.  Without thread
+  *    support it keeps a single cache.
+  * </p>
+  */
+
+class XMLUTIL_EXPORT ThreadCachingMemoryManager : public MemoryManager
+{
+public:
+
+    /**
+      * Allocation statistics, summed over all of the thread caches.
+      */
+    struct Statistics
+    {
+        /** The number of allocate() calls */
+        XMLSize_t   fAllocations;
+
+        /** The number of allocate() calls too large for a size class */
+        XMLSize_t   fLargeAllocations;
+
+        /** The number of deallocate() calls */
+        XMLSize_t   fDeallocations;
+
+        /** The number of blocks freed by a thread that did not allocate them */
+        XMLSize_t   fRemoteDeallocations;
+
+        /** The number of thread caches created */
+        XMLSize_t   fThreadCaches;
+
+        /** The number of bytes held in slabs */
+        XMLSize_t   fSlabSize;
+    };
+
+    /** @name Constructor */
+    //@{
+
+    /**
+      * Default constructor
+      */
+    ThreadCachingMemoryManager();
+    //@}
+
+    /** @name Destructor */
+    //@{
+
+    /**
+      * Destructor.  Returns all of the slabs to the system.
+      */
+    virtual ~ThreadCachingMemoryManager();
+    //@}
+
+
+    /**
+      * This method is called to obtain the memory manager that should be
+      * used to allocate memory used in exceptions.
+      *
+      * @return A pointer to the memory manager
+      */
+    virtual MemoryManager* getExceptionMemoryManager();
+
+
+    /** @name The virtual methods in MemoryManager */
+    //@{
+
+    /**
+      * This method allocates requested memory.
+      *
+      * @param size The requested memory size
+      *
+      * @return A pointer to the allocated memory
+      */
+    virtual void* allocate(XMLSize_t size);
+
+    /**
+      * This method deallocates memory
+      *
+      * @param p The pointer to the allocated memory to be deleted
+      */
+    virtual void deallocate(void* p);
+
+    //@}
+
+    /** @name Statistics */
+    //@{
+
+    /**
+      * Gets the allocation statistics.  The counters are updated without
+      * synchronization, so a snapshot taken while other threads are
+      * allocating is approximate.
+      *
+      * @param stats Receives the statistics
+      */
+    void getStatistics(Statistics& stats) const;
+
+    //@}
+
+private:
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    ThreadCachingMemoryManager(const ThreadCachingMemoryManager&);
+    ThreadCachingMemoryManager& operator=(const ThreadCachingMemoryManager&);
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fHeap
+    //      The thread caches and the synchronization around them.
+    // -----------------------------------------------------------------------
+    ThreadCachingHeap*  fHeap;
+};
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
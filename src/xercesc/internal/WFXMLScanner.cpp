@@ -51,12 +51,10 @@ WFXMLScanner::WFXMLScanner( XMLValidator* const  valToAdopt
                           , MemoryManager* const manager) :
 
     XMLScanner(valToAdopt, grammarResolver, manager)
-    , fElementIndex(0)
+    , fCheckAttrQNames(true)
     , fElements(0)
     , fEntityTable(0)
-    , fAttrNameHashList(0)
     , fAttrNSList(0)
-    , fElementLookup(0)
 {
     CleanupType cleanup(this, &WFXMLScanner::cleanUp);
 
@@ -85,12 +83,10 @@ WFXMLScanner::WFXMLScanner( XMLDocumentHandler* const docHandler
                           , MemoryManager* const      manager) :
 
     XMLScanner(docHandler, docTypeHandler, entityHandler, errHandler, valToAdopt, grammarResolver, manager)
-    , fElementIndex(0)
+    , fCheckAttrQNames(true)
     , fElements(0)
     , fEntityTable(0)
-    , fAttrNameHashList(0)
     , fAttrNSList(0)
-    , fElementLookup(0)
 {
     CleanupType cleanup(this, &WFXMLScanner::cleanUp);
 
@@ -422,10 +418,8 @@ bool WFXMLScanner::scanNext(XMLPScanToken& token)
 void WFXMLScanner::commonInit()
 {
     fEntityTable = new (fMemoryManager) ValueHashTableOf<XMLCh>(11, fMemoryManager);
-    fAttrNameHashList = new (fMemoryManager)ValueVectorOf<XMLSize_t>(16, fMemoryManager);
     fAttrNSList = new (fMemoryManager) ValueVectorOf<XMLAttr*>(8, fMemoryManager);
     fElements = new (fMemoryManager) RefVectorOf<XMLElementDecl>(32, true, fMemoryManager);
-    fElementLookup = new (fMemoryManager) RefHashTableOf<XMLElementDecl>(109, false, fMemoryManager);
 
     //  Add the default entity entries for the character refs that must always
     //  be present.
@@ -439,9 +433,7 @@ void WFXMLScanner::commonInit()
 void WFXMLScanner::cleanUp()
 {
     delete fEntityTable;
-    delete fAttrNameHashList;
     delete fAttrNSList;
-    delete fElementLookup;
     delete fElements;
 }
 
@@ -472,13 +464,10 @@ void WFXMLScanner::scanReset(const InputSource& src)
 
     // Reset some status flags
     fInException = false;
+    fSkipLevel = 0;
     fStandalone = false;
     fErrorCount = 0;
     fHasNoDTD = true;
-    fElementIndex = 0;
-
-    // Reset elements lookup table
-    fElementLookup->removeAll();
 
     //  Handle the creation of the XML reader object for this input source.
     //  This will provide us with transcoding and basic lexing services.
@@ -762,26 +751,23 @@ bool WFXMLScanner::scanStartTag(bool& gotData)
     // See if its the root element
     const bool isRoot = fElemStack.isEmpty();
 
-    //  Lets try to look up the element
+    //  Get the decl for this element's depth, and rename it if the last
+    //  element at this depth had a different name.
     const XMLCh* qnameRawBuf = fQNameBuf.getRawBuffer();
-    XMLElementDecl* elemDecl = fElementLookup->get(qnameRawBuf);
-
-    if (!elemDecl) {
-
-        if (fElementIndex < fElements->size()) {
-            elemDecl = fElements->elementAt(fElementIndex);
-        }
-        else {
-            elemDecl = new (fGrammarPoolMemoryManager) DTDElementDecl
-            (
-                fGrammarPoolMemoryManager
-            );
-            fElements->addElement(elemDecl);
-        }
-
+    const XMLSize_t elemDepth = fElemStack.getLevel();
+    XMLElementDecl* elemDecl = 0;
+    if (elemDepth < fElements->size()) {
+        elemDecl = fElements->elementAt(elemDepth);
+        if (!XMLString::equals(elemDecl->getFullName(), qnameRawBuf))
+            elemDecl->setElementName(XMLUni::fgZeroLenString, qnameRawBuf, fEmptyNamespaceId);
+    }
+    else {
+        elemDecl = new (fGrammarPoolMemoryManager) DTDElementDecl
+        (
+            fGrammarPoolMemoryManager
+        );
         elemDecl->setElementName(XMLUni::fgZeroLenString, qnameRawBuf, fEmptyNamespaceId);
-        fElementLookup->put((void*)elemDecl->getFullName(), elemDecl);
-        fElementIndex++;
+        fElements->addElement(elemDecl);
     }
 
     // Expand the element stack and add the new element
@@ -794,6 +780,7 @@ bool WFXMLScanner::scanStartTag(bool& gotData)
     //  pairs until we get there.
     XMLSize_t    attCount = 0;
     XMLSize_t    curAttListSize = fAttrList->size();
+    fAttrDupChkRegistry->removeAll();
     while (true)
     {
         // And get the next non-space character
@@ -873,34 +860,7 @@ bool WFXMLScanner::scanStartTag(bool& gotData)
                 }
             }
 
-            //  See if this attribute is declared more than one for this element.
             const XMLCh* attNameRawBuf = fAttNameBuf.getRawBuffer();
-            XMLSize_t attNameHash = XMLString::hash(attNameRawBuf, 109);
-
-            if (attCount) {
-
-                for (XMLSize_t k=0; k < attCount; k++) {
-
-                    if (fAttrNameHashList->elementAt(k) == attNameHash) {
-                        if (
-                               XMLString::equals
-                               (
-                                   fAttrList->elementAt(k)->getName()
-                                   , attNameRawBuf
-                               )
-                           )
-                        {
-                            emitError
-                            (
-                                XMLErrs::AttrAlreadyUsedInSTag
-                                , attNameRawBuf
-                                , qnameRawBuf
-                            );
-                            break;
-                        }
-                    }
-                }
-            }
 
             //  Skip any whitespace before the value and then scan the att
             //  value. This will come back normalized with entity refs and
@@ -957,7 +917,6 @@ bool WFXMLScanner::scanStartTag(bool& gotData)
                     , fMemoryManager
                 );
                 fAttrList->addElement(curAtt);
-                fAttrNameHashList->addElement(attNameHash);
             }
             else
             {
@@ -970,7 +929,19 @@ bool WFXMLScanner::scanStartTag(bool& gotData)
                     , fAttValueBuf.getRawBuffer()
                 );
                 curAtt->setSpecified(true);
-                fAttrNameHashList->setElementAt(attNameHash, attCount);
+            }
+
+            //  See if this attribute is declared more than once for this
+            //  element. The set keeps the name pointer, so use the copy in
+            //  the attribute rather than the one in fAttNameBuf.
+            if (!fAttrDupChkRegistry->putIfNotPresent(curAtt->getName(), 0))
+            {
+                emitError
+                (
+                    XMLErrs::AttrAlreadyUsedInSTag
+                    , curAtt->getName()
+                    , qnameRawBuf
+                );
             }
             attCount++;
 
@@ -1089,28 +1060,29 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
     // Skip any whitespace after the name
     fReaderMgr.skipPastSpaces();
 
-    //  Lets try to look up the element
     const XMLCh* qnameRawBuf = fQNameBuf.getRawBuffer();
-    XMLElementDecl* elemDecl = fElementLookup->get(qnameRawBuf);
-
-    if (!elemDecl) {
-        if (!XMLString::compareNString(qnameRawBuf, XMLUni::fgXMLNSColonString, 6))
-            emitError(XMLErrs::NoXMLNSAsElementPrefix, qnameRawBuf);
-
-        if (fElementIndex < fElements->size()) {
-            elemDecl = fElements->elementAt(fElementIndex);
-        }
-        else {
-            elemDecl = new (fGrammarPoolMemoryManager) DTDElementDecl
-            (
-                fGrammarPoolMemoryManager
-            );
-            fElements->addElement(elemDecl);
-        }
-
+    if (!XMLString::compareNString(qnameRawBuf, XMLUni::fgXMLNSColonString, 6))
+        emitError(XMLErrs::NoXMLNSAsElementPrefix, qnameRawBuf);
+
+    //  Get the decl for this element's depth, and rename it if the last
+    //  element at this depth had a different name.
+    const XMLSize_t elemDepth = fElemStack.getLevel();
+    XMLElementDecl* elemDecl = 0;
+    bool newName = true;
+    if (elemDepth < fElements->size()) {
+        elemDecl = fElements->elementAt(elemDepth);
+        if (!XMLString::equals(elemDecl->getFullName(), qnameRawBuf))
+            elemDecl->setElementName(qnameRawBuf, fEmptyNamespaceId);
+        else
+            newName = false;
+    }
+    else {
+        elemDecl = new (fGrammarPoolMemoryManager) DTDElementDecl
+        (
+            fGrammarPoolMemoryManager
+        );
         elemDecl->setElementName(qnameRawBuf, fEmptyNamespaceId);
-        fElementLookup->put((void*)elemDecl->getFullName(), elemDecl);
-        fElementIndex++;
+        fElements->addElement(elemDecl);
     }
 
     // Expand the element stack and add the new element
@@ -1123,6 +1095,8 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
     // pairs until we get there.
     XMLSize_t attCount = 0;
     XMLSize_t curAttListSize = fAttrList->size();
+    if (fCheckAttrQNames)
+        fAttrDupChkRegistry->removeAll();
     while (true)
     {
         // And get the next non-space character
@@ -1206,29 +1180,7 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
                 }
             }
 
-            //  See if this attribute is declared more than one for this element.
             const XMLCh* attNameRawBuf = fAttNameBuf.getRawBuffer();
-            XMLSize_t attNameHash = XMLString::hash(attNameRawBuf, 109);
-            if (attCount) {
-
-                for (XMLSize_t k=0; k < attCount; k++) {
-
-                    if (fAttrNameHashList->elementAt(k) == attNameHash) {
-                        if (XMLString::equals(
-                                fAttrList->elementAt(k)->getQName()
-                                , attNameRawBuf))
-                        {
-                            emitError
-                            (
-                                XMLErrs::AttrAlreadyUsedInSTag
-                                , attNameRawBuf
-                                , qnameRawBuf
-                            );
-                            break;
-                        }
-                    }
-                }
-            }
 
             //  Skip any whitespace before the value and then scan the att
             //  value. This will come back normalized with entity refs and
@@ -1285,7 +1237,6 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
                     , fMemoryManager
                 );
                 fAttrList->addElement(curAtt);
-                fAttrNameHashList->addElement(attNameHash);
             }
             else
             {
@@ -1297,7 +1248,6 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
                     , attValueRawBuf
                 );
                 curAtt->setSpecified(true);
-                fAttrNameHashList->setElementAt(attNameHash, attCount);
             }
 
             // Map prefix to namespace
@@ -1350,6 +1300,20 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
                 }
             }
 
+            //  See if this attribute is declared more than once for this
+            //  element. The set keeps the name pointer, so use the copy in
+            //  the attribute rather than the one in fAttNameBuf.
+            if (fCheckAttrQNames
+            &&  !fAttrDupChkRegistry->putIfNotPresent(curAtt->getQName(), 0))
+            {
+                emitError
+                (
+                    XMLErrs::AttrAlreadyUsedInSTag
+                    , curAtt->getQName()
+                    , qnameRawBuf
+                );
+            }
+
             // increment attribute count
             attCount++;
 
@@ -1415,58 +1379,26 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
 
     if(attCount) {
 
-        //
-        // Decide if to use hash table to do duplicate checking
-        //
-        bool toUseHashTable = false;
-        setAttrDupChkRegistry(attCount, toUseHashTable);
-
         // check for duplicate namespace attributes:
-        // by checking for qualified names with the same local part and with prefixes 
-        // which have been bound to namespace names that are identical. 
-        XMLAttr* loopAttr;
-        XMLAttr* curAtt;
-        for (unsigned int attrIndex=0; attrIndex < attCount-1; attrIndex++) {
-            loopAttr = fAttrList->elementAt(attrIndex);
-
-            if (!toUseHashTable)
-            {
-                for (unsigned int curAttrIndex = attrIndex+1; curAttrIndex < attCount; curAttrIndex++) {
-                    curAtt = fAttrList->elementAt(curAttrIndex);
-                    if (curAtt->getURIId() == loopAttr->getURIId() &&
-                        XMLString::equals(curAtt->getName(), loopAttr->getName())) {
-                        emitError
-                            ( 
-                            XMLErrs::AttrAlreadyUsedInSTag
-                            , curAtt->getName()
-                            , elemDecl->getFullName()
-                            );
-                    }
-                }
-            }
-            else 
+        // by checking for qualified names with the same local part and with prefixes
+        // which have been bound to namespace names that are identical.
+        fAttrDupChkRegistry->removeAll();
+        for (unsigned int attrIndex=0; attrIndex < attCount; attrIndex++) {
+            XMLAttr* curAtt = fAttrList->elementAt(attrIndex);
+            if (!fAttrDupChkRegistry->putIfNotPresent(curAtt->getName(), curAtt->getURIId()))
             {
-                if (fAttrDupChkRegistry->containsKey((void*)loopAttr->getName(), loopAttr->getURIId()))
-                {
-                    emitError
-                    ( 
+                emitError
+                (
                     XMLErrs::AttrAlreadyUsedInSTag
-                    , loopAttr->getName()
+                    , curAtt->getName()
                     , elemDecl->getFullName()
-                    );
-                }
-
-                fAttrDupChkRegistry->put((void*)loopAttr->getName(), loopAttr->getURIId(), loopAttr);
+                );
             }
-        }  
+        }
     }
 
     // Resolve the qualified name to a URI.
-    unsigned int uriId = resolvePrefix
-    (
-        elemDecl->getElementName()->getPrefix()
-        , ElemStack::Mode_Element
-    );
+    const unsigned int uriId = resolveElemPrefix(elemDecl, elemDepth, newName);
 
     // Now we can update the element stack
     fElemStack.setCurrentURI(uriId);
@@ -1502,6 +1434,19 @@ bool WFXMLScanner::scanStartTagNS(bool& gotData)
     return true;
 }
 
+//  This maps the prefix of an element's decl to a URI id. A derived
+//  scanner can override it to remember more about the decl's prefix.
+unsigned int WFXMLScanner::resolveElemPrefix(const  XMLElementDecl* const   elemDecl
+                                             , const XMLSize_t
+                                             , const bool)
+{
+    return resolvePrefix
+    (
+        elemDecl->getElementName()->getPrefix()
+        , ElemStack::Mode_Element
+    );
+}
+
 // ---------------------------------------------------------------------------
 //  XMLScanner: Private parsing methods
 // ---------------------------------------------------------------------------
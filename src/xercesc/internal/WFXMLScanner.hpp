@@ -74,6 +74,38 @@ public :
         , const bool            toCache = false
     );
 
+protected :
+    // -----------------------------------------------------------------------
+    //  XMLScanner virtual methods
+    // -----------------------------------------------------------------------
+    virtual void scanReset(const InputSource& src);
+
+    // -----------------------------------------------------------------------
+    //  Protected scanning methods
+    //
+    //  resolveElemPrefix
+    //      Called by scanStartTagNS(), once the attributes are scanned, to
+    //      map the prefix of the element's decl to a URI id. elemDepth is
+    //      the depth the decl is used for, and newName is true if the decl
+    //      has just been created or renamed for this element.
+    // -----------------------------------------------------------------------
+    virtual unsigned int resolveElemPrefix
+    (
+        const   XMLElementDecl* const   elemDecl
+        , const XMLSize_t               elemDepth
+        , const bool                    newName
+    );
+
+    // -----------------------------------------------------------------------
+    //  Protected data members
+    //
+    //  fCheckAttrQNames
+    //      Whether scanStartTagNS() checks for attributes with the same
+    //      qname as it scans them. Such an attribute is reported again when
+    //      the attributes are checked once their prefixes are mapped.
+    // -----------------------------------------------------------------------
+    bool                               fCheckAttrQNames;
+
 private :
     // -----------------------------------------------------------------------
     //  Unimplemented constructors and operators
@@ -95,7 +127,6 @@ private :
         ,       bool&   escaped
     );
     virtual void scanDocTypeDecl();
-    virtual void scanReset(const InputSource& src);
     virtual void sendCharData(XMLBuffer& toSend);
     virtual InputSource* resolveSystemId(const XMLCh* const sysId
                                         ,const XMLCh* const pubId);
@@ -122,24 +153,23 @@ private :
     // -----------------------------------------------------------------------
     //  Data members
     //
+    //  fElements
+    //      The element decls, one per element depth. There is no grammar,
+    //      so a decl only carries the name of the element that is open at
+    //      its depth, and it is renamed for the next element there. They
+    //      are kept from one parse to the next.
+    //
     //  fEntityTable
     //      This the table that contains the default entity entries.
     //
-    //  fAttrNameHashList
-    //      This contains the hash value for attribute names. It's used when
-    //      checking for duplicate attributes.
-    //
     //  fAttrNSList
     //      This contains XMLAttr objects that we need to map their prefixes
     //      to URIs when namespace is enabled.
     //
     // -----------------------------------------------------------------------
-    unsigned int                       fElementIndex;
     RefVectorOf<XMLElementDecl>*       fElements;
     ValueHashTableOf<XMLCh>*           fEntityTable;
-    ValueVectorOf<XMLSize_t>*          fAttrNameHashList;
     ValueVectorOf<XMLAttr*>*           fAttrNSList;
-    RefHashTableOf<XMLElementDecl>*    fElementLookup;  
 };
 
 inline const XMLCh* WFXMLScanner::getName() const
@@ -28,12 +28,165 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/RuntimeException.hpp>
 #include <xercesc/util/TransService.hpp>
+#include <xercesc/util/UnexpectedEOFException.hpp>
 #include <xercesc/util/XMLEBCDICTranscoder.hpp>
 #include <xercesc/util/XMLString.hpp>
 #include <xercesc/util/Janitor.hpp>
 
+#if XERCES_HAVE_EMMINTRIN_H
+#   include <emmintrin.h>
+#endif
+
 XERCES_CPP_NAMESPACE_BEGIN
 
+// ---------------------------------------------------------------------------
+//  Local helper methods
+//
+//  These find the length of the run of ASCII chars of a given class at the
+//  start of a block of chars, eight chars per step. They only look at
+//  whole steps, and only at the common ASCII members of each class, so a
+//  run can end early on a char that is in the class after all (a tab, or
+//  a non-ASCII name char). Callers always go on with the char table, so
+//  these just let them skip over the bulk of a run. Without SSE2 they
+//  return zero.
+//
+//  countPlainContent
+//      Chars from 0x20 to 0x7E, except for '<', '&' and ']'.
+//
+//  countBlanks
+//      Spaces and tabs, i.e. whitespace that does not end a line.
+//
+//  countNameChars
+//      Letters, digits, '-', '.', '_' and, if colonOk is set, ':'.
+// ---------------------------------------------------------------------------
+#ifdef XERCES_HAVE_SSE2_INTRINSIC
+
+// Returns the number of leading lanes set in a mask of eight 16-bit lanes
+static inline XMLSize_t leadingLanes(unsigned int laneMask)
+{
+    XMLSize_t lanes = 0;
+    while (laneMask & 1)
+    {
+        laneMask >>= 2;
+        lanes++;
+    }
+    return lanes;
+}
+
+//
+//  Signed 16-bit compares are used for the ranges, so chars from 0x8000 up
+//  compare as negative and are never within any range with a positive
+//  lower bound.
+//
+static inline __m128i inRange(const __m128i chars, const short low, const short high)
+{
+    return _mm_and_si128
+    (
+        _mm_cmpgt_epi16(chars, _mm_set1_epi16(short(low - 1)))
+        , _mm_cmplt_epi16(chars, _mm_set1_epi16(short(high + 1)))
+    );
+}
+
+static XMLSize_t countPlainContent(const XMLCh* const toCheck, const XMLSize_t count)
+{
+    if (!XMLPlatformUtils::fgSSE2ok)
+        return 0;
+
+    XMLSize_t index = 0;
+    for (; count - index >= 8; index += 8)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(toCheck + index));
+        const __m128i special = _mm_or_si128
+        (
+            _mm_or_si128(_mm_cmpeq_epi16(chars, _mm_set1_epi16(chOpenAngle))
+                       , _mm_cmpeq_epi16(chars, _mm_set1_epi16(chAmpersand)))
+            , _mm_cmpeq_epi16(chars, _mm_set1_epi16(chCloseSquare))
+        );
+        const unsigned int laneMask = (unsigned int)_mm_movemask_epi8
+        (
+            _mm_andnot_si128(special, inRange(chars, 0x20, 0x7E))
+        );
+        if (laneMask != 0xFFFF)
+            return index + leadingLanes(laneMask);
+    }
+    return index;
+}
+
+static XMLSize_t countBlanks(const XMLCh* const toCheck, const XMLSize_t count)
+{
+    if (!XMLPlatformUtils::fgSSE2ok)
+        return 0;
+
+    XMLSize_t index = 0;
+    for (; count - index >= 8; index += 8)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(toCheck + index));
+        const unsigned int laneMask = (unsigned int)_mm_movemask_epi8
+        (
+            _mm_or_si128(_mm_cmpeq_epi16(chars, _mm_set1_epi16(chSpace))
+                       , _mm_cmpeq_epi16(chars, _mm_set1_epi16(chHTab)))
+        );
+        if (laneMask != 0xFFFF)
+            return index + leadingLanes(laneMask);
+    }
+    return index;
+}
+
+static XMLSize_t countNameChars(const XMLCh* const  toCheck
+                                , const XMLSize_t   count
+                                , const bool        colonOk)
+{
+    if (!XMLPlatformUtils::fgSSE2ok)
+        return 0;
+
+    XMLSize_t index = 0;
+    for (; count - index >= 8; index += 8)
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(toCheck + index));
+
+        // Folding in the 0x20 bit maps upper case letters onto lower case
+        __m128i nameChars = _mm_or_si128
+        (
+            inRange(_mm_or_si128(chars, _mm_set1_epi16(0x20)), chLatin_a, chLatin_z)
+            , inRange(chars, chDigit_0, chDigit_9)
+        );
+        nameChars = _mm_or_si128
+        (
+            nameChars
+            , _mm_or_si128(_mm_cmpeq_epi16(chars, _mm_set1_epi16(chDash))
+                         , _mm_cmpeq_epi16(chars, _mm_set1_epi16(chPeriod)))
+        );
+        nameChars = _mm_or_si128(nameChars, _mm_cmpeq_epi16(chars, _mm_set1_epi16(chUnderscore)));
+        if (colonOk)
+            nameChars = _mm_or_si128(nameChars, _mm_cmpeq_epi16(chars, _mm_set1_epi16(chColon)));
+
+        const unsigned int laneMask = (unsigned int)_mm_movemask_epi8(nameChars);
+        if (laneMask != 0xFFFF)
+            return index + leadingLanes(laneMask);
+    }
+    return index;
+}
+
+#else
+
+static inline XMLSize_t countPlainContent(const XMLCh* const, const XMLSize_t)
+{
+    return 0;
+}
+
+static inline XMLSize_t countBlanks(const XMLCh* const, const XMLSize_t)
+{
+    return 0;
+}
+
+static inline XMLSize_t countNameChars(const XMLCh* const, const XMLSize_t, const bool)
+{
+    return 0;
+}
+
+#endif
+
+
 // ---------------------------------------------------------------------------
 //  XMLReader: Query Methods
 // ---------------------------------------------------------------------------
@@ -95,23 +248,38 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
                     , const bool                  calculateSrcOfs
                     ,       XMLSize_t             lowWaterMark
                     , const XMLVersion            version
+                    , const XMLSize_t             bufferSize
+                    , const bool                  adaptiveBuffer
                     ,       MemoryManager* const  manager) :
     fCharIndex(0)
+    , fCharBuf(0)
+    , fCharStore(0)
+    , fCharBufSize(0)
     , fCharsAvail(0)
+    , fCharSizeBuf(0)
     , fCurCol(1)
     , fCurLine(1)
     , fEncodingStr(0)
     , fForcedEncoding(false)
+    , fInPlaceEnd(0)
     , fNoMore(false)
     , fPublicId(XMLString::replicate(pubId, manager))
     , fRawBufIndex(0)
+    , fRawByteBuf(0)
+    , fRawInPlaceEnd(0)
+    , fRawStore(0)
+    , fRawBufSize(0)
     , fRawBytesAvail(0)
     , fLowWaterMark (lowWaterMark)
+    , fMaxCharBufSize(0)
     , fReaderNum(0xFFFFFFFF)
     , fRefFrom(from)
     , fSentTrailingSpace(false)
     , fSource(source)
     , fSrcOfsBase(0)
+    , fSrcOfsEnd(0)
+    , fSrcOfsIndex(0)
+    , fSrcOfsCur(0)
     , fSrcOfsSupported(false)
     , fCalculateSrcOfs(calculateSrcOfs)
     , fSystemId(XMLString::replicate(sysId, manager))
@@ -123,6 +291,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
     , fMemoryManager(manager)
 {
     setXMLVersion(version);
+    allocBuffers(bufferSize, adaptiveBuffer);
 
     // Do an initial load of raw bytes
     refreshRawBuffer();
@@ -177,24 +346,39 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
                     , const bool                  calculateSrcOfs
                     ,       XMLSize_t             lowWaterMark
                     , const XMLVersion            version
+                    , const XMLSize_t             bufferSize
+                    , const bool                  adaptiveBuffer
                     ,       MemoryManager* const  manager) :
     fCharIndex(0)
+    , fCharBuf(0)
+    , fCharStore(0)
+    , fCharBufSize(0)
     , fCharsAvail(0)
+    , fCharSizeBuf(0)
     , fCurCol(1)
     , fCurLine(1)
     , fEncoding(XMLRecognizer::UTF_8)
     , fEncodingStr(0)
     , fForcedEncoding(true)
+    , fInPlaceEnd(0)
     , fNoMore(false)
     , fPublicId(XMLString::replicate(pubId, manager))
     , fRawBufIndex(0)
+    , fRawByteBuf(0)
+    , fRawInPlaceEnd(0)
+    , fRawStore(0)
+    , fRawBufSize(0)
     , fRawBytesAvail(0)
     , fLowWaterMark (lowWaterMark)
+    , fMaxCharBufSize(0)
     , fReaderNum(0xFFFFFFFF)
     , fRefFrom(from)
     , fSentTrailingSpace(false)
     , fSource(source)
     , fSrcOfsBase(0)
+    , fSrcOfsEnd(0)
+    , fSrcOfsIndex(0)
+    , fSrcOfsCur(0)
     , fSrcOfsSupported(false)
     , fCalculateSrcOfs(calculateSrcOfs)
     , fSystemId(XMLString::replicate(sysId, manager))
@@ -206,6 +390,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
     , fMemoryManager(manager)
 {
     setXMLVersion(version);
+    allocBuffers(bufferSize, adaptiveBuffer);
 
     // Do an initial load of raw bytes
     refreshRawBuffer();
@@ -294,7 +479,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
         (
             fEncodingStr
             , failReason
-            , kCharBufSize
+            , fMaxCharBufSize
             , fMemoryManager
         );
     }
@@ -307,7 +492,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
         (
             fEncoding
             , failReason
-            , kCharBufSize
+            , fMaxCharBufSize
             , fMemoryManager
         );
 
@@ -320,6 +505,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
         //
         fMemoryManager->deallocate(fPublicId);
         fMemoryManager->deallocate(fSystemId);
+        fMemoryManager->deallocate(fCharStore);
         ArrayJanitor<XMLCh> jan (fEncodingStr, fMemoryManager);
 
         ThrowXMLwithMemMgr1
@@ -343,8 +529,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
     {
         // This represents no data from the source
         fCharSizeBuf[fCharsAvail] = 0;
-        fCharOfsBuf[fCharsAvail] = 0;
-        fCharBuf[fCharsAvail++] = chSpace;
+        fCharStore[fCharsAvail++] = chSpace;
     }
 }
 
@@ -360,24 +545,39 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
                     , const bool                  calculateSrcOfs
                     ,       XMLSize_t             lowWaterMark
                     , const XMLVersion            version
+                    , const XMLSize_t             bufferSize
+                    , const bool                  adaptiveBuffer
                     ,       MemoryManager* const  manager) :
     fCharIndex(0)
+    , fCharBuf(0)
+    , fCharStore(0)
+    , fCharBufSize(0)
     , fCharsAvail(0)
+    , fCharSizeBuf(0)
     , fCurCol(1)
     , fCurLine(1)
     , fEncoding(XMLRecognizer::UTF_8)
     , fEncodingStr(0)
     , fForcedEncoding(true)
+    , fInPlaceEnd(0)
     , fNoMore(false)
     , fPublicId(XMLString::replicate(pubId, manager))
     , fRawBufIndex(0)
+    , fRawByteBuf(0)
+    , fRawInPlaceEnd(0)
+    , fRawStore(0)
+    , fRawBufSize(0)
     , fRawBytesAvail(0)
     , fLowWaterMark (lowWaterMark)
+    , fMaxCharBufSize(0)
     , fReaderNum(0xFFFFFFFF)
     , fRefFrom(from)
     , fSentTrailingSpace(false)
     , fSource(source)
     , fSrcOfsBase(0)
+    , fSrcOfsEnd(0)
+    , fSrcOfsIndex(0)
+    , fSrcOfsCur(0)
     , fSrcOfsSupported(false)
     , fCalculateSrcOfs(calculateSrcOfs)
     , fSystemId(XMLString::replicate(sysId, manager))
@@ -389,6 +589,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
     , fMemoryManager(manager)
 {
     setXMLVersion(version);
+    allocBuffers(bufferSize, adaptiveBuffer);
 
     // Do an initial load of raw bytes
     refreshRawBuffer();
@@ -414,7 +615,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
     (
         fEncoding
         , failReason
-        , kCharBufSize
+        , fMaxCharBufSize
         , fMemoryManager
     );
 
@@ -425,6 +626,7 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
         //
         fMemoryManager->deallocate(fPublicId);
         fMemoryManager->deallocate(fSystemId);
+        fMemoryManager->deallocate(fCharStore);
         ArrayJanitor<XMLCh> jan (fEncodingStr, fMemoryManager);
 
         ThrowXMLwithMemMgr1
@@ -448,17 +650,82 @@ XMLReader::XMLReader(const  XMLCh* const          pubId
     {
         // This represents no data from the source
         fCharSizeBuf[fCharsAvail] = 0;
-        fCharOfsBuf[fCharsAvail] = 0;
-        fCharBuf[fCharsAvail++] = chSpace;
+        fCharStore[fCharsAvail++] = chSpace;
     }
 }
 
 
+XMLReader::XMLReader(const  XMLCh* const          sysId
+                    , const XMLCh* const          dataBuf
+                    , const XMLSize_t             dataLen
+                    , const RefFrom               from
+                    , const Types                 type
+                    , const bool                  calculateSrcOfs
+                    , const XMLVersion            version
+                    ,       MemoryManager* const  manager) :
+    fCharIndex(0)
+    , fCharBuf(dataBuf)
+    , fCharStore(0)
+    , fCharBufSize(0)
+    , fCharsAvail(dataLen)
+    , fCharSizeBuf(0)
+    , fCurCol(1)
+    , fCurLine(1)
+    , fEncoding(XMLRecognizer::XERCES_XMLCH)
+    , fEncodingStr(0)
+    , fForcedEncoding(true)
+    , fInPlaceEnd(dataBuf + dataLen)
+    , fNoMore(dataLen == 0)
+    , fPublicId(0)
+    , fRawBufIndex(0)
+    , fRawByteBuf(0)
+    , fRawInPlaceEnd(0)
+    , fRawStore(0)
+    , fRawBufSize(0)
+    , fRawBytesAvail(0)
+    , fLowWaterMark(0)
+    , fMaxCharBufSize(0)
+    , fReaderNum(0xFFFFFFFF)
+    , fRefFrom(from)
+    , fSentTrailingSpace(false)
+    , fSource(Source_Internal)
+    , fSrcOfsBase(0)
+    , fSrcOfsEnd(0)
+    , fSrcOfsIndex(0)
+    , fSrcOfsCur(0)
+    , fSrcOfsSupported(false)
+    , fCalculateSrcOfs(calculateSrcOfs)
+    , fSystemId(XMLString::replicate(sysId, manager))
+    , fStream(0)
+    , fSwapped(false)
+    , fThrowAtEnd(false)
+    , fTranscoder(0)
+    , fType(type)
+    , fMemoryManager(manager)
+{
+    setXMLVersion(version);
+
+    //
+    //  The value of an internal entity is already internalized, so there
+    //  is nothing to probe, decode or buffer. We just scan it in place
+    //  from start to end.
+    //
+    //  NOTE: The leading and trailing spaces of a PE that is not referenced
+    //  from a literal cannot be faked into the caller's buffer, so such an
+    //  entity must get a stream based reader. The reader manager sees to
+    //  that.
+    //
+    fEncodingStr = XMLString::replicate(XMLRecognizer::nameForEncoding(fEncoding, fMemoryManager), fMemoryManager);
+    fSrcOfsSupported = XMLPlatformUtils::fgTransService->supportsSrcOfs();
+}
+
+
 XMLReader::~XMLReader()
 {
     fMemoryManager->deallocate(fEncodingStr);
     fMemoryManager->deallocate(fPublicId);
     fMemoryManager->deallocate(fSystemId);
+    fMemoryManager->deallocate(fCharStore);
     delete fStream;
     delete fTranscoder;
 }
@@ -472,20 +739,28 @@ XMLFilePos XMLReader::getSrcOffset() const
     if (!fSrcOfsSupported || !fCalculateSrcOfs)
         ThrowXMLwithMemMgr(RuntimeException, XMLExcepts::Reader_SrcOfsNotSupported, fMemoryManager);
 
+    // When scanning in place every char is a single UTF-16 unit
+    if (fInPlaceEnd)
+        return fSrcOfsBase + fCharIndex * sizeof(XMLCh);
+
     //
-    //  Take the current source offset and add in the sizes that we've
-    //  eaten from the source so far.
+    //  Take the offset of the last char we were asked about and add in the
+    //  sizes that we've eaten from the source since then. If we have moved
+    //  back since then, start again from the base.
     //
-    if( fCharIndex == 0 ) {
-        return fSrcOfsBase;
+    if (fCharIndex < fSrcOfsIndex)
+    {
+        fSrcOfsIndex = 0;
+        fSrcOfsCur = fSrcOfsBase;
     }
 
-    if( fCharIndex < fCharsAvail ) {
-
-        return (fSrcOfsBase + fCharOfsBuf[fCharIndex]);
-    }
+    XMLFilePos curOfs = fSrcOfsCur;
+    for (XMLSize_t index = fSrcOfsIndex; index < fCharIndex; index++)
+        curOfs += fCharSizeBuf[index];
 
-    return (fSrcOfsBase + fCharOfsBuf[fCharIndex-1] + fCharSizeBuf[fCharIndex-1]);
+    fSrcOfsIndex = fCharIndex;
+    fSrcOfsCur = curOfs;
+    return curOfs;
 }
 
 
@@ -500,8 +775,23 @@ bool XMLReader::refreshCharBuffer()
     // See if we have any existing chars.
     const XMLSize_t spareChars = fCharsAvail - fCharIndex;
 
+    //
+    //  If we are scanning in place, then all of the remaining source is
+    //  already in the window. Just slide its start up to the current char.
+    //
+    if (fInPlaceEnd)
+    {
+        fSrcOfsBase += fCharIndex * sizeof(XMLCh);
+        fCharBuf += fCharIndex;
+        fCharIndex = 0;
+        fCharsAvail = fInPlaceEnd - fCharBuf;
+        if (!fCharsAvail)
+            endInPlaceScan();
+        return (fCharsAvail != 0);
+    }
+
     // If we are full, then don't do anything.
-    if (spareChars == kCharBufSize)
+    if (spareChars == fCharBufSize)
         return true;
 
     //
@@ -524,7 +814,7 @@ bool XMLReader::refreshCharBuffer()
         (
             fEncodingStr
             , failReason
-            , kCharBufSize
+            , fMaxCharBufSize
             , fMemoryManager
         );
 
@@ -540,14 +830,23 @@ bool XMLReader::refreshCharBuffer()
         }
     }
 
+    // See if we can stop transcoding and scan the source in place
+    if (startInPlaceScan(spareChars))
+        return (fCharsAvail != 0);
+
     //
-    //  Add the number of source bytes eaten so far to the base src
-    //  offset member.
+    //  If we are adaptive and the last read from the stream filled up the
+    //  raw buffer, then the source is large so we can use larger buffers.
     //
-    if (fCalculateSrcOfs) {
-        for (startInd = 0; startInd < fCharIndex; startInd++)
-            fSrcOfsBase += fCharSizeBuf[startInd];
-    }
+    if ((fCharBufSize < fMaxCharBufSize) && (fRawBytesAvail == fRawBufSize))
+        growBuffers();
+
+    //
+    //  Move the base src offset up to the first spare char. That is the
+    //  end of what we have transcoded so far, less the spare chars.
+    //
+    if (fCalculateSrcOfs)
+        setSrcOfsBase(spareChars);
 
     //
     //  If there are spare chars, then move then down to the bottom. We
@@ -558,7 +857,7 @@ bool XMLReader::refreshCharBuffer()
     {
         for (XMLSize_t index = fCharIndex; index < fCharsAvail; index++)
         {
-            fCharBuf[startInd] = fCharBuf[index];
+            fCharStore[startInd] = fCharStore[index];
             fCharSizeBuf[startInd] = fCharSizeBuf[index];
             startInd++;
         }
@@ -570,9 +869,9 @@ bool XMLReader::refreshCharBuffer()
     //
     fCharsAvail = xcodeMoreChars
     (
-        &fCharBuf[startInd]
+        &fCharStore[startInd]
         , &fCharSizeBuf[startInd]
-        , kCharBufSize - spareChars
+        , fCharBufSize - spareChars
     );
 
     // Add back in the spare chars
@@ -592,7 +891,8 @@ bool XMLReader::refreshCharBuffer()
     &&  (fRefFrom == RefFrom_NonLiteral)
     &&  !fSentTrailingSpace)
     {
-        fCharBuf[0] = chSpace;
+        fCharSizeBuf[0] = 0;
+        fCharStore[0] = chSpace;
         fCharsAvail = 1;
         fSentTrailingSpace = true;
     }
@@ -605,21 +905,6 @@ bool XMLReader::refreshCharBuffer()
     if (!fCharsAvail)
         fNoMore = true;
 
-    //  Calculate fCharOfsBuf using the elements from fCharBufSize
-    if (fCalculateSrcOfs)
-    {
-        unsigned int last = 0;
-        fCharOfsBuf[0] = 0;
-        for (XMLSize_t index = 1; index < fCharsAvail; ++index) {
-            fCharOfsBuf[index] = last+fCharSizeBuf[index-1];
-            last = fCharOfsBuf[index];
-            // code was:
-            // fCharOfsBuf[index] = fCharOfsBuf[index-1]+fCharSizeBuf[index-1];
-            // but on Solaris 64 bit with sun studio 11 this didn't work as
-            // every value of fCharOfsBuf[] was 1.
-        }
-    }
-
     return (fCharsAvail != 0);
 }
 
@@ -628,6 +913,36 @@ bool XMLReader::refreshCharBuffer()
 // ---------------------------------------------------------------------------
 //  XMLReader: Scanning methods
 // ---------------------------------------------------------------------------
+
+//
+//  Move as many plain (no special handling of any sort required) content
+//  characters as possible from this reader to the supplied destination
+//  buffer.
+//
+//  This is THE hottest performance spot in the parser.
+//
+void XMLReader::movePlainContentChars(XMLBuffer &dest)
+{
+    const XMLSize_t chunkSize = fCharsAvail - fCharIndex;
+    const XMLCh* cursor = &fCharBuf[fCharIndex];
+    XMLSize_t count = 0;
+    while (count < chunkSize)
+    {
+        // Skip the bulk of the run in blocks, then check the char it stopped on
+        count += countPlainContent(cursor + count, chunkSize - count);
+        if ((count == chunkSize) || !(fgCharCharsTable[cursor[count]] & gPlainContentCharMask))
+            break;
+        count++;
+    }
+
+    if (count!=0)
+    {
+        dest.append(&fCharBuf[fCharIndex], count);
+        fCharIndex += count;
+        fCurCol    += (XMLFileLoc)count;
+    }
+}
+
 bool XMLReader::getName(XMLBuffer& toFill, const bool token)
 {
     //  Ok, first lets see if we have chars in the buffer. If not, then lets
@@ -671,6 +986,11 @@ bool XMLReader::getName(XMLBuffer& toFill, const bool token)
     {
         while (fCharIndex < fCharsAvail)
         {
+            // Skip over any run of ASCII name chars in blocks
+            fCharIndex += countNameChars(&fCharBuf[fCharIndex], fCharsAvail - fCharIndex, true);
+            if (fCharIndex == fCharsAvail)
+                break;
+
             //  Check the current char and take it if its a name char. Else
             //  break out.
             if ( (fCharBuf[fCharIndex] >= 0xD800) && (fCharBuf[fCharIndex] <= 0xDB7F) )
@@ -758,6 +1078,8 @@ bool XMLReader::getNCName(XMLBuffer& toFill)
         //  Check the current char and take it if it's a name char
         while(fCharIndex < fCharsAvail)
         {
+            fCharIndex += countNameChars(&fCharBuf[fCharIndex], fCharsAvail - fCharIndex, false);
+            if(fCharIndex == fCharsAvail) break;
             if((fCharBuf[fCharIndex] >= 0xD800) && (fCharBuf[fCharIndex] <= 0xDB7F) && fCharIndex+1 < fCharsAvail && ((fCharBuf[fCharIndex+1] < 0xDC00) || (fCharBuf[fCharIndex+1] > 0xDFFF))) fCharIndex+=2;
             else if(isNCNameChar(fCharBuf[fCharIndex])) fCharIndex++;
             else break;
@@ -817,6 +1139,17 @@ bool XMLReader::getSpaces(XMLBuffer& toFill)
         // Loop through the current chars in the buffer
         while (fCharIndex < fCharsAvail)
         {
+            // Take any run of spaces and tabs in blocks
+            const XMLSize_t blanks = countBlanks(&fCharBuf[fCharIndex], fCharsAvail - fCharIndex);
+            if (blanks)
+            {
+                toFill.append(&fCharBuf[fCharIndex], blanks);
+                fCharIndex += blanks;
+                fCurCol += (XMLFileLoc)blanks;
+                if (fCharIndex == fCharsAvail)
+                    break;
+            }
+
             // Get the current char out of the buffer
             XMLCh curCh = fCharBuf[fCharIndex];
 
@@ -966,6 +1299,17 @@ bool XMLReader::skipSpaces(bool& skippedSomething, bool inDecl)
         // Loop through the current chars in the buffer
         while (fCharIndex < fCharsAvail)
         {
+            // Skip any run of spaces and tabs in blocks
+            const XMLSize_t blanks = countBlanks(&fCharBuf[fCharIndex], fCharsAvail - fCharIndex);
+            if (blanks)
+            {
+                skippedSomething = true;
+                fCharIndex += blanks;
+                fCurCol += (XMLFileLoc)blanks;
+                if (fCharIndex == fCharsAvail)
+                    break;
+            }
+
             //  See if its a white space char. If so, then process it. Else
             //  we've hit a non-space and need to return.
             if (isWhitespace(fCharBuf[fCharIndex]))
@@ -1009,6 +1353,37 @@ bool XMLReader::skipSpaces(bool& skippedSomething, bool inDecl)
     return false;
 }
 
+//
+//  Skips chars until the next one is the one passed, which is left in the
+//  buffer. Returns false if this reader runs out first. This is for skipping
+//  over content as quickly as possible, so it works straight on the buffer,
+//  though it still has to keep the line and column right for later errors.
+//
+bool XMLReader::skipToChar(const XMLCh toSkipTo)
+{
+    do
+    {
+        while (fCharIndex < fCharsAvail)
+        {
+            XMLCh curCh = fCharBuf[fCharIndex];
+            if (curCh == toSkipTo)
+                return true;
+
+            fCharIndex++;
+            if ( curCh & (XMLCh) ~(chCR|chLF|chNEL|chLineSeparator) )
+                fCurCol++;
+            else
+                handleEOL(curCh, false);
+        }
+
+        //  We've eaten up the current buffer, so lets try to reload it. If
+        //  we don't get anything new, then break out.
+    } while(!fNoMore && refreshCharBuffer());
+
+    return false;
+}
+
+
 bool XMLReader::skippedChar(const XMLCh toSkip)
 {
     //
@@ -1087,7 +1462,7 @@ bool XMLReader::skippedSpace()
 
 bool XMLReader::skippedString(const XMLCh* const toSkip)
 {
-    // This function works on strings that are smaller than kCharBufSize.
+    // This function works on strings that are smaller than fCharBufSize.
     // This function guarantees that in case the comparison is unsuccessful
     // the fCharIndex will point to the original data.
     //
@@ -1140,7 +1515,7 @@ bool XMLReader::skippedString(const XMLCh* const toSkip)
 bool XMLReader::skippedStringLong(const XMLCh* toSkip)
 {
     // This function works on strings that are potentially longer than
-    // kCharBufSize (e.g., end tag). This function does not guarantee
+    // fCharBufSize (e.g., end tag). This function does not guarantee
     // that in case the comparison is unsuccessful the fCharIndex will
     // point to the original data.
     //
@@ -1152,7 +1527,7 @@ bool XMLReader::skippedStringLong(const XMLCh* toSkip)
     {
       // Fill up the buffer with as much data as possible.
       //
-      while (charsLeft < srcLen && charsLeft != kCharBufSize)
+      while (charsLeft < srcLen && (fInPlaceEnd || charsLeft != fCharBufSize))
       {
         if (!refreshCharBuffer())
           return false;
@@ -1346,7 +1721,7 @@ bool XMLReader::setEncoding(const XMLCh* const newEncoding)
             (
                 fEncodingStr
                 , failReason
-                , kCharBufSize
+                , fMaxCharBufSize
                 , fMemoryManager
             );
 
@@ -1372,7 +1747,7 @@ bool XMLReader::setEncoding(const XMLCh* const newEncoding)
         (
             newBaseEncoding
             , failReason
-            , kCharBufSize
+            , fMaxCharBufSize
             , fMemoryManager
         );
 
@@ -1392,6 +1767,88 @@ bool XMLReader::setEncoding(const XMLCh* const newEncoding)
 //  XMLReader: Private helper methods
 // ---------------------------------------------------------------------------
 
+//
+//  Allocates the char, char size and raw byte buffers of a stream based
+//  reader as a single block owned by fCharStore, and points the char
+//  buffer at it. If the reader is adaptive, the buffers start out at the
+//  minimum size and may later grow up to the requested size.
+//
+//  If the stream holds all of its content in memory, the raw bytes are
+//  taken from there in place, starting at the stream's current position,
+//  so no raw byte buffer is allocated.
+//
+void XMLReader::allocBuffers(const XMLSize_t bufferSize, const bool adaptiveBuffer)
+{
+    fMaxCharBufSize = (bufferSize < kMinCharBufSize) ? (XMLSize_t)kMinCharBufSize : bufferSize;
+    fCharBufSize = adaptiveBuffer ? (XMLSize_t)kMinCharBufSize : fMaxCharBufSize;
+    fRawBufSize = fCharBufSize * kRawBufRatio;
+
+    XMLSize_t dataSize = 0;
+    const XMLByte* data = fStream->getInMemoryBuffer(dataSize);
+    if (data)
+    {
+        const XMLFilePos streamPos = fStream->curPos();
+        if (streamPos <= dataSize)
+        {
+            fRawByteBuf = data + (XMLSize_t)streamPos;
+            fRawInPlaceEnd = data + dataSize;
+        }
+    }
+
+    fCharStore = (XMLCh*) fMemoryManager->allocate
+    (
+        (fCharBufSize * sizeof(XMLCh)) + fCharBufSize
+        + (fRawInPlaceEnd ? 0 : fRawBufSize)
+    );
+    fCharSizeBuf = (unsigned char*)(fCharStore + fCharBufSize);
+    if (!fRawInPlaceEnd)
+    {
+        fRawStore = (XMLByte*)(fCharSizeBuf + fCharBufSize);
+        fRawByteBuf = fRawStore;
+    }
+    fCharBuf = fCharStore;
+}
+
+
+//
+//  This is called by an adaptive reader when the last read from the stream
+//  filled the raw buffer, which tells us that the source is large. We double
+//  the size of the buffers (up to the maximum) and move over the chars and
+//  raw bytes that have not been used up yet.
+//
+void XMLReader::growBuffers()
+{
+    XMLSize_t newCharSize = fCharBufSize * 2;
+    if (newCharSize > fMaxCharBufSize)
+        newCharSize = fMaxCharBufSize;
+    const XMLSize_t newRawSize = newCharSize * kRawBufRatio;
+
+    XMLCh* newCharStore = (XMLCh*) fMemoryManager->allocate
+    (
+        (newCharSize * sizeof(XMLCh)) + newCharSize
+        + (fRawInPlaceEnd ? 0 : newRawSize)
+    );
+    unsigned char* newCharSizeBuf = (unsigned char*)(newCharStore + newCharSize);
+
+    memcpy(newCharStore, fCharStore, fCharsAvail * sizeof(XMLCh));
+    memcpy(newCharSizeBuf, fCharSizeBuf, fCharsAvail);
+    if (!fRawInPlaceEnd)
+    {
+        XMLByte* newRawStore = (XMLByte*)(newCharSizeBuf + newCharSize);
+        memcpy(newRawStore, fRawByteBuf, fRawBytesAvail);
+        fRawStore = newRawStore;
+        fRawByteBuf = fRawStore;
+    }
+    fMemoryManager->deallocate(fCharStore);
+
+    fCharStore = newCharStore;
+    fCharSizeBuf = newCharSizeBuf;
+    fCharBuf = fCharStore;
+    fCharBufSize = newCharSize;
+    fRawBufSize = newRawSize;
+}
+
+
 //
 //  This is called when the encoding flag is set and just sets the fSwapped
 //  flag appropriately.
@@ -1436,13 +1893,11 @@ void XMLReader::doInitDecode()
         case XMLRecognizer::UCS_4B :
         case XMLRecognizer::UCS_4L :
         {
-            // Remove bom if any
+            // Remove bom if any, by stepping the raw buffer past it
             if (((fRawByteBuf[0] == 0x00) && (fRawByteBuf[1] == 0x00) && (fRawByteBuf[2] == 0xFE) && (fRawByteBuf[3] == 0xFF)) ||
                 ((fRawByteBuf[0] == 0xFF) && (fRawByteBuf[1] == 0xFE) && (fRawByteBuf[2] == 0x00) && (fRawByteBuf[3] == 0x00))  )
             {
-                for (XMLSize_t i = 0; i < fRawBytesAvail; i++)
-                    fRawByteBuf[i] = fRawByteBuf[i+4];
-
+                fRawByteBuf += 4;
                 fRawBytesAvail -=4;
             }
 
@@ -1469,7 +1924,7 @@ void XMLReader::doInitDecode()
 
                 // Make sure we don't exhaust the limited prolog buffer size.
                 // Leave room for a space added at the end of this function.
-                if (fCharsAvail == kCharBufSize - 1) {
+                if (fCharsAvail == fCharBufSize - 1) {
                     fCharsAvail = 0;
                     fRawBufIndex = 0;
                     fMemoryManager->deallocate(fPublicId);
@@ -1511,7 +1966,7 @@ void XMLReader::doInitDecode()
 
                 // Convert the value to an XML char and store it
                 fCharSizeBuf[fCharsAvail] = 4;
-                fCharBuf[fCharsAvail++] = XMLCh(curVal);
+                fCharStore[fCharsAvail++] = XMLCh(curVal);
 
                 // Break out on the > character
                 if (curVal == chCloseAngle)
@@ -1562,7 +2017,7 @@ void XMLReader::doInitDecode()
 
                 // Make sure we don't exhaust the limited prolog buffer size.
                 // Leave room for a space added at the end of this function.
-                if (fCharsAvail == kCharBufSize - 1) {
+                if (fCharsAvail == fCharBufSize - 1) {
                     fCharsAvail = 0;
                     fRawBufIndex = 0;
                     fMemoryManager->deallocate(fPublicId);
@@ -1579,7 +2034,7 @@ void XMLReader::doInitDecode()
 
                 // Looks ok, so store it
                 fCharSizeBuf[fCharsAvail] = 1;
-                fCharBuf[fCharsAvail++] = XMLCh(curCh);
+                fCharStore[fCharsAvail++] = XMLCh(curCh);
 
                 // Break out on a > character
                 if (curCh == chCloseAngle)
@@ -1678,7 +2133,7 @@ void XMLReader::doInitDecode()
 
                 // Make sure we don't exhaust the limited prolog buffer size.
                 // Leave room for a space added at the end of this function.
-                if (fCharsAvail == kCharBufSize - 1) {
+                if (fCharsAvail == fCharBufSize - 1) {
                     fCharsAvail = 0;
                     fRawBufIndex = 0;
                     fMemoryManager->deallocate(fPublicId);
@@ -1706,7 +2161,7 @@ void XMLReader::doInitDecode()
                 //  if UTF16Ch and XMLCh are not the same size.
                 //
                 fCharSizeBuf[fCharsAvail] = 2;
-                fCharBuf[fCharsAvail++] = curVal;
+                fCharStore[fCharsAvail++] = curVal;
 
                 // Break out on a > char
                 if (curVal == chCloseAngle)
@@ -1730,7 +2185,7 @@ void XMLReader::doInitDecode()
 
                 // Make sure we don't exhaust the limited prolog buffer size.
                 // Leave room for a space added at the end of this function.
-                if (fCharsAvail == kCharBufSize - 1) {
+                if (fCharsAvail == fCharBufSize - 1) {
                     fCharsAvail = 0;
                     fRawBufIndex = 0;
                     fMemoryManager->deallocate(fPublicId);
@@ -1751,7 +2206,7 @@ void XMLReader::doInitDecode()
                 //  look like it was normally transcoded.
                 //
                 fCharSizeBuf[fCharsAvail] = 1;
-                fCharBuf[fCharsAvail++] = chCur;
+                fCharStore[fCharsAvail++] = chCur;
 
                 // If its a > char, then break out
                 if (chCur == chCloseAngle)
@@ -1780,23 +2235,23 @@ void XMLReader::doInitDecode()
     //  is required by XML.
     //
     if ((fType == Type_PE) && (fRefFrom == RefFrom_NonLiteral))
-        fCharBuf[fCharsAvail++] = chSpace;
-
-    //  Calculate fCharOfsBuf buffer using the elements from fCharBufSize
-    if (fCalculateSrcOfs)
     {
-        fCharOfsBuf[0] = 0;
-        for (XMLSize_t index = 1; index < fCharsAvail; ++index) {
-            fCharOfsBuf[index] = fCharOfsBuf[index-1]+fCharSizeBuf[index-1];
-        }
+        // This represents no data from the source
+        fCharSizeBuf[fCharsAvail] = 0;
+        fCharStore[fCharsAvail++] = chSpace;
     }
+
+    // And remember where in the source the decoded chars end
+    for (XMLSize_t index = 0; index < fCharsAvail; index++)
+        fSrcOfsEnd += fCharSizeBuf[index];
 }
 
 
 //
 //  This method is called internally when we run out of bytes in the raw
 //  buffer. We just read as many bytes as we can into the raw buffer again
-//  and store the number of bytes we got.
+//  and store the number of bytes we got. If the raw bytes are taken in
+//  place, we just move the window along the stream's buffer instead.
 //
 void XMLReader::refreshRawBuffer()
 {
@@ -1811,6 +2266,15 @@ void XMLReader::refreshRawBuffer()
         );
     }
 
+    if (fRawInPlaceEnd)
+    {
+        fRawByteBuf += fRawBufIndex;
+        const XMLSize_t bytesLeft = fRawInPlaceEnd - fRawByteBuf;
+        fRawBytesAvail = (bytesLeft < fRawBufSize) ? bytesLeft : fRawBufSize;
+        fRawBufIndex = 0;
+        return;
+    }
+
     //
     //  If there are any bytes left, move them down to the start. There
     //  should only ever be (max bytes per char - 1) at the most.
@@ -1819,7 +2283,8 @@ void XMLReader::refreshRawBuffer()
 
     // Move the existing ones down
     for (XMLSize_t index = 0; index < bytesLeft; index++)
-        fRawByteBuf[index] = fRawByteBuf[fRawBufIndex + index];
+        fRawStore[index] = fRawByteBuf[fRawBufIndex + index];
+    fRawByteBuf = fRawStore;
 
     //
     //  And then read into the buffer past the existing bytes. Add back in
@@ -1828,7 +2293,7 @@ void XMLReader::refreshRawBuffer()
     //
     fRawBytesAvail = fStream->readBytes
     (
-        &fRawByteBuf[bytesLeft], kRawBufSize - bytesLeft
+        &fRawStore[bytesLeft], fRawBufSize - bytesLeft
     ) + bytesLeft;
 
     //
@@ -1839,6 +2304,97 @@ void XMLReader::refreshRawBuffer()
 }
 
 
+//
+//  This method is called when the character buffer is about to be refreshed
+//  and moves the base source offset up to the first of the spare chars left
+//  in it, which is where the source offset of the new buffer starts. It
+//  also resets the getSrcOffset() position to that new base.
+//
+void XMLReader::setSrcOfsBase(const XMLSize_t spareChars)
+{
+    XMLFilePos spareBytes = 0;
+    for (XMLSize_t index = fCharsAvail - spareChars; index < fCharsAvail; index++)
+        spareBytes += fCharSizeBuf[index];
+
+    fSrcOfsBase = fSrcOfsEnd - spareBytes;
+    fSrcOfsIndex = 0;
+    fSrcOfsCur = fSrcOfsBase;
+}
+
+
+//
+//  This method is called when the character buffer is refreshed, once the
+//  final transcoder is known. If the source is UTF-16 in our native byte
+//  order (or already internalized XMLCh data) and the stream holds all of
+//  it in memory, then transcoding would only be a copy. So we point
+//  fCharBuf at the current char's position in the stream's buffer and
+//  never transcode (or track char sizes) again. The chars left in
+//  fCharStore were all decoded from the source bytes just preceding the
+//  raw buffer's current position, which is already in the stream's buffer
+//  since the raw bytes are taken in place. Returns true if we switched over.
+//
+bool XMLReader::startInPlaceScan(const XMLSize_t spareChars)
+{
+    if (((fEncoding != XMLRecognizer::UTF_16L)
+      && (fEncoding != XMLRecognizer::UTF_16B)
+      && (fEncoding != XMLRecognizer::XERCES_XMLCH))
+    ||  fSwapped
+    ||  (sizeof(XMLCh) != sizeof(UTF16Ch))
+    ||  ((fType == Type_PE) && (fRefFrom == RefFrom_NonLiteral)))
+    {
+        return false;
+    }
+
+    if (!fRawInPlaceEnd)
+        return false;
+
+    // Work out where the first spare char came from in the source
+    XMLSize_t dataSize = 0;
+    const XMLByte* data = fStream->getInMemoryBuffer(dataSize);
+    const XMLByte* startPtr = fRawByteBuf + fRawBufIndex;
+    const XMLSize_t spareBytes = spareChars * sizeof(XMLCh);
+    if ((XMLSize_t)(startPtr - data) < spareBytes)
+        return false;
+
+    startPtr -= spareBytes;
+    if (reinterpret_cast<XMLSize_t>(startPtr) % sizeof(XMLCh))
+        return false;
+
+    // Account for the chars eaten so far, as refreshCharBuffer() would
+    setSrcOfsBase(spareChars);
+
+    const XMLSize_t charCount = (fRawInPlaceEnd - startPtr) / sizeof(XMLCh);
+    fCharBuf = reinterpret_cast<const XMLCh*>(startPtr);
+    fInPlaceEnd = fCharBuf + charCount;
+    fCharIndex = 0;
+    fCharsAvail = charCount;
+    fRawBufIndex = 0;
+    fRawBytesAvail = 0;
+
+    if (!fCharsAvail)
+        endInPlaceScan();
+    return true;
+}
+
+
+//
+//  This method is called when an in place scan has used up all of its
+//  chars. If the source had an odd number of bytes, its last byte is not
+//  part of any char, so the source was cut short. That is reported as it
+//  is when transcoding.
+//
+void XMLReader::endInPlaceScan()
+{
+    fNoMore = true;
+
+    if (fRawInPlaceEnd
+    &&  (fRawInPlaceEnd != reinterpret_cast<const XMLByte*>(fInPlaceEnd)))
+    {
+        ThrowXMLwithMemMgr(UnexpectedEOFException, XMLExcepts::Gen_UnexpectedEOF, fMemoryManager);
+    }
+}
+
+
 //
 //  This method is called internally when we run out of characters in the
 //  trancoded character buffer. We transcode up to another maxChars chars
@@ -1864,11 +2420,19 @@ XMLReader::xcodeMoreChars(          XMLCh* const            bufToFill
             refreshRawBuffer();
 
             // If there are no characters or if we need more but didn't get
-            // any, return zero now.
+            // any, return zero now. If there was room for a surrogate pair,
+            // then the transcoder only needed more because the source ends
+            // part way through a char, so it was cut short.
             //
-            if (fRawBytesAvail == 0 ||
-                (needMode && (bytesLeft == fRawBytesAvail - fRawBufIndex)))
+            if (fRawBytesAvail == 0)
+                return 0;
+
+            if (needMode && (bytesLeft == fRawBytesAvail - fRawBufIndex))
+            {
+                if (maxChars > 1)
+                    ThrowXMLwithMemMgr(UnexpectedEOFException, XMLExcepts::Gen_UnexpectedEOF, fMemoryManager);
                 return 0;
+            }
         }
 
         // Ask the transcoder to internalize another batch of chars. It is
@@ -1893,7 +2457,10 @@ XMLReader::xcodeMoreChars(          XMLCh* const            bufToFill
         if (bytesEaten == 0)
             needMode = true;
         else
+        {
             fRawBufIndex += bytesEaten;
+            fSrcOfsEnd += bytesEaten;
+        }
     }
 
     return charsDone;
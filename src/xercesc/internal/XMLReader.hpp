@@ -81,6 +81,35 @@ public:
         , XMLV_Unknown
     };
 
+    // -----------------------------------------------------------------------
+    //  Class Constants
+    //
+    //  kDefaultCharBufSize
+    //      The default size of the character spool buffer that we use. Its
+    //      not terribly large because its just getting filled with data from
+    //      a raw byte buffer as we go along. We don't want to decode all the
+    //      text at once before we find out that there is an error.
+    //
+    //  kMinCharBufSize
+    //      The smallest character buffer we will use. Smaller requested
+    //      sizes are rounded up to it. Adaptive readers start out with a
+    //      buffer of this size.
+    //
+    //      NOTE: These are sizes in characters, not bytes.
+    //
+    //  kRawBufRatio
+    //      The raw buffer from which raw bytes are spooled out as we
+    //      transcode chunks of data is this many bytes per char in the
+    //      character buffer. As it is emptied, it is filled back in again
+    //      from the source stream.
+    // -----------------------------------------------------------------------
+    enum Constants
+    {
+        kDefaultCharBufSize = 16 * 1024
+        , kMinCharBufSize   = 1024
+        , kRawBufRatio      = 3
+    };
+
 
     // -----------------------------------------------------------------------
     //  Public, query methods
@@ -125,6 +154,8 @@ public:
         , const bool                  calculateSrcOfs = true
         ,       XMLSize_t             lowWaterMark = 100
         , const XMLVersion            xmlVersion = XMLV1_0
+        , const XMLSize_t             bufferSize = kDefaultCharBufSize
+        , const bool                  adaptiveBuffer = false
         ,       MemoryManager* const  manager = XMLPlatformUtils::fgMemoryManager
     );
 
@@ -141,6 +172,8 @@ public:
         , const bool                  calculateSrcOfs = true
         ,       XMLSize_t             lowWaterMark = 100
         , const XMLVersion            xmlVersion = XMLV1_0
+        , const XMLSize_t             bufferSize = kDefaultCharBufSize
+        , const bool                  adaptiveBuffer = false
         ,       MemoryManager* const  manager = XMLPlatformUtils::fgMemoryManager
     );
 
@@ -157,6 +190,20 @@ public:
         , const bool                  calculateSrcOfs = true
         ,       XMLSize_t             lowWaterMark = 100
         , const XMLVersion            xmlVersion = XMLV1_0
+        , const XMLSize_t             bufferSize = kDefaultCharBufSize
+        , const bool                  adaptiveBuffer = false
+        ,       MemoryManager* const  manager = XMLPlatformUtils::fgMemoryManager
+    );
+
+    XMLReader
+    (
+        const   XMLCh* const          sysId
+        , const XMLCh* const          dataBuf
+        , const XMLSize_t             dataLen
+        , const RefFrom               from
+        , const Types                 type
+        , const bool                  calculateSrcOfs = true
+        , const XMLVersion            xmlVersion = XMLV1_0
         ,       MemoryManager* const  manager = XMLPlatformUtils::fgMemoryManager
     );
 
@@ -184,6 +231,7 @@ public:
     bool peekNextChar(XMLCh& chGotten);
     bool skipIfQuote(XMLCh& chGotten);
     bool skipSpaces(bool& skippedSomething, bool inDecl = false);
+    bool skipToChar(const XMLCh toSkipTo);
     bool skippedChar(const XMLCh toSkip);
     bool skippedSpace();
     bool skippedString(const XMLCh* const toSkip);
@@ -203,6 +251,7 @@ public:
     RefFrom getRefFrom() const;
     Sources getSource() const;
     XMLFilePos getSrcOffset() const;
+    bool getSrcOfsSupported() const;
     const XMLCh* getSystemId() const;
     bool getThrowAtEnd() const;
     Types getType() const;
@@ -227,32 +276,13 @@ private:
     XMLReader(const XMLReader&);
     XMLReader& operator=(const XMLReader&);
 
-    // ---------------------------------------------------------------------------
-    //  Class Constants
-    //
-    //  kCharBufSize
-    //      The size of the character spool buffer that we use. Its not terribly
-    //      large because its just getting filled with data from a raw byte
-    //      buffer as we go along. We don't want to decode all the text at
-    //      once before we find out that there is an error.
-    //
-    //      NOTE: This is a size in characters, not bytes.
-    //
-    //  kRawBufSize
-    //      The size of the raw buffer from which raw bytes are spooled out
-    //      as we transcode chunks of data. As it is emptied, it is filled back
-    //      in again from the source stream.
-    // ---------------------------------------------------------------------------
-    enum Constants
-    {
-        kCharBufSize        = 16 * 1024
-        , kRawBufSize       = 48 * 1024
-    };
-
-
     // -----------------------------------------------------------------------
     //  Private helper methods
     // -----------------------------------------------------------------------
+    void allocBuffers(const XMLSize_t bufferSize, const bool adaptiveBuffer);
+
+    void growBuffers();
+
     void checkForSwapped();
 
     void doInitCharSizeChecks();
@@ -266,6 +296,11 @@ private:
 
     void refreshRawBuffer();
 
+    void setSrcOfsBase(const XMLSize_t spareChars);
+
+    bool startInPlaceScan(const XMLSize_t spareChars);
+    void endInPlaceScan();
+
     void setTranscoder
     (
         const   XMLCh* const    newEncoding
@@ -292,8 +327,21 @@ private:
     //      then its time to refill.
     //
     //  fCharBuf
-    //      A buffer that the reader manager fills up with transcoded
-    //      characters a small amount at a time.
+    //      The characters that are being scanned. Normally this points at
+    //      fCharStore, which the reader manager fills up with transcoded
+    //      characters a small amount at a time. When scanning in place (see
+    //      fInPlaceEnd) it points straight into the stream's own buffer.
+    //
+    //  fCharStore
+    //      The buffer that holds the transcoded characters, unless we are
+    //      scanning in place. It is allocated together with fCharSizeBuf
+    //      and fRawStore in a single block, and not at all by a reader
+    //      over an internal entity's value, which only ever scans in place.
+    //
+    //  fCharBufSize
+    //  fRawBufSize
+    //      The current sizes of the character buffer (in chars) and of the
+    //      raw byte buffer (in bytes).
     //
     //  fCharsAvail
     //      The characters currently available in the character buffer.
@@ -305,11 +353,6 @@ private:
     //      to make the internalized char fCharBuf[x]. This only contains
     //      useful data if fSrcOfsSupported is true.
     //
-    //  fCharOfsBuf
-    //      This buffer is an array that contains the offset in the
-    //      fRawByteBuf buffer of each char in the fCharBuf buffer. It
-    //      only contains useful data if fSrcOfsSupported is true.
-    //
     //  fCurCol
     //  fCurLine
     //      The current line and column that we are in within this reader's
@@ -327,6 +370,16 @@ private:
     //      seen by the scanner. It can also be forced to a particular
     //      encoding, in which case fForcedEncoding is set.
     //
+    //  fInPlaceEnd
+    //      If the source is UTF-16 in our native byte order (or internalized
+    //      XMLCh data) and the stream holds all of it in memory, there is
+    //      nothing to transcode, so we scan the stream's buffer directly
+    //      (see fRawInPlaceEnd). In that case this is the end
+    //      of that buffer, fCharBuf is a window into it, and no per char
+    //      sizes or offsets are kept since every char is one UTF-16 unit.
+    //      Otherwise it is zero. A reader over an internal entity's value
+    //      is created in this mode, and then has no stream or transcoder.
+    //
     //  fForcedEncoding
     //      If the encoding if forced then this is set and all other
     //      information will be ignored. This encoding will be taken as
@@ -342,7 +395,21 @@ private:
     //
     //  fRawByteBuf
     //      This is the raw byte buffer that is used to spool out bytes
-    //      from into the fCharBuf buffer, as we transcode in blocks.
+    //      from into the fCharBuf buffer, as we transcode in blocks. It
+    //      points at fRawStore, unless the raw bytes are taken in place
+    //      (see fRawInPlaceEnd).
+    //
+    //  fRawInPlaceEnd
+    //      If the stream holds all of its content in memory (a memory
+    //      buffer or a memory mapped file), we don't copy it into fRawStore
+    //      but transcode straight from it. In that case this is the end of
+    //      the stream's buffer and fRawByteBuf is a window of at most
+    //      fRawBufSize bytes into it, which refreshRawBuffer() just slides
+    //      along. Otherwise it is zero.
+    //
+    //  fRawStore
+    //      The buffer that raw bytes are read into from the stream. It is
+    //      not allocated if fRawInPlaceEnd is set.
     //
     //  fRawBytesAvail
     //      The number of bytes currently available in the raw buffer. This
@@ -352,6 +419,12 @@ private:
     //  fLowWaterMark
     //      The low water mark for the raw byte buffer.
     //
+    //  fMaxCharBufSize
+    //      The size up to which the buffers may grow. It is the same as
+    //      fCharBufSize unless the reader is adaptive, in which case the
+    //      buffers start out small and are doubled each time a read from
+    //      the stream fills the raw buffer, until they reach this size.
+    //
     //
     //  fReaderNum
     //      Each reader from a particular reader manager (which means from a
@@ -390,6 +463,20 @@ private:
     //      This is the base offset within the source of this entity. Values
     //      in the curent fCharSizeBuf array are relative to this value.
     //
+    //  fSrcOfsEnd
+    //      The offset within the source just past the last char in the
+    //      fCharBuf buffer. This is maintained from the byte counts of each
+    //      transcoding pass, so that the new base offset on a refresh can
+    //      be found from the few spare chars instead of all eaten ones.
+    //
+    //  fSrcOfsIndex
+    //  fSrcOfsCur
+    //      The char index and source offset of the last getSrcOffset()
+    //      request. Offsets are only worked out on demand, by adding up the
+    //      char sizes from this point on, so a run of requests costs no more
+    //      than a single pass over the buffer. They are reset to the start
+    //      of the buffer on each refresh.
+    //
     //  fSrcOfsSupported
     //      This flag is set to indicate whether source byte offset info
     //      is supported. For intrinsic encodings, its always set since we
@@ -435,26 +522,35 @@ private:
     //      Enum to indicate if this Reader is conforming to XML 1.0 or XML 1.1
     // -----------------------------------------------------------------------
     XMLSize_t                   fCharIndex;
-    XMLCh                       fCharBuf[kCharBufSize];
+    const XMLCh*                fCharBuf;
+    XMLCh*                      fCharStore;
+    XMLSize_t                   fCharBufSize;
     XMLSize_t                   fCharsAvail;
-    unsigned char               fCharSizeBuf[kCharBufSize];
-    unsigned int                fCharOfsBuf[kCharBufSize];
+    unsigned char*              fCharSizeBuf;
     XMLFileLoc                  fCurCol;
     XMLFileLoc                  fCurLine;
     XMLRecognizer::Encodings    fEncoding;
     XMLCh*                      fEncodingStr;
     bool                        fForcedEncoding;
+    const XMLCh*                fInPlaceEnd;
     bool                        fNoMore;
     XMLCh*                      fPublicId;
     XMLSize_t                   fRawBufIndex;
-    XMLByte                     fRawByteBuf[kRawBufSize];
+    const XMLByte*              fRawByteBuf;
+    const XMLByte*              fRawInPlaceEnd;
+    XMLByte*                    fRawStore;
+    XMLSize_t                   fRawBufSize;
     XMLSize_t                   fRawBytesAvail;
     XMLSize_t                   fLowWaterMark;
+    XMLSize_t                   fMaxCharBufSize;
     XMLSize_t                   fReaderNum;
     RefFrom                     fRefFrom;
     bool                        fSentTrailingSpace;
     Sources                     fSource;
     XMLFilePos                  fSrcOfsBase;
+    XMLFilePos                  fSrcOfsEnd;
+    mutable XMLSize_t           fSrcOfsIndex;
+    mutable XMLFilePos          fSrcOfsCur;
     bool                        fSrcOfsSupported;
     bool                        fCalculateSrcOfs;
     XMLCh*                      fSystemId;
@@ -578,6 +674,11 @@ inline XMLReader::Sources XMLReader::getSource() const
     return fSource;
 }
 
+inline bool XMLReader::getSrcOfsSupported() const
+{
+    return fSrcOfsSupported && fCalculateSrcOfs;
+}
+
 inline const XMLCh* XMLReader::getSystemId() const
 {
     return fSystemId;
@@ -622,32 +723,6 @@ inline void XMLReader::setXMLVersion(const XMLVersion version)
 
 
 
-// ---------------------------------------------------------------------------
-//
-//  XMLReader: movePlainContentChars()
-//
-//       Move as many plain (no special handling of any sort required) content
-//       characters as possible from this reader to the supplied destination buffer.
-//
-//       This is THE hottest performance spot in the parser.
-//
-// ---------------------------------------------------------------------------
-inline void XMLReader::movePlainContentChars(XMLBuffer &dest)
-{
-    const XMLSize_t chunkSize = fCharsAvail - fCharIndex;
-    const XMLCh* cursor = &fCharBuf[fCharIndex];
-    XMLSize_t count=0;
-    for(;count<chunkSize && (fgCharCharsTable[*cursor++] & gPlainContentCharMask) != 0;++count) /*noop*/ ;
-
-    if (count!=0)
-    {
-        dest.append(&fCharBuf[fCharIndex], count);
-        fCharIndex += count;
-        fCurCol    += (XMLFileLoc)count;
-    }
-}
-
-
 // ---------------------------------------------------------------------------
 //  XMLReader: getNextCharIfNot() method inlined for speed
 // ---------------------------------------------------------------------------
@@ -38,6 +38,7 @@
 #include <xercesc/framework/XMLPScanToken.hpp>
 #include <xercesc/framework/XMLValidator.hpp>
 #include <xercesc/internal/EndOfEntityException.hpp>
+#include <xercesc/internal/PushInputSource.hpp>
 #include <xercesc/validators/DTD/DocTypeHandler.hpp>
 #include <xercesc/validators/common/GrammarResolver.hpp>
 #include <xercesc/util/OutOfMemoryException.hpp>
@@ -91,6 +92,10 @@ XMLScanner::XMLScanner(XMLValidator* const valToAdopt,
     , fExitOnFirstFatal(true)
     , fValidationConstraintFatal(false)
     , fInException(false)
+    , fSkipLevel(0)
+    , fPushSource(0)
+    , fHandlerSkipRequested(false)
+    , fHandlerSkipDepth(0)
     , fStandalone(false)
     , fHasNoDTD(true)
     , fValidate(false)
@@ -193,6 +198,10 @@ XMLScanner::XMLScanner( XMLDocumentHandler* const  docHandler
     , fExitOnFirstFatal(true)
     , fValidationConstraintFatal(false)
     , fInException(false)
+    , fSkipLevel(0)
+    , fPushSource(0)
+    , fHandlerSkipRequested(false)
+    , fHandlerSkipDepth(0)
     , fStandalone(false)
     , fHasNoDTD(true)
     , fValidate(false)
@@ -648,6 +657,55 @@ void XMLScanner::scanReset(XMLPScanToken& token)
     fErrorCount = 0;
 }
 
+//
+//  This can be called from the startElement() callback of an element, to
+//  have its content skipped. The next token that the scanner returns will
+//  be the element's end tag, which is handled as usual. If the element
+//  turns out to be empty, nothing is skipped. Returns false if the scanner
+//  can't do this, because it is validating and so has to see the content,
+//  in which case it is scanned as usual and it is up to the caller to
+//  ignore it.
+//
+bool XMLScanner::skipCurrentElement()
+{
+    if (fValidate)
+        return false;
+
+    fSkipLevel = fElemStack.getLevel();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+//  XMLScanner: Push parsing methods
+// ---------------------------------------------------------------------------
+void XMLScanner::pushBytes(const XMLByte* const bytes, const XMLSize_t count)
+{
+    if (!fPushSource)
+        fPushSource = new (fMemoryManager) PushInputSource(fMemoryManager);
+
+    fPushSource->appendBytes(bytes, count);
+    fPushSource->scanAvailable(this);
+}
+
+void XMLScanner::pushEndOfInput()
+{
+    if (!fPushSource)
+        fPushSource = new (fMemoryManager) PushInputSource(fMemoryManager);
+
+    fPushSource->setEndOfInput();
+    fPushSource->scanAvailable(this);
+}
+
+void XMLScanner::endPush()
+{
+    if (fPushSource)
+    {
+        fPushSource->endScan(this);
+        delete fPushSource;
+        fPushSource = 0;
+    }
+}
+
 void XMLScanner::setParseSettings(XMLScanner* const refScanner)
 {
     setDocHandler(refScanner->getDocHandler());
@@ -659,6 +717,9 @@ void XMLScanner::setParseSettings(XMLScanner* const refScanner)
     setDoSchema(refScanner->getDoSchema());
     setCalculateSrcOfs(refScanner->getCalculateSrcOfs());
     setStandardUriConformant(refScanner->getStandardUriConformant());
+    setReaderBufferSize(refScanner->getReaderBufferSize());
+    setAdaptiveReaderBuffer(refScanner->getAdaptiveReaderBuffer());
+    setReadAhead(refScanner->getReadAhead());
     setExitOnFirstFatal(refScanner->getExitOnFirstFatal());
     setValidationConstraintFatal(refScanner->getValidationConstraintFatal());
     setIdentityConstraintChecking(refScanner->getIdentityConstraintChecking());
@@ -697,6 +758,7 @@ void XMLScanner::commonInit()
     //  during start tag processing. Give it a reasonable initial size that
     //  will serve for most folks, though it will grow as required.
     fAttrList = new (fMemoryManager) RefVectorOf<XMLAttr>(32, true, fMemoryManager);
+    fAttrDupChkRegistry = new (fMemoryManager) AttrNameSet(fMemoryManager);
 
     //  Create the id ref list. This is used to enforce XML 1.0 ID ref
     //  semantics, i.e. all id refs must refer to elements that exist
@@ -724,6 +786,7 @@ void XMLScanner::commonInit()
 
 void XMLScanner::cleanUp()
 {
+    delete fPushSource;
     delete fAttrList;
     delete fAttrDupChkRegistry;
     delete fValidationContext;
@@ -1885,6 +1948,17 @@ bool XMLScanner::isLegalToken(const XMLPScanToken& toCheck)
 //  chars are required to figure out what is next.
 XMLScanner::XMLTokens XMLScanner::senseNextToken(XMLSize_t& orgReader)
 {
+    //  If the content of the element just started is to be skipped, then
+    //  we go straight to its end tag. If the element was empty, it has
+    //  already been popped, and there is nothing to skip.
+    if (fSkipLevel)
+    {
+        const bool isOpen = (fSkipLevel == fElemStack.getLevel());
+        fSkipLevel = 0;
+        if (isOpen && skipElementContent(orgReader))
+            return Token_EndTag;
+    }
+
     //  Get the next character and use it to guesstimate what the next token
     //  is going to be. We turn on end of entity exceptions when we do this
     //  in order to catch the scenario where the current entity ended at
@@ -1958,6 +2032,108 @@ XMLScanner::XMLTokens XMLScanner::senseNextToken(XMLSize_t& orgReader)
     return Token_StartTag;
 }
 
+//  This skips the content of an element, for senseNextToken(), leaving the
+//  reader just after the '</' of its end tag. All it does is count the start
+//  and end tags, so it only has to look at the markup. Comments, PIs, CDATA
+//  sections and quoted attribute values are skipped over whole, so that no
+//  '<' or '>' inside them is taken for markup. Entity references are not
+//  expanded, since a well-formed entity has balanced tags anyway. Nothing
+//  else is checked, and no errors are emitted. Returns false if the input
+//  ends first.
+bool XMLScanner::skipElementContent(XMLSize_t& orgReader)
+{
+    static const XMLCh gCDATAStr[] =
+    {
+            chBang, chOpenSquare, chLatin_C, chLatin_D, chLatin_A
+        ,   chLatin_T, chLatin_A, chOpenSquare, chNull
+    };
+
+    static const XMLCh gCDATAEndStr[] =
+    {
+        chCloseSquare, chCloseSquare, chCloseAngle, chNull
+    };
+
+    static const XMLCh gCommentStr[] =
+    {
+        chBang, chDash, chDash, chNull
+    };
+
+    static const XMLCh gCommentEndStr[] =
+    {
+        chDash, chDash, chCloseAngle, chNull
+    };
+
+    static const XMLCh gPIEndStr[] =
+    {
+        chQuestion, chCloseAngle, chNull
+    };
+
+    XMLSize_t depth = 0;
+    while (true)
+    {
+        if (!fReaderMgr.skipUpToChar(chOpenAngle))
+            return false;
+
+        fReaderMgr.getNextChar();
+        orgReader = fReaderMgr.getCurrentReaderNum();
+
+        // Work out what sort of markup it is and where it ends
+        const XMLCh* endStr = 0;
+        if (fReaderMgr.skippedChar(chForwardSlash))
+        {
+            if (!depth)
+                return true;
+
+            depth--;
+            fReaderMgr.skipPastChar(chCloseAngle);
+            continue;
+        }
+        else if (fReaderMgr.skippedChar(chQuestion))
+        {
+            endStr = gPIEndStr;
+        }
+        else if (fReaderMgr.skippedString(gCommentStr))
+        {
+            endStr = gCommentEndStr;
+        }
+        else if (fReaderMgr.skippedString(gCDATAStr))
+        {
+            endStr = gCDATAEndStr;
+        }
+
+        if (endStr)
+        {
+            // Move from one possible start of the terminator to the next
+            while (true)
+            {
+                if (!fReaderMgr.skipUpToChar(*endStr))
+                    return false;
+                if (fReaderMgr.skippedString(endStr))
+                    break;
+                fReaderMgr.getNextChar();
+            }
+            continue;
+        }
+
+        //  It's a start tag (or junk, which is as good as we're going to
+        //  check it.) It's empty if the last thing before the '>' is a '/'.
+        XMLCh lastCh = 0;
+        XMLCh nextCh;
+        while ((nextCh = fReaderMgr.getNextChar()) != chCloseAngle)
+        {
+            if (!nextCh)
+                return false;
+
+            if ((nextCh == chDoubleQuote) || (nextCh == chSingleQuote))
+                fReaderMgr.skipQuotedString(nextCh);
+            lastCh = nextCh;
+        }
+
+        if (lastCh != chForwardSlash)
+            depth++;
+    }
+}
+
 // ---------------------------------------------------------------------------
 //  XMLScanner: Private parsing methods
 // ---------------------------------------------------------------------------
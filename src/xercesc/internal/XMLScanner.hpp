@@ -31,6 +31,7 @@
 #include <xercesc/util/SecurityManager.hpp>
 #include <xercesc/internal/ReaderMgr.hpp>
 #include <xercesc/internal/ElemStack.hpp>
+#include <xercesc/internal/AttrNameSet.hpp>
 #include <xercesc/validators/DTD/DTDEntityDecl.hpp>
 #include <xercesc/framework/XMLAttr.hpp>
 #include <xercesc/framework/ValidationContext.hpp>
@@ -49,6 +50,7 @@ class Grammar;
 class XMLValidator;
 class MemoryManager;
 class PSVIHandler;
+class PushInputSource;
 
 
 struct PSVIElemContext
@@ -250,6 +252,7 @@ public :
     ) const;*/
     const Locator* getLocator() const;
     const ReaderMgr* getReaderMgr() const;
+    const XMLBufferMgr* getBufferMgr() const;
     XMLFilePos getSrcOffset() const;
     bool getStandalone() const;
     const XMLValidator* getValidator() const;
@@ -279,6 +282,9 @@ public :
     // getProperty.
     //
     const XMLSize_t& getLowWaterMark() const;
+    const XMLSize_t& getReaderBufferSize() const;
+    bool getAdaptiveReaderBuffer() const;
+    bool getReadAhead() const;
 
     bool getGenerateSyntheticAnnotations() const;
     bool getValidateAnnotations() const;
@@ -385,6 +391,9 @@ public :
     void setStandardUriConformant(const bool newValue);
     void setInputBufferSize(const XMLSize_t bufferSize);
     void setLowWaterMark(XMLSize_t newValue);
+    void setReaderBufferSize(const XMLSize_t newValue);
+    void setAdaptiveReaderBuffer(const bool newValue);
+    void setReadAhead(const bool newValue);
 
     void setGenerateSyntheticAnnotations(const bool newValue);
     void setValidateAnnotations(const bool newValue);
@@ -432,6 +441,37 @@ public :
 
     void scanReset(XMLPScanToken& toFill);
 
+    bool skipCurrentElement();
+
+    // -----------------------------------------------------------------------
+    //  Push parsing methods
+    //
+    //  pushBytes() and pushEndOfInput() hand the document to the scanner a
+    //  chunk at a time, the first call starting the parse. endPush() ends
+    //  the parse, whether or not the end of input was reached.
+    // -----------------------------------------------------------------------
+    void pushBytes
+    (
+        const   XMLByte* const  bytes
+        , const XMLSize_t       count
+    );
+    void pushEndOfInput();
+    void endPush();
+    bool isPushing() const;
+
+    // -----------------------------------------------------------------------
+    //  Handler skip state
+    //
+    //  Kept here for the parser that reports our events, when its handler
+    //  asks for the content of an element to be skipped: whether that was
+    //  asked from the current start tag callback, and the depth of the
+    //  element whose content is not being reported, or zero.
+    // -----------------------------------------------------------------------
+    bool getHandlerSkipRequested() const;
+    XMLSize_t getHandlerSkipDepth() const;
+    void setHandlerSkipRequested(const bool newValue);
+    void setHandlerSkipDepth(const XMLSize_t newValue);
+
     bool checkXMLDecl(bool startWithAngle);
 
     // -----------------------------------------------------------------------
@@ -500,6 +540,7 @@ protected:
     void checkIDRefs();
     bool isLegalToken(const XMLPScanToken& toCheck);
     XMLTokens senseNextToken(XMLSize_t& orgReader);
+    bool skipElementContent(XMLSize_t& orgReader);
     void initValidator(XMLValidator* theValidator);
     inline void resetValidationContext();
     unsigned int *getNewUIntPtr();
@@ -518,13 +559,6 @@ protected:
         , const int                 prefixColonPos
     );
 
-    inline
-    void setAttrDupChkRegistry
-         (
-            const XMLSize_t    &attrNumber
-          ,       bool         &toUseHashTable
-         );
-
     // -----------------------------------------------------------------------
     //  Data members
     //
@@ -541,6 +575,11 @@ protected:
     //      just reuse it over and over, allowing it to grow to meet the
     //      peak need.
     //
+    //  fAttrDupChkRegistry
+    //      The names of the attributes of the current start tag, as a local
+    //      name and a URI id, used to check that none of them is given
+    //      twice. It is emptied for each start tag.
+    //
     //  fBufMgr
     //      This is a manager for temporary buffers used during scanning.
     //      For efficiency we must use a set of static buffers, but we have
@@ -592,6 +631,20 @@ protected:
     //      it, which would normally throw again if the 'fail on first error'
     //      flag is one.
     //
+    //  fSkipLevel
+    //      Set by skipCurrentElement() from a start tag callback, to the
+    //      level of the element on the element stack. If the element is
+    //      still open when senseNextToken() is next called, that skips its
+    //      content and returns its end tag. Zero if there is nothing to skip.
+    //
+    //  fPushSource
+    //      The source that holds the bytes passed to pushBytes(), and drives
+    //      the scan over them. It only exists during a push parse.
+    //
+    //  fHandlerSkipRequested
+    //  fHandlerSkipDepth
+    //      The parser's skip state, see the handler skip state methods.
+    //
     //  fReaderMgr
     //      This is the reader manager, from which we get characters. It
     //      manages the reader stack for us, and provides a lot of convenience
@@ -768,6 +821,10 @@ protected:
     bool                        fExitOnFirstFatal;
     bool                        fValidationConstraintFatal;
     bool                        fInException;
+    XMLSize_t                   fSkipLevel;
+    PushInputSource*            fPushSource;
+    bool                        fHandlerSkipRequested;
+    XMLSize_t                   fHandlerSkipDepth;
     bool                        fStandalone;
     bool                        fHasNoDTD;
     bool                        fValidate;
@@ -803,7 +860,7 @@ protected:
     XMLUInt32                   fScannerId;
     XMLUInt32                   fSequenceId;
     RefVectorOf<XMLAttr>*       fAttrList;
-    RefHash2KeysTableOf<XMLAttr>*  fAttrDupChkRegistry;
+    AttrNameSet*                fAttrDupChkRegistry;
     XMLDocumentHandler*         fDocHandler;
     DocTypeHandler*             fDocTypeHandler;
     XMLEntityHandler*           fEntityHandler;
@@ -976,6 +1033,11 @@ inline const ReaderMgr* XMLScanner::getReaderMgr() const
     return &fReaderMgr;
 }
 
+inline const XMLBufferMgr* XMLScanner::getBufferMgr() const
+{
+    return &fBufMgr;
+}
+
 inline XMLFilePos XMLScanner::getSrcOffset() const
 {
     return fReaderMgr.getSrcOffset();
@@ -1161,6 +1223,21 @@ inline const XMLSize_t& XMLScanner::getLowWaterMark() const
     return fLowWaterMark;
 }
 
+inline const XMLSize_t& XMLScanner::getReaderBufferSize() const
+{
+    return fReaderMgr.getReaderBufferSize();
+}
+
+inline bool XMLScanner::getAdaptiveReaderBuffer() const
+{
+    return fReaderMgr.getAdaptiveReaderBuffer();
+}
+
+inline bool XMLScanner::getReadAhead() const
+{
+    return fReaderMgr.getReadAhead();
+}
+
 inline bool XMLScanner::getIgnoreCachedDTD() const
 {
     return fIgnoreCachedDTD;
@@ -1186,6 +1263,21 @@ inline bool XMLScanner::getHandleMultipleImports() const
     return fHandleMultipleImports;
 }
 
+inline bool XMLScanner::isPushing() const
+{
+    return (fPushSource != 0);
+}
+
+inline bool XMLScanner::getHandlerSkipRequested() const
+{
+    return fHandlerSkipRequested;
+}
+
+inline XMLSize_t XMLScanner::getHandlerSkipDepth() const
+{
+    return fHandlerSkipDepth;
+}
+
 // ---------------------------------------------------------------------------
 //  XMLScanner: Setter methods
 // ---------------------------------------------------------------------------
@@ -1375,6 +1467,31 @@ inline void XMLScanner::setLowWaterMark(XMLSize_t newValue)
     fLowWaterMark = newValue;
 }
 
+inline void XMLScanner::setHandlerSkipRequested(const bool newValue)
+{
+    fHandlerSkipRequested = newValue;
+}
+
+inline void XMLScanner::setHandlerSkipDepth(const XMLSize_t newValue)
+{
+    fHandlerSkipDepth = newValue;
+}
+
+inline void XMLScanner::setReaderBufferSize(const XMLSize_t newValue)
+{
+    fReaderMgr.setReaderBufferSize(newValue);
+}
+
+inline void XMLScanner::setAdaptiveReaderBuffer(const bool newValue)
+{
+    fReaderMgr.setAdaptiveReaderBuffer(newValue);
+}
+
+inline void XMLScanner::setReadAhead(const bool newValue)
+{
+    fReaderMgr.setReadAhead(newValue);
+}
+
 inline void XMLScanner::setIgnoredCachedDTD(const bool newValue)
 {
     fIgnoreCachedDTD = newValue;
@@ -1415,29 +1532,6 @@ inline void XMLScanner::resetValidationContext()
     fEntityDeclPoolRetrieved = false;
 }
 
-inline void XMLScanner::setAttrDupChkRegistry(const XMLSize_t    &attrNumber
-                                            ,       bool         &toUseHashTable)
-{
-   // once the attribute exceed 100, we use hash table to check duplication
-    if (attrNumber > 100)
-   {
-        toUseHashTable = true;
-
-        if (!fAttrDupChkRegistry)
-        {
-            fAttrDupChkRegistry = new (fMemoryManager) RefHash2KeysTableOf<XMLAttr>
-            (
-              2*attrNumber+1, false, fMemoryManager
-            );
-        }
-        else
-        {
-            fAttrDupChkRegistry->removeAll();
-        }
-    }
-
-}
-
 inline Grammar::GrammarType XMLScanner::getCurrentGrammarType() const
 {
     return Grammar::UnKnown;
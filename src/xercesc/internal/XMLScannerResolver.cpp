@@ -25,6 +25,7 @@
 // ---------------------------------------------------------------------------
 #include <xercesc/internal/XMLScannerResolver.hpp>
 #include <xercesc/internal/WFXMLScanner.hpp>
+#include <xercesc/internal/NSXMLScanner.hpp>
 #include <xercesc/internal/DGXMLScanner.hpp>
 #include <xercesc/internal/SGXMLScanner.hpp>
 #include <xercesc/internal/IGXMLScanner.hpp>
@@ -56,6 +57,8 @@ XMLScannerResolver::resolveScanner( const XMLCh* const   scannerName
         return new (manager) SGXMLScanner(valToAdopt, grammarResolver, manager);
     else if (XMLString::equals(scannerName, XMLUni::fgDGXMLScanner))
         return new (manager) DGXMLScanner(valToAdopt, grammarResolver, manager);
+    else if (XMLString::equals(scannerName, XMLUni::fgNSXMLScanner))
+        return new (manager) NSXMLScanner(valToAdopt, grammarResolver, manager);
 
     // REVISIT: throw an exception or return a default one?
     return 0;
@@ -79,6 +82,8 @@ XMLScannerResolver::resolveScanner( const XMLCh* const        scannerName
         return new (manager) SGXMLScanner(docHandler, docTypeHandler, entityHandler, errReporter, valToAdopt, grammarResolver, manager);
     else if (XMLString::equals(scannerName, XMLUni::fgDGXMLScanner))
         return new (manager) DGXMLScanner(docHandler, docTypeHandler, entityHandler, errReporter, valToAdopt, grammarResolver, manager);
+    else if (XMLString::equals(scannerName, XMLUni::fgNSXMLScanner))
+        return new (manager) NSXMLScanner(docHandler, docTypeHandler, entityHandler, errReporter, valToAdopt, grammarResolver, manager);
 
     // REVISIT: throw an exception or return a default one?
     return 0;
@@ -552,6 +552,7 @@ void XSAXMLScanner::scanReset(const InputSource& src)
 
     // Reset some status flags
     fInException = false;
+    fSkipLevel = 0;
     fStandalone = false;
     fErrorCount = 0;
     fHasNoDTD = true;
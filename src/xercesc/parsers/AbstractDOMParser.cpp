@@ -75,6 +75,7 @@ XERCES_CPP_NAMESPACE_BEGIN
 
 typedef JanitorMemFunCall<AbstractDOMParser>    CleanupType;
 typedef JanitorMemFunCall<AbstractDOMParser>    ResetInProgressType;
+typedef JanitorMemFunCall<AbstractDOMParser>    ResetPushType;
 
 
 AbstractDOMParser::AbstractDOMParser( XMLValidator* const   valToAdopt
@@ -198,6 +199,13 @@ void AbstractDOMParser::resetInProgress()
 }
 
 
+void AbstractDOMParser::resetPush()
+{
+    fScanner->endPush();
+    fParseInProgress = false;
+}
+
+
 void AbstractDOMParser::resetPool()
 {
     //  We cannot enter here while a regular parse is in progress.
@@ -218,6 +226,15 @@ bool AbstractDOMParser::isDocumentAdopted() const
     return fDocumentAdoptedByUser;
 }
 
+bool AbstractDOMParser::skipCurrentElement()
+{
+    // A push parse may not have all of the content yet, so it can't skip
+    if (fScanner->isPushing())
+        return false;
+
+    return fScanner->skipCurrentElement();
+}
+
 DOMDocument* AbstractDOMParser::adoptDocument()
 {
     fDocumentAdoptedByUser = true;
@@ -317,6 +334,21 @@ const XMLSize_t& AbstractDOMParser::getLowWaterMark() const
     return fScanner->getLowWaterMark();
 }
 
+const XMLSize_t& AbstractDOMParser::getReaderBufferSize() const
+{
+    return fScanner->getReaderBufferSize();
+}
+
+bool AbstractDOMParser::getAdaptiveReaderBuffer() const
+{
+    return fScanner->getAdaptiveReaderBuffer();
+}
+
+bool AbstractDOMParser::getReadAhead() const
+{
+    return fScanner->getReadAhead();
+}
+
 bool AbstractDOMParser::getLoadExternalDTD() const
 {
     return fScanner->getLoadExternalDTD();
@@ -455,6 +487,21 @@ void AbstractDOMParser::setLowWaterMark(XMLSize_t lwm)
     fScanner->setLowWaterMark(lwm);
 }
 
+void AbstractDOMParser::setReaderBufferSize(const XMLSize_t newSize)
+{
+    fScanner->setReaderBufferSize(newSize);
+}
+
+void AbstractDOMParser::setAdaptiveReaderBuffer(const bool newState)
+{
+    fScanner->setAdaptiveReaderBuffer(newState);
+}
+
+void AbstractDOMParser::setReadAhead(const bool newState)
+{
+    fScanner->setReadAhead(newState);
+}
+
 void AbstractDOMParser::setLoadExternalDTD(const bool newState)
 {
     fScanner->setLoadExternalDTD(newState);
@@ -672,6 +719,67 @@ void AbstractDOMParser::parseReset(XMLPScanToken& token)
 }
 
 
+// ---------------------------------------------------------------------------
+//  AbstractDOMParser: Push parse methods
+// ---------------------------------------------------------------------------
+void AbstractDOMParser::feed(const  XMLByte* const  bytes
+                            , const XMLSize_t       count)
+{
+    //
+    //  Avoid multiple entrance. We cannot enter here while any other
+    //  parse is in progress. The first chunk starts a new push parse.
+    //
+    if (fParseInProgress && !fScanner->isPushing())
+        ThrowXMLwithMemMgr(IOException, XMLExcepts::Gen_ParseInProgress, fMemoryManager);
+
+    fParseInProgress = true;
+
+    ResetPushType resetPush(this, &AbstractDOMParser::resetPush);
+
+    try
+    {
+        fScanner->pushBytes(bytes, count);
+    }
+    catch(const OutOfMemoryException&)
+    {
+        resetPush.release();
+
+        throw;
+    }
+
+    // The parse goes on with the next chunk
+    resetPush.release();
+}
+
+void AbstractDOMParser::finish()
+{
+    if (fParseInProgress && !fScanner->isPushing())
+        ThrowXMLwithMemMgr(IOException, XMLExcepts::Gen_ParseInProgress, fMemoryManager);
+
+    fParseInProgress = true;
+
+    ResetPushType resetPush(this, &AbstractDOMParser::resetPush);
+
+    try
+    {
+        fScanner->pushEndOfInput();
+
+        if (fDoXInclude && getErrorCount()==0){
+            DOMDocument *doc = getDocument();
+            // after XInclude, the document must be normalized
+            if(doc)
+                doc->normalizeDocument();
+        }
+    }
+    catch(const OutOfMemoryException&)
+    {
+        resetPush.release();
+
+        throw;
+    }
+}
+
+
 // ---------------------------------------------------------------------------
 //  AbstractDOMParser: Implementation of PSVIHandler interface
 // ---------------------------------------------------------------------------
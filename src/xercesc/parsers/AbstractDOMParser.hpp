@@ -350,6 +350,44 @@ public :
       */
     const XMLSize_t& getLowWaterMark() const;
 
+    /** Get the size of the character buffer of each entity reader.
+      *
+      * Each document or external entity that the parser reads is decoded
+      * into a character buffer of this many characters, and read from its
+      * input stream through a raw byte buffer three times that many bytes.
+      * By default the value for this parameter is 16K characters.
+      *
+      * @return current reader buffer size, in characters
+      *
+      * @see #setReaderBufferSize
+      * @see #getAdaptiveReaderBuffer
+      */
+    const XMLSize_t& getReaderBufferSize() const;
+
+    /** Get the 'adaptive reader buffer' flag
+      *
+      * This method returns the state of the parser's adaptive reader
+      * buffer flag.
+      *
+      * @return true, if the entity readers start out with small buffers
+      *         and grow them up to the reader buffer size, false otherwise.
+      *
+      * @see #setAdaptiveReaderBuffer
+      * @see #getReaderBufferSize
+      */
+    bool getAdaptiveReaderBuffer() const;
+
+    /** Get the 'read ahead' flag
+      *
+      * This method returns the state of the parser's read ahead flag.
+      *
+      * @return true, if local files are read ahead on a background thread
+      *         while they are parsed, false otherwise.
+      *
+      * @see #setReadAhead
+      */
+    bool getReadAhead() const;
+
     /** Get the 'Loading External DTD' flag
       *
       * This method returns the state of the parser's loading external DTD
@@ -793,6 +831,62 @@ public :
       */
     void setLowWaterMark(XMLSize_t lwm);
 
+    /** Set the size of the character buffer of each entity reader.
+      *
+      * Each document or external entity that the parser reads is decoded
+      * into a character buffer of this many characters, and read from its
+      * input stream through a raw byte buffer three times that many bytes.
+      * Small buffers save memory when many parsers work on small documents
+      * at the same time, while large buffers cut down on the number of
+      * reads from very large documents. Values below 1K characters are
+      * rounded up. By default the value for this parameter is 16K
+      * characters.
+      *
+      * @param newSize new reader buffer size, in characters
+      *
+      * @see #getReaderBufferSize
+      * @see #setAdaptiveReaderBuffer
+      */
+    void setReaderBufferSize(const XMLSize_t newSize);
+
+    /** Set the 'adaptive reader buffer' flag
+      *
+      * When set to true, each entity reader starts out with 1K character
+      * buffers, and doubles them every time a read from its input stream
+      * fills the raw buffer, until they reach the reader buffer size. So
+      * small documents only use small buffers, while large ones quickly
+      * get the full size.
+      *
+      * The parser's default state is: false.
+      *
+      * @param newState The value specifying whether the reader buffers
+      *                 should be adaptive.
+      *
+      * @see #getAdaptiveReaderBuffer
+      * @see #setReaderBufferSize
+      */
+    void setAdaptiveReaderBuffer(const bool newState);
+
+    /** Set the 'read ahead' flag
+      *
+      * When set to true, the document and the external entities that are
+      * read from local files (compressed or not) are read ahead on a
+      * background thread, so that waiting for the disk, or decompressing
+      * the data, overlaps with parsing. Other sources are read as usual:
+      * a parse that ends early has to wait for the read in progress, and
+      * a pipe or a network connection could keep it waiting. Without
+      * thread support this flag has no effect.
+      *
+      * The parser's default state is: false.
+      *
+      * @param newState The value specifying whether local files should
+      *                 be read ahead.
+      *
+      * @see #getReadAhead
+      * @see BinReadAheadInputStream
+      */
+    void setReadAhead(const bool newState);
+
     /** Set the 'Loading External DTD' flag
       *
       * This method allows users to enable or disable the loading of external DTD.
@@ -1180,6 +1274,46 @@ public :
       */
     void parseReset(XMLPScanToken& token);
 
+    /** Parse the next chunk of a document that is pushed to the parser
+      *
+      * This method is used to parse a document that arrives a chunk at
+      * a time, for instance from a non-blocking socket, without tying up
+      * a thread per document. The first call starts a new parse. Each
+      * call then adds as much of the document to the DOM tree as the bytes
+      * passed in so far allow, and returns without waiting for more. Call
+      * finish() once the last chunk is passed in.
+      *
+      * The bytes are copied, so the caller can reuse the buffer. Only a
+      * token which is split across chunks is kept until the rest of it
+      * arrives. Documents in UTF-16, UCS-4 or EBCDIC are the exception,
+      * and are kept until finish() is called.
+      *
+      * No other parse can be started until finish() is called. If the
+      * parse stops early because of a fatal error, the rest of the chunks
+      * are ignored.
+      *
+      * @param bytes A pointer to the next bytes of the document.
+      * @param count The number of bytes to parse.
+      *
+      * @see #finish
+      */
+    void feed
+    (
+        const   XMLByte* const  bytes
+        , const XMLSize_t       count
+    );
+
+    /** Finish a push parse operation
+      *
+      * This method tells the parser that all of the document has been
+      * passed to feed(). It parses the rest of it, after which the
+      * document is available from getDocument(), and resets the parser
+      * so that it can be used for another parse.
+      *
+      * @see #feed
+      */
+    void finish();
+
     //@}
 
     // -----------------------------------------------------------------------
@@ -1670,6 +1804,13 @@ protected :
      */
     bool isDocumentAdopted() const;
 
+    /**
+     * Ask the scanner to skip the content of the element just started,
+     * so that no nodes are built for it. Returns false if the content is
+     * going to be reported anyway, in which case it has to be ignored.
+     */
+    bool skipCurrentElement();
+
     //@}
 
 
@@ -1680,6 +1821,7 @@ private :
     void initialize();
     void cleanUp();
     void resetInProgress();
+    void resetPush();
 
     // -----------------------------------------------------------------------
     //  Unimplemented constructors and operators
@@ -145,6 +145,9 @@ AbstractDOMParser(valToAdopt, manager, gramPool)
     fSupportedParameters->add(XMLUni::fgXercesSkipDTDValidation);
     fSupportedParameters->add(XMLUni::fgXercesDoXInclude);
     fSupportedParameters->add(XMLUni::fgXercesHandleMultipleImports);
+    fSupportedParameters->add(XMLUni::fgXercesReaderBufferSize);
+    fSupportedParameters->add(XMLUni::fgXercesAdaptiveReaderBuffer);
+    fSupportedParameters->add(XMLUni::fgXercesReadAhead);
 
     // LSParser by default does namespace processing
     setDoNamespaces(true);
@@ -244,6 +247,10 @@ void DOMLSParserImpl::setParameter(const XMLCh* name, const void* value)
     {
         setLowWaterMark(*(const XMLSize_t*)value);
     }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReaderBufferSize) == 0)
+    {
+        setReaderBufferSize(*(const XMLSize_t*)value);
+    }
     else
         throw DOMException(DOMException::NOT_FOUND_ERR, 0, getMemoryManager());
 }
@@ -433,6 +440,14 @@ void DOMLSParserImpl::setParameter(const XMLCh* name, bool state)
     {
         getScanner()->setHandleMultipleImports(state);
     }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesAdaptiveReaderBuffer) == 0)
+    {
+        setAdaptiveReaderBuffer(state);
+    }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReadAhead) == 0)
+    {
+        setReadAhead(state);
+    }
     else
         throw DOMException(DOMException::NOT_FOUND_ERR, 0, getMemoryManager());
 }
@@ -615,6 +630,14 @@ const void* DOMLSParserImpl::getParameter(const XMLCh* name) const
     {
         return (void*)getScanner()->getHandleMultipleImports();
     }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesAdaptiveReaderBuffer) == 0)
+    {
+        return (void*)getAdaptiveReaderBuffer();
+    }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReadAhead) == 0)
+    {
+        return (void*)getReadAhead();
+    }
     else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesEntityResolver) == 0)
     {
         return fXMLEntityResolver;
@@ -639,6 +662,10 @@ const void* DOMLSParserImpl::getParameter(const XMLCh* name) const
     {
       return (void*)&getLowWaterMark();
     }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReaderBufferSize) == 0)
+    {
+      return &getReaderBufferSize();
+    }
     else
         throw DOMException(DOMException::NOT_FOUND_ERR, 0, getMemoryManager());
 }
@@ -653,7 +680,8 @@ bool DOMLSParserImpl::canSetParameter(const XMLCh* name, const void* /*value*/)
         XMLString::compareIStringASCII(name, XMLUni::fgXercesSecurityManager) == 0 ||
         XMLString::compareIStringASCII(name, XMLUni::fgXercesScannerName) == 0 ||
         XMLString::compareIStringASCII(name, XMLUni::fgXercesParserUseDocumentFromImplementation) == 0 ||
-        XMLString::compareIStringASCII(name, XMLUni::fgXercesLowWaterMark) == 0)
+        XMLString::compareIStringASCII(name, XMLUni::fgXercesLowWaterMark) == 0 ||
+        XMLString::compareIStringASCII(name, XMLUni::fgXercesReaderBufferSize) == 0)
       return true;
     else if(XMLString::compareIStringASCII(name, XMLUni::fgDOMSchemaLocation) == 0 ||
             XMLString::compareIStringASCII(name, XMLUni::fgDOMSchemaType) == 0)
@@ -693,7 +721,9 @@ bool DOMLSParserImpl::canSetParameter(const XMLCh* name, bool value) const
         XMLString::compareIStringASCII(name, XMLUni::fgXercesDisableDefaultEntityResolution) == 0 ||
         XMLString::compareIStringASCII(name, XMLUni::fgXercesSkipDTDValidation) == 0 ||
 		XMLString::compareIStringASCII(name, XMLUni::fgXercesDoXInclude) == 0 ||
-        XMLString::compareIStringASCII(name, XMLUni::fgXercesHandleMultipleImports) == 0)
+        XMLString::compareIStringASCII(name, XMLUni::fgXercesHandleMultipleImports) == 0 ||
+        XMLString::compareIStringASCII(name, XMLUni::fgXercesAdaptiveReaderBuffer) == 0 ||
+        XMLString::compareIStringASCII(name, XMLUni::fgXercesReadAhead) == 0)
       return true;
     else if(XMLString::compareIStringASCII(name, XMLUni::fgDOMIgnoreUnknownCharacterDenormalization) == 0 ||
             XMLString::compareIStringASCII(name, XMLUni::fgDOMCanonicalForm) == 0 ||
@@ -1366,6 +1396,9 @@ void DOMLSParserImpl::startElement(const XMLElementDecl&         elemDecl
             case DOMLSParserFilter::FILTER_SKIP:        if(fFilterAction==0)
                                                             fFilterAction=new (fMemoryManager) ValueHashTableOf<DOMLSParserFilter::FilterAction, PtrHasher>(7, fMemoryManager);
                                                         fFilterAction->put(fCurrentNode, action);
+                                                        // no need to build the children of a rejected element
+                                                        if(action==DOMLSParserFilter::FILTER_REJECT && !isEmpty)
+                                                            skipCurrentElement();
                                                         break;
             case DOMLSParserFilter::FILTER_INTERRUPT:   throw DOMLSException(DOMLSException::PARSE_ERR, XMLDOMMsg::LSParser_ParsingAborted, fMemoryManager);
             }
@@ -0,0 +1,2177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#if HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <xercesc/parsers/SAX2ParallelParser.hpp>
+#include <xercesc/parsers/SAX2XMLReaderImpl.hpp>
+#include <xercesc/framework/XMLBuffer.hpp>
+#include <xercesc/sax/ErrorHandler.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax/Locator.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/ContentHandler.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/LexicalHandler.hpp>
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/ValueVectorOf.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <string.h>
+
+#if defined(HAVE_STD_THREAD) && !defined(XERCES_USE_MUTEXMGR_NOTHREAD)
+#define XERCES_PARALLEL_PARSE 1
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#endif
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+#if defined(XERCES_PARALLEL_PARSE)
+
+// ---------------------------------------------------------------------------
+//  Local helper methods
+//
+//  The splitting works on the raw bytes, which are known to be in an ASCII
+//  compatible encoding by then, so markup can be compared against plain
+//  char strings.
+// ---------------------------------------------------------------------------
+static bool isSpaceByte(const XMLByte toCheck)
+{
+    return (toCheck == 0x20) || (toCheck == 0x09)
+        || (toCheck == 0x0A) || (toCheck == 0x0D);
+}
+
+static bool isNameEndByte(const XMLByte toCheck)
+{
+    return isSpaceByte(toCheck) || (toCheck == '>') || (toCheck == '/');
+}
+
+static bool matchBytes(const XMLByte* const data
+                       , const XMLSize_t    pos
+                       , const XMLSize_t    end
+                       , const char* const  toMatch)
+{
+    const XMLSize_t len = strlen(toMatch);
+    return (pos + len <= end) && !memcmp(data + pos, toMatch, len);
+}
+
+//
+//  Returns the offset of the first toFind at or after pos, or end if there
+//  is none.
+//
+static XMLSize_t findBytes(const XMLByte* const data
+                           , XMLSize_t          pos
+                           , const XMLSize_t    end
+                           , const char* const  toFind)
+{
+    const XMLSize_t len = strlen(toFind);
+    while (pos + len <= end)
+    {
+        const XMLByte* found = (const XMLByte*) memchr
+        (
+            data + pos, toFind[0], end - pos - len + 1
+        );
+        if (!found)
+            break;
+
+        pos = found - data;
+        if (!memcmp(data + pos, toFind, len))
+            return pos;
+        pos++;
+    }
+    return end;
+}
+
+//
+//  If pos is at a comment, CDATA section or PI, moves it past the end of it
+//  and returns true. Returns false, leaving pos alone, if there is
+//  something else at pos or if the markup is not closed.
+//
+static bool skipMarkup(const XMLByte* const data
+                       , XMLSize_t&         pos
+                       , const XMLSize_t    end)
+{
+    const char* closeStr;
+    XMLSize_t openLen;
+    if (matchBytes(data, pos, end, "<!--"))
+    {
+        closeStr = "-->";
+        openLen = 4;
+    }
+    else if (matchBytes(data, pos, end, "<![CDATA["))
+    {
+        closeStr = "]]>";
+        openLen = 9;
+    }
+    else if (matchBytes(data, pos, end, "<?"))
+    {
+        closeStr = "?>";
+        openLen = 2;
+    }
+    else
+    {
+        return false;
+    }
+
+    const XMLSize_t closePos = findBytes(data, pos + openLen, end, closeStr);
+    if (closePos == end)
+        return false;
+
+    pos = closePos + strlen(closeStr);
+    return true;
+}
+
+//
+//  Gets the value of a pseudo attribute of the XML declaration, which lies
+//  within [pos, end). Returns false if it is not there or is too long for
+//  toFill, which is then empty.
+//
+static bool getDeclValue(const XMLByte* const   data
+                         , const XMLSize_t      pos
+                         , const XMLSize_t      end
+                         , const char* const    name
+                         , char* const          toFill
+                         , const XMLSize_t      maxChars)
+{
+    toFill[0] = 0;
+    XMLSize_t curPos = findBytes(data, pos, end, name) + strlen(name);
+    while ((curPos < end) && isSpaceByte(data[curPos]))
+        curPos++;
+    if ((curPos >= end) || (data[curPos] != '='))
+        return false;
+
+    curPos++;
+    while ((curPos < end) && isSpaceByte(data[curPos]))
+        curPos++;
+    if ((curPos >= end) || ((data[curPos] != '"') && (data[curPos] != '\'')))
+        return false;
+
+    const XMLByte* closeQuote = (const XMLByte*) memchr
+    (
+        data + curPos + 1, data[curPos], end - curPos - 1
+    );
+    if (!closeQuote)
+        return false;
+
+    const XMLSize_t len = closeQuote - (data + curPos + 1);
+    if (len > maxChars)
+        return false;
+
+    memcpy(toFill, data + curPos + 1, len);
+    toFill[len] = 0;
+    return true;
+}
+
+//
+//  Moves the line and column over the bytes in [pos, end) the way that the
+//  reader counts them, for a version 1.0 document. In UTF-8, a character
+//  outside of the BMP takes two columns, as it is read as a surrogate pair.
+//
+static void advanceLocation(const XMLByte* const    data
+                            , const XMLSize_t       pos
+                            , const XMLSize_t       end
+                            , const bool            isUTF8
+                            , XMLFileLoc&           line
+                            , XMLFileLoc&           column)
+{
+    for (XMLSize_t index = pos; index < end; index++)
+    {
+        const XMLByte curByte = data[index];
+        if (curByte == 0x0A)
+        {
+            // The LF of a CR/LF pair was counted with the CR
+            if ((index > pos) && (data[index - 1] == 0x0D))
+                continue;
+            line++;
+            column = 1;
+        }
+        else if (curByte == 0x0D)
+        {
+            line++;
+            column = 1;
+        }
+        else if (!isUTF8 || (curByte < 0x80))
+        {
+            column++;
+        }
+        else if (curByte >= 0xF0)
+        {
+            column += 2;
+        }
+        else if (curByte >= 0xC0)
+        {
+            column++;
+        }
+    }
+}
+
+//
+//  Maps a location in one text onto another one which has the same content
+//  from (fromLine, fromColumn) on, but which has it at (toLine, toColumn).
+//
+static void mapLocation(XMLFileLoc&         line
+                        , XMLFileLoc&       column
+                        , const XMLFileLoc  fromLine
+                        , const XMLFileLoc  fromColumn
+                        , const XMLFileLoc  toLine
+                        , const XMLFileLoc  toColumn)
+{
+    if (!line)
+        return;
+
+    if (line == fromLine)
+    {
+        line = toLine;
+        column = toColumn + (column - fromColumn);
+    }
+    else
+    {
+        line = toLine + (line - fromLine);
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+//  ParallelChunkStream and ParallelChunkSource
+//
+//  A document made up of a few pieces of the real one, which are read one
+//  after the other. The whole of it is in memory only if it is made of one
+//  piece, which is the real document.
+// ---------------------------------------------------------------------------
+struct ParallelSegment
+{
+    const XMLByte*  fData;
+    XMLSize_t       fSize;
+};
+
+class ParallelChunkStream : public BinInputStream
+{
+public :
+    ParallelChunkStream(const ParallelSegment* const    segments
+                        , const unsigned int            segmentCount
+                        , const bool                    inMemory) :
+        fSegmentCount(segmentCount)
+        , fCurSegment(0)
+        , fSegmentPos(0)
+        , fCurPos(0)
+        , fInMemory(inMemory)
+    {
+        for (unsigned int index = 0; index < segmentCount; index++)
+            fSegments[index] = segments[index];
+    }
+
+    virtual XMLFilePos curPos() const
+    {
+        return fCurPos;
+    }
+
+    virtual XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead)
+    {
+        XMLSize_t bytesDone = 0;
+        while ((bytesDone < maxToRead) && (fCurSegment < fSegmentCount))
+        {
+            const ParallelSegment& curSegment = fSegments[fCurSegment];
+            XMLSize_t toCopy = curSegment.fSize - fSegmentPos;
+            if (toCopy > maxToRead - bytesDone)
+                toCopy = maxToRead - bytesDone;
+
+            memcpy(toFill + bytesDone, curSegment.fData + fSegmentPos, toCopy);
+            bytesDone += toCopy;
+            fSegmentPos += toCopy;
+            if (fSegmentPos == curSegment.fSize)
+            {
+                fCurSegment++;
+                fSegmentPos = 0;
+            }
+        }
+        fCurPos += bytesDone;
+        return bytesDone;
+    }
+
+    virtual const XMLCh* getContentType() const
+    {
+        return 0;
+    }
+
+    virtual const XMLByte* getInMemoryBuffer(XMLSize_t& size) const
+    {
+        if (!fInMemory)
+            return 0;
+        size = fSegments[0].fSize;
+        return fSegments[0].fData;
+    }
+
+private :
+    ParallelChunkStream(const ParallelChunkStream&);
+    ParallelChunkStream& operator=(const ParallelChunkStream&);
+
+    ParallelSegment fSegments[3];
+    unsigned int    fSegmentCount;
+    unsigned int    fCurSegment;
+    XMLSize_t       fSegmentPos;
+    XMLFilePos      fCurPos;
+    bool            fInMemory;
+};
+
+class ParallelChunkSource : public InputSource
+{
+public :
+    ParallelChunkSource(const ParallelSegment* const    segments
+                        , const unsigned int            segmentCount
+                        , const bool                    inMemory
+                        , const InputSource&            original
+                        , MemoryManager* const          manager) :
+        InputSource(original.getSystemId(), original.getPublicId(), manager)
+        , fSegments(segments)
+        , fSegmentCount(segmentCount)
+        , fInMemory(inMemory)
+    {
+    }
+
+    virtual BinInputStream* makeStream() const
+    {
+        return new (getMemoryManager()) ParallelChunkStream
+        (
+            fSegments, fSegmentCount, fInMemory
+        );
+    }
+
+private :
+    ParallelChunkSource(const ParallelChunkSource&);
+    ParallelChunkSource& operator=(const ParallelChunkSource&);
+
+    const ParallelSegment*  fSegments;
+    unsigned int            fSegmentCount;
+    bool                    fInMemory;
+};
+
+
+// ---------------------------------------------------------------------------
+//  ParallelChunk
+//
+//  The events recorded for a chunk. The strings are all kept in one buffer,
+//  each followed by a null, and the events refer to them by offset.
+// ---------------------------------------------------------------------------
+enum ParallelEventTypes
+{
+    ParallelEvent_StartElement
+    , ParallelEvent_EndElement
+    , ParallelEvent_Characters
+    , ParallelEvent_Whitespace
+    , ParallelEvent_PI
+    , ParallelEvent_StartPrefix
+    , ParallelEvent_EndPrefix
+    , ParallelEvent_SkippedEntity
+    , ParallelEvent_Comment
+    , ParallelEvent_StartCDATA
+    , ParallelEvent_EndCDATA
+    , ParallelEvent_StartEntity
+    , ParallelEvent_EndEntity
+};
+
+struct ParallelEvent
+{
+    ParallelEventTypes  fType;
+    XMLSize_t           fText1;
+    XMLSize_t           fText2;
+    XMLSize_t           fText3;
+    XMLSize_t           fLength;
+    XMLSize_t           fFirstAttr;
+    XMLSize_t           fAttrCount;
+    XMLFileLoc          fLine;
+    XMLFileLoc          fColumn;
+};
+
+struct ParallelAttr
+{
+    XMLSize_t   fURI;
+    XMLSize_t   fLocalName;
+    XMLSize_t   fQName;
+    XMLSize_t   fType;
+    XMLSize_t   fValue;
+};
+
+static const XMLSize_t  gNoString = ~(XMLSize_t)0;
+
+class ParallelChunk : public XMemory
+{
+public :
+    ParallelChunk(MemoryManager* const manager) :
+        fIndex(~(XMLSize_t)0)
+        , fDone(false)
+        , fFailed(false)
+        , fTopCount(0)
+        , fLines(0)
+        , fColumns(0)
+        , fEvents(1024, manager)
+        , fAttrs(256, manager)
+        , fStrings(16 * 1024, manager)
+    {
+    }
+
+    void reset()
+    {
+        fDone = false;
+        fFailed = false;
+        fTopCount = 0;
+        fLines = 0;
+        fColumns = 0;
+        fEvents.removeAllElements();
+        fAttrs.removeAllElements();
+        fStrings.reset();
+    }
+
+    XMLSize_t addString(const XMLCh* const text, const XMLSize_t length)
+    {
+        if (!text)
+            return gNoString;
+
+        const XMLSize_t offset = fStrings.getLen();
+        fStrings.append(text, length);
+        fStrings.append(chNull);
+        return offset;
+    }
+
+    XMLSize_t addString(const XMLCh* const text)
+    {
+        return addString(text, text ? XMLString::stringLen(text) : 0);
+    }
+
+    const XMLCh* getString(const XMLSize_t offset) const
+    {
+        if (offset == gNoString)
+            return 0;
+        return fStrings.getRawBuffer() + offset;
+    }
+
+    //
+    //  fIndex
+    //      The number of the chunk held. It and fDone are guarded by the
+    //      mutex of the parse.
+    //
+    //  fDone
+    //      Whether the chunk has been parsed.
+    //
+    //  fFailed
+    //      Whether the chunk could not be parsed cleanly, so that the
+    //      events are no good.
+    //
+    //  fTopCount
+    //      The number of children of the root element in the chunk.
+    //
+    //  fLines
+    //  fColumns
+    //      How far the chunk moves the location, from a start of (0, 0).
+    //
+    XMLSize_t                       fIndex;
+    bool                            fDone;
+    bool                            fFailed;
+    XMLSize_t                       fTopCount;
+    XMLFileLoc                      fLines;
+    XMLFileLoc                      fColumns;
+    ValueVectorOf<ParallelEvent>    fEvents;
+    ValueVectorOf<ParallelAttr>     fAttrs;
+    XMLBuffer                       fStrings;
+
+private :
+    ParallelChunk(const ParallelChunk&);
+    ParallelChunk& operator=(const ParallelChunk&);
+};
+
+
+// ---------------------------------------------------------------------------
+//  ParallelAttributes
+//
+//  The attributes of a recorded start tag, as handed on to the content
+//  handler.
+// ---------------------------------------------------------------------------
+class ParallelAttributes : public Attributes
+{
+public :
+    ParallelAttributes(const ParallelChunk& chunk, const ParallelEvent& event) :
+        fChunk(chunk)
+        , fFirstAttr(event.fFirstAttr)
+        , fAttrCount(event.fAttrCount)
+    {
+    }
+
+    virtual XMLSize_t getLength() const
+    {
+        return fAttrCount;
+    }
+
+    virtual const XMLCh* getURI(const XMLSize_t index) const
+    {
+        return (index < fAttrCount) ? fChunk.getString(getAttr(index).fURI) : 0;
+    }
+
+    virtual const XMLCh* getLocalName(const XMLSize_t index) const
+    {
+        return (index < fAttrCount) ? fChunk.getString(getAttr(index).fLocalName) : 0;
+    }
+
+    virtual const XMLCh* getQName(const XMLSize_t index) const
+    {
+        return (index < fAttrCount) ? fChunk.getString(getAttr(index).fQName) : 0;
+    }
+
+    virtual const XMLCh* getType(const XMLSize_t index) const
+    {
+        return (index < fAttrCount) ? fChunk.getString(getAttr(index).fType) : 0;
+    }
+
+    virtual const XMLCh* getValue(const XMLSize_t index) const
+    {
+        return (index < fAttrCount) ? fChunk.getString(getAttr(index).fValue) : 0;
+    }
+
+    virtual bool getIndex(const XMLCh* const    uri
+                          , const XMLCh* const  localPart
+                          , XMLSize_t&          index) const
+    {
+        for (index = 0; index < fAttrCount; index++)
+        {
+            if (XMLString::equals(getURI(index), uri)
+            &&  XMLString::equals(getLocalName(index), localPart))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    virtual int getIndex(const XMLCh* const uri, const XMLCh* const localPart) const
+    {
+        XMLSize_t index;
+        return getIndex(uri, localPart, index) ? (int) index : -1;
+    }
+
+    virtual bool getIndex(const XMLCh* const qName, XMLSize_t& index) const
+    {
+        for (index = 0; index < fAttrCount; index++)
+        {
+            if (XMLString::equals(getQName(index), qName))
+                return true;
+        }
+        return false;
+    }
+
+    virtual int getIndex(const XMLCh* const qName) const
+    {
+        XMLSize_t index;
+        return getIndex(qName, index) ? (int) index : -1;
+    }
+
+    virtual const XMLCh* getType(const XMLCh* const uri, const XMLCh* const localPart) const
+    {
+        XMLSize_t index;
+        return getIndex(uri, localPart, index) ? getType(index) : 0;
+    }
+
+    virtual const XMLCh* getType(const XMLCh* const qName) const
+    {
+        XMLSize_t index;
+        return getIndex(qName, index) ? getType(index) : 0;
+    }
+
+    virtual const XMLCh* getValue(const XMLCh* const uri, const XMLCh* const localPart) const
+    {
+        XMLSize_t index;
+        return getIndex(uri, localPart, index) ? getValue(index) : 0;
+    }
+
+    virtual const XMLCh* getValue(const XMLCh* const qName) const
+    {
+        XMLSize_t index;
+        return getIndex(qName, index) ? getValue(index) : 0;
+    }
+
+private :
+    ParallelAttributes(const ParallelAttributes&);
+    ParallelAttributes& operator=(const ParallelAttributes&);
+
+    const ParallelAttr& getAttr(const XMLSize_t index) const
+    {
+        return fChunk.fAttrs.elementAt(fFirstAttr + index);
+    }
+
+    const ParallelChunk&    fChunk;
+    XMLSize_t               fFirstAttr;
+    XMLSize_t               fAttrCount;
+};
+
+
+// ---------------------------------------------------------------------------
+//  ParallelLocator
+//
+//  The locator handed to the content handler. It passes on the locator of
+//  the reader in use, either as it is, or shifted from the frame document
+//  onto the real one, or it gives the location of a recorded event.
+// ---------------------------------------------------------------------------
+class ParallelLocator : public Locator
+{
+public :
+    ParallelLocator() :
+        fLocator(0)
+        , fMode(Mode_PassThrough)
+        , fLine(0)
+        , fColumn(0)
+        , fFromLine(0)
+        , fFromColumn(0)
+    {
+    }
+
+    void setLocator(const Locator* const locator)
+    {
+        fLocator = locator;
+        fMode = Mode_PassThrough;
+    }
+
+    void setFixed(const XMLFileLoc line, const XMLFileLoc column)
+    {
+        fMode = Mode_Fixed;
+        fLine = line;
+        fColumn = column;
+    }
+
+    void setShifted(const XMLFileLoc fromLine
+                    , const XMLFileLoc fromColumn
+                    , const XMLFileLoc toLine
+                    , const XMLFileLoc toColumn)
+    {
+        fMode = Mode_Shifted;
+        fFromLine = fromLine;
+        fFromColumn = fromColumn;
+        fLine = toLine;
+        fColumn = toColumn;
+    }
+
+    //  Maps a location reported by the reader, when shifting
+    void map(XMLFileLoc& line, XMLFileLoc& column) const
+    {
+        if (fMode == Mode_Shifted)
+            mapLocation(line, column, fFromLine, fFromColumn, fLine, fColumn);
+    }
+
+    virtual const XMLCh* getPublicId() const
+    {
+        return fLocator ? fLocator->getPublicId() : 0;
+    }
+
+    virtual const XMLCh* getSystemId() const
+    {
+        return fLocator ? fLocator->getSystemId() : 0;
+    }
+
+    virtual XMLFileLoc getLineNumber() const
+    {
+        XMLFileLoc line;
+        XMLFileLoc column;
+        getLocation(line, column);
+        return line;
+    }
+
+    virtual XMLFileLoc getColumnNumber() const
+    {
+        XMLFileLoc line;
+        XMLFileLoc column;
+        getLocation(line, column);
+        return column;
+    }
+
+private :
+    ParallelLocator(const ParallelLocator&);
+    ParallelLocator& operator=(const ParallelLocator&);
+
+    enum Modes
+    {
+        Mode_PassThrough
+        , Mode_Fixed
+        , Mode_Shifted
+    };
+
+    void getLocation(XMLFileLoc& line, XMLFileLoc& column) const
+    {
+        if (fMode == Mode_Fixed)
+        {
+            line = fLine;
+            column = fColumn;
+            return;
+        }
+
+        line = fLocator ? fLocator->getLineNumber() : 0;
+        column = fLocator ? fLocator->getColumnNumber() : 0;
+        map(line, column);
+    }
+
+    const Locator*  fLocator;
+    Modes           fMode;
+    XMLFileLoc      fLine;
+    XMLFileLoc      fColumn;
+    XMLFileLoc      fFromLine;
+    XMLFileLoc      fFromColumn;
+};
+
+
+// ---------------------------------------------------------------------------
+//  ParallelRecorder
+//
+//  Records the events of a chunk document into a ParallelChunk. Only what is
+//  within the root element is recorded, as the rest is the same for every
+//  chunk. Any error within the root element, or not getting to the end of
+//  it, marks the chunk as failed.
+// ---------------------------------------------------------------------------
+class ParallelRecorder : public DefaultHandler
+{
+public :
+    ParallelRecorder() :
+        fChunk(0)
+        , fLocator(0)
+        , fDepth(0)
+        , fRootEnded(false)
+    {
+    }
+
+    void startChunk(ParallelChunk* const chunk)
+    {
+        fChunk = chunk;
+        fDepth = 0;
+        fRootEnded = false;
+    }
+
+    bool getRootEnded() const
+    {
+        return fRootEnded;
+    }
+
+    virtual void setDocumentLocator(const Locator* const locator)
+    {
+        fLocator = locator;
+    }
+
+    virtual void startElement(const XMLCh* const    uri
+                              , const XMLCh* const  localname
+                              , const XMLCh* const  qname
+                              , const Attributes&   attrs)
+    {
+        if (fDepth)
+        {
+            if (fDepth == 1)
+                fChunk->fTopCount++;
+
+            ParallelEvent& event = addEvent(ParallelEvent_StartElement);
+            event.fText1 = fChunk->addString(uri);
+            event.fText2 = fChunk->addString(localname);
+            event.fText3 = fChunk->addString(qname);
+            event.fFirstAttr = fChunk->fAttrs.size();
+            event.fAttrCount = attrs.getLength();
+            for (XMLSize_t index = 0; index < event.fAttrCount; index++)
+            {
+                ParallelAttr attr;
+                attr.fURI = fChunk->addString(attrs.getURI(index));
+                attr.fLocalName = fChunk->addString(attrs.getLocalName(index));
+                attr.fQName = fChunk->addString(attrs.getQName(index));
+                attr.fType = fChunk->addString(attrs.getType(index));
+                attr.fValue = fChunk->addString(attrs.getValue(index));
+                fChunk->fAttrs.addElement(attr);
+            }
+        }
+        fDepth++;
+    }
+
+    virtual void endElement(const XMLCh* const      uri
+                            , const XMLCh* const    localname
+                            , const XMLCh* const    qname)
+    {
+        if (!fDepth)
+            return;
+
+        fDepth--;
+        if (!fDepth)
+        {
+            fRootEnded = true;
+            return;
+        }
+
+        ParallelEvent& event = addEvent(ParallelEvent_EndElement);
+        event.fText1 = fChunk->addString(uri);
+        event.fText2 = fChunk->addString(localname);
+        event.fText3 = fChunk->addString(qname);
+    }
+
+    virtual void characters(const XMLCh* const chars, const XMLSize_t length)
+    {
+        addText(ParallelEvent_Characters, chars, length);
+    }
+
+    virtual void ignorableWhitespace(const XMLCh* const chars, const XMLSize_t length)
+    {
+        addText(ParallelEvent_Whitespace, chars, length);
+    }
+
+    virtual void processingInstruction(const XMLCh* const   target
+                                       , const XMLCh* const data)
+    {
+        if (fDepth)
+        {
+            ParallelEvent& event = addEvent(ParallelEvent_PI);
+            event.fText1 = fChunk->addString(target);
+            event.fText2 = fChunk->addString(data);
+        }
+    }
+
+    virtual void startPrefixMapping(const XMLCh* const  prefix
+                                    , const XMLCh* const uri)
+    {
+        if (fDepth)
+        {
+            ParallelEvent& event = addEvent(ParallelEvent_StartPrefix);
+            event.fText1 = fChunk->addString(prefix);
+            event.fText2 = fChunk->addString(uri);
+        }
+    }
+
+    virtual void endPrefixMapping(const XMLCh* const prefix)
+    {
+        addName(ParallelEvent_EndPrefix, prefix);
+    }
+
+    virtual void skippedEntity(const XMLCh* const name)
+    {
+        addName(ParallelEvent_SkippedEntity, name);
+    }
+
+    virtual void comment(const XMLCh* const chars, const XMLSize_t length)
+    {
+        addText(ParallelEvent_Comment, chars, length);
+    }
+
+    virtual void startCDATA()
+    {
+        if (fDepth)
+            addEvent(ParallelEvent_StartCDATA);
+    }
+
+    virtual void endCDATA()
+    {
+        if (fDepth)
+            addEvent(ParallelEvent_EndCDATA);
+    }
+
+    virtual void startEntity(const XMLCh* const name)
+    {
+        addName(ParallelEvent_StartEntity, name);
+    }
+
+    virtual void endEntity(const XMLCh* const name)
+    {
+        addName(ParallelEvent_EndEntity, name);
+    }
+
+    virtual void warning(const SAXParseException&)
+    {
+        if (fDepth)
+            fChunk->fFailed = true;
+    }
+
+    virtual void error(const SAXParseException&)
+    {
+        if (fDepth)
+            fChunk->fFailed = true;
+    }
+
+    virtual void fatalError(const SAXParseException&)
+    {
+        if (fDepth)
+            fChunk->fFailed = true;
+    }
+
+private :
+    ParallelRecorder(const ParallelRecorder&);
+    ParallelRecorder& operator=(const ParallelRecorder&);
+
+    ParallelEvent& addEvent(const ParallelEventTypes type)
+    {
+        ParallelEvent event;
+        event.fType = type;
+        event.fText1 = gNoString;
+        event.fText2 = gNoString;
+        event.fText3 = gNoString;
+        event.fLength = 0;
+        event.fFirstAttr = 0;
+        event.fAttrCount = 0;
+        event.fLine = fLocator ? fLocator->getLineNumber() : 0;
+        event.fColumn = fLocator ? fLocator->getColumnNumber() : 0;
+        fChunk->fEvents.addElement(event);
+        return fChunk->fEvents.elementAt(fChunk->fEvents.size() - 1);
+    }
+
+    void addText(const ParallelEventTypes   type
+                 , const XMLCh* const       chars
+                 , const XMLSize_t          length)
+    {
+        if (fDepth)
+        {
+            ParallelEvent& event = addEvent(type);
+            event.fText1 = fChunk->addString(chars, length);
+            event.fLength = length;
+        }
+    }
+
+    void addName(const ParallelEventTypes type, const XMLCh* const name)
+    {
+        if (fDepth)
+            addEvent(type).fText1 = fChunk->addString(name);
+    }
+
+    //
+    //  fChunk
+    //      The chunk being recorded into.
+    //
+    //  fDepth
+    //      The element depth, counting the root element.
+    //
+    //  fRootEnded
+    //      Whether the end of the root element has been seen.
+    //
+    ParallelChunk*  fChunk;
+    const Locator*  fLocator;
+    XMLSize_t       fDepth;
+    bool            fRootEnded;
+};
+
+
+// ---------------------------------------------------------------------------
+//  ParallelWorker
+// ---------------------------------------------------------------------------
+struct ParallelWorker : public XMemory
+{
+    ParallelWorker() :
+        fReader(0)
+    {
+    }
+
+    ~ParallelWorker()
+    {
+        delete fReader;
+    }
+
+    SAX2XMLReader*      fReader;
+    ParallelRecorder    fRecorder;
+    std::thread         fThread;
+};
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser::ParallelParse
+//
+//  Drives a parallel parse. It splits the document, starts the workers on
+//  the chunks, and parses the frame document, which is the document with
+//  the content of the root element taken out, on the calling thread. This
+//  object is the handler of that parse and passes it on. At the start of
+//  the root element, it hands on the events of the chunks in turn as they
+//  are done, and then lets the frame parse go on with the end of the
+//  document, with its locations shifted by the content that was left out.
+//
+//  If a chunk fails, the workers are stopped and the whole document is
+//  parsed again on the calling thread. That parse skips over the children
+//  of the root that were already handed on, and this object, as its
+//  handler, starts passing it on with the first child of the failed chunk.
+// ---------------------------------------------------------------------------
+class SAX2ParallelParser::ParallelParse : public DefaultHandler
+{
+public :
+    ParallelParse
+    (
+        SAX2ParallelParser&     owner
+        , const InputSource&    source
+        , const XMLByte* const  data
+        , const XMLSize_t       size
+    );
+    ~ParallelParse();
+
+    bool parse();
+
+    //  The handler interfaces
+    virtual void setDocumentLocator(const Locator* const locator);
+    virtual void startDocument();
+    virtual void endDocument();
+    virtual void startElement
+    (
+        const   XMLCh* const    uri
+        , const XMLCh* const    localname
+        , const XMLCh* const    qname
+        , const Attributes&     attrs
+    );
+    virtual void endElement
+    (
+        const   XMLCh* const    uri
+        , const XMLCh* const    localname
+        , const XMLCh* const    qname
+    );
+    virtual void characters(const XMLCh* const chars, const XMLSize_t length);
+    virtual void ignorableWhitespace(const XMLCh* const chars, const XMLSize_t length);
+    virtual void processingInstruction(const XMLCh* const target, const XMLCh* const data);
+    virtual void startPrefixMapping(const XMLCh* const prefix, const XMLCh* const uri);
+    virtual void endPrefixMapping(const XMLCh* const prefix);
+    virtual void skippedEntity(const XMLCh* const name);
+    virtual void comment(const XMLCh* const chars, const XMLSize_t length);
+    virtual void startCDATA();
+    virtual void endCDATA();
+    virtual void startDTD
+    (
+        const   XMLCh* const    name
+        , const XMLCh* const    publicId
+        , const XMLCh* const    systemId
+    );
+    virtual void endDTD();
+    virtual void startEntity(const XMLCh* const name);
+    virtual void endEntity(const XMLCh* const name);
+    virtual void warning(const SAXParseException& exc);
+    virtual void error(const SAXParseException& exc);
+    virtual void fatalError(const SAXParseException& exc);
+    virtual void resetErrors();
+
+private :
+    // -----------------------------------------------------------------------
+    //  Private class types
+    // -----------------------------------------------------------------------
+    enum States
+    {
+        State_Frame
+        , State_Recovering
+        , State_Done
+    };
+
+    enum ErrTypes
+    {
+        ErrType_Warning
+        , ErrType_Error
+        , ErrType_Fatal
+    };
+
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    ParallelParse(const ParallelParse&);
+    ParallelParse& operator=(const ParallelParse&);
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    bool split();
+    bool startWorkers();
+    void stopWorkers();
+    void work(ParallelWorker* const worker);
+    void replayChunks();
+    void replay(const ParallelChunk& chunk, const XMLFileLoc line, const XMLFileLoc column);
+    void recover(const XMLSize_t failedIndex, const XMLSize_t skipCount);
+    void flushPending();
+    bool isPassing() const;
+    void reportError(const SAXParseException& exc, const ErrTypes errType);
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fData
+    //  fSize
+    //      The document, and whether it is in UTF-8.
+    //
+    //  fContentStart
+    //  fContentEnd
+    //      Where the content of the root element starts and ends.
+    //
+    //  fBoundaries
+    //      Where each chunk starts, and then fContentEnd.
+    //
+    //  fPrefixLine
+    //  fPrefixColumn
+    //      The location at fContentStart.
+    //
+    //  fState
+    //      Which parse is being passed on, if any.
+    //
+    //  fRootSeen
+    //      Whether the frame parse got to the root element.
+    //
+    //  fSkipCount
+    //  fTopSeen
+    //  fRecoverDepth
+    //  fResumed
+    //  fErrorsOn
+    //  fPending
+    //      When recovering, the number of children of the root to skip, the
+    //      number seen so far and the element depth. Then whether events,
+    //      and errors, are passed on yet, and the prefix mappings that are
+    //      held back until it is known whether the next element is skipped.
+    //
+    //  fSlots
+    //  fSlotCount
+    //      The chunks being worked on or waiting to be handed on. Chunk n
+    //      goes in slot n % fSlotCount.
+    //
+    //  fMutex
+    //  fChunkDone
+    //  fSlotFreed
+    //  fNextChunk
+    //  fReplayedCount
+    //  fCancelled
+    //      The state shared with the workers. A worker takes the next chunk
+    //      once there is a free slot for it, and signals when it is done.
+    // -----------------------------------------------------------------------
+    SAX2ParallelParser&         fOwner;
+    const InputSource&          fSource;
+    const XMLByte* const        fData;
+    const XMLSize_t             fSize;
+    bool                        fUTF8;
+    XMLSize_t                   fContentStart;
+    XMLSize_t                   fContentEnd;
+    ValueVectorOf<XMLSize_t>    fBoundaries;
+    XMLFileLoc                  fPrefixLine;
+    XMLFileLoc                  fPrefixColumn;
+    States                      fState;
+    bool                        fRootSeen;
+    XMLSize_t                   fSkipCount;
+    XMLSize_t                   fTopSeen;
+    XMLSize_t                   fRecoverDepth;
+    bool                        fResumed;
+    bool                        fErrorsOn;
+    ParallelChunk               fPending;
+    ParallelLocator             fLocator;
+    SAX2XMLReader*              fRecoveryReader;
+    ParallelWorker**            fWorkers;
+    unsigned int                fWorkerCount;
+    ParallelChunk**             fSlots;
+    XMLSize_t                   fSlotCount;
+    std::mutex                  fMutex;
+    std::condition_variable     fChunkDone;
+    std::condition_variable     fSlotFreed;
+    XMLSize_t                   fNextChunk;
+    XMLSize_t                   fReplayedCount;
+    bool                        fCancelled;
+    MemoryManager* const        fMemoryManager;
+};
+
+SAX2ParallelParser::ParallelParse::ParallelParse(SAX2ParallelParser&     owner
+                                                 , const InputSource&    source
+                                                 , const XMLByte* const  data
+                                                 , const XMLSize_t       size) :
+    fOwner(owner)
+    , fSource(source)
+    , fData(data)
+    , fSize(size)
+    , fUTF8(true)
+    , fContentStart(0)
+    , fContentEnd(0)
+    , fBoundaries(64, owner.fMemoryManager)
+    , fPrefixLine(1)
+    , fPrefixColumn(1)
+    , fState(State_Frame)
+    , fRootSeen(false)
+    , fSkipCount(0)
+    , fTopSeen(0)
+    , fRecoverDepth(0)
+    , fResumed(false)
+    , fErrorsOn(false)
+    , fPending(owner.fMemoryManager)
+    , fRecoveryReader(0)
+    , fWorkers(0)
+    , fWorkerCount(0)
+    , fSlots(0)
+    , fSlotCount(0)
+    , fNextChunk(0)
+    , fReplayedCount(0)
+    , fCancelled(false)
+    , fMemoryManager(owner.fMemoryManager)
+{
+}
+
+SAX2ParallelParser::ParallelParse::~ParallelParse()
+{
+    stopWorkers();
+
+    if (fSlots)
+    {
+        for (XMLSize_t index = 0; index < fSlotCount; index++)
+            delete fSlots[index];
+        fMemoryManager->deallocate(fSlots);
+    }
+}
+
+//
+//  Splits the document up, and if that works, parses it. Returns false,
+//  without having called any handler, if the document can't be split.
+//
+bool SAX2ParallelParser::ParallelParse::parse()
+{
+    if (!split() || !startWorkers())
+        return false;
+
+    const ParallelSegment segments[2] =
+    {
+        { fData, fContentStart }
+        , { fData + fContentEnd, fSize - fContentEnd }
+    };
+    ParallelChunkSource frameSource(segments, 2, false, fSource, fMemoryManager);
+
+    SAX2XMLReader* reader = fOwner.createReader();
+    Janitor<SAX2XMLReader> janReader(reader);
+    reader->setContentHandler(this);
+    reader->setLexicalHandler(this);
+    reader->setErrorHandler(this);
+    reader->parse(frameSource);
+    return true;
+}
+
+//
+//  Finds the root element, its content, and the name of the elements to
+//  split the content before, and picks the chunk boundaries.
+//
+bool SAX2ParallelParser::ParallelParse::split()
+{
+    XMLSize_t pos = 0;
+
+    // A UTF-8 byte order mark is skipped, and doesn't count as a column
+    if (matchBytes(fData, 0, fSize, "\xEF\xBB\xBF"))
+        pos = 3;
+    const XMLSize_t docStart = pos;
+
+    //
+    //  This rules out UTF-16, UCS-4 and EBCDIC, which can't start with an
+    //  ASCII '<' or space followed by a non-null.
+    //
+    if ((pos + 2 > fSize)
+    ||  ((fData[pos] != '<') && !isSpaceByte(fData[pos]))
+    ||  !fData[pos + 1])
+    {
+        return false;
+    }
+
+    //
+    //  Check the XML declaration. Only version 1.0 is split, as it has no
+    //  other line ends, and only encodings which are ASCII compatible and
+    //  which the location can be worked out for.
+    //
+    if (matchBytes(fData, pos, fSize, "<?xml") && (pos + 5 < fSize)
+    &&  isSpaceByte(fData[pos + 5]))
+    {
+        const XMLSize_t declEnd = findBytes(fData, pos, fSize, "?>");
+        char value[16];
+        if (!getDeclValue(fData, pos, declEnd, "version", value, 15)
+        ||  strcmp(value, "1.0"))
+        {
+            return false;
+        }
+
+        if (getDeclValue(fData, pos, declEnd, "encoding", value, 15))
+        {
+            if (!XMLString::compareIString(value, "ISO-8859-1")
+            ||  !XMLString::compareIString(value, "US-ASCII"))
+            {
+                fUTF8 = false;
+            }
+            else if (XMLString::compareIString(value, "UTF-8"))
+            {
+                return false;
+            }
+        }
+        else if (findBytes(fData, pos, declEnd, "encoding") != declEnd)
+        {
+            return false;
+        }
+    }
+
+    //
+    //  Go through the prolog to the root element. The internal subset can
+    //  hold quoted literals, comments and PIs which might contain a '>' or
+    //  ']'.
+    //
+    while (true)
+    {
+        while ((pos < fSize) && isSpaceByte(fData[pos]))
+            pos++;
+        if ((pos + 1 >= fSize) || (fData[pos] != '<'))
+            return false;
+
+        if (skipMarkup(fData, pos, fSize))
+            continue;
+
+        if (!matchBytes(fData, pos, fSize, "<!DOCTYPE"))
+            break;
+
+        pos += 9;
+        bool inSubset = false;
+        bool closed = false;
+        while (!closed && (pos < fSize))
+        {
+            const XMLByte curByte = fData[pos];
+            if ((curByte == '"') || (curByte == '\''))
+            {
+                const XMLByte* closeQuote = (const XMLByte*) memchr
+                (
+                    fData + pos + 1, curByte, fSize - pos - 1
+                );
+                if (!closeQuote)
+                    return false;
+                pos = (closeQuote - fData) + 1;
+            }
+            else if (inSubset && (curByte == '<') && skipMarkup(fData, pos, fSize))
+            {
+            }
+            else
+            {
+                if (curByte == '[')
+                    inSubset = true;
+                else if (curByte == ']')
+                    inSubset = false;
+                else if ((curByte == '>') && !inSubset)
+                    closed = true;
+                pos++;
+            }
+        }
+        if (!closed)
+            return false;
+    }
+
+    // The root start tag, which has to have content to split
+    if ((fData[pos + 1] == '!') || (fData[pos + 1] == '/')
+    ||  isNameEndByte(fData[pos + 1]))
+    {
+        return false;
+    }
+
+    const XMLSize_t rootName = pos + 1;
+    while ((pos < fSize) && !isNameEndByte(fData[pos]))
+        pos++;
+    const XMLSize_t rootNameLen = pos - rootName;
+
+    while ((pos < fSize) && (fData[pos] != '>'))
+    {
+        if ((fData[pos] == '"') || (fData[pos] == '\''))
+        {
+            const XMLByte* closeQuote = (const XMLByte*) memchr
+            (
+                fData + pos + 1, fData[pos], fSize - pos - 1
+            );
+            if (!closeQuote)
+                return false;
+            pos = closeQuote - fData;
+        }
+        pos++;
+    }
+    if ((pos >= fSize) || (fData[pos - 1] == '/'))
+        return false;
+    fContentStart = pos + 1;
+
+    //
+    //  Find the root end tag, working back over the misc at the end. Then
+    //  go forward over the end to be sure that is all there is.
+    //
+    XMLSize_t end = fSize;
+    while (true)
+    {
+        while ((end > fContentStart) && isSpaceByte(fData[end - 1]))
+            end--;
+        if ((end < fContentStart + 3) || (fData[end - 1] != '>'))
+            return false;
+
+        const char* openStr;
+        if ((fData[end - 2] == '-') && (fData[end - 3] == '-'))
+            openStr = "<!--";
+        else if (fData[end - 2] == '?')
+            openStr = "<?";
+        else
+            openStr = "</";
+
+        const XMLSize_t openLen = strlen(openStr);
+        XMLSize_t openPos = end - 1;
+        while ((openPos > fContentStart) && !matchBytes(fData, openPos, end, openStr))
+            openPos--;
+        if (!matchBytes(fData, openPos, end, openStr) || (openPos + openLen >= end))
+            return false;
+
+        end = openPos;
+        if (openStr[1] == '/')
+            break;
+    }
+    fContentEnd = end;
+
+    pos = fContentEnd + 2;
+    if ((pos + rootNameLen > fSize)
+    ||  memcmp(fData + pos, fData + rootName, rootNameLen))
+    {
+        return false;
+    }
+    pos += rootNameLen;
+    while ((pos < fSize) && isSpaceByte(fData[pos]))
+        pos++;
+    if ((pos >= fSize) || (fData[pos] != '>'))
+        return false;
+    pos++;
+    while (pos < fSize)
+    {
+        if (isSpaceByte(fData[pos]))
+            pos++;
+        else if ((fData[pos] != '<') || matchBytes(fData, pos, fSize, "<![CDATA[")
+             ||  !skipMarkup(fData, pos, fSize))
+            return false;
+    }
+
+    //
+    //  The elements to split before are named after the first child of the
+    //  root.
+    //
+    pos = fContentStart;
+    while (true)
+    {
+        const XMLByte* found = (const XMLByte*) memchr
+        (
+            fData + pos, '<', fContentEnd - pos
+        );
+        if (!found)
+            return false;
+
+        pos = found - fData;
+        if (!skipMarkup(fData, pos, fContentEnd))
+            break;
+    }
+    if ((pos + 1 >= fContentEnd) || (fData[pos + 1] == '!')
+    ||  (fData[pos + 1] == '/') || isNameEndByte(fData[pos + 1]))
+    {
+        return false;
+    }
+
+    const XMLSize_t recordName = pos;
+    while ((pos < fContentEnd) && !isNameEndByte(fData[pos]))
+        pos++;
+    const XMLSize_t recordNameLen = pos - recordName;
+
+    //
+    //  Each boundary is at the first start tag of that name at least a chunk
+    //  after the last one. It is only a guess, which is checked by parsing.
+    //
+    const XMLSize_t chunkSize = fOwner.fChunkSize ? fOwner.fChunkSize : 1;
+    fBoundaries.addElement(fContentStart);
+    pos = fContentStart + chunkSize;
+    while (pos < fContentEnd)
+    {
+        const XMLByte* found = (const XMLByte*) memchr
+        (
+            fData + pos, '<', fContentEnd - pos
+        );
+        if (!found)
+            break;
+
+        pos = found - fData;
+        if ((pos + recordNameLen < fContentEnd)
+        &&  !memcmp(fData + pos, fData + recordName, recordNameLen)
+        &&  isNameEndByte(fData[pos + recordNameLen]))
+        {
+            fBoundaries.addElement(pos);
+            pos += chunkSize;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+    fBoundaries.addElement(fContentEnd);
+
+    if (fBoundaries.size() < 3)
+        return false;
+
+    advanceLocation(fData, docStart, fContentStart, fUTF8, fPrefixLine, fPrefixColumn);
+    return true;
+}
+
+bool SAX2ParallelParser::ParallelParse::startWorkers()
+{
+    const XMLSize_t chunkCount = fBoundaries.size() - 1;
+    XMLSize_t workerCount = fOwner.fThreadCount;
+    if (!workerCount)
+    {
+        // With one processor, the workers would only get in the way
+        workerCount = std::thread::hardware_concurrency();
+        if (workerCount < 2)
+            return false;
+    }
+    if (workerCount > chunkCount)
+        workerCount = chunkCount;
+
+    fSlotCount = workerCount * 2;
+    fSlots = (ParallelChunk**) fMemoryManager->allocate
+    (
+        fSlotCount * sizeof(ParallelChunk*)
+    );
+    memset(fSlots, 0, fSlotCount * sizeof(ParallelChunk*));
+    for (XMLSize_t index = 0; index < fSlotCount; index++)
+        fSlots[index] = new (fMemoryManager) ParallelChunk(fMemoryManager);
+
+    fWorkers = (ParallelWorker**) fMemoryManager->allocate
+    (
+        workerCount * sizeof(ParallelWorker*)
+    );
+    for (XMLSize_t index = 0; index < workerCount; index++)
+    {
+        ParallelWorker* worker = new (fMemoryManager) ParallelWorker;
+        fWorkers[fWorkerCount++] = worker;
+        worker->fReader = fOwner.createReader();
+        worker->fReader->setContentHandler(&worker->fRecorder);
+        worker->fReader->setLexicalHandler(&worker->fRecorder);
+        worker->fReader->setErrorHandler(&worker->fRecorder);
+
+        try
+        {
+            worker->fThread = std::thread(&ParallelParse::work, this, worker);
+        }
+        catch (const std::system_error&)
+        {
+            break;
+        }
+    }
+
+    // Any threads that did start can do the work
+    return fWorkers[0]->fThread.joinable();
+}
+
+void SAX2ParallelParser::ParallelParse::stopWorkers()
+{
+    if (!fWorkers)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fCancelled = true;
+    }
+    fSlotFreed.notify_all();
+
+    for (unsigned int index = 0; index < fWorkerCount; index++)
+    {
+        if (fWorkers[index]->fThread.joinable())
+            fWorkers[index]->fThread.join();
+        delete fWorkers[index];
+    }
+    fMemoryManager->deallocate(fWorkers);
+    fWorkers = 0;
+    fWorkerCount = 0;
+}
+
+void SAX2ParallelParser::ParallelParse::work(ParallelWorker* const worker)
+{
+    const XMLSize_t chunkCount = fBoundaries.size() - 1;
+    while (true)
+    {
+        // Wait for the next chunk to have a free slot
+        XMLSize_t chunkIndex;
+        ParallelChunk* chunk;
+        {
+            std::unique_lock<std::mutex> lock(fMutex);
+            while (!fCancelled && (fNextChunk < chunkCount)
+            &&     (fNextChunk >= fReplayedCount + fSlotCount))
+            {
+                fSlotFreed.wait(lock);
+            }
+
+            if (fCancelled || (fNextChunk >= chunkCount))
+                return;
+
+            chunkIndex = fNextChunk++;
+            chunk = fSlots[chunkIndex % fSlotCount];
+            chunk->fIndex = chunkIndex;
+        }
+
+        const XMLSize_t chunkStart = fBoundaries.elementAt(chunkIndex);
+        const XMLSize_t chunkEnd = fBoundaries.elementAt(chunkIndex + 1);
+        const ParallelSegment segments[3] =
+        {
+            { fData, fContentStart }
+            , { fData + chunkStart, chunkEnd - chunkStart }
+            , { fData + fContentEnd, fSize - fContentEnd }
+        };
+
+        worker->fRecorder.startChunk(chunk);
+        try
+        {
+            ParallelChunkSource chunkSource(segments, 3, false, fSource, fMemoryManager);
+            worker->fReader->parse(chunkSource);
+        }
+        catch (...)
+        {
+            chunk->fFailed = true;
+        }
+        if (!worker->fRecorder.getRootEnded())
+            chunk->fFailed = true;
+
+        advanceLocation(fData, chunkStart, chunkEnd, fUTF8, chunk->fLines, chunk->fColumns);
+
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            chunk->fDone = true;
+        }
+        fChunkDone.notify_all();
+    }
+}
+
+//
+//  Hands on the chunks in order, or stops at the first failed one and
+//  parses the rest of the document here.
+//
+void SAX2ParallelParser::ParallelParse::replayChunks()
+{
+    const XMLSize_t chunkCount = fBoundaries.size() - 1;
+    XMLFileLoc line = fPrefixLine;
+    XMLFileLoc column = fPrefixColumn;
+    XMLSize_t topCount = 0;
+    for (XMLSize_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        ParallelChunk* chunk = fSlots[chunkIndex % fSlotCount];
+        {
+            std::unique_lock<std::mutex> lock(fMutex);
+            while ((chunk->fIndex != chunkIndex) || !chunk->fDone)
+                fChunkDone.wait(lock);
+        }
+
+        if (chunk->fFailed)
+        {
+            stopWorkers();
+            recover(chunkIndex, topCount);
+            return;
+        }
+
+        replay(*chunk, line, column);
+        topCount += chunk->fTopCount;
+        if (chunk->fLines)
+        {
+            line += chunk->fLines;
+            column = chunk->fColumns;
+        }
+        else
+        {
+            column += chunk->fColumns;
+        }
+
+        chunk->reset();
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fReplayedCount++;
+        }
+        fSlotFreed.notify_all();
+    }
+
+    stopWorkers();
+    fLocator.setShifted(fPrefixLine, fPrefixColumn, line, column);
+    fOwner.fParsedInParallel = true;
+}
+
+void SAX2ParallelParser::ParallelParse::replay(const ParallelChunk&    chunk
+                                               , const XMLFileLoc      line
+                                               , const XMLFileLoc      column)
+{
+    ContentHandler* contentHandler = fOwner.fContentHandler;
+    LexicalHandler* lexicalHandler = fOwner.fLexicalHandler;
+    const XMLSize_t eventCount = chunk.fEvents.size();
+    for (XMLSize_t index = 0; index < eventCount; index++)
+    {
+        const ParallelEvent& event = chunk.fEvents.elementAt(index);
+        XMLFileLoc eventLine = event.fLine;
+        XMLFileLoc eventColumn = event.fColumn;
+        mapLocation(eventLine, eventColumn, fPrefixLine, fPrefixColumn, line, column);
+        fLocator.setFixed(eventLine, eventColumn);
+
+        const XMLCh* text1 = chunk.getString(event.fText1);
+        switch(event.fType)
+        {
+        case ParallelEvent_StartElement :
+            if (contentHandler)
+            {
+                ParallelAttributes attrs(chunk, event);
+                contentHandler->startElement
+                (
+                    text1, chunk.getString(event.fText2), chunk.getString(event.fText3), attrs
+                );
+            }
+            break;
+
+        case ParallelEvent_EndElement :
+            if (contentHandler)
+            {
+                contentHandler->endElement
+                (
+                    text1, chunk.getString(event.fText2), chunk.getString(event.fText3)
+                );
+            }
+            break;
+
+        case ParallelEvent_Characters :
+            if (contentHandler)
+                contentHandler->characters(text1, event.fLength);
+            break;
+
+        case ParallelEvent_Whitespace :
+            if (contentHandler)
+                contentHandler->ignorableWhitespace(text1, event.fLength);
+            break;
+
+        case ParallelEvent_PI :
+            if (contentHandler)
+                contentHandler->processingInstruction(text1, chunk.getString(event.fText2));
+            break;
+
+        case ParallelEvent_StartPrefix :
+            if (contentHandler)
+                contentHandler->startPrefixMapping(text1, chunk.getString(event.fText2));
+            break;
+
+        case ParallelEvent_EndPrefix :
+            if (contentHandler)
+                contentHandler->endPrefixMapping(text1);
+            break;
+
+        case ParallelEvent_SkippedEntity :
+            if (contentHandler)
+                contentHandler->skippedEntity(text1);
+            break;
+
+        case ParallelEvent_Comment :
+            if (lexicalHandler)
+                lexicalHandler->comment(text1, event.fLength);
+            break;
+
+        case ParallelEvent_StartCDATA :
+            if (lexicalHandler)
+                lexicalHandler->startCDATA();
+            break;
+
+        case ParallelEvent_EndCDATA :
+            if (lexicalHandler)
+                lexicalHandler->endCDATA();
+            break;
+
+        case ParallelEvent_StartEntity :
+            if (lexicalHandler)
+                lexicalHandler->startEntity(text1);
+            break;
+
+        case ParallelEvent_EndEntity :
+            if (lexicalHandler)
+                lexicalHandler->endEntity(text1);
+            break;
+        default :
+            break;
+        }
+    }
+}
+
+//
+//  Parses the whole document again, with this object as the handler,
+//  carrying on after the children of the root which were handed on from
+//  the chunks before the failed one. Those are skipped by the reader, so
+//  only the prolog and the start tags of the skipped elements are looked
+//  at again.
+//
+void SAX2ParallelParser::ParallelParse::recover(const XMLSize_t   failedIndex
+                                                , const XMLSize_t skipCount)
+{
+    fState = State_Recovering;
+    fSkipCount = skipCount;
+    fTopSeen = 0;
+    fRecoverDepth = 0;
+    fResumed = false;
+    fErrorsOn = false;
+    fPending.reset();
+
+    // The first chunk carries on right after the root start tag
+    if (!failedIndex)
+        fSkipCount = ~(XMLSize_t)0;
+
+    const ParallelSegment segment = { fData, fSize };
+    ParallelChunkSource wholeSource(&segment, 1, true, fSource, fMemoryManager);
+
+    fRecoveryReader = fOwner.createReader();
+    Janitor<SAX2XMLReader> janReader(fRecoveryReader);
+    fRecoveryReader->setContentHandler(this);
+    fRecoveryReader->setLexicalHandler(this);
+    fRecoveryReader->setErrorHandler(this);
+    fRecoveryReader->parse(wholeSource);
+
+    fRecoveryReader = 0;
+    fState = State_Done;
+}
+
+void SAX2ParallelParser::ParallelParse::flushPending()
+{
+    ContentHandler* contentHandler = fOwner.fContentHandler;
+    const XMLSize_t eventCount = fPending.fEvents.size();
+    for (XMLSize_t index = 0; index < eventCount && contentHandler; index++)
+    {
+        const ParallelEvent& event = fPending.fEvents.elementAt(index);
+        contentHandler->startPrefixMapping
+        (
+            fPending.getString(event.fText1), fPending.getString(event.fText2)
+        );
+    }
+    fPending.reset();
+}
+
+bool SAX2ParallelParser::ParallelParse::isPassing() const
+{
+    return (fState == State_Frame) || ((fState == State_Recovering) && fResumed);
+}
+
+void SAX2ParallelParser::ParallelParse::reportError(const SAXParseException&  exc
+                                                    , const ErrTypes          errType)
+{
+    ErrorHandler* errorHandler = fOwner.fErrorHandler;
+    if (!errorHandler || (fState == State_Done)
+    ||  ((fState == State_Recovering) && !fErrorsOn))
+    {
+        return;
+    }
+
+    XMLFileLoc line = exc.getLineNumber();
+    XMLFileLoc column = exc.getColumnNumber();
+    if (fState == State_Frame)
+        fLocator.map(line, column);
+
+    SAXParseException toReport
+    (
+        exc.getMessage()
+        , exc.getPublicId()
+        , exc.getSystemId()
+        , line
+        , column
+        , fMemoryManager
+    );
+
+    if (errType == ErrType_Warning)
+        errorHandler->warning(toReport);
+    else if (errType == ErrType_Fatal)
+        errorHandler->fatalError(toReport);
+    else
+        errorHandler->error(toReport);
+}
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser::ParallelParse: The handler interfaces
+// ---------------------------------------------------------------------------
+void SAX2ParallelParser::ParallelParse::setDocumentLocator(const Locator* const locator)
+{
+    fLocator.setLocator(locator);
+    if ((fState == State_Frame) && fOwner.fContentHandler)
+        fOwner.fContentHandler->setDocumentLocator(&fLocator);
+}
+
+void SAX2ParallelParser::ParallelParse::startDocument()
+{
+    if ((fState == State_Frame) && fOwner.fContentHandler)
+        fOwner.fContentHandler->startDocument();
+}
+
+void SAX2ParallelParser::ParallelParse::endDocument()
+{
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->endDocument();
+}
+
+void SAX2ParallelParser::ParallelParse::startElement(const XMLCh* const    uri
+                                                     , const XMLCh* const  localname
+                                                     , const XMLCh* const  qname
+                                                     , const Attributes&   attrs)
+{
+    if (fState == State_Recovering)
+    {
+        fRecoverDepth++;
+        if (!fResumed)
+        {
+            //
+            //  The root start tag was handed on by the frame parse. The
+            //  errors from here on are new, unless there are children to
+            //  skip first.
+            //
+            if (fRecoverDepth == 1)
+            {
+                if (fSkipCount == ~(XMLSize_t)0)
+                {
+                    fResumed = true;
+                    fErrorsOn = true;
+                }
+                else if (!fSkipCount)
+                {
+                    fErrorsOn = true;
+                }
+                return;
+            }
+
+            if (++fTopSeen <= fSkipCount)
+            {
+                fPending.reset();
+                fRecoveryReader->skipElement();
+                return;
+            }
+
+            fResumed = true;
+            flushPending();
+        }
+    }
+    else if (fState == State_Frame)
+    {
+        if (fOwner.fContentHandler)
+            fOwner.fContentHandler->startElement(uri, localname, qname, attrs);
+
+        // The frame only has the root element
+        if (!fRootSeen)
+        {
+            fRootSeen = true;
+            replayChunks();
+        }
+        return;
+    }
+
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->startElement(uri, localname, qname, attrs);
+}
+
+void SAX2ParallelParser::ParallelParse::endElement(const XMLCh* const    uri
+                                                   , const XMLCh* const  localname
+                                                   , const XMLCh* const  qname)
+{
+    if (fState == State_Recovering)
+    {
+        if (!fResumed && (fRecoverDepth == 2) && (fTopSeen == fSkipCount))
+            fErrorsOn = true;
+        if (fRecoverDepth)
+            fRecoverDepth--;
+    }
+
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->endElement(uri, localname, qname);
+}
+
+void SAX2ParallelParser::ParallelParse::characters(const XMLCh* const   chars
+                                                   , const XMLSize_t    length)
+{
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->characters(chars, length);
+}
+
+void SAX2ParallelParser::ParallelParse::ignorableWhitespace(const XMLCh* const   chars
+                                                            , const XMLSize_t    length)
+{
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->ignorableWhitespace(chars, length);
+}
+
+void SAX2ParallelParser::ParallelParse::processingInstruction(const XMLCh* const   target
+                                                              , const XMLCh* const data)
+{
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->processingInstruction(target, data);
+}
+
+void SAX2ParallelParser::ParallelParse::startPrefixMapping(const XMLCh* const   prefix
+                                                           , const XMLCh* const uri)
+{
+    //
+    //  The mappings of a child of the root come before it, so they are held
+    //  back until it is known whether it is skipped.
+    //
+    if ((fState == State_Recovering) && !fResumed && (fRecoverDepth == 1))
+    {
+        ParallelEvent event;
+        event.fType = ParallelEvent_StartPrefix;
+        event.fText1 = fPending.addString(prefix);
+        event.fText2 = fPending.addString(uri);
+        fPending.fEvents.addElement(event);
+        return;
+    }
+
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->startPrefixMapping(prefix, uri);
+}
+
+void SAX2ParallelParser::ParallelParse::endPrefixMapping(const XMLCh* const prefix)
+{
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->endPrefixMapping(prefix);
+}
+
+void SAX2ParallelParser::ParallelParse::skippedEntity(const XMLCh* const name)
+{
+    if (isPassing() && fOwner.fContentHandler)
+        fOwner.fContentHandler->skippedEntity(name);
+}
+
+void SAX2ParallelParser::ParallelParse::comment(const XMLCh* const  chars
+                                                , const XMLSize_t   length)
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->comment(chars, length);
+}
+
+void SAX2ParallelParser::ParallelParse::startCDATA()
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->startCDATA();
+}
+
+void SAX2ParallelParser::ParallelParse::endCDATA()
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->endCDATA();
+}
+
+void SAX2ParallelParser::ParallelParse::startDTD(const XMLCh* const    name
+                                                 , const XMLCh* const  publicId
+                                                 , const XMLCh* const  systemId)
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->startDTD(name, publicId, systemId);
+}
+
+void SAX2ParallelParser::ParallelParse::endDTD()
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->endDTD();
+}
+
+void SAX2ParallelParser::ParallelParse::startEntity(const XMLCh* const name)
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->startEntity(name);
+}
+
+void SAX2ParallelParser::ParallelParse::endEntity(const XMLCh* const name)
+{
+    if (isPassing() && fOwner.fLexicalHandler)
+        fOwner.fLexicalHandler->endEntity(name);
+}
+
+void SAX2ParallelParser::ParallelParse::warning(const SAXParseException& exc)
+{
+    reportError(exc, ErrType_Warning);
+}
+
+void SAX2ParallelParser::ParallelParse::error(const SAXParseException& exc)
+{
+    reportError(exc, ErrType_Error);
+}
+
+void SAX2ParallelParser::ParallelParse::fatalError(const SAXParseException& exc)
+{
+    reportError(exc, ErrType_Fatal);
+}
+
+void SAX2ParallelParser::ParallelParse::resetErrors()
+{
+    if ((fState == State_Frame) && fOwner.fErrorHandler)
+        fOwner.fErrorHandler->resetErrors();
+}
+
+#endif
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser: Constructors and Destructor
+// ---------------------------------------------------------------------------
+SAX2ParallelParser::SAX2ParallelParser(MemoryManager* const manager) :
+
+    fContentHandler(0)
+    , fLexicalHandler(0)
+    , fErrorHandler(0)
+    , fEntityResolver(0)
+    , fDoNamespaces(true)
+    , fNamespacePrefixes(false)
+    , fLoadExternalDTD(true)
+    , fParsedInParallel(false)
+    , fThreadCount(0)
+    , fChunkSize(1024 * 1024)
+    , fMemoryManager(manager)
+{
+}
+
+SAX2ParallelParser::~SAX2ParallelParser()
+{
+}
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser: Parsing methods
+// ---------------------------------------------------------------------------
+void SAX2ParallelParser::parse(const InputSource& source)
+{
+    fParsedInParallel = false;
+
+#if defined(XERCES_PARALLEL_PARSE)
+    //
+    //  The document can only be split if it is all in memory already, and
+    //  if its encoding can be worked out from its start.
+    //
+    if (!source.getEncoding())
+    {
+        BinInputStream* stream = source.makeStream();
+        Janitor<BinInputStream> janStream(stream);
+        XMLSize_t size = 0;
+        const XMLByte* data = stream ? stream->getInMemoryBuffer(size) : 0;
+        if (data)
+        {
+            ParallelParse parallelParse(*this, source, data, size);
+            if (parallelParse.parse())
+                return;
+        }
+    }
+#endif
+
+    SAX2XMLReader* reader = createReader();
+    Janitor<SAX2XMLReader> janReader(reader);
+    reader->setContentHandler(fContentHandler);
+    reader->setLexicalHandler(fLexicalHandler);
+    reader->setErrorHandler(fErrorHandler);
+    reader->parse(source);
+}
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser: Private helper methods
+// ---------------------------------------------------------------------------
+SAX2XMLReader* SAX2ParallelParser::createReader() const
+{
+    SAX2XMLReader* reader = new (fMemoryManager) SAX2XMLReaderImpl(fMemoryManager);
+    reader->setFeature(XMLUni::fgSAX2CoreNameSpaces, fDoNamespaces);
+    reader->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, fNamespacePrefixes);
+    reader->setFeature(XMLUni::fgSAX2CoreValidation, false);
+    reader->setFeature(XMLUni::fgXercesLoadExternalDTD, fLoadExternalDTD);
+    reader->setEntityResolver(fEntityResolver);
+    return reader;
+}
+
+XERCES_CPP_NAMESPACE_END
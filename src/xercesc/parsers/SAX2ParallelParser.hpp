@@ -0,0 +1,441 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_SAX2PARALLELPARSER_HPP)
+#define XERCESC_INCLUDE_GUARD_SAX2PARALLELPARSER_HPP
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMemory.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+
+class ContentHandler;
+class EntityResolver;
+class ErrorHandler;
+class InputSource;
+class LexicalHandler;
+class SAX2XMLReader;
+
+/**
+  * This class parses a large document on several threads, and reports it
+  * to the SAX2 handlers in the same order, and with the same locations, as
+  * a SAX2XMLReader would.
+  *
+  * <p>It is meant for record oriented documents, which have a root element
+  * holding many elements of the same name. The content of the root element
+  * is split into chunks in front of those elements, and each chunk is
+  * parsed on a worker thread as a document of its own, made of the prolog
+  * and root start tag of the real document, the chunk, and the root end
+  * tag. So each chunk sees the namespace declarations of the root and the
+  * entities declared in the DTD. The workers record the events, and the
+  * calling thread hands them to the handlers in document order. Only a few
+  * chunks are parsed ahead of the ones being handed on, which bounds the
+  * memory used.</p>
+  *
+  * <p>The chunks are found by searching for the start tags, without
+  * scanning the markup in between, so a split can land inside a comment, a
+  * CDATA section or a nested element of the same name. That shows up as an
+  * error in the chunk, and the rest of the document is then parsed on the
+  * calling thread, carrying on from where the last good chunk left off.
+  * The same happens for a real error, which is reported just as the serial
+  * parse would report it.</p>
+  *
+  * <p>Only documents whose content is in memory can be split, that is a
+  * MemBufInputSource or a LocalFileInputSource which maps its file, and
+  * only documents in UTF-8, US-ASCII or ISO-8859-1. Others, and documents
+  * too small to be worth splitting, are parsed on the calling thread. The
+  * parser does not validate. The handlers are only called on the calling
+  * thread, but an entity resolver is called from the workers as well, so
+  * it has to be thread safe. So does the memory manager.</p>
+  */
+class PARSERS_EXPORT SAX2ParallelParser : public XMemory
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    /** @name Constructors and Destructor */
+    //@{
+    /** Constructor
+      *
+      * @param manager    Pointer to the memory manager to be used to
+      *                   allocate objects.
+      */
+    SAX2ParallelParser
+    (
+        MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager
+    );
+
+    /**
+      * Destructor
+      */
+    ~SAX2ParallelParser();
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Getter methods
+    // -----------------------------------------------------------------------
+    /** @name Getter methods */
+    //@{
+    /** Get the installed content handler
+      *
+      * @return The installed content handler, or 0 if none.
+      */
+    ContentHandler* getContentHandler() const;
+
+    /** Get the installed lexical handler
+      *
+      * @return The installed lexical handler, or 0 if none.
+      */
+    LexicalHandler* getLexicalHandler() const;
+
+    /** Get the installed error handler
+      *
+      * @return The installed error handler, or 0 if none.
+      */
+    ErrorHandler* getErrorHandler() const;
+
+    /** Get the installed entity resolver
+      *
+      * @return The installed entity resolver, or 0 if none.
+      */
+    EntityResolver* getEntityResolver() const;
+
+    /** Get the 'do namespaces' flag
+      *
+      * @return true if namespaces are processed, false otherwise.
+      *
+      * @see #setDoNamespaces
+      */
+    bool getDoNamespaces() const;
+
+    /** Get the 'namespace prefixes' flag
+      *
+      * @return true if the namespace declarations are reported as
+      *         attributes, false otherwise.
+      *
+      * @see #setNamespacePrefixes
+      */
+    bool getNamespacePrefixes() const;
+
+    /** Get the 'load external DTD' flag
+      *
+      * @return true if the external DTD is loaded, false otherwise.
+      *
+      * @see #setLoadExternalDTD
+      */
+    bool getLoadExternalDTD() const;
+
+    /** Get the number of worker threads
+      *
+      * @return The number of worker threads, or 0 if it is worked out
+      *         from the number of processors.
+      *
+      * @see #setThreadCount
+      */
+    unsigned int getThreadCount() const;
+
+    /** Get the chunk size
+      *
+      * @return The number of bytes that the document is split into.
+      *
+      * @see #setChunkSize
+      */
+    XMLSize_t getChunkSize() const;
+
+    /** Find out if the last document was parsed in parallel
+      *
+      * @return true if the last document was split into chunks and all of
+      *         them were parsed by the workers, false if it was parsed on
+      *         the calling thread, in whole or in part.
+      */
+    bool getParsedInParallel() const;
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Setter methods
+    // -----------------------------------------------------------------------
+    /** @name Setter methods */
+    //@{
+    /** Set the content handler
+      *
+      * @param handler The content handler, or 0 for none.
+      */
+    void setContentHandler(ContentHandler* const handler);
+
+    /** Set the lexical handler
+      *
+      * @param handler The lexical handler, or 0 for none.
+      */
+    void setLexicalHandler(LexicalHandler* const handler);
+
+    /** Set the error handler
+      *
+      * If there is no error handler, errors are not reported, and a fatal
+      * error just ends the parse, as with SAX2XMLReader.
+      *
+      * @param handler The error handler, or 0 for none.
+      */
+    void setErrorHandler(ErrorHandler* const handler);
+
+    /** Set the entity resolver
+      *
+      * The resolver is called from the worker threads, which parse the
+      * prolog of the document with each chunk, so it has to be thread safe.
+      *
+      * @param resolver The entity resolver, or 0 for none.
+      */
+    void setEntityResolver(EntityResolver* const resolver);
+
+    /** Set the 'do namespaces' flag
+      *
+      * This is the same as the SAX2 namespaces feature. The default is true.
+      *
+      * @param newState The value specifying whether namespaces are
+      *                 processed or not.
+      */
+    void setDoNamespaces(const bool newState);
+
+    /** Set the 'namespace prefixes' flag
+      *
+      * This is the same as the SAX2 namespace prefixes feature. The default
+      * is false.
+      *
+      * @param newState The value specifying whether namespace declarations
+      *                 are reported as attributes or not.
+      */
+    void setNamespacePrefixes(const bool newState);
+
+    /** Set the 'load external DTD' flag
+      *
+      * The default is true.
+      *
+      * @param newState The value specifying whether the external DTD is
+      *                 loaded or not.
+      */
+    void setLoadExternalDTD(const bool newState);
+
+    /** Set the number of worker threads
+      *
+      * @param threadCount The number of worker threads. The default, 0,
+      *                    uses one per processor, or none if there is only
+      *                    one, so that the document is parsed on the
+      *                    calling thread.
+      */
+    void setThreadCount(const unsigned int threadCount);
+
+    /** Set the chunk size
+      *
+      * The document is split into chunks of about this many bytes. Each
+      * split adds a parse of the prolog to the work, so the chunks should
+      * be large compared to it. The default is 1MB.
+      *
+      * @param chunkSize The number of bytes in a chunk.
+      */
+    void setChunkSize(const XMLSize_t chunkSize);
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Parsing methods
+    // -----------------------------------------------------------------------
+    /** @name Parsing methods */
+    //@{
+    /** Parse a document
+      *
+      * This method parses the document, in parallel if it can, calling the
+      * installed handlers on the calling thread as it goes. It returns when
+      * the document has been parsed.
+      *
+      * @param source A const reference to the InputSource object which
+      *               points to the XML file to be parsed.
+      *
+      * @exception SAXException Any SAX exception, possibly
+      *            wrapping another exception.
+      * @exception XMLException An exception from the parser or client
+      *            handler code.
+      */
+    void parse(const InputSource& source);
+    //@}
+
+
+private :
+    // -----------------------------------------------------------------------
+    //  Private class types
+    // -----------------------------------------------------------------------
+    class ParallelParse;
+
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    SAX2ParallelParser(const SAX2ParallelParser&);
+    SAX2ParallelParser& operator=(const SAX2ParallelParser&);
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    SAX2XMLReader* createReader() const;
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fContentHandler
+    //  fLexicalHandler
+    //  fErrorHandler
+    //  fEntityResolver
+    //      The installed handlers. They are set on every reader used for
+    //      a parse, except that the worker readers record the events
+    //      instead of calling the first three.
+    //
+    //  fDoNamespaces
+    //  fNamespacePrefixes
+    //  fLoadExternalDTD
+    //      The features that every reader is set up with.
+    //
+    //  fThreadCount
+    //  fChunkSize
+    //      How to split up the work.
+    //
+    //  fParsedInParallel
+    //      Whether the last parse ran on the workers from start to end.
+    // -----------------------------------------------------------------------
+    ContentHandler*     fContentHandler;
+    LexicalHandler*     fLexicalHandler;
+    ErrorHandler*       fErrorHandler;
+    EntityResolver*     fEntityResolver;
+    bool                fDoNamespaces;
+    bool                fNamespacePrefixes;
+    bool                fLoadExternalDTD;
+    bool                fParsedInParallel;
+    unsigned int        fThreadCount;
+    XMLSize_t           fChunkSize;
+    MemoryManager*      fMemoryManager;
+};
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser: Getter methods
+// ---------------------------------------------------------------------------
+inline ContentHandler* SAX2ParallelParser::getContentHandler() const
+{
+    return fContentHandler;
+}
+
+inline LexicalHandler* SAX2ParallelParser::getLexicalHandler() const
+{
+    return fLexicalHandler;
+}
+
+inline ErrorHandler* SAX2ParallelParser::getErrorHandler() const
+{
+    return fErrorHandler;
+}
+
+inline EntityResolver* SAX2ParallelParser::getEntityResolver() const
+{
+    return fEntityResolver;
+}
+
+inline bool SAX2ParallelParser::getDoNamespaces() const
+{
+    return fDoNamespaces;
+}
+
+inline bool SAX2ParallelParser::getNamespacePrefixes() const
+{
+    return fNamespacePrefixes;
+}
+
+inline bool SAX2ParallelParser::getLoadExternalDTD() const
+{
+    return fLoadExternalDTD;
+}
+
+inline unsigned int SAX2ParallelParser::getThreadCount() const
+{
+    return fThreadCount;
+}
+
+inline XMLSize_t SAX2ParallelParser::getChunkSize() const
+{
+    return fChunkSize;
+}
+
+inline bool SAX2ParallelParser::getParsedInParallel() const
+{
+    return fParsedInParallel;
+}
+
+
+// ---------------------------------------------------------------------------
+//  SAX2ParallelParser: Setter methods
+// ---------------------------------------------------------------------------
+inline void SAX2ParallelParser::setContentHandler(ContentHandler* const handler)
+{
+    fContentHandler = handler;
+}
+
+inline void SAX2ParallelParser::setLexicalHandler(LexicalHandler* const handler)
+{
+    fLexicalHandler = handler;
+}
+
+inline void SAX2ParallelParser::setErrorHandler(ErrorHandler* const handler)
+{
+    fErrorHandler = handler;
+}
+
+inline void SAX2ParallelParser::setEntityResolver(EntityResolver* const resolver)
+{
+    fEntityResolver = resolver;
+}
+
+inline void SAX2ParallelParser::setDoNamespaces(const bool newState)
+{
+    fDoNamespaces = newState;
+}
+
+inline void SAX2ParallelParser::setNamespacePrefixes(const bool newState)
+{
+    fNamespacePrefixes = newState;
+}
+
+inline void SAX2ParallelParser::setLoadExternalDTD(const bool newState)
+{
+    fLoadExternalDTD = newState;
+}
+
+inline void SAX2ParallelParser::setThreadCount(const unsigned int threadCount)
+{
+    fThreadCount = threadCount;
+}
+
+inline void SAX2ParallelParser::setChunkSize(const XMLSize_t chunkSize)
+{
+    fChunkSize = chunkSize;
+}
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
@@ -190,6 +190,25 @@ void SAX2XMLFilterImpl::parseReset(XMLPScanToken& token)
         fParentReader->parseReset(token);
 }
 
+void SAX2XMLFilterImpl::feed(const  XMLByte* const  bytes
+                            , const XMLSize_t       count)
+{
+    if(fParentReader)
+        fParentReader->feed(bytes, count);
+}
+
+void SAX2XMLFilterImpl::finish()
+{
+    if(fParentReader)
+        fParentReader->finish();
+}
+
+void SAX2XMLFilterImpl::skipElement()
+{
+    if(fParentReader)
+        fParentReader->skipElement();
+}
+
 // ---------------------------------------------------------------------------
 //  SAX2XMLFilterImpl: Features and Properties
 // ---------------------------------------------------------------------------
@@ -698,6 +698,51 @@ public :
       */
     virtual void parseReset(XMLPScanToken& token) ;
 
+    /** Parse the next chunk of a document that is pushed to the parser
+      *
+      * This method is used to parse a document that arrives a chunk at
+      * a time, for instance from a non-blocking socket, without tying up
+      * a thread per document. The first call starts a new parse. Each
+      * call then parses as much of the document as the bytes passed in so
+      * far allow, invoking the handlers as it goes, and returns without
+      * waiting for more. Call finish() once the last chunk is passed in.
+      *
+      * The bytes are copied, so the caller can reuse the buffer. Only a
+      * token which is split across chunks is kept until the rest of it
+      * arrives. Documents in UTF-16, UCS-4 or EBCDIC are the exception,
+      * and are kept until finish() is called.
+      *
+      * No other parse can be started until finish() is called. If the
+      * parse stops early because of a fatal error, the rest of the chunks
+      * are ignored.
+      *
+      * @param bytes A pointer to the next bytes of the document.
+      * @param count The number of bytes to parse.
+      *
+      * @see #finish
+      */
+    virtual void feed
+    (
+        const   XMLByte* const  bytes
+        , const XMLSize_t       count
+    ) ;
+
+    /** Finish a push parse operation
+      *
+      * This method tells the parser that all of the document has been
+      * passed to feed(). It parses the rest of it and resets the parser
+      * so that it can be used for another parse.
+      *
+      * @see #feed
+      */
+    virtual void finish() ;
+
+    /** Skip the content of the current element
+      *
+      * @see SAX2XMLReader#skipElement
+      */
+    virtual void skipElement() ;
+
     //@}
 
     // -----------------------------------------------------------------------
@@ -61,6 +61,7 @@ const XMLCh gDTDEntityStr[] =
 
 typedef JanitorMemFunCall<SAX2XMLReaderImpl>    CleanupType;
 typedef JanitorMemFunCall<SAX2XMLReaderImpl>    ResetInProgressType;
+typedef JanitorMemFunCall<SAX2XMLReaderImpl>    ResetPushType;
 
 
 SAX2XMLReaderImpl::SAX2XMLReaderImpl(MemoryManager* const  manager
@@ -511,6 +512,65 @@ void SAX2XMLReaderImpl::parseReset(XMLPScanToken& token)
     fScanner->scanReset(token);
 }
 
+// ---------------------------------------------------------------------------
+//  SAX2XMLReaderImpl: Push parse methods
+// ---------------------------------------------------------------------------
+void SAX2XMLReaderImpl::feed(const  XMLByte* const  bytes
+                            , const XMLSize_t       count)
+{
+    //
+    //  Avoid multiple entrance. We cannot enter here while any other
+    //  parse is in progress. The first chunk starts a new push parse.
+    //
+    if (fParseInProgress && !fScanner->isPushing())
+        ThrowXMLwithMemMgr(IOException, XMLExcepts::Gen_ParseInProgress, fMemoryManager);
+
+    fParseInProgress = true;
+
+    ResetPushType resetPush(this, &SAX2XMLReaderImpl::resetPush);
+
+    try
+    {
+        fScanner->pushBytes(bytes, count);
+    }
+    catch(const OutOfMemoryException&)
+    {
+        resetPush.release();
+
+        throw;
+    }
+
+    // The parse goes on with the next chunk
+    resetPush.release();
+}
+
+void SAX2XMLReaderImpl::finish()
+{
+    if (fParseInProgress && !fScanner->isPushing())
+        ThrowXMLwithMemMgr(IOException, XMLExcepts::Gen_ParseInProgress, fMemoryManager);
+
+    fParseInProgress = true;
+
+    ResetPushType resetPush(this, &SAX2XMLReaderImpl::resetPush);
+
+    try
+    {
+        fScanner->pushEndOfInput();
+    }
+    catch(const OutOfMemoryException&)
+    {
+        resetPush.release();
+
+        throw;
+    }
+}
+
+void SAX2XMLReaderImpl::skipElement()
+{
+    // Picked up by startElement() once the handler returns
+    fScanner->setHandlerSkipRequested(true);
+}
+
 // ---------------------------------------------------------------------------
 //  SAX2XMLReaderImpl: Overrides of the XMLDocumentHandler interface
 // ---------------------------------------------------------------------------
@@ -518,6 +578,10 @@ void SAX2XMLReaderImpl::docCharacters(  const   XMLCh* const    chars
                                 , const XMLSize_t       length
                                 , const bool            cdataSection)
 {
+    // Nothing is reported from within a skipped element
+    if (fScanner->getHandlerSkipDepth())
+        return;
+
     // Suppress the chars before the root element.
     if (fElemDepth)
     {
@@ -545,6 +609,9 @@ void SAX2XMLReaderImpl::docCharacters(  const   XMLCh* const    chars
 
 void SAX2XMLReaderImpl::docComment(const XMLCh* const commentText)
 {
+    if (fScanner->getHandlerSkipDepth())
+        return;
+
     // Call the installed LexicalHandler.
     if (fLexicalHandler)
     {
@@ -582,6 +649,9 @@ void SAX2XMLReaderImpl::XMLDecl( const  XMLCh* const    versionStr
 void SAX2XMLReaderImpl::docPI(  const   XMLCh* const    target
                         , const XMLCh* const    data)
 {
+    if (fScanner->getHandlerSkipDepth())
+        return;
+
     // Just map to the SAX document handler
     if (fDocHandler)
         fDocHandler->processingInstruction(target, data);
@@ -611,6 +681,9 @@ void SAX2XMLReaderImpl::endDocument()
 
 void SAX2XMLReaderImpl::endEntityReference(const XMLEntityDecl& entityDecl)
 {
+   if (fScanner->getHandlerSkipDepth())
+        return;
+
    // Call the installed LexicalHandler.
    if (fLexicalHandler)
         fLexicalHandler->endEntity(entityDecl.getName());
@@ -629,7 +702,7 @@ void SAX2XMLReaderImpl::ignorableWhitespace(const   XMLCh* const    chars
                                     , const bool            cdataSection)
 {
     // Do not report the whitespace before the root element.
-    if (!fElemDepth)
+    if (!fElemDepth || fScanner->getHandlerSkipDepth())
         return;
 
     // Just map to the SAX document handler
@@ -656,6 +729,8 @@ void SAX2XMLReaderImpl::resetDocument()
 
     // Make sure our element depth flag gets set back to zero
     fElemDepth = 0;
+    fScanner->setHandlerSkipDepth(0);
+    fScanner->setHandlerSkipRequested(false);
 
     // reset prefix counters and prefix map
     fPrefixCounts->removeAllElements();
@@ -694,6 +769,12 @@ startElement(   const   XMLElementDecl&         elemDecl
     if (!isEmpty)
         fElemDepth++;
 
+    // Nothing is reported from within a skipped element
+    if (fScanner->getHandlerSkipDepth())
+        return;
+
+    fScanner->setHandlerSkipRequested(false);
+
     if (fDocHandler)
     {
         const QName* qName=elemDecl.getElementName();
@@ -836,6 +917,23 @@ startElement(   const   XMLElementDecl&         elemDecl
             , isRoot
         );
     }
+
+    //
+    //  If the handler asked to skip the content, remember the depth of the
+    //  element so that its end tag is still reported. Let the scanner skip
+    //  over the content if it can. It can't in a push parse, since only a
+    //  part of the content may have arrived yet.
+    //
+    if (fScanner->getHandlerSkipRequested())
+    {
+        fScanner->setHandlerSkipRequested(false);
+        if (!isEmpty)
+        {
+            fScanner->setHandlerSkipDepth(fElemDepth);
+            if (!fScanner->isPushing())
+                fScanner->skipCurrentElement();
+        }
+    }
 }
 
 void SAX2XMLReaderImpl::endElement( const   XMLElementDecl& elemDecl
@@ -843,6 +941,21 @@ void SAX2XMLReaderImpl::endElement( const   XMLElementDecl& elemDecl
                             , const bool            isRoot
                             , const XMLCh* const    elemPrefix)
 {
+    //
+    //  Within a skipped element, only track the depth, until the end tag of
+    //  the skipped element itself, which is reported.
+    //
+    if (fScanner->getHandlerSkipDepth())
+    {
+        if (fElemDepth != fScanner->getHandlerSkipDepth())
+        {
+            if (fElemDepth)
+                fElemDepth--;
+            return;
+        }
+        fScanner->setHandlerSkipDepth(0);
+    }
+
     // Just map to the SAX document handler
     if (fDocHandler)
     {
@@ -910,6 +1023,9 @@ void SAX2XMLReaderImpl::endElement( const   XMLElementDecl& elemDecl
 
 void SAX2XMLReaderImpl::startEntityReference(const XMLEntityDecl& entityDecl)
 {
+   if (fScanner->getHandlerSkipDepth())
+        return;
+
    // Call the installed LexicalHandler.
    if (fLexicalHandler)
         fLexicalHandler->startEntity(entityDecl.getName());
@@ -1366,6 +1482,14 @@ void SAX2XMLReaderImpl::setFeature(const XMLCh* const name, const bool value)
     {
         fScanner->setHandleMultipleImports(value);
     }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesAdaptiveReaderBuffer) == 0)
+    {
+        fScanner->setAdaptiveReaderBuffer(value);
+    }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReadAhead) == 0)
+    {
+        fScanner->setReadAhead(value);
+    }
     else
        throw SAXNotRecognizedException("Unknown Feature", fMemoryManager);
 }
@@ -1416,6 +1540,10 @@ bool SAX2XMLReaderImpl::getFeature(const XMLCh* const name) const
         return fScanner->getSkipDTDValidation();
     else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesHandleMultipleImports) == 0)
         return fScanner->getHandleMultipleImports();
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesAdaptiveReaderBuffer) == 0)
+        return fScanner->getAdaptiveReaderBuffer();
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReadAhead) == 0)
+        return fScanner->getReadAhead();
     else
        throw SAXNotRecognizedException("Unknown Feature", fMemoryManager);
 
@@ -1443,6 +1571,10 @@ void SAX2XMLReaderImpl::setProperty(const XMLCh* const name, void* value)
     {
         fScanner->setLowWaterMark(*(const XMLSize_t*)value);
     }
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReaderBufferSize) == 0)
+    {
+        fScanner->setReaderBufferSize(*(const XMLSize_t*)value);
+    }
     else if (XMLString::equals(name, XMLUni::fgXercesScannerName))
     {
         XMLScanner* tempScanner = XMLScannerResolver::resolveScanner
@@ -1476,6 +1608,8 @@ void* SAX2XMLReaderImpl::getProperty(const XMLCh* const name) const
         return (void*)fScanner->getSecurityManager();
     else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesLowWaterMark) == 0)
         return (void*)&fScanner->getLowWaterMark();
+    else if (XMLString::compareIStringASCII(name, XMLUni::fgXercesReaderBufferSize) == 0)
+        return const_cast<XMLSize_t*>(&fScanner->getReaderBufferSize());
     else if (XMLString::equals(name, XMLUni::fgXercesScannerName))
         return (void*)fScanner->getName();
     else
@@ -1605,6 +1739,12 @@ void SAX2XMLReaderImpl::resetInProgress()
     fParseInProgress = false;
 }
 
+void SAX2XMLReaderImpl::resetPush()
+{
+    fScanner->endPush();
+    fParseInProgress = false;
+}
+
 void SAX2XMLReaderImpl::resetCachedGrammarPool()
 {
     fGrammarResolver->resetCachedGrammar();
@@ -312,6 +312,21 @@ XMLSize_t SAXParser::getLowWaterMark() const
     return fScanner->getLowWaterMark();
 }
 
+XMLSize_t SAXParser::getReaderBufferSize() const
+{
+    return fScanner->getReaderBufferSize();
+}
+
+bool SAXParser::getAdaptiveReaderBuffer() const
+{
+    return fScanner->getAdaptiveReaderBuffer();
+}
+
+bool SAXParser::getReadAhead() const
+{
+    return fScanner->getReadAhead();
+}
+
 bool SAXParser::getLoadExternalDTD() const
 {
     return fScanner->getLoadExternalDTD();
@@ -475,6 +490,21 @@ void SAXParser::setLowWaterMark(XMLSize_t lwm)
     fScanner->setLowWaterMark(lwm);
 }
 
+void SAXParser::setReaderBufferSize(const XMLSize_t newSize)
+{
+    fScanner->setReaderBufferSize(newSize);
+}
+
+void SAXParser::setAdaptiveReaderBuffer(const bool newState)
+{
+    fScanner->setAdaptiveReaderBuffer(newState);
+}
+
+void SAXParser::setReadAhead(const bool newState)
+{
+    fScanner->setReadAhead(newState);
+}
+
 void SAXParser::setLoadExternalDTD(const bool newState)
 {
     fScanner->setLoadExternalDTD(newState);
@@ -0,0 +1,680 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#include <xercesc/parsers/XMLPullParser.hpp>
+#include <xercesc/internal/XMLScannerResolver.hpp>
+#include <xercesc/framework/XMLValidator.hpp>
+#include <xercesc/sax/ErrorHandler.hpp>
+#include <xercesc/sax/Locator.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/validators/common/GrammarResolver.hpp>
+#include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/OutOfMemoryException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Constructors and Destructor
+// ---------------------------------------------------------------------------
+
+
+typedef JanitorMemFunCall<XMLPullParser>    CleanupType;
+typedef JanitorMemFunCall<XMLPullParser>    ResetInProgressType;
+
+
+XMLPullParser::XMLPullParser( XMLValidator* const   valToAdopt
+                            , MemoryManager* const  manager
+                            , XMLGrammarPool* const gramPool):
+
+    fEvents(0)
+    , fNextEvent(0)
+    , fTextBuf(1023, manager)
+    , fQNameBuf(1023, manager)
+    , fDepth(0)
+    , fSkipDepth(0)
+    , fParseInProgress(false)
+    , fScanDone(false)
+    , fErrorHandler(0)
+    , fScanner(0)
+    , fGrammarResolver(0)
+    , fURIStringPool(0)
+    , fValidator(valToAdopt)
+    , fMemoryManager(manager)
+    , fGrammarPool(gramPool)
+{
+    CleanupType cleanup(this, &XMLPullParser::cleanUp);
+
+    try
+    {
+        initialize();
+    }
+    catch(const OutOfMemoryException&)
+    {
+        // Don't cleanup when out of memory, since executing the
+        // code can cause problems.
+        cleanup.release();
+
+        throw;
+    }
+
+    cleanup.release();
+}
+
+
+XMLPullParser::~XMLPullParser()
+{
+    cleanUp();
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Initialize/CleanUp methods
+// ---------------------------------------------------------------------------
+void XMLPullParser::initialize()
+{
+    // Create grammar resolver and string pool to pass to scanner
+    fGrammarResolver = new (fMemoryManager) GrammarResolver(fGrammarPool, fMemoryManager);
+    fURIStringPool = fGrammarResolver->getStringPool();
+
+    // Create our scanner and tell it what validator to use
+    fScanner = XMLScannerResolver::getDefaultScanner(fValidator, fGrammarResolver, fMemoryManager);
+    fScanner->setURIStringPool(fURIStringPool);
+
+    // We get the events and the errors, there are no other handlers
+    fScanner->setDocHandler(this);
+    fScanner->setErrorReporter(this);
+
+    fEvents = new (fMemoryManager) ValueVectorOf<PullEvent>(32, fMemoryManager);
+}
+
+void XMLPullParser::cleanUp()
+{
+    delete fEvents;
+    delete fScanner;
+    delete fGrammarResolver;
+    // grammar pool must do this
+    //delete fURIStringPool;
+
+    if (fValidator)
+        delete fValidator;
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Getter and setter methods
+// ---------------------------------------------------------------------------
+const XMLValidator& XMLPullParser::getValidator() const
+{
+    return *fScanner->getValidator();
+}
+
+bool XMLPullParser::getDoNamespaces() const
+{
+    return fScanner->getDoNamespaces();
+}
+
+XMLSize_t XMLPullParser::getErrorCount() const
+{
+    return fScanner->getErrorCount();
+}
+
+void XMLPullParser::setDoNamespaces(const bool newState)
+{
+    fScanner->setDoNamespaces(newState);
+}
+
+void XMLPullParser::setValidationScheme(const ValSchemes newScheme)
+{
+    if (newScheme == Val_Never)
+        fScanner->setValidationScheme(XMLScanner::Val_Never);
+    else if (newScheme == Val_Always)
+        fScanner->setValidationScheme(XMLScanner::Val_Always);
+    else
+        fScanner->setValidationScheme(XMLScanner::Val_Auto);
+}
+
+void XMLPullParser::setDoSchema(const bool newState)
+{
+    fScanner->setDoSchema(newState);
+}
+
+void XMLPullParser::setExitOnFirstFatalError(const bool newState)
+{
+    fScanner->setExitOnFirstFatal(newState);
+}
+
+void XMLPullParser::setLoadExternalDTD(const bool newState)
+{
+    fScanner->setLoadExternalDTD(newState);
+}
+
+void XMLPullParser::useScanner(const XMLCh* const scannerName)
+{
+    XMLScanner* tempScanner = XMLScannerResolver::resolveScanner
+    (
+        scannerName
+        , fValidator
+        , fGrammarResolver
+        , fMemoryManager
+    );
+
+    if (tempScanner) {
+
+        tempScanner->setParseSettings(fScanner);
+        tempScanner->setURIStringPool(fURIStringPool);
+        delete fScanner;
+        fScanner = tempScanner;
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Parsing methods
+// ---------------------------------------------------------------------------
+bool XMLPullParser::parseFirst(const InputSource& source)
+{
+    parseReset();
+
+    // If the scan fails or throws, drop whatever events it found
+    ResetInProgressType resetInProgress(this, &XMLPullParser::resetParse);
+
+    if (!fScanner->scanFirst(source, fScanToken))
+        return false;
+
+    resetInProgress.release();
+    fParseInProgress = true;
+    return true;
+}
+
+bool XMLPullParser::parseFirst(const XMLCh* const systemId)
+{
+    parseReset();
+
+    // If the scan fails or throws, drop whatever events it found
+    ResetInProgressType resetInProgress(this, &XMLPullParser::resetParse);
+
+    if (!fScanner->scanFirst(systemId, fScanToken))
+        return false;
+
+    resetInProgress.release();
+    fParseInProgress = true;
+    return true;
+}
+
+bool XMLPullParser::parseFirst(const char* const systemId)
+{
+    parseReset();
+
+    // If the scan fails or throws, drop whatever events it found
+    ResetInProgressType resetInProgress(this, &XMLPullParser::resetParse);
+
+    if (!fScanner->scanFirst(systemId, fScanToken))
+        return false;
+
+    resetInProgress.release();
+    fParseInProgress = true;
+    return true;
+}
+
+XMLPullParser::EventTypes XMLPullParser::next()
+{
+    // Return the next of the events we already have, if there is one
+    if (fNextEvent < fEvents->size())
+        return fEvents->elementAt(fNextEvent++).fType;
+
+    if (!fillEvents())
+        return Event_None;
+
+    return fEvents->elementAt(fNextEvent++).fType;
+}
+
+XMLPullParser::EventTypes XMLPullParser::skipElement()
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || curEvent->fType != Event_StartElement)
+        return getEventType();
+
+    //
+    //  If it was an empty element, then its end event is already waiting.
+    //  Otherwise nothing else can have been found by the scan step that
+    //  found its start tag.
+    //
+    if (fNextEvent < fEvents->size())
+        return next();
+
+    //
+    //  Have the callbacks drop everything up to the element's end tag. That
+    //  end tag becomes the first event of the list, so next() returns it.
+    //  The scanner skips over the content itself if it isn't validating.
+    //
+    fSkipDepth = curEvent->fDepth;
+    fScanner->skipCurrentElement();
+    if (!fillEvents())
+        return Event_None;
+
+    return fEvents->elementAt(fNextEvent++).fType;
+}
+
+void XMLPullParser::parseReset()
+{
+    if (fParseInProgress)
+    {
+        fParseInProgress = false;
+        fScanner->scanReset(fScanToken);
+    }
+    resetParse();
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Current event methods
+// ---------------------------------------------------------------------------
+const XMLCh* XMLPullParser::getLocalName() const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || !curEvent->fElemDecl)
+        return 0;
+
+    if (fScanner->getDoNamespaces())
+        return curEvent->fElemDecl->getBaseName();
+    return curEvent->fElemDecl->getFullName();
+}
+
+const XMLCh* XMLPullParser::getPrefix() const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || !curEvent->fElemDecl)
+        return 0;
+
+    if (fScanner->getDoNamespaces() && curEvent->fPrefix)
+        return curEvent->fPrefix;
+    return XMLUni::fgZeroLenString;
+}
+
+const XMLCh* XMLPullParser::getQName() const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || !curEvent->fElemDecl)
+        return 0;
+
+    if (!fScanner->getDoNamespaces())
+        return curEvent->fElemDecl->getFullName();
+
+    if (!curEvent->fPrefix || !*curEvent->fPrefix)
+        return curEvent->fElemDecl->getBaseName();
+
+    fQNameBuf.set(curEvent->fPrefix);
+    fQNameBuf.append(chColon);
+    fQNameBuf.append(curEvent->fElemDecl->getBaseName());
+    return fQNameBuf.getRawBuffer();
+}
+
+const XMLCh* XMLPullParser::getURI() const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || !curEvent->fElemDecl)
+        return 0;
+
+    if (fScanner->getDoNamespaces())
+        return fScanner->getURIText(curEvent->fURIId);
+    return XMLUni::fgZeroLenString;
+}
+
+const XMLAttr* XMLPullParser::getAttribute(const XMLSize_t index) const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || index >= curEvent->fAttrCount)
+        return 0;
+
+    return curEvent->fAttrList->elementAt(index);
+}
+
+const XMLCh* XMLPullParser::getAttributeURI(const XMLSize_t index) const
+{
+    const XMLAttr* attr = getAttribute(index);
+    if (!attr)
+        return 0;
+
+    if (fScanner->getDoNamespaces())
+        return fScanner->getURIText(attr->getURIId());
+    return XMLUni::fgZeroLenString;
+}
+
+const XMLCh* XMLPullParser::getAttributeValue(const XMLCh* const qName) const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent)
+        return 0;
+
+    for (XMLSize_t index = 0; index < curEvent->fAttrCount; index++)
+    {
+        const XMLAttr* attr = curEvent->fAttrList->elementAt(index);
+        if (XMLString::equals(attr->getQName(), qName))
+            return attr->getValue();
+    }
+    return 0;
+}
+
+const XMLCh* XMLPullParser::getText() const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || curEvent->fType < Event_Characters)
+        return 0;
+
+    return fTextBuf.getRawBuffer() + curEvent->fTextOfs;
+}
+
+const XMLCh* XMLPullParser::getPITarget() const
+{
+    const PullEvent* curEvent = currentEvent();
+    if (!curEvent || curEvent->fType != Event_PI)
+        return 0;
+
+    return fTextBuf.getRawBuffer() + curEvent->fTargetOfs;
+}
+
+XMLFileLoc XMLPullParser::getLineNumber() const
+{
+    return fScanner->getLocator()->getLineNumber();
+}
+
+XMLFileLoc XMLPullParser::getColumnNumber() const
+{
+    return fScanner->getLocator()->getColumnNumber();
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Overrides of the XMLDocumentHandler interface
+// ---------------------------------------------------------------------------
+void XMLPullParser::docCharacters(  const   XMLCh* const    chars
+                                    , const XMLSize_t       length
+                                    , const bool            cdataSection)
+{
+    // Suppress the chars before the root element and in skipped content
+    if (fDepth && !fSkipDepth)
+        addTextEvent(cdataSection ? Event_CData : Event_Characters, chars, length);
+}
+
+
+void XMLPullParser::docComment(const XMLCh* const commentText)
+{
+    if (!fSkipDepth)
+        addTextEvent(Event_Comment, commentText, XMLString::stringLen(commentText));
+}
+
+
+void XMLPullParser::docPI(  const   XMLCh* const    target
+                            , const XMLCh* const    data)
+{
+    if (fSkipDepth)
+        return;
+
+    const XMLSize_t targetOfs = fTextBuf.getLen();
+    fTextBuf.append(target);
+    fTextBuf.append(chNull);
+
+    addTextEvent(Event_PI, data, XMLString::stringLen(data));
+    fEvents->elementAt(fEvents->size() - 1).fTargetOfs = targetOfs;
+}
+
+
+void XMLPullParser::endDocument()
+{
+    // There won't be anything more from the scanner after this
+    fScanDone = true;
+    addEvent(Event_EndDocument);
+}
+
+
+void XMLPullParser::endElement( const   XMLElementDecl& elemDecl
+                                , const unsigned int    uriId
+                                , const bool
+                                , const XMLCh* const    elemPrefix)
+{
+    //
+    //  If this is the end of the element being skipped, then it is the
+    //  first event that we keep.
+    //
+    if (fSkipDepth)
+    {
+        if (fDepth != fSkipDepth)
+        {
+            fDepth--;
+            return;
+        }
+        fSkipDepth = 0;
+    }
+
+    addEvent(Event_EndElement, &elemDecl, uriId, elemPrefix);
+    fDepth--;
+}
+
+
+void XMLPullParser::endEntityReference(const XMLEntityDecl&)
+{
+}
+
+
+void XMLPullParser::ignorableWhitespace(const   XMLCh* const    chars
+                                        , const XMLSize_t       length
+                                        , const bool)
+{
+    if (fDepth && !fSkipDepth)
+        addTextEvent(Event_Whitespace, chars, length);
+}
+
+
+void XMLPullParser::resetDocument()
+{
+    fDepth = 0;
+    fSkipDepth = 0;
+}
+
+
+void XMLPullParser::startDocument()
+{
+    addEvent(Event_StartDocument);
+}
+
+
+void XMLPullParser::
+startElement(   const   XMLElementDecl&         elemDecl
+                , const unsigned int            elemURLId
+                , const XMLCh* const            elemPrefix
+                , const RefVectorOf<XMLAttr>&   attrList
+                , const XMLSize_t               attrCount
+                , const bool                    isEmpty
+                , const bool)
+{
+    if (fSkipDepth)
+    {
+        if (!isEmpty)
+            fDepth++;
+        return;
+    }
+
+    fDepth++;
+    addEvent(Event_StartElement, &elemDecl, elemURLId, elemPrefix);
+
+    PullEvent& newEvent = fEvents->elementAt(fEvents->size() - 1);
+    newEvent.fAttrList = &attrList;
+    newEvent.fAttrCount = attrCount;
+
+    // If its empty, the end tag event comes right after
+    if (isEmpty)
+    {
+        addEvent(Event_EndElement, &elemDecl, elemURLId, elemPrefix);
+        fDepth--;
+    }
+}
+
+
+void XMLPullParser::startEntityReference(const XMLEntityDecl&)
+{
+}
+
+
+void XMLPullParser::XMLDecl(const   XMLCh* const
+                            , const XMLCh* const
+                            , const XMLCh* const
+                            , const XMLCh* const)
+{
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Overrides of the XMLErrorReporter interface
+// ---------------------------------------------------------------------------
+void XMLPullParser::error(  const   unsigned int
+                            , const XMLCh* const
+                            , const XMLErrorReporter::ErrTypes  errType
+                            , const XMLCh* const                errorText
+                            , const XMLCh* const                systemId
+                            , const XMLCh* const                publicId
+                            , const XMLFileLoc                  lineNum
+                            , const XMLFileLoc                  colNum)
+{
+    SAXParseException toThrow = SAXParseException
+    (
+        errorText
+        , publicId
+        , systemId
+        , lineNum
+        , colNum
+        , fMemoryManager
+    );
+
+    if (!fErrorHandler)
+    {
+        if (errType == XMLErrorReporter::ErrType_Fatal)
+            throw toThrow;
+        else
+            return;
+    }
+
+    if (errType == XMLErrorReporter::ErrType_Warning)
+        fErrorHandler->warning(toThrow);
+    else if (errType == XMLErrorReporter::ErrType_Fatal)
+        fErrorHandler->fatalError(toThrow);
+    else
+        fErrorHandler->error(toThrow);
+}
+
+
+void XMLPullParser::resetErrors()
+{
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Private helper methods
+// ---------------------------------------------------------------------------
+void XMLPullParser::addEvent(const  EventTypes              type
+                            , const XMLElementDecl* const   elemDecl
+                            , const unsigned int            uriId
+                            , const XMLCh* const            elemPrefix)
+{
+    PullEvent newEvent;
+    newEvent.fType = type;
+    newEvent.fDepth = fDepth;
+    newEvent.fElemDecl = elemDecl;
+    newEvent.fURIId = uriId;
+    newEvent.fPrefix = elemPrefix;
+    newEvent.fAttrList = 0;
+    newEvent.fAttrCount = 0;
+    newEvent.fTextOfs = 0;
+    newEvent.fTextLen = 0;
+    newEvent.fTargetOfs = 0;
+    fEvents->addElement(newEvent);
+}
+
+void XMLPullParser::addTextEvent(const  EventTypes      type
+                                , const XMLCh* const    text
+                                , const XMLSize_t       length)
+{
+    addEvent(type);
+
+    PullEvent& newEvent = fEvents->elementAt(fEvents->size() - 1);
+    newEvent.fTextOfs = fTextBuf.getLen();
+    newEvent.fTextLen = length;
+
+    if (length)
+        fTextBuf.append(text, length);
+    fTextBuf.append(chNull);
+}
+
+//
+//  Drop the events that have all been returned and scan until there are
+//  new ones, or until the scanner is done. Returns false in that case.
+//
+bool XMLPullParser::fillEvents()
+{
+    fEvents->removeAllElements();
+    fTextBuf.reset();
+    fNextEvent = 0;
+
+    if (!fParseInProgress)
+        return false;
+
+    // If the scanner or the error handler throws, the parse is over
+    ResetInProgressType resetInProgress(this, &XMLPullParser::parseReset);
+
+    try
+    {
+        while (!fEvents->size() && !fScanDone)
+        {
+            if (!fScanner->scanNext(fScanToken))
+                fScanDone = true;
+        }
+    }
+    catch(const OutOfMemoryException&)
+    {
+        // Don't reset when out of memory, since executing the
+        // code can cause problems.
+        resetInProgress.release();
+
+        throw;
+    }
+
+    resetInProgress.release();
+    return (fEvents->size() != 0);
+}
+
+void XMLPullParser::resetParse()
+{
+    fEvents->removeAllElements();
+    fTextBuf.reset();
+    fNextEvent = 0;
+    fDepth = 0;
+    fSkipDepth = 0;
+    fScanDone = false;
+}
+
+XERCES_CPP_NAMESPACE_END
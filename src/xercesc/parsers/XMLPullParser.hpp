@@ -0,0 +1,715 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_XMLPULLPARSER_HPP)
+#define XERCESC_INCLUDE_GUARD_XMLPULLPARSER_HPP
+
+#include <xercesc/framework/XMLDocumentHandler.hpp>
+#include <xercesc/framework/XMLErrorReporter.hpp>
+#include <xercesc/framework/XMLBuffer.hpp>
+#include <xercesc/framework/XMLPScanToken.hpp>
+#include <xercesc/util/ValueVectorOf.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+
+class ErrorHandler;
+class GrammarResolver;
+class InputSource;
+class XMLGrammarPool;
+class XMLScanner;
+class XMLStringPool;
+class XMLValidator;
+
+/**
+  * This class is a pull parser. Rather than calling the application's
+  * handlers, it hands the document back one event at a time from next(),
+  * and the application asks for the details of the current event.
+  *
+  * <p>It is built on the progressive scan support of the scanner, so the
+  * document is only scanned as far as the application has asked for. The
+  * names, prefixes and attributes of elements are not copied, they are
+  * views into the scanner's own data and stay valid until the next call
+  * to next(). Character data, comments and processing instructions are
+  * copied once into a buffer that is reused, so there is no allocation
+  * per event once the parser has warmed up.</p>
+  *
+  * <p>skipElement() moves past the content of the current element without
+  * returning any of the events in it to the application.</p>
+  *
+  * <pre>
+  *   XMLPullParser parser;
+  *   parser.setDoNamespaces(true);
+  *   if (parser.parseFirst(source))
+  *   {
+  *       XMLPullParser::EventTypes type;
+  *       while ((type = parser.next()) != XMLPullParser::Event_None)
+  *       {
+  *           if (type == XMLPullParser::Event_StartElement)
+  *               ...
+  *       }
+  *   }
+  * </pre>
+  */
+class PARSERS_EXPORT XMLPullParser :
+
+    public XMemory
+    , public XMLDocumentHandler
+    , public XMLErrorReporter
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Class types
+    // -----------------------------------------------------------------------
+    /** ValScheme enum used in setValidationScheme
+      *    Val_Never:  Do not report validation errors.
+      *    Val_Always: The parser will always report validation errors.
+      *    Val_Auto:   The parser will report validation errors only if a grammar is specified.
+      *
+      * @see #setValidationScheme
+      */
+    enum ValSchemes
+    {
+        Val_Never
+        , Val_Always
+        , Val_Auto
+    };
+
+    /** The kinds of events that next() returns.
+      *
+      *   Event_None:          There are no more events, either because the
+      *                        end of the document was returned already or
+      *                        because the scan stopped on an error.
+      *   Event_StartDocument: The scan of the document has started.
+      *   Event_EndDocument:   The document has been scanned to the end.
+      *   Event_StartElement:  A start tag or an empty element tag.
+      *   Event_EndElement:    An end tag. One is also returned after the
+      *                        start event of an empty element.
+      *   Event_Characters:    Character data.
+      *   Event_CData:         The content of a CDATA section.
+      *   Event_Whitespace:    Ignorable whitespace, which is only reported
+      *                        when validating against a DTD.
+      *   Event_Comment:       A comment.
+      *   Event_PI:            A processing instruction.
+      */
+    enum EventTypes
+    {
+        Event_None
+        , Event_StartDocument
+        , Event_EndDocument
+        , Event_StartElement
+        , Event_EndElement
+        , Event_Characters
+        , Event_CData
+        , Event_Whitespace
+        , Event_Comment
+        , Event_PI
+    };
+
+
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    /** @name Constructors and Destructor */
+    //@{
+    /** Constructor with an instance of validator class to use for
+      * validation.
+      * @param valToAdopt Pointer to the validator instance to use. The
+      *                   parser is responsible for freeing the memory.
+      * @param manager    Pointer to the memory manager to be used to
+      *                   allocate objects.
+      * @param gramPool   The collection of cached grammars.
+      */
+    XMLPullParser
+    (
+          XMLValidator*   const valToAdopt = 0
+        , MemoryManager*  const manager = XMLPlatformUtils::fgMemoryManager
+        , XMLGrammarPool* const gramPool = 0
+    );
+
+    /**
+      * Destructor
+      */
+    ~XMLPullParser();
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Getter and setter methods
+    // -----------------------------------------------------------------------
+    /** @name Getter and setter methods */
+    //@{
+    /**
+      * This method returns the installed error handler.
+      *
+      * @return A pointer to the installed error handler object.
+      */
+    ErrorHandler* getErrorHandler() const;
+
+    /**
+      * This method returns a reference to the parser's installed
+      * validator.
+      *
+      * @return A const reference to the installed validator object.
+      */
+    const XMLValidator& getValidator() const;
+
+    /**
+      * Get the 'do namespaces' flag.
+      *
+      * @return true, if the parser is currently configured to
+      *         understand namespaces, false otherwise.
+      *
+      * @see #setDoNamespaces
+      */
+    bool getDoNamespaces() const;
+
+    /**
+      * This method returns the total number of errors seen by the scanner
+      * so far in the current parse.
+      *
+      * @return The number of errors encountered.
+      */
+    XMLSize_t getErrorCount() const;
+
+    /**
+      * This method allows users to install their own error handler. The
+      * parser will call its methods for the warnings, errors and fatal
+      * errors that it finds. Without one, a fatal error is thrown as a
+      * SAXParseException from parseFirst() or next().
+      *
+      * @param handler A pointer to the error handler to be called
+      *                when the parser comes across 'error' events
+      *                as per the SAX specification.
+      */
+    void setErrorHandler(ErrorHandler* const handler);
+
+    /**
+      * This method allows users to enable or disable the parser's
+      * namespace processing. When set to true, the parser starts
+      * enforcing all the constraints / rules specified by the NameSpace
+      * specification.
+      *
+      * The parser's default state is: false.
+      *
+      * @param newState The value specifying whether NameSpace rules should
+      *                 be enforced or not.
+      *
+      * @see #getDoNamespaces
+      */
+    void setDoNamespaces(const bool newState);
+
+    /**
+      * This method allows users to set the validation scheme to be used
+      * by this parser.
+      *
+      * The parser's default state is: Val_Never.
+      *
+      * @param newScheme The new validation scheme to use.
+      */
+    void setValidationScheme(const ValSchemes newScheme);
+
+    /**
+      * Set the 'schema support' flag.
+      *
+      * The parser's default state is: false.
+      *
+      * @param newState The value specifying whether schema support should
+      *                 be enforced or not.
+      */
+    void setDoSchema(const bool newState);
+
+    /**
+      * This method allows users to set the parser's behaviour when it
+      * encounters the first fatal error. If set to true, the parser
+      * will exit at the first fatal error. If false, then it will
+      * report the error and continue processing.
+      *
+      * The default value is 'true' and the parser exits on the
+      * first fatal error.
+      *
+      * @param newState The value specifying whether the parser should
+      *                 continue or exit when it encounters the first
+      *                 fatal error.
+      */
+    void setExitOnFirstFatalError(const bool newState);
+
+    /**
+      * Set the 'loadExternalDTD' flag. When false, the parser will ignore
+      * the external DTD completely unless validation is on.
+      *
+      * The parser's default state is: true.
+      *
+      * @param newState The value specifying whether the external DTD
+      *                 should be loaded or not.
+      */
+    void setLoadExternalDTD(const bool newState);
+
+    /** Set the scanner to use when scanning the XML document
+      *
+      * This method allows users to set the scanner to use
+      * when scanning a given XML document.
+      *
+      * @param scannerName The name of the desired scanner
+      */
+    void useScanner(const XMLCh* const scannerName);
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Parsing methods
+    // -----------------------------------------------------------------------
+    /** @name Parsing methods */
+    //@{
+    /** Begin a pull parse of an XML document.
+      *
+      * This method scans the XML declaration and the prolog, up to and
+      * including the root element's start tag. The events found there are
+      * returned by the following calls to next(). The input source must
+      * stay alive until the parse is done or parseReset() is called. Any
+      * pull parse already under way is reset first.
+      *
+      * @param source A const reference to the InputSource object which
+      *               points to the XML file to be parsed.
+      *
+      * @return 'true', if successful in parsing the prolog. It indicates
+      *         the caller can now call next(). 'false', otherwise.
+      *
+      * @exception SAXException Any SAX exception, possibly
+      *            wrapping another exception.
+      * @exception XMLException An exception from the parser or client
+      *            handler code.
+      *
+      * @see #next
+      * @see #parseReset
+      */
+    bool parseFirst(const InputSource& source);
+
+    /** Begin a pull parse of an XML document.
+      *
+      * @param systemId A pointer to a Unicode string representing the path
+      *                 to the XML file to be parsed.
+      *
+      * @return 'true', if successful in parsing the prolog.
+      *
+      * @see #parseFirst(const InputSource&)
+      */
+    bool parseFirst(const XMLCh* const systemId);
+
+    /** Begin a pull parse of an XML document.
+      *
+      * @param systemId A pointer to a regular native string representing
+      *                 the path to the XML file to be parsed.
+      *
+      * @return 'true', if successful in parsing the prolog.
+      *
+      * @see #parseFirst(const InputSource&)
+      */
+    bool parseFirst(const char* const systemId);
+
+    /** Move to the next event.
+      *
+      * The document is only scanned as far as is needed to find the next
+      * event. Any names, attributes and text returned for the previous
+      * event are no longer valid after this call.
+      *
+      * @return The type of the new current event, or Event_None if there
+      *         are no more.
+      *
+      * @exception SAXException Any SAX exception, possibly
+      *            wrapping another exception.
+      * @exception XMLException An exception from the parser or client
+      *            handler code.
+      */
+    EventTypes next();
+
+    /** Skip the content of the current element.
+      *
+      * When the current event is Event_StartElement, this scans forward
+      * to the element's end tag without returning any of the events in
+      * between, and makes the end tag the current event. It does nothing
+      * for any other event. Unless the document is being validated, the
+      * content is only looked at for its markup, and entity references
+      * in it are not expanded.
+      *
+      * @return The type of the new current event. This is Event_None if
+      *         the scan stopped before the end tag was found.
+      */
+    EventTypes skipElement();
+
+    /** Reset the parser after a pull parse.
+      *
+      * This method resets the scanner and drops any events which have not
+      * been returned. It must be called if a parse is abandoned before the
+      * end of the document. It is harmless to call it after a parse has
+      * run to the end.
+      */
+    void parseReset();
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Current event methods
+    // -----------------------------------------------------------------------
+    /** @name Current event methods */
+    //@{
+    /** Get the type of the current event. */
+    EventTypes getEventType() const;
+
+    /** Get the element depth of the current event. The root element's
+      * start and end events are at depth 1, as is the content directly
+      * inside of it.
+      */
+    XMLSize_t getDepth() const;
+
+    /** Get the local name of the current element event. This is the whole
+      * name if namespace processing is off.
+      */
+    const XMLCh* getLocalName() const;
+
+    /** Get the prefix of the current element event, or an empty string
+      * if it has none.
+      */
+    const XMLCh* getPrefix() const;
+
+    /** Get the qualified name of the current element event, as it
+      * appeared in the document.
+      */
+    const XMLCh* getQName() const;
+
+    /** Get the namespace URI of the current element event, or an empty
+      * string if it has none.
+      */
+    const XMLCh* getURI() const;
+
+    /** Get the element declaration of the current element event. */
+    const XMLElementDecl* getElementDecl() const;
+
+    /** Get the number of attributes of the current start element event,
+      * including those defaulted from the grammar.
+      */
+    XMLSize_t getAttributeCount() const;
+
+    /** Get an attribute of the current start element event.
+      *
+      * @param index The index of the attribute, which must be less than
+      *              getAttributeCount().
+      *
+      * @return The attribute, or zero if the index is out of range.
+      */
+    const XMLAttr* getAttribute(const XMLSize_t index) const;
+
+    /** Get the namespace URI of an attribute of the current start
+      * element event, or an empty string if it has none.
+      */
+    const XMLCh* getAttributeURI(const XMLSize_t index) const;
+
+    /** Get the value of an attribute of the current start element event
+      * by its qualified name.
+      *
+      * @return The value, or zero if there is no such attribute.
+      */
+    const XMLCh* getAttributeValue(const XMLCh* const qName) const;
+
+    /** Get the text of the current character data, CDATA, whitespace or
+      * comment event, or the data of the current processing instruction.
+      * It is null terminated.
+      */
+    const XMLCh* getText() const;
+
+    /** Get the length of the text returned by getText(). */
+    XMLSize_t getTextLength() const;
+
+    /** Get the target of the current processing instruction event. */
+    const XMLCh* getPITarget() const;
+
+    /** Get the line number in the document at which the scanner is
+      * positioned. This is after the end of the latest scanned event,
+      * which may be ahead of the current one.
+      */
+    XMLFileLoc getLineNumber() const;
+
+    /** Get the column number in the document at which the scanner is
+      * positioned.
+      *
+      * @see #getLineNumber
+      */
+    XMLFileLoc getColumnNumber() const;
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Implementation of the XMLDocumentHandler interface
+    // -----------------------------------------------------------------------
+    /** @name Implementation of the XMLDocumentHandler interface. */
+    //@{
+    virtual void docCharacters
+    (
+        const   XMLCh* const    chars
+        , const XMLSize_t       length
+        , const bool            cdataSection
+    );
+    virtual void docComment
+    (
+        const   XMLCh* const    comment
+    );
+    virtual void docPI
+    (
+        const   XMLCh* const    target
+        , const XMLCh* const    data
+    );
+    virtual void endDocument();
+    virtual void endElement
+    (
+        const   XMLElementDecl& elemDecl
+        , const unsigned int    urlId
+        , const bool            isRoot
+        , const XMLCh* const    elemPrefix
+    );
+    virtual void endEntityReference
+    (
+        const   XMLEntityDecl&  entDecl
+    );
+    virtual void ignorableWhitespace
+    (
+        const   XMLCh* const    chars
+        , const XMLSize_t       length
+        , const bool            cdataSection
+    );
+    virtual void resetDocument();
+    virtual void startDocument();
+    virtual void startElement
+    (
+        const   XMLElementDecl&         elemDecl
+        , const unsigned int            urlId
+        , const XMLCh* const            elemPrefix
+        , const RefVectorOf<XMLAttr>&   attrList
+        , const XMLSize_t               attrCount
+        , const bool                    isEmpty
+        , const bool                    isRoot
+    );
+    virtual void startEntityReference
+    (
+        const   XMLEntityDecl&  entDecl
+    );
+    virtual void XMLDecl
+    (
+        const   XMLCh* const    versionStr
+        , const XMLCh* const    encodingStr
+        , const XMLCh* const    standaloneStr
+        , const XMLCh* const    actualEncodingStr
+    );
+    //@}
+
+
+    // -----------------------------------------------------------------------
+    //  Implementation of the XMLErrorReporter interface
+    // -----------------------------------------------------------------------
+    /** @name Implementation of the XMLErrorReporter interface. */
+    //@{
+    virtual void error
+    (
+        const   unsigned int    errCode
+        , const XMLCh* const    msgDomain
+        , const XMLErrorReporter::ErrTypes errType
+        , const XMLCh* const    errorText
+        , const XMLCh* const    systemId
+        , const XMLCh* const    publicId
+        , const XMLFileLoc      lineNum
+        , const XMLFileLoc      colNum
+    );
+    virtual void resetErrors();
+    //@}
+
+
+private :
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    XMLPullParser(const XMLPullParser&);
+    XMLPullParser& operator=(const XMLPullParser&);
+
+
+    // -----------------------------------------------------------------------
+    //  Private class types
+    //
+    //  PullEvent
+    //      An event which the scanner has reported but which has not been
+    //      returned yet. Element events point into the scanner's data, which
+    //      stays put until the next scanNext() call. Text is copied into
+    //      fTextBuf and found by its offset, since that buffer can move
+    //      while it grows.
+    // -----------------------------------------------------------------------
+    struct PullEvent
+    {
+        EventTypes                  fType;
+        XMLSize_t                   fDepth;
+        const XMLElementDecl*       fElemDecl;
+        unsigned int                fURIId;
+        const XMLCh*                fPrefix;
+        const RefVectorOf<XMLAttr>* fAttrList;
+        XMLSize_t                   fAttrCount;
+        XMLSize_t                   fTextOfs;
+        XMLSize_t                   fTextLen;
+        XMLSize_t                   fTargetOfs;
+    };
+
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    void addEvent
+    (
+        const   EventTypes              type
+        , const XMLElementDecl* const   elemDecl = 0
+        , const unsigned int            uriId = 0
+        , const XMLCh* const            elemPrefix = 0
+    );
+    void addTextEvent
+    (
+        const   EventTypes      type
+        , const XMLCh* const    text
+        , const XMLSize_t       length
+    );
+    void cleanUp();
+    const PullEvent* currentEvent() const;
+    bool fillEvents();
+    void initialize();
+    void resetParse();
+
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fEvents
+    //  fNextEvent
+    //      The events found by the latest scan step and the index of the one
+    //      which next() will return. The one before it is the current event,
+    //      so there is none until next() is first called.
+    //
+    //  fTextBuf
+    //      The text of the events in fEvents, each one null terminated.
+    //
+    //  fQNameBuf
+    //      Where getQName() puts together a prefix and a local name.
+    //
+    //  fDepth
+    //      The current element depth of the scan.
+    //
+    //  fSkipDepth
+    //      While skipElement() is scanning, the depth of the element being
+    //      skipped. Events are dropped until its end tag. Zero otherwise.
+    //
+    //  fParseInProgress
+    //  fScanDone
+    //      Whether a pull parse is under way, and if so whether the scanner
+    //      has nothing more to give us.
+    //
+    //  fScanToken
+    //      The token for the scanner's progressive scan calls.
+    //
+    //  fErrorHandler
+    //      The installed SAX error handler, if any.
+    //
+    //  fScanner
+    //  fGrammarResolver
+    //  fURIStringPool
+    //  fValidator
+    //  fMemoryManager
+    //  fGrammarPool
+    //      The scanner and the objects it needs, as for the other parsers.
+    // -----------------------------------------------------------------------
+    ValueVectorOf<PullEvent>*   fEvents;
+    XMLSize_t                   fNextEvent;
+    XMLBuffer                   fTextBuf;
+    mutable XMLBuffer           fQNameBuf;
+    XMLSize_t                   fDepth;
+    XMLSize_t                   fSkipDepth;
+    bool                        fParseInProgress;
+    bool                        fScanDone;
+    XMLPScanToken               fScanToken;
+    ErrorHandler*               fErrorHandler;
+    XMLScanner*                 fScanner;
+    GrammarResolver*            fGrammarResolver;
+    XMLStringPool*              fURIStringPool;
+    XMLValidator*               fValidator;
+    MemoryManager*              fMemoryManager;
+    XMLGrammarPool*             fGrammarPool;
+};
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Getter methods
+// ---------------------------------------------------------------------------
+inline ErrorHandler* XMLPullParser::getErrorHandler() const
+{
+    return fErrorHandler;
+}
+
+inline void XMLPullParser::setErrorHandler(ErrorHandler* const handler)
+{
+    fErrorHandler = handler;
+}
+
+inline XMLPullParser::EventTypes XMLPullParser::getEventType() const
+{
+    const PullEvent* curEvent = currentEvent();
+    return curEvent ? curEvent->fType : Event_None;
+}
+
+inline XMLSize_t XMLPullParser::getDepth() const
+{
+    const PullEvent* curEvent = currentEvent();
+    return curEvent ? curEvent->fDepth : 0;
+}
+
+inline const XMLElementDecl* XMLPullParser::getElementDecl() const
+{
+    const PullEvent* curEvent = currentEvent();
+    return curEvent ? curEvent->fElemDecl : 0;
+}
+
+inline XMLSize_t XMLPullParser::getAttributeCount() const
+{
+    const PullEvent* curEvent = currentEvent();
+    return curEvent ? curEvent->fAttrCount : 0;
+}
+
+inline XMLSize_t XMLPullParser::getTextLength() const
+{
+    const PullEvent* curEvent = currentEvent();
+    return curEvent ? curEvent->fTextLen : 0;
+}
+
+
+// ---------------------------------------------------------------------------
+//  XMLPullParser: Private helper methods
+// ---------------------------------------------------------------------------
+inline const XMLPullParser::PullEvent* XMLPullParser::currentEvent() const
+{
+    if (!fNextEvent || fNextEvent > fEvents->size())
+        return 0;
+    return &fEvents->elementAt(fNextEvent - 1);
+}
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
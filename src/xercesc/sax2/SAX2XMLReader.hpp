@@ -26,6 +26,7 @@
 #include <xercesc/util/XMLUniDefs.hpp>
 #include <xercesc/framework/XMLValidator.hpp>
 #include <xercesc/framework/XMLPScanToken.hpp>
+#include <xercesc/sax/SAXException.hpp>
 #include <xercesc/validators/common/Grammar.hpp>
 
 XERCES_CPP_NAMESPACE_BEGIN
@@ -242,6 +243,7 @@ public:
     * <br>http://apache.org/xml/features/nonvalidating/load-external-dtd (default: true)
     * <br>http://apache.org/xml/features/continue-after-fatal-error (default: false)
     * <br>http://apache.org/xml/features/validation-error-as-fatal (default: false)
+    * <br>http://apache.org/xml/features/adaptive-reader-buffer (default: false)
     *
     * @param name The unique identifier (URI) of the feature.
     * @param value The requested state of the feature (true or false).
@@ -260,6 +262,7 @@ public:
     * <br>http://apache.org/xml/properties/schema/external-noNamespaceSchemaLocation
     * <br>http://apache.org/xml/properties/security-manager
     * <br>http://apache.org/xml/properties/low-water-mark
+    * <br>http://apache.org/xml/properties/reader-buffer-size
     * <br>http://apache.org/xml/properties/scannerName
     *
     * It takes a void pointer as the property value.  Application is required to initialize this void
@@ -878,6 +881,73 @@ public:
     virtual bool removeAdvDocHandler(XMLDocumentHandler* const toRemove) = 0;
     //@}
 
+    // -----------------------------------------------------------------------
+    //  Push parsing and skipping interface
+    // -----------------------------------------------------------------------
+
+    /** @name Push parsing and skipping interface */
+    //@{
+    /** Parse the next chunk of a document that is pushed to the parser
+      *
+      * This method is used to parse a document that arrives a chunk at
+      * a time, for instance from a non-blocking socket, without tying up
+      * a thread per document. The first call starts a new parse. Each
+      * call then parses as much of the document as the bytes passed in so
+      * far allow, invoking the handlers as it goes, and returns without
+      * waiting for more. Call finish() once the last chunk is passed in.
+      *
+      * The bytes are copied, so the caller can reuse the buffer. Only a
+      * token which is split across chunks is kept until the rest of it
+      * arrives. Documents in UTF-16, UCS-4 or EBCDIC are the exception,
+      * and are kept until finish() is called.
+      *
+      * No other parse can be started until finish() is called. If the
+      * parse stops early because of a fatal error, the rest of the chunks
+      * are ignored.
+      *
+      * The default implementation throws SAXNotSupportedException.
+      *
+      * @param bytes A pointer to the next bytes of the document.
+      * @param count The number of bytes to parse.
+      *
+      * @see #finish
+      */
+    virtual void feed
+    (
+        const   XMLByte* const  bytes
+        , const XMLSize_t       count
+    );
+
+    /** Finish a push parse operation
+      *
+      * This method tells the parser that all of the document has been
+      * passed to feed(). It parses the rest of it and resets the parser
+      * so that it can be used for another parse.
+      *
+      * The default implementation throws SAXNotSupportedException.
+      *
+      * @see #feed
+      */
+    virtual void finish();
+
+    /** Skip the content of the current element
+      *
+      * This method may only be called from ContentHandler::startElement.
+      * It tells the parser that the application is not interested in the
+      * content of the element being started. No events are reported for
+      * its children, and the next event is the element's endElement.
+      *
+      * When the document is not being validated, the scanner skips the
+      * content without building any events for it, so a large subtree
+      * costs little more than reading it. Entity references within the
+      * skipped content are not expanded. When validating, the content is
+      * still scanned and validated, but its events are not reported.
+      *
+      * The default implementation throws SAXNotSupportedException.
+      */
+    virtual void skipElement();
+    //@}
+
 private :
     /* The copy constructor, you cannot call this directly */
     SAX2XMLReader(const SAX2XMLReader&);
@@ -891,6 +961,22 @@ inline void SAX2XMLReader::setInputBufferSize(const XMLSize_t /*bufferSize*/)
 {
 }
 
+inline void SAX2XMLReader::feed(const   XMLByte* const  /*bytes*/
+                                , const XMLSize_t       /*count*/)
+{
+    throw SAXNotSupportedException("Push parsing is not supported by this reader");
+}
+
+inline void SAX2XMLReader::finish()
+{
+    throw SAXNotSupportedException("Push parsing is not supported by this reader");
+}
+
+inline void SAX2XMLReader::skipElement()
+{
+    throw SAXNotSupportedException("Skipping elements is not supported by this reader");
+}
+
 XERCES_CPP_NAMESPACE_END
 
 #endif
@@ -0,0 +1,430 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#if HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <xercesc/util/BinDecompressInputStream.hpp>
+#include <xercesc/util/IOException.hpp>
+#include <xercesc/util/OutOfMemoryException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemoryManager.hpp>
+#include <string.h>
+
+#if defined(XERCES_USE_COMPRESSION_GZIP)
+#include <limits.h>
+#include <zlib.h>
+#endif
+
+#if defined(XERCES_USE_COMPRESSION_ZSTD)
+#include <zstd.h>
+#endif
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+// ---------------------------------------------------------------------------
+//  Local data
+//
+//  kInBufSize
+//      The size of the buffer that compressed data is read into.
+//
+//  gGzipMagic
+//  gZstdMagic
+//      The bytes that the data of each format starts with.
+// ---------------------------------------------------------------------------
+static const XMLSize_t  kInBufSize = 64 * 1024;
+static const XMLByte    gGzipMagic[] = { 0x1F, 0x8B };
+static const XMLByte    gZstdMagic[] = { 0x28, 0xB5, 0x2F, 0xFD };
+
+
+#if defined(XERCES_USE_COMPRESSION_GZIP)
+// ---------------------------------------------------------------------------
+//  Local functions
+//
+//  zlib allocates its state through these, so that it comes from our memory
+//  manager. They are called from C code, so they must not throw; zlib turns
+//  a null return into Z_MEM_ERROR, which we report as out of memory.
+// ---------------------------------------------------------------------------
+extern "C" {
+
+static voidpf zlibAlloc(voidpf opaque, uInt items, uInt size)
+{
+    try
+    {
+        return ((MemoryManager*)opaque)->allocate((XMLSize_t)items * size);
+    }
+    catch (...)
+    {
+        return Z_NULL;
+    }
+}
+
+static void zlibFree(voidpf opaque, voidpf address)
+{
+    ((MemoryManager*)opaque)->deallocate(address);
+}
+
+}
+#endif
+
+
+// ---------------------------------------------------------------------------
+//  BinDecompressInputStream: Constructors and Destructor
+// ---------------------------------------------------------------------------
+BinDecompressInputStream::BinDecompressInputStream(BinInputStream* const   streamToAdopt
+                                                   , const XMLCh* const    systemId
+                                                   , MemoryManager* const  manager) :
+    fStream(streamToAdopt)
+    , fSystemId(0)
+    , fFormat(Format_Unknown)
+    , fInBuf(0)
+    , fInBufSize(kInBufSize)
+    , fInIndex(0)
+    , fInAvail(0)
+    , fInFrame(false)
+    , fAtEnd(false)
+    , fCurPos(0)
+    , fDecoder(0)
+    , fMemoryManager(manager)
+{
+    if (systemId)
+        fSystemId = XMLString::replicate(systemId, fMemoryManager);
+}
+
+BinDecompressInputStream::~BinDecompressInputStream()
+{
+#if defined(XERCES_USE_COMPRESSION_GZIP)
+    if (fDecoder && (fFormat == Format_Gzip))
+    {
+        inflateEnd((z_stream*)fDecoder);
+        fMemoryManager->deallocate(fDecoder);
+    }
+#endif
+#if defined(XERCES_USE_COMPRESSION_ZSTD)
+    if (fDecoder && (fFormat == Format_Zstd))
+        ZSTD_freeDStream((ZSTD_DStream*)fDecoder);
+#endif
+
+    fMemoryManager->deallocate(fInBuf);
+    fMemoryManager->deallocate(fSystemId);
+    delete fStream;
+}
+
+
+// ---------------------------------------------------------------------------
+//  BinDecompressInputStream: Getter methods
+// ---------------------------------------------------------------------------
+bool BinDecompressInputStream::isSupported(const Formats format)
+{
+    switch(format)
+    {
+        case Format_None :
+            return true;
+
+        case Format_Gzip :
+#if defined(XERCES_USE_COMPRESSION_GZIP)
+            return true;
+#else
+            return false;
+#endif
+
+        case Format_Zstd :
+#if defined(XERCES_USE_COMPRESSION_ZSTD)
+            return true;
+#else
+            return false;
+#endif
+
+        default :
+            break;
+    }
+    return false;
+}
+
+
+// ---------------------------------------------------------------------------
+//  BinDecompressInputStream: Implementation of the input stream interface
+// ---------------------------------------------------------------------------
+XMLFilePos BinDecompressInputStream::curPos() const
+{
+    return fCurPos;
+}
+
+XMLSize_t
+BinDecompressInputStream::readBytes(        XMLByte* const  toFill
+                                    , const XMLSize_t       maxToRead)
+{
+    if (fFormat == Format_Unknown)
+        detectFormat();
+
+    if (fAtEnd || !maxToRead)
+        return 0;
+
+    XMLSize_t bytesRead = 0;
+    if (fFormat == Format_Gzip)
+    {
+        bytesRead = readGzip(toFill, maxToRead);
+    }
+    else if (fFormat == Format_Zstd)
+    {
+        bytesRead = readZstd(toFill, maxToRead);
+    }
+    else
+    {
+        // Hand out the bytes we looked at first, then read straight through
+        if (fInIndex < fInAvail)
+        {
+            bytesRead = fInAvail - fInIndex;
+            if (bytesRead > maxToRead)
+                bytesRead = maxToRead;
+            memcpy(toFill, fInBuf + fInIndex, bytesRead);
+            fInIndex += bytesRead;
+        }
+        else
+        {
+            bytesRead = fStream->readBytes(toFill, maxToRead);
+        }
+    }
+
+    fCurPos += bytesRead;
+    return bytesRead;
+}
+
+const XMLCh* BinDecompressInputStream::getContentType() const
+{
+    return fStream->getContentType();
+}
+
+const XMLCh* BinDecompressInputStream::getEncoding() const
+{
+    return fStream->getEncoding();
+}
+
+
+// ---------------------------------------------------------------------------
+//  BinDecompressInputStream: Private helper methods
+// ---------------------------------------------------------------------------
+void BinDecompressInputStream::detectFormat()
+{
+    fInBuf = (XMLByte*) fMemoryManager->allocate(fInBufSize);
+
+    // The stream may hand out less than we ask for, so read until we have
+    // enough bytes to tell the formats apart, or the data runs out.
+    while (fInAvail < sizeof(gZstdMagic))
+    {
+        const XMLSize_t bytesRead = fStream->readBytes
+        (
+            fInBuf + fInAvail
+            , fInBufSize - fInAvail
+        );
+        if (!bytesRead)
+            break;
+        fInAvail += bytesRead;
+    }
+
+    Formats format = Format_None;
+    if ((fInAvail >= sizeof(gGzipMagic))
+    &&  !memcmp(fInBuf, gGzipMagic, sizeof(gGzipMagic)))
+    {
+        format = Format_Gzip;
+    }
+    else if ((fInAvail >= sizeof(gZstdMagic))
+         &&  !memcmp(fInBuf, gZstdMagic, sizeof(gZstdMagic)))
+    {
+        format = Format_Zstd;
+    }
+
+    if (!isSupported(format))
+    {
+        // We know what the data is, but can't decompress it
+        fAtEnd = true;
+        throwReadError();
+    }
+
+#if defined(XERCES_USE_COMPRESSION_GZIP)
+    if (format == Format_Gzip)
+    {
+        z_stream* zStream = (z_stream*) fMemoryManager->allocate(sizeof(z_stream));
+        memset(zStream, 0, sizeof(z_stream));
+        zStream->zalloc = zlibAlloc;
+        zStream->zfree = zlibFree;
+        zStream->opaque = (voidpf)fMemoryManager;
+
+        // A window size of 15 plus 16 accepts the gzip format only
+        if (inflateInit2(zStream, 15 + 16) != Z_OK)
+        {
+            fMemoryManager->deallocate(zStream);
+            fAtEnd = true;
+            throw OutOfMemoryException();
+        }
+        fDecoder = zStream;
+    }
+#endif
+
+#if defined(XERCES_USE_COMPRESSION_ZSTD)
+    if (format == Format_Zstd)
+    {
+        ZSTD_DStream* dStream = ZSTD_createDStream();
+        if (!dStream)
+        {
+            fAtEnd = true;
+            throw OutOfMemoryException();
+        }
+        ZSTD_initDStream(dStream);
+        fDecoder = dStream;
+    }
+#endif
+
+    fFormat = format;
+}
+
+bool BinDecompressInputStream::fillInput()
+{
+    if (fInIndex < fInAvail)
+        return true;
+
+    fInIndex = 0;
+    fInAvail = fStream->readBytes(fInBuf, fInBufSize);
+    return (fInAvail != 0);
+}
+
+//
+//  Both of these loop until they have produced some output, or the data is
+//  used up. fInFrame is set while we are within a gzip member or zstd frame,
+//  so running out of data then means that it was cut short. Even then the
+//  decoder may still hold output from input that it has already taken, so
+//  it gets one more go with no input before we give up on it.
+//
+XMLSize_t
+BinDecompressInputStream::readGzip(         XMLByte* const  toFill
+                                   , const XMLSize_t       maxToRead)
+{
+#if defined(XERCES_USE_COMPRESSION_GZIP)
+    z_stream* zStream = (z_stream*)fDecoder;
+
+    const uInt outSize = (maxToRead > UINT_MAX) ? UINT_MAX : (uInt)maxToRead;
+    zStream->next_out = toFill;
+    zStream->avail_out = outSize;
+
+    while (zStream->avail_out == outSize)
+    {
+        const bool haveInput = fillInput();
+        if (!fInFrame)
+        {
+            //
+            //  Between members. Anything after the last one that isn't
+            //  another member is ignored, as gzip does with the padding
+            //  that archives often leave at the end of the data.
+            //
+            if (!haveInput || (fInBuf[fInIndex] != gGzipMagic[0]))
+            {
+                fAtEnd = true;
+                break;
+            }
+            fInFrame = true;
+        }
+
+        zStream->next_in = fInBuf + fInIndex;
+        zStream->avail_in = (uInt)(fInAvail - fInIndex);
+
+        const int result = inflate(zStream, Z_NO_FLUSH);
+        fInIndex = fInAvail - zStream->avail_in;
+
+        if (result == Z_STREAM_END)
+        {
+            inflateReset(zStream);
+            fInFrame = false;
+        }
+        else if (result == Z_MEM_ERROR)
+        {
+            fAtEnd = true;
+            throw OutOfMemoryException();
+        }
+        else if ((result != Z_OK) || (!haveInput && (zStream->avail_out == outSize)))
+        {
+            fAtEnd = true;
+            throwReadError();
+        }
+    }
+    return outSize - zStream->avail_out;
+#else
+    (void)toFill;
+    (void)maxToRead;
+    return 0;
+#endif
+}
+
+XMLSize_t
+BinDecompressInputStream::readZstd(         XMLByte* const  toFill
+                                   , const XMLSize_t       maxToRead)
+{
+#if defined(XERCES_USE_COMPRESSION_ZSTD)
+    ZSTD_DStream* dStream = (ZSTD_DStream*)fDecoder;
+    ZSTD_outBuffer outBuf = { toFill, maxToRead, 0 };
+
+    while (!outBuf.pos)
+    {
+        const bool haveInput = fillInput();
+        if (!haveInput && !fInFrame)
+        {
+            fAtEnd = true;
+            break;
+        }
+
+        ZSTD_inBuffer inBuf = { fInBuf + fInIndex, fInAvail - fInIndex, 0 };
+        const size_t result = ZSTD_decompressStream(dStream, &outBuf, &inBuf);
+        fInIndex += inBuf.pos;
+
+        if (ZSTD_isError(result) || (!haveInput && !outBuf.pos))
+        {
+            fAtEnd = true;
+            throwReadError();
+        }
+
+        // A result of zero means that a frame has just been completed
+        fInFrame = (result != 0);
+    }
+    return outBuf.pos;
+#else
+    (void)toFill;
+    (void)maxToRead;
+    return 0;
+#endif
+}
+
+void BinDecompressInputStream::throwReadError()
+{
+    ThrowXMLwithMemMgr1
+    (
+        IOException
+        , XMLExcepts::File_CouldNotDecompress
+        , fSystemId ? fSystemId : XMLUni::fgZeroLenString
+        , fMemoryManager
+    );
+}
+
+XERCES_CPP_NAMESPACE_END
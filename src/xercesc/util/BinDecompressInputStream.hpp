@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_BINDECOMPRESSINPUTSTREAM_HPP)
+#define XERCESC_INCLUDE_GUARD_BINDECOMPRESSINPUTSTREAM_HPP
+
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+//
+//  This class wraps another input stream and decompresses its data as it
+//  is read. The compression format is detected from the first bytes of the
+//  data: gzip, and zstd where the library was built with support for it.
+//  Data in neither format is passed through unchanged, so any stream can
+//  be wrapped. Concatenated gzip members and zstd frames are decompressed
+//  one after the other, as the gzip and zstd tools do.
+//
+//  Compressed data that is corrupt or cut short, or that is in a format
+//  the library was built without, causes readBytes() to throw an
+//  IOException naming the system id that the stream was created with.
+//
+class XMLUTIL_EXPORT BinDecompressInputStream : public BinInputStream
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Class specific types
+    // -----------------------------------------------------------------------
+    enum Formats
+    {
+        Format_Unknown
+        , Format_None
+        , Format_Gzip
+        , Format_Zstd
+    };
+
+
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    BinDecompressInputStream
+    (
+        BinInputStream* const   streamToAdopt
+        , const XMLCh* const    systemId = 0
+        , MemoryManager* const  manager = XMLPlatformUtils::fgMemoryManager
+    );
+    virtual ~BinDecompressInputStream();
+
+
+    // -----------------------------------------------------------------------
+    //  Getter methods
+    // -----------------------------------------------------------------------
+    Formats getFormat() const;
+    static bool isSupported(const Formats format);
+
+
+    // -----------------------------------------------------------------------
+    //  Implementation of the input stream interface
+    // -----------------------------------------------------------------------
+    virtual XMLFilePos curPos() const;
+
+    virtual XMLSize_t readBytes
+    (
+                XMLByte* const      toFill
+        , const XMLSize_t           maxToRead
+    );
+
+    virtual const XMLCh* getContentType() const;
+
+    virtual const XMLCh* getEncoding() const;
+
+private :
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    BinDecompressInputStream(const BinDecompressInputStream&);
+    BinDecompressInputStream& operator=(const BinDecompressInputStream&);
+
+    // -----------------------------------------------------------------------
+    //  Private helper methods
+    // -----------------------------------------------------------------------
+    void detectFormat();
+    bool fillInput();
+    XMLSize_t readGzip(XMLByte* const toFill, const XMLSize_t maxToRead);
+    XMLSize_t readZstd(XMLByte* const toFill, const XMLSize_t maxToRead);
+    void throwReadError();
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fStream
+    //      The stream that we decompress. We own it.
+    //
+    //  fSystemId
+    //      Our copy of the system id of the data, if we were given one, for
+    //      use in error messages.
+    //
+    //  fFormat
+    //      The compression format of fStream, which is unknown until the
+    //      first read.
+    //
+    //  fInBuf
+    //  fInBufSize
+    //  fInIndex
+    //  fInAvail
+    //      The buffer that compressed data is read into from fStream, its
+    //      size, the index of the next byte to use in it and the number of
+    //      bytes that were read into it.
+    //
+    //  fInFrame
+    //      Set while we are within a gzip member or a zstd frame, so that
+    //      we can tell data that was cut short from data that has ended.
+    //
+    //  fAtEnd
+    //      Set once all of the data has been decompressed.
+    //
+    //  fCurPos
+    //      The number of decompressed bytes handed out so far.
+    //
+    //  fDecoder
+    //      The zlib or zstd decompression state, once the format is known.
+    //      It is held as a void pointer so that this header doesn't need
+    //      the headers of either library.
+    // -----------------------------------------------------------------------
+    BinInputStream*         fStream;
+    XMLCh*                  fSystemId;
+    Formats                 fFormat;
+    XMLByte*                fInBuf;
+    XMLSize_t               fInBufSize;
+    XMLSize_t               fInIndex;
+    XMLSize_t               fInAvail;
+    bool                    fInFrame;
+    bool                    fAtEnd;
+    XMLFilePos              fCurPos;
+    void*                   fDecoder;
+    MemoryManager* const    fMemoryManager;
+};
+
+
+// ---------------------------------------------------------------------------
+//  BinDecompressInputStream: Getter methods
+// ---------------------------------------------------------------------------
+inline BinDecompressInputStream::Formats BinDecompressInputStream::getFormat() const
+{
+    return fFormat;
+}
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
@@ -28,6 +28,7 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/XMLExceptMsgs.hpp>
 #include <xercesc/util/XMLString.hpp>
+#include <string.h>
 
 XERCES_CPP_NAMESPACE_BEGIN
 
@@ -38,6 +39,9 @@ BinFileInputStream::BinFileInputStream(const XMLCh* const fileName
                                        , MemoryManager* const manager) :
 
     fSource(XMLPlatformUtils::openFile(fileName, manager))
+  , fMapAddr(0)
+  , fMapSize(0)
+  , fMapPos(0)
   , fMemoryManager(manager)
 {
 }
@@ -46,6 +50,9 @@ BinFileInputStream::BinFileInputStream(const char* const fileName,
                                        MemoryManager* const manager) :
 
     fSource(XMLPlatformUtils::openFile(fileName, manager))
+  , fMapAddr(0)
+  , fMapSize(0)
+  , fMapPos(0)
   , fMemoryManager(manager)
 {
 }
@@ -54,6 +61,9 @@ BinFileInputStream::BinFileInputStream(const FileHandle toAdopt
                                        , MemoryManager* const manager) :
 
     fSource(toAdopt)
+  , fMapAddr(0)
+  , fMapSize(0)
+  , fMapPos(0)
   , fMemoryManager(manager)
 {
 }
@@ -64,6 +74,8 @@ BinFileInputStream::~BinFileInputStream()
     {
         try
         {
+            if (fMapAddr)
+                XMLPlatformUtils::unmapFile(fMapAddr, fMapSize, fMemoryManager);
             XMLPlatformUtils::closeFile(fSource, fMemoryManager);
         }
         catch (...)
@@ -89,6 +101,36 @@ XMLFilePos BinFileInputStream::getSize() const
 void BinFileInputStream::reset()
 {
     XMLPlatformUtils::resetFile(fSource, fMemoryManager);
+    fMapPos = 0;
+}
+
+//
+//  Maps the whole file into memory, if the file manager supports it, from
+//  which point on the data is taken from the mapping rather than read from
+//  the file. The current position is kept. Returns true if the file is now
+//  mapped, and false if it is read as usual.
+//
+bool BinFileInputStream::mapFile(const bool hugePages)
+{
+    if (fMapAddr || !getIsOpen())
+        return getIsMapped();
+
+    const XMLFilePos filePos = XMLPlatformUtils::curFilePos(fSource, fMemoryManager);
+    XMLSize_t mapSize = 0;
+    const XMLByte* mapAddr = XMLPlatformUtils::mapFile(fSource, mapSize, hugePages, fMemoryManager);
+    if (!mapAddr)
+        return false;
+
+    if (filePos > mapSize)
+    {
+        XMLPlatformUtils::unmapFile(mapAddr, mapSize, fMemoryManager);
+        return false;
+    }
+
+    fMapAddr = mapAddr;
+    fMapSize = mapSize;
+    fMapPos = (XMLSize_t)filePos;
+    return true;
 }
 
 
@@ -97,6 +139,8 @@ void BinFileInputStream::reset()
 // ---------------------------------------------------------------------------
 XMLFilePos BinFileInputStream::curPos() const
 {
+    if (fMapAddr)
+        return fMapPos;
     return XMLPlatformUtils::curFilePos(fSource, fMemoryManager);
 }
 
@@ -108,6 +152,15 @@ BinFileInputStream::readBytes(          XMLByte* const  toFill
     //  Read up to the maximum bytes requested. We return the number
     //  actually read.
     //
+    if (fMapAddr)
+    {
+        XMLSize_t toRead = fMapSize - fMapPos;
+        if (toRead > maxToRead)
+            toRead = maxToRead;
+        memcpy(toFill, fMapAddr + fMapPos, toRead);
+        fMapPos += toRead;
+        return toRead;
+    }
     return XMLPlatformUtils::readFileBuffer(fSource, maxToRead, toFill, fMemoryManager);
 }
 
@@ -116,4 +169,11 @@ const XMLCh* BinFileInputStream::getContentType() const
     return 0;
 }
 
+const XMLByte* BinFileInputStream::getInMemoryBuffer(XMLSize_t& size) const
+{
+    if (fMapAddr)
+        size = fMapSize;
+    return fMapAddr;
+}
+
 XERCES_CPP_NAMESPACE_END
@@ -58,10 +58,17 @@ public :
     //  Getter methods
     // -----------------------------------------------------------------------
     bool getIsOpen() const;
+    bool getIsMapped() const;
     XMLFilePos getSize() const;
     void reset();
 
 
+    // -----------------------------------------------------------------------
+    //  Stream management methods
+    // -----------------------------------------------------------------------
+    bool mapFile(const bool hugePages = false);
+
+
     // -----------------------------------------------------------------------
     //  Implementation of the input stream interface
     // -----------------------------------------------------------------------
@@ -75,6 +82,8 @@ public :
 
     virtual const XMLCh* getContentType() const;
 
+    virtual const XMLByte* getInMemoryBuffer(XMLSize_t& size) const;
+
 private :
     // -----------------------------------------------------------------------
     //  Unimplemented constructors and operators
@@ -88,8 +97,19 @@ private :
     //  fSource
     //      The source file that we represent. The FileHandle type is defined
     //      per platform.
+    //
+    //  fMapAddr
+    //  fMapSize
+    //  fMapPos
+    //      If mapFile() succeeded, the read only mapping of the whole file,
+    //      its size, and our current position in it. The data is then read
+    //      from the mapping and handed out by getInMemoryBuffer(), so that
+    //      the reader can take it in place. Otherwise fMapAddr is zero.
     // -----------------------------------------------------------------------
     FileHandle              fSource;
+    const XMLByte*          fMapAddr;
+    XMLSize_t               fMapSize;
+    XMLSize_t               fMapPos;
     MemoryManager* const    fMemoryManager;
 };
 
@@ -102,6 +122,11 @@ inline bool BinFileInputStream::getIsOpen() const
     return (fSource != (FileHandle) XERCES_Invalid_File_Handle);
 }
 
+inline bool BinFileInputStream::getIsMapped() const
+{
+    return (fMapAddr != 0);
+}
+
 XERCES_CPP_NAMESPACE_END
 
 #endif
@@ -50,4 +50,9 @@ const XMLCh* BinInputStream::getEncoding() const
     return 0;
 }
 
+const XMLByte* BinInputStream::getInMemoryBuffer(XMLSize_t&) const
+{
+    return 0;
+}
+
 XERCES_CPP_NAMESPACE_END
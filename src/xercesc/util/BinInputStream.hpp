@@ -84,6 +84,21 @@ public :
      */
     virtual const XMLCh *getEncoding() const;
 
+    /**
+     * Return the complete content of the stream if it is held in memory,
+     * unchanged, for the whole lifetime of the stream. Readers can then
+     * scan the data in place instead of copying it out with readBytes.
+     * The returned buffer starts at stream position 0, regardless of how
+     * much has already been read.
+     *
+     * An example of a stream that may return non-0 from this function is
+     * a stream over a caller supplied memory buffer.
+     *
+     * @param size On success, set to the number of bytes in the buffer.
+     * @return The buffer, or 0 if the content is not available in memory.
+     */
+    virtual const XMLByte* getInMemoryBuffer(XMLSize_t& size) const;
+
 protected :
     // -----------------------------------------------------------------------
     //  Hidden Constructors
@@ -95,4 +95,10 @@ const XMLCh* BinMemInputStream::getContentType() const
     return 0;
 }
 
+const XMLByte* BinMemInputStream::getInMemoryBuffer(XMLSize_t& size) const
+{
+    size = fCapacity;
+    return fBuffer;
+}
+
 XERCES_CPP_NAMESPACE_END
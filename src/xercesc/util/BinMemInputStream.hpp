@@ -73,6 +73,8 @@ public :
 
     virtual const XMLCh* getContentType() const;
 
+    virtual const XMLByte* getInMemoryBuffer(XMLSize_t& size) const;
+
     inline XMLSize_t getSize() const;
 
 private :
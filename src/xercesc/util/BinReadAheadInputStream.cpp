@@ -0,0 +1,373 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+
+// ---------------------------------------------------------------------------
+//  Includes
+// ---------------------------------------------------------------------------
+#if HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <xercesc/util/BinReadAheadInputStream.hpp>
+#include <xercesc/framework/MemoryManager.hpp>
+#include <string.h>
+
+#if defined(HAVE_STD_THREAD) && !defined(XERCES_USE_MUTEXMGR_NOTHREAD)
+#define XERCES_READ_AHEAD_THREAD 1
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#endif
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+#if defined(XERCES_READ_AHEAD_THREAD)
+
+// ---------------------------------------------------------------------------
+//  BinReadAheadInputStream::ReadAhead
+//
+//  The blocks form a ring. The background thread fills the free blocks in
+//  turn and the reader empties the filled ones in the same order, so at most
+//  all of the blocks are filled and waiting to be read at any time. The
+//  wrapped stream is only used by the background thread, and outside of
+//  the lock, so that reading it doesn't hold up the reader.
+// ---------------------------------------------------------------------------
+class BinReadAheadInputStream::ReadAhead : public XMemory
+{
+public :
+    ReadAhead
+    (
+        BinInputStream* const   stream
+        , const XMLSize_t       blockSize
+        , const unsigned int    blockCount
+        , MemoryManager* const  manager
+    );
+    ~ReadAhead();
+
+    bool start();
+    XMLSize_t read(XMLByte* const toFill, const XMLSize_t maxToRead);
+
+private :
+    ReadAhead(const ReadAhead&);
+    ReadAhead& operator=(const ReadAhead&);
+
+    void run();
+
+    struct Block
+    {
+        XMLByte*    fData;
+        XMLSize_t   fSize;
+        XMLSize_t   fUsed;
+    };
+
+    BinInputStream* const   fStream;
+    const XMLSize_t         fBlockSize;
+    const unsigned int      fBlockCount;
+    XMLByte*                fData;
+    Block*                  fBlocks;
+    unsigned int            fReadBlock;
+    unsigned int            fFillBlock;
+    unsigned int            fFilledCount;
+    bool                    fAtEnd;
+    bool                    fCancelled;
+    std::exception_ptr      fError;
+    std::mutex              fMutex;
+    std::condition_variable fFilled;
+    std::condition_variable fFreed;
+    std::thread             fThread;
+    MemoryManager* const    fMemoryManager;
+};
+
+BinReadAheadInputStream::ReadAhead::ReadAhead(BinInputStream* const   stream
+                                              , const XMLSize_t       blockSize
+                                              , const unsigned int    blockCount
+                                              , MemoryManager* const  manager) :
+    fStream(stream)
+    , fBlockSize(blockSize)
+    , fBlockCount(blockCount)
+    , fData(0)
+    , fBlocks(0)
+    , fReadBlock(0)
+    , fFillBlock(0)
+    , fFilledCount(0)
+    , fAtEnd(false)
+    , fCancelled(false)
+    , fMemoryManager(manager)
+{
+    fData = (XMLByte*) fMemoryManager->allocate(fBlockSize * fBlockCount);
+    fBlocks = (Block*) fMemoryManager->allocate(fBlockCount * sizeof(Block));
+    for (unsigned int index = 0; index < fBlockCount; index++)
+    {
+        fBlocks[index].fData = fData + (index * fBlockSize);
+        fBlocks[index].fSize = 0;
+        fBlocks[index].fUsed = 0;
+    }
+}
+
+BinReadAheadInputStream::ReadAhead::~ReadAhead()
+{
+    //
+    //  Tell the thread to stop, and wait for any read in progress to finish.
+    //  The read can't be interrupted, which is why only streams whose reads
+    //  return on their own should be read ahead.
+    //
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fCancelled = true;
+    }
+    fFreed.notify_all();
+    if (fThread.joinable())
+        fThread.join();
+
+    fMemoryManager->deallocate(fBlocks);
+    fMemoryManager->deallocate(fData);
+}
+
+bool BinReadAheadInputStream::ReadAhead::start()
+{
+    try
+    {
+        fThread = std::thread(&ReadAhead::run, this);
+    }
+    catch (const std::system_error&)
+    {
+        return false;
+    }
+    return true;
+}
+
+void BinReadAheadInputStream::ReadAhead::run()
+{
+    while (true)
+    {
+        // Wait for a free block
+        unsigned int blockIndex;
+        {
+            std::unique_lock<std::mutex> lock(fMutex);
+            while (!fCancelled && (fFilledCount == fBlockCount))
+                fFreed.wait(lock);
+
+            if (fCancelled)
+                return;
+            blockIndex = fFillBlock;
+        }
+
+        XMLSize_t bytesRead = 0;
+        std::exception_ptr error;
+        try
+        {
+            bytesRead = fStream->readBytes(fBlocks[blockIndex].fData, fBlockSize);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            if (error)
+            {
+                fError = error;
+                fAtEnd = true;
+            }
+            else if (!bytesRead)
+            {
+                fAtEnd = true;
+            }
+            else
+            {
+                fBlocks[blockIndex].fSize = bytesRead;
+                fBlocks[blockIndex].fUsed = 0;
+                fFillBlock = (fFillBlock + 1) % fBlockCount;
+                fFilledCount++;
+            }
+        }
+        fFilled.notify_one();
+
+        if (error || !bytesRead)
+            return;
+    }
+}
+
+XMLSize_t
+BinReadAheadInputStream::ReadAhead::read(       XMLByte* const  toFill
+                                         , const XMLSize_t       maxToRead)
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    while (!fFilledCount && !fAtEnd)
+        fFilled.wait(lock);
+
+    //
+    //  If there is nothing left, we are at the end of the data. If that is
+    //  because of an error, throw it now that the data before it is used up.
+    //
+    if (!fFilledCount)
+    {
+        if (fError)
+        {
+            std::exception_ptr error = fError;
+            fError = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+        return 0;
+    }
+
+    // Hand out as much as we have, up to the amount asked for
+    XMLSize_t bytesDone = 0;
+    bool freedBlock = false;
+    while (fFilledCount && (bytesDone < maxToRead))
+    {
+        Block& curBlock = fBlocks[fReadBlock];
+        XMLSize_t toCopy = curBlock.fSize - curBlock.fUsed;
+        if (toCopy > maxToRead - bytesDone)
+            toCopy = maxToRead - bytesDone;
+
+        memcpy(toFill + bytesDone, curBlock.fData + curBlock.fUsed, toCopy);
+        curBlock.fUsed += toCopy;
+        bytesDone += toCopy;
+
+        if (curBlock.fUsed == curBlock.fSize)
+        {
+            fReadBlock = (fReadBlock + 1) % fBlockCount;
+            fFilledCount--;
+            freedBlock = true;
+        }
+    }
+    lock.unlock();
+
+    if (freedBlock)
+        fFreed.notify_one();
+    return bytesDone;
+}
+
+#else
+
+//
+//  Without thread support there is nothing to read ahead with. This just
+//  lets the stream compile; it is never created.
+//
+class BinReadAheadInputStream::ReadAhead : public XMemory
+{
+public :
+    XMLSize_t read(XMLByte* const, const XMLSize_t)
+    {
+        return 0;
+    }
+};
+
+#endif
+
+
+// ---------------------------------------------------------------------------
+//  BinReadAheadInputStream: Constructors and Destructor
+// ---------------------------------------------------------------------------
+BinReadAheadInputStream::BinReadAheadInputStream(BinInputStream* const   streamToAdopt
+                                                 , const XMLSize_t       blockSize
+                                                 , const unsigned int    blockCount
+                                                 , MemoryManager* const  manager) :
+    fStream(streamToAdopt)
+    , fContentType(0)
+    , fEncoding(0)
+    , fCurPos(0)
+    , fReadAhead(0)
+    , fMemoryManager(manager)
+{
+    fContentType = fStream->getContentType();
+    fEncoding = fStream->getEncoding();
+
+    // There is no point in reading ahead from memory
+    XMLSize_t dataSize = 0;
+    if (fStream->getInMemoryBuffer(dataSize))
+        return;
+
+#if defined(XERCES_READ_AHEAD_THREAD)
+    fCurPos = fStream->curPos();
+
+    ReadAhead* readAhead = new (fMemoryManager) ReadAhead
+    (
+        fStream
+        , blockSize ? blockSize : (XMLSize_t)kDefaultBlockSize
+        , blockCount ? blockCount : 1
+        , fMemoryManager
+    );
+
+    // If we can't get a thread, just read from the stream directly
+    if (readAhead->start())
+        fReadAhead = readAhead;
+    else
+        delete readAhead;
+#else
+    (void)blockSize;
+    (void)blockCount;
+#endif
+}
+
+BinReadAheadInputStream::~BinReadAheadInputStream()
+{
+    // Stop reading ahead before the stream goes away
+    delete fReadAhead;
+    delete fStream;
+}
+
+
+// ---------------------------------------------------------------------------
+//  BinReadAheadInputStream: Implementation of the input stream interface
+// ---------------------------------------------------------------------------
+XMLFilePos BinReadAheadInputStream::curPos() const
+{
+    if (!fReadAhead)
+        return fStream->curPos();
+    return fCurPos;
+}
+
+XMLSize_t
+BinReadAheadInputStream::readBytes(       XMLByte* const  toFill
+                                   , const XMLSize_t       maxToRead)
+{
+    if (!fReadAhead)
+        return fStream->readBytes(toFill, maxToRead);
+
+    const XMLSize_t bytesRead = fReadAhead->read(toFill, maxToRead);
+    fCurPos += bytesRead;
+    return bytesRead;
+}
+
+const XMLCh* BinReadAheadInputStream::getContentType() const
+{
+    return fContentType;
+}
+
+const XMLCh* BinReadAheadInputStream::getEncoding() const
+{
+    return fEncoding;
+}
+
+const XMLByte* BinReadAheadInputStream::getInMemoryBuffer(XMLSize_t& size) const
+{
+    if (!fReadAhead)
+        return fStream->getInMemoryBuffer(size);
+    return 0;
+}
+
+XERCES_CPP_NAMESPACE_END
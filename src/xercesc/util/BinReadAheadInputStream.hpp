@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_BINREADAHEADINPUTSTREAM_HPP)
+#define XERCESC_INCLUDE_GUARD_BINREADAHEADINPUTSTREAM_HPP
+
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+
+//
+//  This class wraps another input stream and reads ahead from it on a
+//  background thread, into a fixed number of blocks, while the data already
+//  read is being consumed. So reading from a slow source (a disk, a pipe or
+//  a network connection, or a stream that decompresses its data) overlaps
+//  with parsing instead of stalling it.
+//
+//  Errors thrown by the wrapped stream are thrown again from readBytes()
+//  once the data read before them has been consumed. Destroying the stream
+//  stops the background thread, waiting for a read in progress to finish.
+//  There is no way to interrupt a read of the wrapped stream, so only wrap
+//  streams whose reads return on their own, such as local files: if a pipe
+//  or a network connection stalls, destroying the stream waits until data
+//  arrives or the other end closes it. This is why the parsers' read ahead
+//  option is only applied to local files.
+//
+//  If the wrapped stream holds all of its data in memory, or if the library
+//  was built without thread support, nothing is read ahead and the wrapped
+//  stream is used directly.
+//
+class XMLUTIL_EXPORT BinReadAheadInputStream : public BinInputStream
+{
+public :
+    // -----------------------------------------------------------------------
+    //  Class specific types
+    // -----------------------------------------------------------------------
+    enum Constants
+    {
+        kDefaultBlockSize   = 64 * 1024
+        , kDefaultBlockCount = 4
+    };
+
+
+    // -----------------------------------------------------------------------
+    //  Constructors and Destructor
+    // -----------------------------------------------------------------------
+    BinReadAheadInputStream
+    (
+        BinInputStream* const   streamToAdopt
+        , const XMLSize_t       blockSize = kDefaultBlockSize
+        , const unsigned int    blockCount = kDefaultBlockCount
+        , MemoryManager* const  manager = XMLPlatformUtils::fgMemoryManager
+    );
+    virtual ~BinReadAheadInputStream();
+
+
+    // -----------------------------------------------------------------------
+    //  Implementation of the input stream interface
+    // -----------------------------------------------------------------------
+    virtual XMLFilePos curPos() const;
+
+    virtual XMLSize_t readBytes
+    (
+                XMLByte* const      toFill
+        , const XMLSize_t           maxToRead
+    );
+
+    virtual const XMLCh* getContentType() const;
+
+    virtual const XMLCh* getEncoding() const;
+
+    virtual const XMLByte* getInMemoryBuffer(XMLSize_t& size) const;
+
+private :
+    // -----------------------------------------------------------------------
+    //  Unimplemented constructors and operators
+    // -----------------------------------------------------------------------
+    BinReadAheadInputStream(const BinReadAheadInputStream&);
+    BinReadAheadInputStream& operator=(const BinReadAheadInputStream&);
+
+    // -----------------------------------------------------------------------
+    //  Private class types
+    // -----------------------------------------------------------------------
+    class ReadAhead;
+
+    // -----------------------------------------------------------------------
+    //  Private data members
+    //
+    //  fStream
+    //      The stream we are reading ahead from. We own it.
+    //
+    //  fContentType
+    //  fEncoding
+    //      The content type and encoding of fStream, which are taken when we
+    //      are constructed so that fStream is only used by one thread.
+    //
+    //  fCurPos
+    //      The number of bytes handed out by readBytes() so far.
+    //
+    //  fReadAhead
+    //      The blocks and the background thread that fills them, or zero if
+    //      we don't read ahead.
+    // -----------------------------------------------------------------------
+    BinInputStream*         fStream;
+    const XMLCh*            fContentType;
+    const XMLCh*            fEncoding;
+    XMLFilePos              fCurPos;
+    ReadAhead*              fReadAhead;
+    MemoryManager* const    fMemoryManager;
+};
+
+XERCES_CPP_NAMESPACE_END
+
+#endif
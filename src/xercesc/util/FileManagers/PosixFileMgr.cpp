@@ -30,6 +30,11 @@
 #include <limits.h>
 #endif
 
+#if HAVE_SYS_MMAN_H && HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include <xercesc/util/FileManagers/PosixFileMgr.hpp>
 
 #include <xercesc/util/PlatformUtils.hpp>
@@ -183,6 +188,61 @@ PosixFileMgr::fileWrite(FileHandle f, XMLSize_t byteCount, const XMLByte* buffer
 }
 
 
+const XMLByte*
+PosixFileMgr::fileMap(FileHandle f, XMLSize_t& mapSize, bool hugePages, MemoryManager* const manager)
+{
+    if (!f)
+        ThrowXMLwithMemMgr(XMLPlatformUtilsException, XMLExcepts::CPtr_PointerIsZero, manager);
+
+#if HAVE_SYS_MMAN_H && HAVE_MMAP
+    // Map the whole file, if it is a regular file that fits in memory
+    const int fd = fileno((FILE*)f);
+    struct stat fileInfo;
+    if (fd == -1 || fstat(fd, &fileInfo) || !S_ISREG(fileInfo.st_mode)
+    ||  fileInfo.st_size <= 0 || (XMLSize_t)fileInfo.st_size != (unsigned long long)fileInfo.st_size)
+    {
+        return 0;
+    }
+
+    void* mapAddr = mmap(0, (XMLSize_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapAddr == MAP_FAILED)
+        return 0;
+
+    // These are only hints, so failures are ignored
+#if HAVE_MADVISE && defined(MADV_SEQUENTIAL)
+    madvise(mapAddr, (XMLSize_t)fileInfo.st_size, MADV_SEQUENTIAL);
+#endif
+#if HAVE_MADVISE && defined(MADV_HUGEPAGE)
+    if (hugePages)
+        madvise(mapAddr, (XMLSize_t)fileInfo.st_size, MADV_HUGEPAGE);
+#else
+    (void)hugePages;
+#endif
+
+    mapSize = (XMLSize_t)fileInfo.st_size;
+    return (const XMLByte*)mapAddr;
+#else
+    (void)mapSize;
+    (void)hugePages;
+    return 0;
+#endif
+}
+
+
+void
+PosixFileMgr::fileUnmap(const XMLByte* mapAddr, XMLSize_t mapSize, MemoryManager* const manager)
+{
+    if (!mapAddr)
+        ThrowXMLwithMemMgr(XMLPlatformUtilsException, XMLExcepts::CPtr_PointerIsZero, manager);
+
+#if HAVE_SYS_MMAN_H && HAVE_MMAP
+    munmap(const_cast<XMLByte*>(mapAddr), mapSize);
+#else
+    (void)mapSize;
+#endif
+}
+
+
 XMLCh*
 PosixFileMgr::getFullPath(const XMLCh* const srcPath, MemoryManager* const manager)
 {
@@ -317,6 +317,43 @@ WindowsFileMgr::fileWrite(FileHandle f, XMLSize_t byteCount, const XMLByte* buff
 }
 
 
+const XMLByte*
+WindowsFileMgr::fileMap(FileHandle f, XMLSize_t& mapSize, bool /*hugePages*/, MemoryManager* const manager)
+{
+    if (!f)
+		ThrowXMLwithMemMgr(XMLPlatformUtilsException, XMLExcepts::CPtr_PointerIsZero, manager);
+
+    // Large pages need a privilege that we can't count on, so we ignore the hint
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(f, &size) || size.QuadPart <= 0
+    ||  (unsigned long long)size.QuadPart != (XMLSize_t)size.QuadPart)
+        return 0;
+
+    HANDLE mapping = ::CreateFileMapping(f, 0, PAGE_READONLY, 0, 0, 0);
+    if (!mapping)
+        return 0;
+
+    // The view keeps the mapping object alive until it is unmapped
+    const void* mapAddr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if (!mapAddr)
+        return 0;
+
+    mapSize = (XMLSize_t)size.QuadPart;
+    return (const XMLByte*)mapAddr;
+}
+
+
+void
+WindowsFileMgr::fileUnmap(const XMLByte* mapAddr, XMLSize_t /*mapSize*/, MemoryManager* const manager)
+{
+    if (!mapAddr)
+		ThrowXMLwithMemMgr(XMLPlatformUtilsException, XMLExcepts::CPtr_PointerIsZero, manager);
+
+    ::UnmapViewOfFile(mapAddr);
+}
+
+
 XMLCh*
 WindowsFileMgr::getFullPath(const XMLCh* const srcPath, MemoryManager* const manager)
 {
@@ -47,12 +47,16 @@ class WindowsFileMgr : public XMLFileMgr
 
         virtual XMLSize_t   fileRead(FileHandle f, XMLSize_t byteCount, XMLByte* buffer, MemoryManager* const manager);
         virtual void		fileWrite(FileHandle f, XMLSize_t byteCount, const XMLByte* buffer, MemoryManager* const manager);
-        
+
         // Ancillary path handling routines
         virtual XMLCh*		getFullPath(const XMLCh* const srcPath, MemoryManager* const manager);
         virtual XMLCh*		getCurrentDirectory(MemoryManager* const manager);
         virtual bool		isRelative(const XMLCh* const toCheck, MemoryManager* const manager);
 
+        // Mapping of whole files
+        virtual const XMLByte*	fileMap(FileHandle f, XMLSize_t& mapSize, bool hugePages, MemoryManager* const manager);
+        virtual void		fileUnmap(const XMLByte* mapAddr, XMLSize_t mapSize, MemoryManager* const manager);
+
     private:
         bool _onNT;
 };
@@ -1418,10 +1418,12 @@ const XMLCh gXMLExceptArray[][128] =
       0x006F,0x0061,0x0064,0x0065,0x0072,0x0020,0x006C,0x0065,0x0076,0x0065,0x006C,0x0020,0x0027,0x007B,0x0031,0x007D,0x0027,0x00 }
   , { 0x0075,0x006E,0x0064,0x0065,0x0066,0x0069,0x006E,0x0065,0x0064,0x0020,0x0070,0x0072,0x0065,0x0066,0x0069,0x0078,0x0020,0x0069,0x006E,0x0020,0x0051,0x004E,0x0061,0x006D,0x0065,0x0020,0x0076,0x0061,0x006C,0x0075,0x0065,0x0020,0x0027,0x007B,0x0030,
       0x007D,0x0027,0x00 }
+  , { 0x0075,0x006E,0x0061,0x0062,0x006C,0x0065,0x0020,0x0074,0x006F,0x0020,0x0064,0x0065,0x0063,0x006F,0x006D,0x0070,0x0072,0x0065,0x0073,0x0073,0x0020,0x0064,0x0061,0x0074,0x0061,0x0020,0x0066,0x0072,0x006F,0x006D,0x0020,0x0027,0x007B,0x0030,0x007D,
+      0x0027,0x00 }
   , { 0x0046,0x005F,0x0045,0x006E,0x0064,0x00 }
 
 };
-const unsigned int gXMLExceptArraySize = 369;
+const unsigned int gXMLExceptArraySize = 370;
 
 const XMLCh gXMLDOMMsgArray[][128] = 
 {
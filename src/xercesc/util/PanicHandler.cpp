@@ -57,6 +57,9 @@ const char* PanicHandler::getPanicReasonString(const PanicReasons reason)
     case Panic_MutexErr:
         reasonStr = "Cannot create, lock or unlock a mutex";
         break;
+    case Panic_HeaderlessDelete:
+        reasonStr = "Cannot delete an object allocated without a memory manager header";
+        break;
     default:
         reasonStr = "Unknown reason";
         break;
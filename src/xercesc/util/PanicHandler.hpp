@@ -58,6 +58,7 @@ public:
         , Panic_SystemInit
         , Panic_AllStaticInitErr
         , Panic_MutexErr
+        , Panic_HeaderlessDelete
         , PanicReasons_Count
     };
     //@}
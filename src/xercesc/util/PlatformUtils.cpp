@@ -52,6 +52,7 @@
 #include <xercesc/util/DefaultPanicHandler.hpp>
 #include <xercesc/util/XMLInitializer.hpp>
 #include <xercesc/internal/MemoryManagerImpl.hpp>
+#include <xercesc/internal/ThreadCachingMemoryManager.hpp>
 
 #if XERCES_HAVE_INTRIN_H
 #   include <intrin.h>
@@ -197,7 +198,11 @@ void XMLPlatformUtils::Initialize(const char*          const locale
         }
         else
         {
+#if defined(XERCES_USE_MEMORYMGR_THREADCACHING)
+            fgMemoryManager = new ThreadCachingMemoryManager();
+#else
             fgMemoryManager = new MemoryManagerImpl();
+#endif
         }
     }
 
@@ -634,6 +639,31 @@ XMLPlatformUtils::writeBufferToFile(   const   FileHandle   theFile
 }
 
 
+const XMLByte*
+XMLPlatformUtils::mapFile(         FileHandle      theFile
+                          ,        XMLSize_t&      mapSize
+                          ,  const bool            hugePages
+                          ,  MemoryManager* const  memmgr)
+{
+    if (!fgFileMgr)
+		ThrowXMLwithMemMgr(XMLPlatformUtilsException, XMLExcepts::CPtr_PointerIsZero, memmgr);
+
+    return fgFileMgr->fileMap(theFile, mapSize, hugePages, memmgr);
+}
+
+
+void
+XMLPlatformUtils::unmapFile(   const XMLByte* const  mapAddr
+                            ,  const XMLSize_t       mapSize
+                            ,  MemoryManager* const  memmgr)
+{
+    if (!fgFileMgr)
+		ThrowXMLwithMemMgr(XMLPlatformUtilsException, XMLExcepts::CPtr_PointerIsZero, memmgr);
+
+    fgFileMgr->fileUnmap(mapAddr, mapSize, memmgr);
+}
+
+
 // ---------------------------------------------------------------------------
 //  XMLPlatformUtils: File system methods
 // ---------------------------------------------------------------------------
@@ -436,6 +436,43 @@ public :
     static void resetFile(FileHandle theFile
         , MemoryManager* const manager  = XMLPlatformUtils::fgMemoryManager);
 
+    /** Maps the file into memory
+      *
+      * This may be implemented by the per-platform driver, which should
+      * use local file services to map the whole of the passed file into
+      * memory, read only, and advise the system that it will be read
+      * sequentially. The file position is not changed. If the file can't
+      * be mapped (or mapping is not supported), a null pointer should be
+      * returned and the file can still be read with readFileBuffer.
+      *
+      * @param theFile The file handle of the file to map
+      * @param mapSize On success, set to the size of the mapping in bytes
+      * @param hugePages If true, the system is also asked to back the
+      * mapping with huge pages, if it can
+      * @param manager The MemoryManager to use to allocate objects
+      * @return The start of the mapping, or 0 if the file was not mapped
+      */
+    static const XMLByte* mapFile
+    (
+                FileHandle      theFile
+        ,       XMLSize_t&      mapSize
+        , const bool            hugePages = false
+        , MemoryManager* const manager  = XMLPlatformUtils::fgMemoryManager
+    );
+
+    /** Unmaps a file mapped by mapFile
+      *
+      * @param mapAddr The start of the mapping, as returned by mapFile
+      * @param mapSize The size of the mapping, as returned by mapFile
+      * @param manager The MemoryManager to use to allocate objects
+      */
+    static void unmapFile
+    (
+          const XMLByte* const  mapAddr
+        , const XMLSize_t       mapSize
+        , MemoryManager* const manager  = XMLPlatformUtils::fgMemoryManager
+    );
+
     //@}
 
 
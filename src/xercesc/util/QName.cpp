@@ -117,7 +117,7 @@ QName::~QName()
 // ---------------------------------------------------------------------------
 QName::QName(const QName& qname)
 :XSerializable(qname)
-,XMemory(qname)
+,XMemoryOptionalHeader(qname)
 ,fPrefixBufSz(0)
 ,fLocalPartBufSz(0)
 ,fRawNameBufSz(0)
@@ -148,6 +148,34 @@ QName::QName(const QName& qname)
     fURIId = qname.getURI();
 }
 
+QName::QName(const QName& qname, MemoryManager* const manager)
+:XSerializable(qname)
+,XMemoryOptionalHeader(qname)
+,fPrefixBufSz(0)
+,fLocalPartBufSz(0)
+,fRawNameBufSz(0)
+,fURIId(0)
+,fPrefix(0)
+,fLocalPart(0)
+,fRawName(0)
+,fMemoryManager(manager)
+{
+    CleanupType cleanup(this, &QName::cleanUp);
+
+    try
+    {
+        setName(qname.getPrefix(), qname.getLocalPart(), qname.getURI());
+    }
+    catch(const OutOfMemoryException&)
+    {
+        cleanup.release();
+
+        throw;
+    }
+
+    cleanup.release();
+}
+
 // ---------------------------------------------------------------------------
 //  QName: Getter methods
 // ---------------------------------------------------------------------------
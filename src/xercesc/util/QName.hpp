@@ -31,7 +31,12 @@
 
 XERCES_CPP_NAMESPACE_BEGIN
 
-class XMLUTIL_EXPORT QName : public XSerializable, public XMemory
+//
+//  In builds with XERCES_HEADERLESS_OBJECTS, QNames are allocated without
+//  the XMemory header. The library creates them with the memory manager it
+//  gives them and deletes them with deleteOwnedObject().
+//
+class XMLUTIL_EXPORT QName : public XSerializable, public XMemoryOptionalHeader
 {
 public :
     // -----------------------------------------------------------------------
@@ -60,6 +65,9 @@ public :
     /** Copy constructor. */
     QName(const QName& qname);
 
+    /** Copies a qname into memory of the specified memory manager. */
+    QName(const QName& qname, MemoryManager* const manager);
+
     ~QName();
 
     // -----------------------------------------------------------------------
@@ -385,9 +385,10 @@ public :
       , XSer_StringPool_NotEmpty           = 363
       , XSer_Storer_Loader_Mismatch        = 364
       , VALUE_QName_Invalid2               = 365
-      , F_HighBounds                       = 366
-      , E_LowBounds                        = 367
-      , E_HighBounds                       = 368
+      , File_CouldNotDecompress            = 366
+      , F_HighBounds                       = 367
+      , E_LowBounds                        = 368
+      , E_HighBounds                       = 369
     };
 
 
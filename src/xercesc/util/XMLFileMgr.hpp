@@ -50,11 +50,17 @@ class XMLFileMgr : public XMemory
 
         virtual XMLSize_t	fileRead(FileHandle f, XMLSize_t byteCount, XMLByte* buffer, MemoryManager* const manager) = 0;
         virtual void		fileWrite(FileHandle f, XMLSize_t byteCount, const XMLByte* buffer, MemoryManager* const manager) = 0;
-        
+
         // Ancillary path handling routines
         virtual XMLCh*		getFullPath(const XMLCh* const srcPath, MemoryManager* const manager) = 0;
         virtual XMLCh*		getCurrentDirectory(MemoryManager* const manager) = 0;
         virtual bool		isRelative(const XMLCh* const toCheck, MemoryManager* const manager) = 0;
+
+        // Read only mapping of a whole file into memory. A file manager that
+        // can't map files leaves these as they are, in which case the file
+        // is read with fileRead.
+        virtual const XMLByte*	fileMap(FileHandle /*f*/, XMLSize_t& /*mapSize*/, bool /*hugePages*/, MemoryManager* const /*manager*/) { return 0; }
+        virtual void		fileUnmap(const XMLByte* /*mapAddr*/, XMLSize_t /*mapSize*/, MemoryManager* const /*manager*/) {}
 };
 
 XERCES_CPP_NAMESPACE_END
@@ -26,6 +26,12 @@
 #include <xercesc/util/XMLString.hpp>
 #include <xercesc/util/XMLUniDefs.hpp>
 #include <xercesc/util/XMLUTF8Transcoder.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <string.h>
+
+#if XERCES_HAVE_EMMINTRIN_H
+#   include <emmintrin.h>
+#endif
 
 XERCES_CPP_NAMESPACE_BEGIN
 
@@ -93,6 +99,55 @@ static const XMLByte gFirstByteMark[7] =
 };
 
 
+#ifdef XERCES_HAVE_SSE2_INTRINSIC
+// ---------------------------------------------------------------------------
+//  Local helper methods
+// ---------------------------------------------------------------------------
+
+//
+//  Widens the run of ASCII bytes at the start of srcPtr into outPtr, 16
+//  bytes per step, and returns how many bytes were consumed. At most
+//  maxCount bytes are read and at most maxCount chars are written, so the
+//  caller must guarantee room for that many in both buffers. The run stops
+//  at the first byte with the high bit set, which is left for the caller.
+//
+//  Only ASCII runs are vectorized. Multi-byte sequences are still validated
+//  and decoded one at a time by the scalar gUTFBytes path in transcodeFrom,
+//  so documents that are mostly non-ASCII do not gain from this.
+//
+static XMLSize_t widenASCIIRun(const XMLByte* const srcPtr
+                               , XMLCh* const       outPtr
+                               , const XMLSize_t    maxCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+    XMLSize_t index = 0;
+    while (maxCount - index >= 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPtr + index));
+
+        // Widen all 16 lanes first; the lanes past a non-ASCII byte are
+        // within maxCount and are simply overwritten by the caller later.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outPtr + index), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outPtr + index + 8), _mm_unpackhi_epi8(bytes, zero));
+
+        unsigned int highBits = (unsigned int)_mm_movemask_epi8(bytes);
+        if (highBits)
+        {
+            // Count the ASCII lanes that precede the first multi-byte lead
+            while (!(highBits & 1))
+            {
+                highBits >>= 1;
+                index++;
+            }
+            return index;
+        }
+        index += 16;
+    }
+    return index;
+}
+#endif
+
+
 
 // ---------------------------------------------------------------------------
 //  XMLUTF8Transcoder: Constructors and Destructor
@@ -147,7 +202,16 @@ XMLUTF8Transcoder::transcodeFrom(const  XMLByte* const          srcData
         {
             // Handle ASCII in groups instead of single character at a time.
             const XMLByte* srcPtr_save = srcPtr;
-            const XMLSize_t chunkSize = (srcEnd-srcPtr)<(outEnd-outPtr)?(srcEnd-srcPtr):(outEnd-outPtr);
+            XMLSize_t chunkSize = (srcEnd-srcPtr)<(outEnd-outPtr)?(srcEnd-srcPtr):(outEnd-outPtr);
+#ifdef XERCES_HAVE_SSE2_INTRINSIC
+            if (XMLPlatformUtils::fgSSE2ok)
+            {
+                const XMLSize_t widened = widenASCIIRun(srcPtr, outPtr, chunkSize);
+                srcPtr += widened;
+                outPtr += widened;
+                chunkSize -= widened;
+            }
+#endif
             for(XMLSize_t i=0;i<chunkSize && *srcPtr <= 127;++i)
                 *outPtr++ = XMLCh(*srcPtr++);
             memset(sizePtr,1,srcPtr - srcPtr_save);
@@ -391,12 +455,15 @@ XMLUTF8Transcoder::transcodeFrom(const  XMLByte* const          srcData
             //
             //  If we have enough room to store the leading and trailing
             //  chars, then lets do it. Else, pretend this one never
-            //  happened, and leave it for the next time. Since we don't
-            //  update the bytes read until the bottom of the loop, by
-            //  breaking out here its like it never happened.
+            //  happened, and leave it for the next time. We have already
+            //  moved past its source bytes, so back up to its first byte
+            //  before breaking out, so that it is not counted as eaten.
             //
             if (outPtr + 1 >= outEnd)
+            {
+                srcPtr -= trailingBytes + 1;
                 break;
+            }
 
             // Store the leading surrogate char
             tmpVal -= 0x10000;
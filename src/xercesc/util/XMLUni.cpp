@@ -711,6 +711,12 @@ const XMLCh XMLUni::fgDGXMLScanner[] =
     ,   chLatin_c, chLatin_a, chLatin_n, chLatin_n, chLatin_e, chLatin_r, chNull
 };
 
+const XMLCh XMLUni::fgNSXMLScanner[] =
+{
+        chLatin_N, chLatin_S, chLatin_X, chLatin_M, chLatin_L, chLatin_S
+    ,   chLatin_c, chLatin_a, chLatin_n, chLatin_n, chLatin_e, chLatin_r, chNull
+};
+
 const XMLCh XMLUni::fgXSAXMLScanner[] =
 {
         chLatin_X, chLatin_S, chLatin_A
@@ -1417,6 +1423,47 @@ const XMLCh XMLUni::fgXercesLowWaterMark[] =
     ,   chLatin_m, chLatin_a, chLatin_r, chLatin_k, chNull
 };
 
+//Property
+//Xerces: http://apache.org/xml/properties/reader-buffer-size
+const XMLCh XMLUni::fgXercesReaderBufferSize[] =
+{
+        chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash
+    ,   chForwardSlash, chLatin_a, chLatin_p, chLatin_a, chLatin_c, chLatin_h
+    ,   chLatin_e, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash
+    ,   chLatin_x, chLatin_m, chLatin_l, chForwardSlash, chLatin_p, chLatin_r
+    ,   chLatin_o, chLatin_p, chLatin_e, chLatin_r, chLatin_t, chLatin_i
+    ,   chLatin_e, chLatin_s, chForwardSlash, chLatin_r, chLatin_e, chLatin_a
+    ,   chLatin_d, chLatin_e, chLatin_r, chDash, chLatin_b, chLatin_u
+    ,   chLatin_f, chLatin_f, chLatin_e, chLatin_r, chDash, chLatin_s
+    ,   chLatin_i, chLatin_z, chLatin_e, chNull
+};
+
+//Xerces: http://apache.org/xml/features/adaptive-reader-buffer
+const XMLCh XMLUni::fgXercesAdaptiveReaderBuffer[] =
+{
+        chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash
+    ,   chForwardSlash, chLatin_a, chLatin_p, chLatin_a, chLatin_c, chLatin_h
+    ,   chLatin_e, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash
+    ,   chLatin_x, chLatin_m, chLatin_l, chForwardSlash, chLatin_f, chLatin_e
+    ,   chLatin_a, chLatin_t, chLatin_u, chLatin_r, chLatin_e, chLatin_s
+    ,   chForwardSlash, chLatin_a, chLatin_d, chLatin_a, chLatin_p, chLatin_t
+    ,   chLatin_i, chLatin_v, chLatin_e, chDash, chLatin_r, chLatin_e
+    ,   chLatin_a, chLatin_d, chLatin_e, chLatin_r, chDash, chLatin_b
+    ,   chLatin_u, chLatin_f, chLatin_f, chLatin_e, chLatin_r, chNull
+};
+
+//Xerces: http://apache.org/xml/features/read-ahead
+const XMLCh XMLUni::fgXercesReadAhead[] =
+{
+        chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash
+    ,   chForwardSlash, chLatin_a, chLatin_p, chLatin_a, chLatin_c, chLatin_h
+    ,   chLatin_e, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash
+    ,   chLatin_x, chLatin_m, chLatin_l, chForwardSlash, chLatin_f, chLatin_e
+    ,   chLatin_a, chLatin_t, chLatin_u, chLatin_r, chLatin_e, chLatin_s
+    ,   chForwardSlash, chLatin_r, chLatin_e, chLatin_a, chLatin_d, chDash
+    ,   chLatin_a, chLatin_h, chLatin_e, chLatin_a, chLatin_d, chNull
+};
+
 //Introduced in DOM Level 3
 const XMLCh XMLUni::fgDOMCanonicalForm[] =
 {
@@ -176,6 +176,7 @@ public :
     static const XMLCh fgIGXMLScanner[];
     static const XMLCh fgSGXMLScanner[];
     static const XMLCh fgDGXMLScanner[];
+    static const XMLCh fgNSXMLScanner[];
     static const XMLCh fgXSAXMLScanner[];
     static const XMLCh fgCDataStart[];
     static const XMLCh fgCDataEnd[];
@@ -245,6 +246,9 @@ public :
     static const XMLCh fgXercesHandleMultipleImports[];
     static const XMLCh fgXercesDoXInclude[];
     static const XMLCh fgXercesLowWaterMark[];
+    static const XMLCh fgXercesReaderBufferSize[];
+    static const XMLCh fgXercesAdaptiveReaderBuffer[];
+    static const XMLCh fgXercesReadAhead[];
 
     // SAX2 features/properties names
     static const XMLCh fgSAX2CoreValidation[];
@@ -120,5 +120,50 @@ void XMemory::operator delete(void* /*p*/, void* /*ptr*/)
 
 #endif
 
+// ---------------------------------------------------------------------------
+//  XMemoryNoHeader
+// ---------------------------------------------------------------------------
+void* XMemoryNoHeader::operator new(size_t size, MemoryManager* manager)
+{
+    assert(manager != 0);
+
+    return manager->allocate(size);
+}
+
+void* XMemoryNoHeader::operator new(size_t /*size*/, void* ptr)
+{
+    return ptr;
+}
+
+void XMemoryNoHeader::deallocate(void* p, MemoryManager* manager)
+{
+    assert(manager != 0);
+
+    manager->deallocate(p);
+}
+
+void XMemoryNoHeader::operator delete(void* /*p*/)
+{
+    // The object does not say which memory manager it came from; it should
+    // have been destroyed with destroy(). Its memory cannot be freed, so
+    // don't let this go unnoticed.
+    XMLPlatformUtils::panic(PanicHandler::Panic_HeaderlessDelete);
+}
+
+//The Borland compiler is complaining about duplicate overloading of delete
+#if !defined(XERCES_NO_MATCHING_DELETE_OPERATOR)
+
+void XMemoryNoHeader::operator delete(void* p, MemoryManager* manager)
+{
+    if (p != 0)
+        deallocate(p, manager);
+}
+
+void XMemoryNoHeader::operator delete(void* /*p*/, void* /*ptr*/)
+{
+}
+
+#endif
+
 XERCES_CPP_NAMESPACE_END
 
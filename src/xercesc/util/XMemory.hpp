@@ -139,6 +139,150 @@ protected :
 #endif
 };
 
+/**
+ *  This class is an alternative to XMemory for small objects that keep a
+ *  pointer to their memory manager anyway.  XMemory puts a header holding
+ *  the memory manager in front of every object, so that operator delete
+ *  can find it; objects derived from this class are allocated without it.
+ *
+ *  Such an object must be created with the memory manager form of operator
+ *  new, passing the same memory manager the object keeps, and is destroyed
+ *  with destroy(), which takes the memory manager from the object before
+ *  running its destructor.  Containers that adopt their elements do this
+ *  on their own.  The ordinary new and delete operators are not available,
+ *  so using them by mistake is a compile error.
+ */
+class XMLUTIL_EXPORT XMemoryNoHeader
+{
+public :
+    // -----------------------------------------------------------------------
+    //  The C++ memory management
+    // -----------------------------------------------------------------------
+    /** @name The C++ memory management */
+    //@{
+
+    /**
+      * This method allocates the object from the provided memory manager,
+      * without a header
+      *
+      * @param size   The requested memory size
+      * @param memMgr The memory manager the object keeps
+      */
+    void* operator new(size_t size, MemoryManager* memMgr);
+
+    /**
+      * This method overrides placement operator new
+      *
+      * @param size   The requested memory size
+      * @param ptr    The memory location where the object should be allocated
+      */
+    void* operator new(size_t size, void* ptr);
+
+     //The Borland compiler is complaining about duplicate overloading of delete
+#if !defined(XERCES_NO_MATCHING_DELETE_OPERATOR)
+    /**
+      * This method provides a matching delete for the custom operator new
+      *
+      * @param p      The pointer to the allocated memory
+      * @param memMgr The memory manager the object was allocated from
+      */
+    void operator delete(void* p, MemoryManager* memMgr);
+
+    /**
+      * This method provides a matching delete for the placement new
+      *
+      * @param p      The pointer to the allocated memory
+      * @param ptr    The memory location where the object had to be allocated
+      */
+    void operator delete(void* p, void* ptr);
+#endif
+
+    /**
+      * Destroys an object allocated without a header and returns its memory
+      * to the memory manager it keeps.  The object's class must provide
+      * getMemoryManager() and must be its most derived class.
+      *
+      * @param p The object to destroy; it may be null
+      */
+    template <class T> static void destroy(T* p)
+    {
+        if (p)
+        {
+            MemoryManager* const manager = p->getMemoryManager();
+            p->~T();
+            deallocate(const_cast<void*>(static_cast<const void*>(p)), manager);
+        }
+    }
+
+    //@}
+
+private :
+    // -----------------------------------------------------------------------
+    //  Helper methods
+    // -----------------------------------------------------------------------
+    static void deallocate(void* p, MemoryManager* manager);
+
+protected :
+    // -----------------------------------------------------------------------
+    //  Hidden Constructors
+    // -----------------------------------------------------------------------
+    /** @name Constructor */
+    //@{
+
+    /**
+      * Protected default constructor
+      */
+    XMemoryNoHeader()
+    {
+    }
+    //@}
+
+    // -----------------------------------------------------------------------
+    //  Hidden operators
+    //
+    //  Only there for the deleting destructor of derived classes with a
+    //  virtual destructor; the object must never be deleted directly, for
+    //  instance through a pointer to another base class. If it is, this
+    //  panics.
+    // -----------------------------------------------------------------------
+    void operator delete(void* p);
+};
+
+// ---------------------------------------------------------------------------
+//  Deletes an object that may have been allocated without the memory
+//  manager header.  Such objects are handed to XMemoryNoHeader::destroy(),
+//  the others are deleted as usual.  The collections that adopt their
+//  elements use delete, so they can't hold header-less objects.
+// ---------------------------------------------------------------------------
+template <class T> inline void deleteOwnedObject(T* p, const XMemoryNoHeader*)
+{
+    XMemoryNoHeader::destroy(p);
+}
+
+template <class T> inline void deleteOwnedObject(T* p, const void*)
+{
+    delete p;
+}
+
+template <class T> inline void deleteOwnedObject(T* p)
+{
+    deleteOwnedObject(p, p);
+}
+
+// ---------------------------------------------------------------------------
+//  The base of the small classes that keep their memory manager, and so can
+//  do without the header. They are only allocated without it when Xerces is
+//  built with XERCES_HEADERLESS_OBJECTS; otherwise they derive from XMemory,
+//  so that applications can create them with new and delete them as usual.
+//  The library itself creates them with the memory manager form of operator
+//  new and deletes them with deleteOwnedObject(), which works either way.
+// ---------------------------------------------------------------------------
+#if defined(XERCES_HEADERLESS_OBJECTS)
+typedef XMemoryNoHeader XMemoryOptionalHeader;
+#else
+typedef XMemory XMemoryOptionalHeader;
+#endif
+
 XERCES_CPP_NAMESPACE_END
 
 #endif
@@ -82,7 +82,7 @@ AllContentModel::AllContentModel( ContentSpecNode* const parentContentSpec
     fChildren = (QName**) fMemoryManager->allocate(fCount * sizeof(QName*)); //new QName*[fCount];
     fChildOptional = (bool*) fMemoryManager->allocate(fCount * sizeof(bool)); //new bool[fCount];
     for (unsigned int index = 0; index < fCount; index++) {
-        fChildren[index] = new (fMemoryManager) QName(*(children.elementAt(index)));
+        fChildren[index] = new (fMemoryManager) QName(*(children.elementAt(index)), fMemoryManager);
         fChildOptional[index] = childOptional.elementAt(index);
     }
 }
@@ -90,7 +90,7 @@ AllContentModel::AllContentModel( ContentSpecNode* const parentContentSpec
 AllContentModel::~AllContentModel()
 {
     for (XMLSize_t index = 0; index < fCount; index++)
-        delete fChildren[index];
+        deleteOwnedObject(fChildren[index]);
     fMemoryManager->deallocate(fChildren); //delete [] fChildren;
     fMemoryManager->deallocate(fChildOptional); //delete [] fChildOptional;
 }
@@ -176,7 +176,7 @@ inline CMLeaf::CMLeaf( QName* const         element
 inline CMLeaf::~CMLeaf()
 {
     if (fAdopt)
-        delete fElement;
+        deleteOwnedObject(fElement);
 }
 
 
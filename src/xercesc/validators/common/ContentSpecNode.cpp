@@ -54,7 +54,7 @@ ContentSpecNode::ContentSpecNode(const ContentSpecNode& toCopy) :
 {
     const QName* tempElement = toCopy.getElement();
     if (tempElement)
-        fElement = new (fMemoryManager) QName(*tempElement);
+        fElement = new (fMemoryManager) QName(*tempElement, fMemoryManager);
 
     const ContentSpecNode *tmp = toCopy.getFirst();
     if (tmp)
@@ -76,7 +76,7 @@ ContentSpecNode::~ContentSpecNode()
 		deleteChildNode(fSecond);
     }
 
-    delete fElement;
+    deleteOwnedObject(fElement);
 }
 
 void ContentSpecNode::deleteChildNode(ContentSpecNode* node)
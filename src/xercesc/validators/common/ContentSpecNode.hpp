@@ -237,7 +237,7 @@ ContentSpecNode::ContentSpecNode(QName* const element,
     , fMaxOccurs(1)
 {
     if (element)
-        fElement = new (fMemoryManager) QName(*element);
+        fElement = new (fMemoryManager) QName(*element, fMemoryManager);
 }
 
 inline
@@ -256,7 +256,7 @@ ContentSpecNode::ContentSpecNode(XMLElementDecl* const elemDecl,
     , fMaxOccurs(1)
 {
     if (elemDecl)
-        fElement = new (manager) QName(*(elemDecl->getElementName()));
+        fElement = new (manager) QName(*(elemDecl->getElementName()), manager);
 }
 
 inline
@@ -278,7 +278,7 @@ ContentSpecNode::ContentSpecNode( QName* const element
     if (copyQName)
     {
         if (element)
-            fElement = new (fMemoryManager) QName(*element);
+            fElement = new (fMemoryManager) QName(*element, fMemoryManager);
     }
     else
     {
@@ -395,10 +395,10 @@ inline bool ContentSpecNode::isSecondAdopted() const
 // ---------------------------------------------------------------------------
 inline void ContentSpecNode::setElement(QName* const element)
 {
-    delete fElement;
+    deleteOwnedObject(fElement);
     fElement = 0;
     if (element)
-        fElement = new (fMemoryManager) QName(*element);
+        fElement = new (fMemoryManager) QName(*element, fMemoryManager);
 }
 
 inline void ContentSpecNode::setFirst(ContentSpecNode* const toAdopt)
@@ -139,7 +139,7 @@ DFAContentModel::~DFAContentModel()
     }
 
     for (index = 0; index < fLeafCount; index++)
-        delete fElemMap[index];
+        deleteOwnedObject(fElemMap[index]);
     fMemoryManager->deallocate(fElemMap); //delete [] fElemMap;
 
     fMemoryManager->deallocate(fElemMapType); //delete [] fElemMapType;
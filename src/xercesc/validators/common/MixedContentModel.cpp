@@ -80,7 +80,7 @@ MixedContentModel::MixedContentModel(const bool             dtd
         fCount * sizeof(ContentSpecNode::NodeTypes)
     ); //new ContentSpecNode::NodeTypes[fCount];
     for (XMLSize_t index = 0; index < fCount; index++) {
-        fChildren[index] = new (fMemoryManager) QName(*children.elementAt(index));
+        fChildren[index] = new (fMemoryManager) QName(*children.elementAt(index), fMemoryManager);
         fChildTypes[index] = childTypes.elementAt(index);
     }
 }
@@ -88,7 +88,7 @@ MixedContentModel::MixedContentModel(const bool             dtd
 MixedContentModel::~MixedContentModel()
 {
     for (XMLSize_t index = 0; index < fCount; index++) {
-        delete fChildren[index];
+        deleteOwnedObject(fChildren[index]);
     }
     fMemoryManager->deallocate(fChildren); //delete [] fChildren;
     fMemoryManager->deallocate(fChildTypes); //delete [] fChildTypes;
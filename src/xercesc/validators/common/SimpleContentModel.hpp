@@ -168,20 +168,20 @@ inline SimpleContentModel::SimpleContentModel
     , fMemoryManager(manager)
 {
     if (firstChild)
-        fFirstChild = new (manager) QName(*firstChild);
+        fFirstChild = new (manager) QName(*firstChild, manager);
     else
         fFirstChild = new (manager) QName(XMLUni::fgZeroLenString, XMLUni::fgZeroLenString, XMLElementDecl::fgInvalidElemId, manager);
 
     if (secondChild)
-        fSecondChild = new (manager) QName(*secondChild);
+        fSecondChild = new (manager) QName(*secondChild, manager);
     else
         fSecondChild = new (manager) QName(XMLUni::fgZeroLenString, XMLUni::fgZeroLenString, XMLElementDecl::fgInvalidElemId, manager);
 }
 
 inline SimpleContentModel::~SimpleContentModel()
 {
-    delete fFirstChild;
-    delete fSecondChild;
+    deleteOwnedObject(fFirstChild);
+    deleteOwnedObject(fSecondChild);
 }
 
 
@@ -56,7 +56,7 @@ void XMLInitializer::initializeComplexTypeInfo()
 
   ContentSpecNode* term = new ContentSpecNode
     (
-      new QName
+      new (XMLPlatformUtils::fgMemoryManager) QName
       (
         XMLUni::fgZeroLenString
         , XMLUni::fgZeroLenString
@@ -111,7 +111,7 @@ SchemaAttDef::SchemaAttDef(const SchemaAttDef* other) :
 
 SchemaAttDef::~SchemaAttDef()
 {
-   delete fAttName;
+   deleteOwnedObject(fAttName);
    delete fNamespaceList;
 }
 
@@ -73,7 +73,7 @@ SchemaValidator::SchemaValidator( XMLErrorReporter* const errReporter
 
 SchemaValidator::~SchemaValidator()
 {
-    delete fXsiType;
+    deleteOwnedObject(fXsiType);
     delete fTypeStack;
 
     if (fNotationBuf)
@@ -340,7 +340,7 @@ void SchemaValidator::reset()
     fSeenNonWhiteSpace = false;
     fSeenId = false;
 	fTypeStack->removeAllElements();
-    delete fXsiType;
+    deleteOwnedObject(fXsiType);
     fXsiType = 0;
     fCurrentDatatypeValidator = 0;
     fNil = false;
@@ -714,7 +714,7 @@ void SchemaValidator::validateElement(const   XMLElementDecl*  elemDef)
             }
         }
 
-        delete fXsiType;
+        deleteOwnedObject(fXsiType);
         fXsiType = 0;
     }
     else {
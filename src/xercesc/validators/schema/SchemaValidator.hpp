@@ -322,7 +322,7 @@ inline void SchemaValidator::setXsiType(const XMLCh* const        prefix
       , const XMLCh* const        localPart
        , const unsigned int        uriId)
 {
-    delete fXsiType;
+    deleteOwnedObject(fXsiType);
     fXsiType = new (fMemoryManager) QName(prefix, localPart, uriId, fMemoryManager);
 }
 
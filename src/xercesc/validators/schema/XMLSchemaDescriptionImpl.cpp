@@ -63,10 +63,10 @@ XMLSchemaDescriptionImpl::~XMLSchemaDescriptionImpl()
         delete fLocationHints;
 
     if (fTriggeringComponent)
-        delete fTriggeringComponent;
+        deleteOwnedObject(fTriggeringComponent);
 
     if (fEnclosingElementName)
-        delete fEnclosingElementName;
+        deleteOwnedObject(fEnclosingElementName);
 
 }
 
@@ -128,7 +128,7 @@ void XMLSchemaDescriptionImpl::setLocationHints(const XMLCh* const hint)
 void XMLSchemaDescriptionImpl::setTriggeringComponent(QName* const trigComponent)
 { 
     if ( fTriggeringComponent) {
-        delete fTriggeringComponent;
+        deleteOwnedObject(fTriggeringComponent);
         fTriggeringComponent = 0;
     }
     
@@ -139,7 +139,7 @@ void XMLSchemaDescriptionImpl::setTriggeringComponent(QName* const trigComponent
 void XMLSchemaDescriptionImpl::setEnclosingElementName(QName* const encElement)
 { 
     if (fEnclosingElementName) {
-        delete fEnclosingElementName;
+        deleteOwnedObject(fEnclosingElementName);
         fEnclosingElementName = 0; 
     }
 
@@ -62,7 +62,7 @@ public:
     XercesNodeTest(const XMLCh* const prefix, const unsigned int uriId,
                    MemoryManager* const manager = XMLPlatformUtils::fgMemoryManager);
     XercesNodeTest(const XercesNodeTest& other);
-    ~XercesNodeTest() { delete fName; }
+    ~XercesNodeTest() { deleteOwnedObject(fName); }
 
     // -----------------------------------------------------------------------
     //  Operators
@@ -0,0 +1,281 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks the arena memory manager: that it hands out
+//  aligned, distinct memory, that reset() makes the blocks available
+//  again, and that parsing the same kind of document with a parser
+//  created on the arena for each request stops allocating from the
+//  parent memory manager once the first request has been served.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/ArenaMemoryManager.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/EventTestHelpers.hpp"
+
+#include <iostream>
+#include <new>
+#include <string>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  The parent of the arenas under test.  It counts the calls made to it.
+//
+class CountingMemoryManager : public MemoryManager
+{
+public :
+    CountingMemoryManager() : fAllocations(0), fLive(0)
+    {
+    }
+
+    MemoryManager* getExceptionMemoryManager()
+    {
+        return this;
+    }
+
+    void* allocate(XMLSize_t size)
+    {
+        fAllocations++;
+        fLive++;
+        return ::operator new(size);
+    }
+
+    void deallocate(void* p)
+    {
+        if (p)
+        {
+            fLive--;
+            ::operator delete(p);
+        }
+    }
+
+    XMLSize_t   fAllocations;
+    XMLSize_t   fLive;
+};
+
+static const char* gTestDocs[] =
+{
+    // Namespaces, entities and a validated internal subset
+    "<?xml version=\"1.0\"?>\n"
+    "<!DOCTYPE a:root [\n"
+    "  <!ELEMENT a:root (item*)>\n"
+    "  <!ATTLIST a:root xmlns:a CDATA #FIXED \"urn:a\" xmlns CDATA #IMPLIED>\n"
+    "  <!ELEMENT item (#PCDATA|sub)*>\n"
+    "  <!ATTLIST item a:id ID #REQUIRED kind (x|y) \"x\">\n"
+    "  <!ELEMENT sub EMPTY>\n"
+    "  <!ATTLIST sub xmlns:a CDATA #IMPLIED a:x CDATA #IMPLIED>\n"
+    "  <!ENTITY e \"<sub/>&amp;\">\n"
+    "]>\n"
+    "<a:root xmlns:a=\"urn:a\" xmlns=\"urn:d\">\n"
+    "  <item a:id=\"i1\">one&e;</item>\n"
+    "  <item a:id=\"i2\" kind=\"y\"><sub xmlns:a=\"urn:b\" a:x='y'/>two</item>\n"
+    "</a:root>\n"
+
+    // A validity error and a well-formedness error
+    , "<!DOCTYPE r [<!ELEMENT r EMPTY>]><r>text</r>"
+    , "<root><a>x</b></root>"
+};
+
+static const unsigned int gRounds = 4;
+
+static bool check(const bool condition, const char* const message)
+{
+    if (!condition)
+        std::cout << message << std::endl;
+    return condition;
+}
+
+static bool checkBasics()
+{
+    CountingMemoryManager parent;
+    bool ok = true;
+    {
+        ArenaMemoryManager arena(1024, &parent);
+        const XMLSize_t alignment = XMLPlatformUtils::alignPointerForNewBlockAllocation(1);
+
+        char* first = (char*)arena.allocate(3);
+        char* second = (char*)arena.allocate(0);
+        char* third = (char*)arena.allocate(100);
+        ok = check(((XMLSize_t)first % alignment) == 0 && ((XMLSize_t)second % alignment) == 0
+                   && ((XMLSize_t)third % alignment) == 0, "Arena memory is not aligned") && ok;
+        ok = check(second >= first + 3 && third > second, "Arena memory overlaps") && ok;
+
+        // Larger requests get a block of their own
+        char* large = (char*)arena.allocate(4000);
+        large[3999] = 0;
+        ok = check(arena.getUsedSize() >= 4103, "Used size is too small") && ok;
+
+        // Filling more than a block moves on to another one
+        for (unsigned int index = 0; index < 100; index++)
+            arena.deallocate(arena.allocate(100));
+        const XMLSize_t allocations = parent.fAllocations;
+        const XMLSize_t reserved = arena.getReservedSize();
+
+        // After a reset the same requests are served from the same memory
+        arena.reset();
+        ok = check(arena.getUsedSize() == 0, "Used size not cleared by reset") && ok;
+        ok = check(arena.allocate(3) == first, "Blocks were not reused after reset") && ok;
+        arena.allocate(0);
+        arena.allocate(100);
+        ok = check(arena.allocate(4000) == large, "Large block was not reused after reset") && ok;
+        for (unsigned int index = 0; index < 100; index++)
+            arena.allocate(100);
+        ok = check(parent.fAllocations == allocations && arena.getReservedSize() == reserved,
+                   "Repeated requests allocated from the parent") && ok;
+
+        arena.release();
+        ok = check(arena.getReservedSize() == 0 && parent.fLive == 0, "Release kept blocks") && ok;
+
+        arena.allocate(10);
+    }
+    ok = check(parent.fLive == 0, "Arena leaked blocks") && ok;
+    return ok;
+}
+
+static std::string parseSAX(MemoryManager* const manager, const std::string& doc)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader(manager);
+    parser->setFeature(XMLUni::fgSAX2CoreValidation, true);
+    parser->setFeature(XMLUni::fgXercesDynamic, true);
+
+    RecordHandler handler;
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "", false, manager);
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        handler.fEvents += "!X";
+    }
+
+    delete parser;
+    return handler.fEvents;
+}
+
+static bool checkSAX(const char* const label, const std::string& doc)
+{
+    const std::string expected = parseSAX(XMLPlatformUtils::fgMemoryManager, doc);
+
+    CountingMemoryManager parent;
+    bool ok = true;
+    {
+        ArenaMemoryManager arena(16 * 1024, &parent);
+        XMLSize_t allocations = 0;
+        for (unsigned int round = 0; round < gRounds; round++)
+        {
+            if (parseSAX(&arena, doc) != expected)
+            {
+                std::cout << "Different events on the arena in round " << round << ": " << label << std::endl;
+                ok = false;
+            }
+            if (round > 0 && parent.fAllocations != allocations)
+            {
+                std::cout << "SAX parse allocated from the parent in round " << round << ": " << label << std::endl;
+                ok = false;
+            }
+            allocations = parent.fAllocations;
+            arena.reset();
+        }
+    }
+    return check(parent.fLive == 0, "Arena leaked blocks") && ok;
+}
+
+static bool checkDOM()
+{
+    const std::string doc = gTestDocs[0];
+
+    CountingMemoryManager parent;
+    bool ok = true;
+    {
+        ArenaMemoryManager arena(64 * 1024, &parent);
+        XMLSize_t allocations = 0;
+        for (unsigned int round = 0; round < gRounds; round++)
+        {
+            XercesDOMParser* parser = new XercesDOMParser(0, &arena);
+            parser->setDoNamespaces(true);
+            parser->setValidationScheme(XercesDOMParser::Val_Auto);
+
+            MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "", false, &arena);
+            parser->parse(src);
+
+            const DOMElement* root = parser->getDocument()->getDocumentElement();
+            if (parser->getErrorCount() != 0 || !root || root->getChildElementCount() != 2)
+            {
+                std::cout << "Wrong DOM tree on the arena in round " << round << std::endl;
+                ok = false;
+            }
+
+            delete parser;
+            if (round > 0 && parent.fAllocations != allocations)
+            {
+                std::cout << "DOM parse allocated from the parent in round " << round << std::endl;
+                ok = false;
+            }
+            allocations = parent.fAllocations;
+            arena.reset();
+        }
+    }
+    return check(parent.fLive == 0, "Arena leaked blocks") && ok;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = checkBasics();
+    ok = checkSAX("valid", gTestDocs[0]) && ok;
+    ok = checkSAX("invalid", gTestDocs[1]) && ok;
+    ok = checkSAX("malformed", gTestDocs[2]) && ok;
+    ok = checkDOM() && ok;
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All arena memory tests passed" << std::endl;
+    return 0;
+}
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <xercesc/dom/DOM.hpp>
+#include <xercesc/dom/DOMMemoryManager.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/XMLException.hpp>
 #include <xercesc/util/XMLString.hpp>
@@ -1452,6 +1453,65 @@ void DOMReleaseTests()
         text->setNodeValue(X(tempchar));
     }
 
+    //keep replacing the text of an element, releasing the old text node,
+    //   and the value of an attribute with strings of changing length; once
+    //   every size has been seen the document should not need any more memory
+    DOMMemoryManager* docMemMgr = (DOMMemoryManager*)cpXMLDocument->getFeature(XMLUni::fgXercescInterfaceDOMMemoryManager, 0);
+    DOMElement* cpUpdated = cpXMLDocument->createElement(tempStr3);
+    cpRoot->appendChild(cpUpdated);
+    cpUpdated->appendChild(cpXMLDocument->createTextNode(tempStr3));
+    XMLSize_t heapSize = 0;
+    for(i=0;i<4000;i++)
+    {
+        if (i == 2000)
+            heapSize = docMemMgr->getHeapSize();
+        XMLSize_t len = 1 + (i * 7) % 300, j;
+        for (j = 0; j < len; j++)
+            tempchar[j] = (char)('a' + (i + j) % 26);
+        tempchar[j]=0;
+        XMLString::transcode(tempchar, tempStr2, 3999);
+        DOMNode* oldText = cpUpdated->replaceChild(cpXMLDocument->createTextNode(tempStr2), cpUpdated->getFirstChild());
+        oldText->release();
+        cpUpdated->setAttribute(tempStr, tempStr2 + len / 2);
+    }
+    TASSERT(XMLString::equals(cpUpdated->getTextContent(), tempStr2));
+    TASSERT(docMemMgr->getHeapSize() == heapSize);
+    TASSERT(docMemMgr->getLiveSize() + docMemMgr->getWastedSize() <= docMemMgr->getHeapSize());
+
+    //grow an attribute list and the ID map well past the size where the
+    //   storage they outgrow is released back
+    DOMElement* cpMany = cpXMLDocument->createElement(tempStr3);
+    cpRoot->appendChild(cpMany);
+    for(i=0;i<2000;i++)
+    {
+        sprintf(tempchar, "a%d", i);
+        XMLString::transcode(tempchar, tempStr, 3999);
+        cpMany->setAttribute(tempStr, tempStr);
+        cpMany->setIdAttribute(tempStr, true);
+    }
+    for(i=0;i<2000;i++)
+    {
+        sprintf(tempchar, "a%d", i);
+        XMLString::transcode(tempchar, tempStr, 3999);
+        TASSERT(cpXMLDocument->getElementById(tempStr) == cpMany);
+        TASSERT(XMLString::equals(cpMany->getAttribute(tempStr), tempStr));
+    }
+
+    //a block released with the wrong size stays in use, one released with
+    //   the size it was allocated with is given back
+    XMLSize_t blockSizes[] = { 64, 1000 };
+    for(i=0;i<2;i++)
+    {
+        XMLSize_t liveSize = docMemMgr->getLiveSize();
+        void* block = docMemMgr->allocate(blockSizes[i]);
+        XMLSize_t blockLiveSize = docMemMgr->getLiveSize();
+        docMemMgr->release(block, blockSizes[i] * 2);
+        docMemMgr->release(block, blockSizes[i] / 2);
+        TASSERT(docMemMgr->getLiveSize() == blockLiveSize);
+        docMemMgr->release(block, blockSizes[i]);
+        TASSERT(docMemMgr->getLiveSize() == liveSize);
+    }
+
     cpXMLDocument->release();
 
 }
@@ -0,0 +1,286 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that BinDecompressInputStream hands out
+//  the decompressed bytes of gzip data, including data made of several
+//  members, whatever the sizes of the reads, that it passes data which
+//  isn't compressed through unchanged, that it reports data which is
+//  cut short or corrupt, and that parsing through it gives the same
+//  result as parsing the uncompressed document.
+//
+//  The gzip data is built here from stored (uncompressed) deflate
+//  blocks, so that the test doesn't need a compressor.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/BinDecompressInputStream.hpp>
+#include <xercesc/util/IOException.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/StreamTestHelpers.hpp"
+
+#include <iostream>
+#include <string>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+class CompressedInputSource : public InputSource
+{
+public :
+    CompressedInputSource(const std::string& data) :
+        fData(data)
+    {
+    }
+
+    virtual BinInputStream* makeStream() const
+    {
+        return new BinDecompressInputStream(new TrickleInputStream(fData, 1000));
+    }
+
+private :
+    const std::string   fData;
+};
+
+static void appendLE32(std::string& out, const unsigned long value)
+{
+    for (unsigned int index = 0; index < 4; index++)
+        out += char((value >> (index * 8)) & 0xFF);
+}
+
+static unsigned long crc32(const std::string& data)
+{
+    unsigned long crc = 0xFFFFFFFFUL;
+    for (XMLSize_t index = 0; index < data.size(); index++)
+    {
+        crc ^= (unsigned char)data[index];
+        for (unsigned int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+    }
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+//
+//  Builds a gzip member holding the data in stored deflate blocks of at
+//  most blockSize bytes.
+//
+static std::string makeGzip(const std::string& data, const XMLSize_t blockSize)
+{
+    static const char header[] = { 0x1F, char(0x8B), 8, 0, 0, 0, 0, 0, 0, char(0xFF) };
+    std::string out(header, sizeof(header));
+
+    XMLSize_t pos = 0;
+    do
+    {
+        XMLSize_t length = data.size() - pos;
+        if (length > blockSize)
+            length = blockSize;
+        const bool last = (pos + length == data.size());
+
+        out += char(last ? 1 : 0);
+        out += char(length & 0xFF);
+        out += char(length >> 8);
+        out += char(~length & 0xFF);
+        out += char((~length >> 8) & 0xFF);
+        out.append(data, pos, length);
+        pos += length;
+    } while (pos < data.size());
+
+    appendLE32(out, crc32(data));
+    appendLE32(out, (unsigned long)data.size());
+    return out;
+}
+
+static const XMLCh gSystemId[] =
+{
+    chLatin_d, chLatin_a, chLatin_t, chLatin_a, chPeriod, chLatin_g, chLatin_z, chNull
+};
+
+//
+//  Reads the stream to the end. Returns false if it threw, in which case
+//  the exception's message is left in errorText.
+//
+static bool readAll(const std::string& src, const XMLSize_t chunkSize,
+                    const XMLSize_t readSize, std::string& result,
+                    XMLCh** const errorText = 0)
+{
+    BinDecompressInputStream stream(new TrickleInputStream(src, chunkSize), gSystemId);
+
+    result.clear();
+    XMLByte buffer[4096];
+    try
+    {
+        while (true)
+        {
+            const XMLSize_t bytesRead = stream.readBytes(buffer, readSize);
+            if (!bytesRead)
+                break;
+            result.append((const char*)buffer, bytesRead);
+            if (stream.curPos() != result.size())
+                return false;
+        }
+    }
+    catch (const IOException& toCatch)
+    {
+        if (errorText)
+            *errorText = XMLString::replicate(toCatch.getMessage());
+        return false;
+    }
+    return true;
+}
+
+static bool checkRead(const char* const label, const std::string& src, const std::string& expected,
+                      const XMLSize_t chunkSize, const XMLSize_t readSize)
+{
+    std::string result;
+    if (!readAll(src, chunkSize, readSize, result) || (result != expected))
+    {
+        std::cout << "Wrong data read: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkFails(const char* const label, const std::string& src)
+{
+    std::string result;
+    XMLCh* errorText = 0;
+    if (readAll(src, 100, 4096, result, &errorText))
+    {
+        std::cout << "Bad data was not reported: " << label << std::endl;
+        return false;
+    }
+
+    // The error should name the data that couldn't be read
+    const bool named = (XMLString::patternMatch(errorText, gSystemId) != -1);
+    XMLString::release(&errorText);
+    if (!named)
+    {
+        std::cout << "Error does not name the data: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool parse(InputSource& src, CountHandler& handler)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        delete parser;
+        return false;
+    }
+    delete parser;
+    return true;
+}
+
+static bool checkParse(const std::string& doc, const std::string& compressed)
+{
+    CountHandler plainCounts;
+    CountHandler compressedCounts;
+    CompressedInputSource plainSrc(doc);
+    CompressedInputSource compressedSrc(compressed);
+
+    if (!parse(plainSrc, plainCounts) || !parse(compressedSrc, compressedCounts))
+    {
+        std::cout << "Parse failed" << std::endl;
+        return false;
+    }
+
+    if (!plainCounts.sameCounts(compressedCounts) || plainCounts.fErrors)
+    {
+        std::cout << "Different results when decompressing" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool runGzipTests(const std::string& doc)
+{
+    bool ok = true;
+    const std::string gzip = makeGzip(doc, 30000);
+
+    ok = checkRead("one read", gzip, doc, 1024 * 1024, 4096) && ok;
+    ok = checkRead("small chunks", gzip, doc, 7, 4096) && ok;
+    ok = checkRead("small reads", gzip, doc, 4096, 5) && ok;
+    ok = checkRead("empty", makeGzip(std::string(), 100), std::string(), 100, 4096) && ok;
+
+    const std::string half = doc.substr(0, doc.size() / 2);
+    const std::string members = makeGzip(half, 1000) + makeGzip(doc.substr(half.size()), 1000);
+    ok = checkRead("members", members, doc, 333, 4096) && ok;
+    ok = checkRead("padding", gzip + std::string(512, '\0'), doc, 100, 4096) && ok;
+
+    ok = checkFails("truncated", gzip.substr(0, gzip.size() / 2)) && ok;
+    ok = checkFails("truncated trailer", gzip.substr(0, gzip.size() - 3)) && ok;
+
+    std::string corrupt = gzip;
+    corrupt[corrupt.size() - 6] ^= 0x55;
+    ok = checkFails("bad checksum", corrupt) && ok;
+
+    ok = checkParse(doc, gzip) && ok;
+    return ok;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        const std::string doc = makeDocument(1000);
+        ok = checkRead("not compressed", doc, doc, 100, 4096) && ok;
+        ok = checkRead("short", "<a", "<a", 1, 4096) && ok;
+        ok = checkRead("nothing", std::string(), std::string(), 1, 4096) && ok;
+
+        // Without gzip support, gzip data must be refused rather than passed on
+        if (BinDecompressInputStream::isSupported(BinDecompressInputStream::Format_Gzip))
+            ok = runGzipTests(doc) && ok;
+        else
+            ok = checkFails("unsupported", makeGzip(doc, 30000)) && ok;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All decompression tests passed" << std::endl;
+    return 0;
+}
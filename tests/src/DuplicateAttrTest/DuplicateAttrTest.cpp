@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks the errors that each of the scanners
+//  reports for attributes given more than once in a start tag, with
+//  few attributes and with enough of them that the scanners switch to
+//  a hash table. An attribute given n times is reported once for each
+//  repeat, rather than once for each pair; with namespaces the qualified
+//  name and then the namespace and local name are checked, so a repeated
+//  name is reported by both checks. Distinct names that share a local
+//  name are only duplicates if their prefixes map to the same namespace.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  Counts the errors of each kind.
+//
+class ErrorCountHandler : public DefaultHandler
+{
+public :
+    ErrorCountHandler() :
+        fErrors(0)
+        , fFatalErrors(0)
+    {
+    }
+
+    void error(const SAXParseException&)
+    {
+        fErrors++;
+    }
+
+    void fatalError(const SAXParseException&)
+    {
+        fFatalErrors++;
+    }
+
+    unsigned int    fErrors;
+    unsigned int    fFatalErrors;
+};
+
+//
+//  Makes an element with filler attributes f0, f1, ... and then the
+//  given attributes.
+//
+static std::string makeDocument(const unsigned int fillerCount, const char* const atts)
+{
+    std::string doc = "<root xmlns:p='urn:a' xmlns:q='urn:a' xmlns:r='urn:b'";
+    for (unsigned int index = 0; index < fillerCount; index++)
+    {
+        char att[32];
+        sprintf(att, " f%u='x'", index);
+        doc += att;
+    }
+    doc += " ";
+    doc += atts;
+    doc += "/>";
+    return doc;
+}
+
+static unsigned int countErrors(const std::string& doc, const XMLCh* const scanner,
+                                const bool namespaces)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    parser->setProperty(XMLUni::fgXercesScannerName, const_cast<XMLCh*>(scanner));
+    parser->setFeature(XMLUni::fgSAX2CoreNameSpaces, namespaces);
+    parser->setFeature(XMLUni::fgXercesContinueAfterFatalError, true);
+
+    ErrorCountHandler handler;
+    parser->setErrorHandler(&handler);
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "dupatt", false);
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        handler.fFatalErrors += 1000;
+    }
+    delete parser;
+    return handler.fErrors + handler.fFatalErrors;
+}
+
+static bool check(const char* const atts, const bool namespaces, const unsigned int expected)
+{
+    static const XMLCh* const scanners[] =
+    {
+        XMLUni::fgWFXMLScanner
+        , XMLUni::fgIGXMLScanner
+        , XMLUni::fgDGXMLScanner
+    };
+    static const unsigned int fillerCounts[] = { 0, 200 };
+
+    bool ok = true;
+    for (unsigned int scanIndex = 0; scanIndex < sizeof(scanners) / sizeof(scanners[0]); scanIndex++)
+    {
+        // The DG scanner doesn't do namespaces
+        if (namespaces && (scanners[scanIndex] == XMLUni::fgDGXMLScanner))
+            continue;
+
+        for (unsigned int fillIndex = 0; fillIndex < sizeof(fillerCounts) / sizeof(fillerCounts[0]); fillIndex++)
+        {
+            const std::string doc = makeDocument(fillerCounts[fillIndex], atts);
+            const unsigned int found = countErrors(doc, scanners[scanIndex], namespaces);
+            if (found != expected)
+            {
+                char* name = XMLString::transcode(scanners[scanIndex]);
+                std::cout << "Wrong error count for \"" << atts << "\" with " << name
+                          << (namespaces ? ", namespaces" : "")
+                          << " and " << fillerCounts[fillIndex] << " other attributes: "
+                          << found << " instead of " << expected << std::endl;
+                XMLString::release(&name);
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cout << "Error during initialization: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    for (int index = 0; index < 2; index++)
+    {
+        const bool namespaces = (index == 1);
+        ok = check("a='1' b='2'", namespaces, 0) && ok;
+        ok = check("a='1' a='2'", namespaces, namespaces ? 2 : 1) && ok;
+        ok = check("a='1' b='2' a='3' a='4'", namespaces, namespaces ? 4 : 2) && ok;
+    }
+    ok = check("p:a='1' r:a='2'", true, 0) && ok;
+    ok = check("p:a='1' q:a='2'", true, 1) && ok;
+    ok = check("p:a='1' q:a='2' p:a='3'", true, 3) && ok;
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "All duplicate attribute tests passed" << std::endl;
+    return 0;
+}
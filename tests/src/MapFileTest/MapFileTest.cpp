@@ -0,0 +1,221 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program parses local files with and without
+//  LocalFileInputSource::setMapFile(), and checks that mapping the
+//  file makes no difference to what is reported: for a UTF-8 document
+//  larger than the reader's buffer, a UTF-16 document in the native
+//  byte order (which is scanned straight from the mapping), a document
+//  that ends in the middle of a character, and an empty file, which
+//  can't be mapped and is read as usual.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/BinFileInputStream.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  Counts the elements, characters and errors reported.
+//
+class CountHandler : public DefaultHandler
+{
+public :
+    CountHandler() :
+        fElements(0)
+        , fChars(0)
+        , fFatalErrors(0)
+    {
+    }
+
+    void startElement(const XMLCh* const, const XMLCh* const, const XMLCh* const, const Attributes&)
+    {
+        fElements++;
+    }
+
+    void characters(const XMLCh* const, const XMLSize_t length)
+    {
+        fChars += length;
+    }
+
+    void fatalError(const SAXParseException&)
+    {
+        fFatalErrors++;
+    }
+
+    XMLSize_t       fElements;
+    XMLSize_t       fChars;
+    unsigned int    fFatalErrors;
+};
+
+static bool writeFile(const char* const name, const std::string& content)
+{
+    FILE* file = fopen(name, "wb");
+    if (!file)
+        return false;
+    const bool ok = (fwrite(content.data(), 1, content.size(), file) == content.size());
+    return (fclose(file) == 0) && ok;
+}
+
+static void parseFile(const char* const name, const bool mapFile, CountHandler& handler)
+{
+    XMLCh* path = XMLString::transcode(name);
+    LocalFileInputSource src(path);
+    XMLString::release(&path);
+    src.setMapFile(mapFile);
+
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        handler.fFatalErrors++;
+    }
+    delete parser;
+}
+
+static bool isMapped(const char* const name)
+{
+    XMLCh* path = XMLString::transcode(name);
+    LocalFileInputSource src(path);
+    XMLString::release(&path);
+    src.setMapFile(true);
+
+    BinFileInputStream* stream = (BinFileInputStream*)src.makeStream();
+    const bool mapped = stream && stream->getIsMapped();
+    delete stream;
+    return mapped;
+}
+
+static bool check(const char* const name, const std::string& content,
+                  const bool expectMapped, const bool expectErrors)
+{
+    if (!writeFile(name, content))
+    {
+        std::cout << "Could not write " << name << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    CountHandler read;
+    CountHandler mapped;
+    parseFile(name, false, read);
+    parseFile(name, true, mapped);
+
+    if (isMapped(name) != expectMapped)
+    {
+        std::cout << name << " is " << (expectMapped ? "not " : "") << "mapped" << std::endl;
+        ok = false;
+    }
+    if (mapped.fElements != read.fElements || mapped.fChars != read.fChars
+    ||  mapped.fFatalErrors != read.fFatalErrors)
+    {
+        std::cout << name << " mapped: " << mapped.fElements << " elements, " << mapped.fChars
+                  << " characters, " << mapped.fFatalErrors << " errors; read: "
+                  << read.fElements << " elements, " << read.fChars << " characters, "
+                  << read.fFatalErrors << " errors" << std::endl;
+        ok = false;
+    }
+    if ((read.fFatalErrors != 0) != expectErrors)
+    {
+        std::cout << name << ": " << read.fFatalErrors << " errors" << std::endl;
+        ok = false;
+    }
+
+    remove(name);
+    return ok;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cout << "Error during initialization: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    // A UTF-8 document that is several times the size of the reader buffer
+    std::string utf8 = "<?xml version='1.0' encoding='UTF-8'?>\n<root>";
+    for (unsigned int index = 0; index < 20000; index++)
+    {
+        char item[64];
+        sprintf(item, "<item n='%u'>caf\xC3\xA9 \xE2\x82\xAC%u</item>\n", index, index);
+        utf8 += item;
+    }
+    utf8 += "</root>";
+
+    // The same markup as UTF-16 in the byte order of this machine
+    std::string utf16;
+    {
+        const char* const text = "<root><a>some text</a><b/><c>more text</c></root>";
+        const XMLCh bom = 0xFEFF;
+        utf16.append((const char*)&bom, sizeof(bom));
+        for (const char* cur = text; *cur; cur++)
+        {
+            const XMLCh ch = (XMLCh)*cur;
+            utf16.append((const char*)&ch, sizeof(ch));
+        }
+    }
+
+    bool ok = true;
+    try
+    {
+        ok = check("MapFileTest-utf8.xml", utf8, true, false) && ok;
+        ok = check("MapFileTest-utf16.xml", utf16, true, false) && ok;
+        ok = check("MapFileTest-truncated.xml", "<r>x</r>\xE2\x82", true, true) && ok;
+        ok = check("MapFileTest-empty.xml", "", false, true) && ok;
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cout << "Error during parsing: " << msg << std::endl;
+        XMLString::release(&msg);
+        ok = false;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "All mapped file tests passed" << std::endl;
+    return 0;
+}
@@ -35,6 +35,7 @@
 #include <xercesc/util/XercesDefs.hpp>
 #include <xercesc/util/OutOfMemoryException.hpp>
 #include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/QName.hpp>
 
 MemoryManager* MemoryMonitor::getExceptionMemoryManager()
 {
@@ -72,6 +73,36 @@ unsigned int MemoryMonitor::getTotalMemory()
     return total;
 }
 
+unsigned int MemoryMonitor::getBlockSize(void* p)
+{
+    return fHashTable->containsKey(p) ? fHashTable->get(p) : 0;
+}
+
+//
+//  QName objects are allocated without the memory manager header in builds
+//  with XERCES_HEADERLESS_OBJECTS, and with it otherwise. Checks that one
+//  takes exactly the memory it should.
+//
+static bool checkObjectHeaders(MemoryMonitor* const memMonitor)
+{
+#if defined(XERCES_HEADERLESS_OBJECTS)
+    const XMLSize_t headerSize = 0;
+#else
+    const XMLSize_t headerSize = XMLPlatformUtils::alignPointerForNewBlockAllocation(sizeof(MemoryManager*));
+#endif
+    bool ok = true;
+
+    QName* qName = new (memMonitor) QName(XMLUni::fgXMLNSString, XMLUni::fgXercesSchema, 1, memMonitor);
+    if (memMonitor->getBlockSize((char*)qName - headerSize) != sizeof(QName) + headerSize)
+    {
+        XERCES_STD_QUALIFIER cout << "QName does not take " << sizeof(QName) + headerSize << " bytes." << XERCES_STD_QUALIFIER endl;
+        ok = false;
+    }
+    deleteOwnedObject(qName);
+
+    return ok;
+}
+
 static void usage()
 {
     XERCES_STD_QUALIFIER cout << "\nUsage:\n"
@@ -259,6 +290,9 @@ int main (int argC,  char *argV[])
         return 1;
     }
 
+    if (!checkObjectHeaders(staticMemMonitor))
+        return 4;
+
     // Instantiate the DOM domBuilder with its memory manager.
     MemoryMonitor *domBuilderMemMonitor = new MemoryMonitor();
     static const XMLCh gLS[] = { chLatin_L, chLatin_S, chNull };
@@ -102,6 +102,9 @@ public:
     // Print out amount of currently allocated memory
     unsigned int getTotalMemory();
 
+    // Size of the block allocated at p, or 0 if there is none
+    unsigned int getBlockSize(void* p);
+
 private:
     // -----------------------------------------------------------------------
     //  Unimplemented constructors and operators
@@ -0,0 +1,468 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that SAX2ParallelParser reports the same
+//  events, at the same locations, and the same errors as SAX2XMLReader,
+//  whether the document is split into chunks or it has to fall back to
+//  parsing on one thread, and with several numbers of threads.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/parsers/SAX2ParallelParser.hpp>
+#include <xercesc/sax/Locator.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/EventTestHelpers.hpp"
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  Writes down the SAX2 events with their locations. The characters can
+//  be reported in different pieces, so they are joined up, and written
+//  down without a location.
+//
+class LocationHandler : public DefaultHandler
+{
+public :
+    LocationHandler() :
+        fLocator(0)
+    {
+    }
+
+    void setDocumentLocator(const Locator* const locator)
+    {
+        fLocator = locator;
+    }
+
+    void startDocument()
+    {
+        appendEvent("startDocument");
+    }
+
+    void endDocument()
+    {
+        appendEvent("endDocument");
+    }
+
+    void startElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname, const Attributes& attrs)
+    {
+        appendEvent("<");
+        appendString(fEvents, qname);
+        fEvents += " {";
+        appendString(fEvents, uri);
+        fEvents += "}";
+        appendString(fEvents, localname);
+        for (XMLSize_t index = 0; index < attrs.getLength(); index++)
+        {
+            fEvents += " ";
+            appendString(fEvents, attrs.getQName(index));
+            fEvents += "{";
+            appendString(fEvents, attrs.getURI(index));
+            fEvents += "}";
+            appendString(fEvents, attrs.getType(index));
+            fEvents += "=";
+            appendString(fEvents, attrs.getValue(index));
+        }
+
+        // Look the last attribute up by name as well
+        if (attrs.getLength())
+        {
+            const XMLSize_t last = attrs.getLength() - 1;
+            if ((attrs.getIndex(attrs.getQName(last)) != (int)last)
+            ||  (attrs.getValue(attrs.getURI(last), attrs.getLocalName(last)) != attrs.getValue(last)))
+            {
+                fEvents += " lookup failed";
+            }
+        }
+    }
+
+    void endElement(const XMLCh* const, const XMLCh* const, const XMLCh* const qname)
+    {
+        appendEvent("</");
+        appendString(fEvents, qname);
+    }
+
+    void characters(const XMLCh* const chars, const XMLSize_t length)
+    {
+        appendText(chars, length);
+    }
+
+    void ignorableWhitespace(const XMLCh* const chars, const XMLSize_t length)
+    {
+        appendText(chars, length);
+    }
+
+    void processingInstruction(const XMLCh* const target, const XMLCh* const data)
+    {
+        appendEvent("<?");
+        appendString(fEvents, target);
+        fEvents += " ";
+        appendString(fEvents, data);
+    }
+
+    void startPrefixMapping(const XMLCh* const prefix, const XMLCh* const uri)
+    {
+        appendEvent("xmlns:");
+        appendString(fEvents, prefix);
+        fEvents += "=";
+        appendString(fEvents, uri);
+    }
+
+    void endPrefixMapping(const XMLCh* const prefix)
+    {
+        appendEvent("/xmlns:");
+        appendString(fEvents, prefix);
+    }
+
+    void comment(const XMLCh* const chars, const XMLSize_t length)
+    {
+        appendEvent("<!--");
+        appendText(chars, length);
+        flushText();
+    }
+
+    void startCDATA()
+    {
+        appendEvent("<![CDATA[");
+    }
+
+    void endCDATA()
+    {
+        appendEvent("]]>");
+    }
+
+    void startDTD(const XMLCh* const name, const XMLCh* const, const XMLCh* const)
+    {
+        appendEvent("<!DOCTYPE ");
+        appendString(fEvents, name);
+    }
+
+    void endDTD()
+    {
+        appendEvent("]>");
+    }
+
+    void startEntity(const XMLCh* const name)
+    {
+        appendEvent("&");
+        appendString(fEvents, name);
+    }
+
+    void endEntity(const XMLCh* const name)
+    {
+        appendEvent("/&");
+        appendString(fEvents, name);
+    }
+
+    void warning(const SAXParseException& e)
+    {
+        appendError("!W", e);
+    }
+
+    void error(const SAXParseException& e)
+    {
+        appendError("!E", e);
+    }
+
+    void fatalError(const SAXParseException& e)
+    {
+        appendError("!F", e);
+    }
+
+    void appendError(const char* const kind, const SAXParseException& e)
+    {
+        char location[64];
+        sprintf(location, "%u:%u", (unsigned int)e.getLineNumber(), (unsigned int)e.getColumnNumber());
+        flushText();
+        fEvents += kind;
+        fEvents += location;
+        fEvents += " ";
+        appendString(fEvents, e.getMessage());
+        fEvents += "\n";
+    }
+
+    std::string getEvents()
+    {
+        flushText();
+        return fEvents;
+    }
+
+private :
+    void appendEvent(const char* const name)
+    {
+        flushText();
+        char location[64];
+        if (fLocator)
+            sprintf(location, "%u:%u ", (unsigned int)fLocator->getLineNumber(), (unsigned int)fLocator->getColumnNumber());
+        else
+            strcpy(location, "?:? ");
+        fEvents += "\n";
+        fEvents += location;
+        fEvents += name;
+    }
+
+    void appendText(const XMLCh* const chars, const XMLSize_t length)
+    {
+        for (XMLSize_t index = 0; index < length; index++)
+        {
+            char hex[8];
+            if ((chars[index] >= 0x20) && (chars[index] < 0x7F))
+                fText += (char)chars[index];
+            else
+            {
+                sprintf(hex, "#%X;", (unsigned int)chars[index]);
+                fText += hex;
+            }
+        }
+    }
+
+    void flushText()
+    {
+        if (!fText.empty())
+        {
+            fEvents += "\n  \"" + fText + "\"";
+            fText.clear();
+        }
+    }
+
+    const Locator*  fLocator;
+    std::string     fEvents;
+    std::string     fText;
+};
+
+static std::string makeRecords(const unsigned int count)
+{
+    std::string records;
+    for (unsigned int index = 0; index < count; index++)
+    {
+        char record[512];
+        sprintf
+        (
+            record
+            , "  <rec id='%u' a:n=\"%u\">\r\n"
+              "    <name>caf\xC3\xA9 \xF0\x9F\x98\x80 &amp; &e;</name><!-- c%u --><?pi %u?>"
+              "<![CDATA[<re> & ]]><p:x xmlns:p='urn:p%u'/>\n"
+              "  </rec>\n"
+            , index, index, index, index, index % 3
+        );
+        records += record;
+    }
+    return records;
+}
+
+static const char* gProlog =
+    "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<!-- before -->\n"
+    "<!DOCTYPE root [\n"
+    "  <!ENTITY e \"<ent a='1'>]></ent>\">\n"
+    "  <!ATTLIST rec id ID #IMPLIED>\n"
+    "  <?dtd pi?><!-- ]> -->\n"
+    "]>\n"
+    "<?before pi?>\n"
+    "<root xmlns='urn:root' xmlns:a=\"urn:a\" note='x > y'>\n";
+
+static const char* gEpilog =
+    "</root  >\n"
+    "<!-- after -->\r\n"
+    "<?after pi?>  \n";
+
+static void parseSerial(const std::string& doc, const bool useErrorHandler, std::string& events)
+{
+    SAX2XMLReader* reader = XMLReaderFactory::createXMLReader();
+    reader->setFeature(XMLUni::fgSAX2CoreValidation, false);
+
+    LocationHandler handler;
+    reader->setContentHandler(&handler);
+    reader->setLexicalHandler(&handler);
+    if (useErrorHandler)
+        reader->setErrorHandler(&handler);
+    try
+    {
+        MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "test");
+        reader->parse(src);
+    }
+    catch (const SAXParseException& e)
+    {
+        handler.appendError("!T", e);
+    }
+    catch (const XMLException&)
+    {
+        handler.appendError("!X", SAXParseException(XMLUni::fgZeroLenString, 0, 0, 0, 0));
+    }
+    delete reader;
+
+    events = handler.getEvents();
+}
+
+static void parseParallel(const std::string& doc, const bool useErrorHandler, const unsigned int threadCount, const XMLSize_t chunkSize, std::string& events, bool& inParallel)
+{
+    SAX2ParallelParser parser;
+    parser.setThreadCount(threadCount);
+    parser.setChunkSize(chunkSize);
+
+    LocationHandler handler;
+    parser.setContentHandler(&handler);
+    parser.setLexicalHandler(&handler);
+    if (useErrorHandler)
+        parser.setErrorHandler(&handler);
+    try
+    {
+        MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "test");
+        parser.parse(src);
+    }
+    catch (const SAXParseException& e)
+    {
+        handler.appendError("!T", e);
+    }
+    catch (const XMLException&)
+    {
+        handler.appendError("!X", SAXParseException(XMLUni::fgZeroLenString, 0, 0, 0, 0));
+    }
+
+    events = handler.getEvents();
+    inParallel = parser.getParsedInParallel();
+}
+
+//
+//  Whether a document is expected to be parsed in parallel. A document in
+//  which speculation fails may get split in the right places anyway if the
+//  chunks are large, but not if every record starts a chunk.
+//
+enum Expectations
+{
+    Expect_Parallel
+    , Expect_Serial
+    , Expect_SerialWhenSmall
+};
+
+static bool gCanSplit = true;
+
+//
+//  Parses the document both ways, with and without an error handler, and
+//  checks whether it was split all the way through as expected.
+//
+static bool check(const char* const label, const std::string& doc, const Expectations expectation)
+{
+    const unsigned int threadCounts[] = { 1, 4, 2 };
+    const XMLSize_t chunkSizes[] = { 1, 300, 2000 };
+
+    for (unsigned int useErrorHandler = 0; useErrorHandler < 2; useErrorHandler++)
+    {
+        std::string expected;
+        parseSerial(doc, useErrorHandler != 0, expected);
+
+        for (unsigned int index = 0; index < sizeof(threadCounts) / sizeof(threadCounts[0]); index++)
+        {
+            std::string events;
+            bool inParallel;
+            parseParallel(doc, useErrorHandler != 0, threadCounts[index], chunkSizes[index], events, inParallel);
+            if (events != expected)
+            {
+                std::cout << "Different events: " << label << ", " << threadCounts[index] << " threads"
+                          << (useErrorHandler ? "" : ", no error handler") << std::endl
+                          << "serial:" << expected << std::endl
+                          << "parallel:" << events << std::endl;
+                return false;
+            }
+
+            bool expectParallel = gCanSplit && (expectation == Expect_Parallel);
+            if ((expectation == Expect_SerialWhenSmall) && (chunkSizes[index] > 1))
+                expectParallel = inParallel;
+            if (inParallel != expectParallel)
+            {
+                std::cout << label << " was " << (inParallel ? "" : "not ") << "parsed in parallel"
+                          << " in chunks of " << (unsigned int)chunkSizes[index] << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        const std::string records = makeRecords(40);
+        const std::string plain = std::string(gProlog) + records + gEpilog;
+
+        //
+        //  Without thread support, nothing is ever done in parallel. The
+        //  other documents are checked against this one.
+        //
+        std::string events;
+        parseParallel(plain, true, 2, 300, events, gCanSplit);
+        ok = check("plain", plain, Expect_Parallel) && ok;
+
+        // Text before the first record, and an error after the root
+        ok = check("leading text", std::string(gProlog) + "text<!-- c -->" + records + "</root>\n\n<?xml version='1.0'?>", Expect_Parallel) && ok;
+
+        // Documents which are not split
+        ok = check("UTF-16", "<?xml version='1.0' encoding='UTF-16'?><root><rec/><rec/></root>", Expect_Serial) && ok;
+        ok = check("junk after root", std::string(gProlog) + records + "</root><junk/>", Expect_Serial) && ok;
+        ok = check("no records", std::string(gProlog) + "text only" + gEpilog, Expect_Serial) && ok;
+
+        //
+        //  A nested record, or records in a comment or CDATA section, are
+        //  taken for boundaries, which fails, so the rest is parsed on one
+        //  thread.
+        //
+        ok = check("nested", std::string(gProlog) + records + "<rec><rec>\n<rec/></rec></rec>\n" + records + gEpilog, Expect_SerialWhenSmall) && ok;
+        ok = check("comment", std::string(gProlog) + records + "<!--\n<rec/>\n-->" + records + gEpilog, Expect_SerialWhenSmall) && ok;
+        ok = check("CDATA", std::string(gProlog) + records + "<rec><![CDATA[\n<rec/>\n]]></rec>\n" + records + gEpilog, Expect_SerialWhenSmall) && ok;
+
+        // Errors in the middle, which the serial parse has to report
+        ok = check("error", std::string(gProlog) + records + "<rec>\n\n  <x></y></rec>" + records + gEpilog, Expect_Serial) && ok;
+        ok = check("unbound prefix", std::string(gProlog) + records + "<rec><q:x/></rec>" + records + gEpilog, Expect_Serial) && ok;
+        ok = check("error in first", std::string(gProlog) + "&undeclared;" + records + gEpilog, Expect_Serial) && ok;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All parallel parse tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,349 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that XMLPullParser returns the same events
+//  as the SAX2 parser, with each of the scanners, that it only scans as
+//  far as it has been asked to, and that skipElement() drops exactly the
+//  content of the element being skipped.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/XMLAttr.hpp>
+#include <xercesc/parsers/XMLPullParser.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/EventTestHelpers.hpp"
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  Writes down an end tag, checking that its depth matches the start tag.
+//
+static bool appendEndTag(XMLPullParser& parser, std::string& events, XMLSize_t& depth)
+{
+    if (parser.getDepth() != depth--)
+        return false;
+    events += "</";
+    appendString(events, parser.getQName());
+    events += ">";
+    return true;
+}
+
+//
+//  Pulls the events of the current parse, writing down the same things as
+//  RecordHandler does for SAX2, and also checking the depths. Elements
+//  with the given local name are skipped.
+//
+static bool pullEvents(XMLPullParser& parser, std::string& events, const XMLCh* const toSkip = 0)
+{
+    XMLSize_t depth = 0;
+    bool sawEnd = false;
+    XMLPullParser::EventTypes type;
+    while ((type = parser.next()) != XMLPullParser::Event_None)
+    {
+        switch (type)
+        {
+            case XMLPullParser::Event_StartElement :
+                depth++;
+                events += "<{";
+                appendString(events, parser.getURI());
+                events += "}";
+                appendString(events, parser.getQName());
+                for (XMLSize_t index = 0; index < parser.getAttributeCount(); index++)
+                {
+                    const XMLAttr* attr = parser.getAttribute(index);
+                    events += " ";
+                    appendString(events, attr->getQName());
+                    events += "=";
+                    appendString(events, attr->getValue());
+                    if (parser.getAttributeValue(attr->getQName()) != attr->getValue())
+                        return false;
+                }
+                events += ">";
+                if (toSkip && XMLString::equals(parser.getLocalName(), toSkip))
+                {
+                    if (parser.skipElement() != XMLPullParser::Event_EndElement)
+                        return false;
+                    events += "...";
+                    if (!appendEndTag(parser, events, depth))
+                        return false;
+                }
+                break;
+
+            case XMLPullParser::Event_EndElement :
+                if (!appendEndTag(parser, events, depth))
+                    return false;
+                break;
+
+            case XMLPullParser::Event_Characters :
+            case XMLPullParser::Event_CData :
+                if (parser.getDepth() != depth
+                ||  XMLString::stringLen(parser.getText()) != parser.getTextLength())
+                    return false;
+                appendChars(events, parser.getText(), parser.getTextLength());
+                break;
+
+            case XMLPullParser::Event_PI :
+                events += "<?";
+                appendString(events, parser.getPITarget());
+                events += " ";
+                appendString(events, parser.getText());
+                break;
+
+            case XMLPullParser::Event_EndDocument :
+                sawEnd = true;
+                events += "$";
+                break;
+
+            default :
+                break;
+        }
+    }
+
+    // A document which stopped on an error can leave elements open
+    return (!sawEnd || depth == 0);
+}
+
+static const char* gTestDocs[] =
+{
+    // Plain content with namespaces
+    "<?xml version=\"1.0\"?>\n"
+    "<a:root xmlns:a=\"urn:a\" xmlns=\"urn:d\">\n"
+    "  <item a:id=\"1\">one</item>\n"
+    "  <item a:id=\"2\"><sub xmlns:a=\"urn:b\" a:x='y'/>two</item>\n"
+    "</a:root>\n"
+
+    // A doctype with entities and defaulted attributes
+    , "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<!-- before the doctype -->\n"
+      "<!DOCTYPE r [\n"
+      "  <!ENTITY e \"<b x='&gt;'>t]]&amp;</b>\">\n"
+      "  <!ATTLIST r a CDATA \"d>f\">\n"
+      "]>\n"
+      "<?p x?>\n"
+      "<r>a&e;b&#233;&lt;<![CDATA[ <x> ]] ]]><c a=\"1>\" b='/'/><!--z-->"
+      "<d>\xC3\xA9\xE2\x82\xAC</d>&e;\r\n</r>\n"
+      "<!-- after --> <?q?>\n"
+
+    // An empty root element
+    , "<?xml version=\"1.0\"?><root/>"
+
+    // Documents with errors
+    , "<root><a>x</b></root>"
+    , "<root>text"
+    , "<root></root>junk"
+};
+
+static bool checkEvents(const char* const label, const std::string& doc, const XMLCh* const scannerName)
+{
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "");
+
+    SAX2XMLReader* reader = XMLReaderFactory::createXMLReader();
+    reader->setProperty(XMLUni::fgXercesScannerName, const_cast<XMLCh*>(scannerName));
+    reader->setFeature(XMLUni::fgSAX2CoreValidation, false);
+    reader->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+
+    RecordHandler saxEvents;
+    reader->setContentHandler(&saxEvents);
+    reader->setErrorHandler(&saxEvents);
+    try
+    {
+        reader->parse(src);
+    }
+    catch (const XMLException&)
+    {
+    }
+    delete reader;
+
+    XMLPullParser parser;
+    parser.useScanner(scannerName);
+    parser.setDoNamespaces(true);
+
+    RecordHandler errors;
+    parser.setErrorHandler(&errors);
+
+    // Parse it twice, to check that the parser can be used again
+    for (unsigned int round = 0; round < 2; round++)
+    {
+        std::string pullEvts;
+        errors.fEvents.clear();
+        if (parser.parseFirst(src) && !pullEvents(parser, pullEvts))
+        {
+            std::cout << "Bad depths or attributes: " << label << std::endl;
+            return false;
+        }
+        pullEvts += errors.fEvents;
+
+        // The errors come out in order with the events for SAX2
+        std::string saxEvts = saxEvents.fEvents;
+        const std::string::size_type errorPos = saxEvts.find('!');
+        if (errorPos != std::string::npos)
+            saxEvts = saxEvts.substr(0, errorPos) + saxEvts.substr(errorPos + 3) + saxEvts.substr(errorPos, 3);
+
+        if (pullEvts != saxEvts)
+        {
+            std::cout << "Different events: " << label << std::endl
+                      << "  SAX2: " << saxEvts << std::endl
+                      << "  pull: " << pullEvts << std::endl;
+            return false;
+        }
+    }
+    parser.parseReset();
+    return true;
+}
+
+static bool checkSkip()
+{
+    const char* const doc =
+        "<root>"
+        "<keep n='1'>a<skip><x/>b<skip>c</skip><?pi d?></skip>e</keep>"
+        "<skip/>"
+        "<skip><deep><deeper>f</deeper></deep></skip>"
+        "<keep n='2'>g</keep>"
+        "</root>";
+    const char* const expected =
+        "<{}root><{}keep n=1>a<{}skip>...</skip>e</keep>"
+        "<{}skip>...</skip>"
+        "<{}skip>...</skip>"
+        "<{}keep n=2>g</keep></root>$";
+
+    MemBufInputSource src((const XMLByte*)doc, strlen(doc), "");
+    XMLPullParser parser;
+    parser.setDoNamespaces(true);
+
+    XMLCh* skipName = XMLString::transcode("skip");
+    std::string events;
+    const bool ok = parser.parseFirst(src) && pullEvents(parser, events, skipName);
+    XMLString::release(&skipName);
+
+    if (!ok || events != expected)
+    {
+        std::cout << "Skipping went wrong: " << events << std::endl;
+        return false;
+    }
+
+    // Skipping the root element leaves only the end of the document
+    if (!parser.parseFirst(src)
+    ||  parser.next() != XMLPullParser::Event_StartDocument
+    ||  parser.next() != XMLPullParser::Event_StartElement
+    ||  parser.skipElement() != XMLPullParser::Event_EndElement
+    ||  parser.getDepth() != 1
+    ||  parser.next() != XMLPullParser::Event_EndDocument
+    ||  parser.next() != XMLPullParser::Event_None)
+    {
+        std::cout << "Skipping the root element went wrong" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkLazy()
+{
+    //
+    //  The error at the end of the document must not be seen until the
+    //  events before it have all been pulled.
+    //
+    std::string doc = "<records>";
+    for (unsigned int index = 0; index < 500; index++)
+        doc += "<record id=\"1\">Lorem ipsum dolor sit amet</record>";
+    doc += "</records>junk";
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "");
+    XMLPullParser parser;
+    RecordHandler errors;
+    parser.setErrorHandler(&errors);
+
+    unsigned int elements = 0;
+    if (parser.parseFirst(src))
+    {
+        while (parser.next() != XMLPullParser::Event_None)
+        {
+            if (!errors.fEvents.empty())
+                break;
+            if (parser.getEventType() == XMLPullParser::Event_StartElement)
+                elements++;
+        }
+    }
+
+    if (elements != 501 || errors.fEvents != "!F1")
+    {
+        std::cout << "Scanned ahead of the events pulled" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        const XMLCh* const scanners[] =
+        {
+            XMLUni::fgIGXMLScanner
+            , XMLUni::fgWFXMLScanner
+            , XMLUni::fgNSXMLScanner
+            , XMLUni::fgSGXMLScanner
+            , XMLUni::fgDGXMLScanner
+        };
+
+        for (unsigned int docIndex = 0; docIndex < sizeof(gTestDocs) / sizeof(gTestDocs[0]); docIndex++)
+        {
+            char label[32];
+            sprintf(label, "document %u", docIndex);
+            for (unsigned int index = 0; index < sizeof(scanners) / sizeof(scanners[0]); index++)
+                ok = checkEvents(label, gTestDocs[docIndex], scanners[index]) && ok;
+        }
+
+        ok = checkSkip() && ok;
+        ok = checkLazy() && ok;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All pull parse tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,312 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that pushing a document to the parsers a
+//  chunk at a time with feed() and finish() gives the same events and
+//  DOM tree as parsing it in one go, whatever the chunk size, that the
+//  events come out before finish() is called, and that the parsers can
+//  be used again afterwards.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/EventTestHelpers.hpp"
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+static const char* gTestDocs[] =
+{
+    // Plain content with namespaces
+    "<?xml version=\"1.0\"?>\n"
+    "<a:root xmlns:a=\"urn:a\" xmlns=\"urn:d\">\n"
+    "  <item a:id=\"1\">one</item>\n"
+    "  <item a:id=\"2\"><sub xmlns:a=\"urn:b\" a:x='y'/>two</item>\n"
+    "</a:root>\n"
+
+    // A BOM, and markup that hides its terminators in literals and comments
+    , "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<!-- before > the doctype -->\n"
+      "<!DOCTYPE r [\n"
+      "  <!ENTITY e \"<b x='&gt;'>t]]&amp;</b>\">\n"
+      "  <!-- don't ] > -->\n"
+      "  <?pi ]> ?>\n"
+      "  <!ATTLIST r a CDATA \"d>f\">\n"
+      "]>\n"
+      "<?p x?>\n"
+      "<r>a&e;b&#233;&lt;<![CDATA[ <x> ]] ]]><c a=\"1>\" b='/'/><!--z-->"
+      "<d>\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80</d>&e;\r\n</r>\n"
+      "<!-- after --> <?q?>\n"
+
+    // An empty root element
+    , "<?xml version=\"1.0\"?><root/>"
+
+    // A latin-1 document
+    , "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n<r a=\"\xE9\">\xE9\xE8<x/>\r\n\r</r>"
+
+    // Documents with errors
+    , "<root><a>x</b></root>"
+    , "<root>text"
+    , "<root></root>junk"
+    , ""
+};
+
+static const XMLSize_t gChunkSizes[] = { 1, 2, 3, 7, 64, 4096 };
+
+static bool parseWhole(SAX2XMLReader* const parser, const std::string& doc, RecordHandler& handler)
+{
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "");
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        return false;
+    }
+    return true;
+}
+
+static bool parsePushed(SAX2XMLReader* const parser, const std::string& doc, const XMLSize_t chunkSize,
+                        RecordHandler& handler, XMLSize_t& elementsBeforeFinish)
+{
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+    try
+    {
+        for (XMLSize_t offset = 0; offset < doc.size(); offset += chunkSize)
+        {
+            const XMLSize_t count = (doc.size() - offset < chunkSize) ? doc.size() - offset : chunkSize;
+            parser->feed((const XMLByte*)doc.data() + offset, count);
+        }
+        elementsBeforeFinish = handler.fElements;
+        parser->finish();
+    }
+    catch (const XMLException&)
+    {
+        return false;
+    }
+    return true;
+}
+
+static bool checkSAX(const char* const label, const std::string& doc, const XMLCh* const scannerName)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    parser->setProperty(XMLUni::fgXercesScannerName, const_cast<XMLCh*>(scannerName));
+    parser->setFeature(XMLUni::fgSAX2CoreValidation, false);
+
+    bool ok = true;
+    RecordHandler wholeEvents;
+    if (!parseWhole(parser, doc, wholeEvents))
+    {
+        std::cout << "Parse failed: " << label << std::endl;
+        ok = false;
+    }
+
+    for (unsigned int index = 0; ok && index < sizeof(gChunkSizes) / sizeof(gChunkSizes[0]); index++)
+    {
+        RecordHandler pushEvents;
+        XMLSize_t elementsBeforeFinish = 0;
+        if (!parsePushed(parser, doc, gChunkSizes[index], pushEvents, elementsBeforeFinish))
+        {
+            std::cout << "Push parse failed: " << label << std::endl;
+            ok = false;
+        }
+        else if (pushEvents.fEvents != wholeEvents.fEvents)
+        {
+            std::cout << "Different events when pushed in chunks of " << gChunkSizes[index]
+                      << ": " << label << std::endl;
+            ok = false;
+        }
+    }
+
+    delete parser;
+    return ok;
+}
+
+//
+//  The document ends part way through a char, which must be reported
+//  whether the reader transcodes it or scans it in place.
+//
+static bool checkTruncated(const char* const label, const std::string& doc)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    RecordHandler events;
+    const bool parsed = parseWhole(parser, doc, events);
+    delete parser;
+
+    if (!parsed || (events.fEvents.find("!F") == std::string::npos))
+    {
+        std::cout << "Truncated input not reported: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkProgress()
+{
+    //
+    //  Everything but the root element's end tag should be reported before
+    //  the end of input, so the elements have all been seen by then.
+    //
+    std::string doc = "<?xml version=\"1.0\"?>\n<records>\n";
+    for (unsigned int index = 0; index < 500; index++)
+        doc += "  <record id=\"1\">Lorem ipsum dolor sit amet</record>\n";
+    doc += "</records>\n";
+
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    RecordHandler handler;
+    XMLSize_t elementsBeforeFinish = 0;
+    bool ok = parsePushed(parser, doc, 100, handler, elementsBeforeFinish);
+    delete parser;
+
+    if (!ok || (elementsBeforeFinish != 501) || (handler.fElements != 501))
+    {
+        std::cout << "Events were held back until the end of input" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkDOM(const char* const label, const std::string& doc)
+{
+    XercesDOMParser wholeParser;
+    XercesDOMParser pushParser;
+    wholeParser.setDoNamespaces(true);
+    pushParser.setDoNamespaces(true);
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "");
+    wholeParser.parse(src);
+    const DOMDocument* wholeDoc = wholeParser.getDocument();
+
+    // Push it twice to make sure the parser is ready to go again after finish()
+    for (unsigned int round = 0; round < 2; round++)
+    {
+        for (XMLSize_t offset = 0; offset < doc.size(); offset += 5)
+            pushParser.feed((const XMLByte*)doc.data() + offset, (doc.size() - offset < 5) ? doc.size() - offset : 5);
+        pushParser.finish();
+        const DOMDocument* pushDoc = pushParser.getDocument();
+
+        if (!wholeDoc->getDocumentElement() || !pushDoc->getDocumentElement()
+        ||  !wholeDoc->getDocumentElement()->isEqualNode(pushDoc->getDocumentElement()))
+        {
+            std::cout << "Different DOM trees when pushed: " << label << std::endl;
+            return false;
+        }
+    }
+
+    // And that a regular parse still works
+    pushParser.parse(src);
+    if (!pushParser.getDocument()->getDocumentElement()->isEqualNode(wholeDoc->getDocumentElement()))
+    {
+        std::cout << "Parse after a push parse failed: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        const XMLCh* const scanners[] =
+        {
+            XMLUni::fgIGXMLScanner
+            , XMLUni::fgWFXMLScanner
+            , XMLUni::fgNSXMLScanner
+            , XMLUni::fgSGXMLScanner
+            , XMLUni::fgDGXMLScanner
+        };
+
+        for (unsigned int docIndex = 0; docIndex < sizeof(gTestDocs) / sizeof(gTestDocs[0]); docIndex++)
+        {
+            char label[32];
+            sprintf(label, "document %u", docIndex);
+            for (unsigned int index = 0; index < sizeof(scanners) / sizeof(scanners[0]); index++)
+                ok = checkSAX(label, gTestDocs[docIndex], scanners[index]) && ok;
+        }
+
+        // UTF-16 is held until the end of input, but must parse the same
+        const XMLCh utf16Doc[] =
+        {
+            0xFEFF, chOpenAngle, chLatin_r, chSpace, chLatin_a, chEqual, chDoubleQuote
+            , chDigit_1, chDoubleQuote, chCloseAngle, chLatin_h, 0x00E9, chOpenAngle
+            , chLatin_x, chForwardSlash, chCloseAngle, chOpenAngle, chForwardSlash
+            , chLatin_r, chCloseAngle
+        };
+        ok = checkSAX("UTF-16", std::string((const char*)utf16Doc, sizeof(utf16Doc)), XMLUni::fgIGXMLScanner) && ok;
+
+        // An odd byte at the end cuts the last UTF-16 char short
+        const std::string oddDoc = std::string((const char*)utf16Doc, sizeof(utf16Doc)) + "x";
+        ok = checkSAX("UTF-16 with an odd byte", oddDoc, XMLUni::fgIGXMLScanner) && ok;
+        ok = checkTruncated("UTF-16 with an odd byte", oddDoc) && ok;
+        ok = checkTruncated("UTF-8 with a partial char", "<r>x</r>\xE2\x82") && ok;
+
+        //
+        //  Without a BOM, UTF-16 is only recognized from the whole encoded
+        //  '<?xml ' prefix, which small chunks must not cut short.
+        //
+        XMLCh* noBOMDoc = XMLString::transcode("<?xml version=\"1.0\" encoding=\"UTF-16\"?><r a=\"1\">h<x/></r>");
+        ok = checkSAX("UTF-16 without BOM", std::string((const char*)noBOMDoc, XMLString::stringLen(noBOMDoc) * sizeof(XMLCh)), XMLUni::fgIGXMLScanner) && ok;
+        XMLString::release(&noBOMDoc);
+
+        ok = checkProgress() && ok;
+        ok = checkDOM("namespaces", gTestDocs[0]) && ok;
+        ok = checkDOM("doctype", gTestDocs[1]) && ok;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All push parse tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,348 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that BinReadAheadInputStream hands out
+//  exactly the bytes of the stream it wraps, whatever the sizes of the
+//  reads, that an error thrown by the wrapped stream comes out after the
+//  data read before it, that the stream can be destroyed before it has
+//  been read to the end, also while the wrapped stream is in the middle
+//  of a read, and that parsing a local file with read ahead gives the
+//  same result as parsing it without.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/BinReadAheadInputStream.hpp>
+#include <xercesc/util/IOException.hpp>
+#include <xercesc/util/Mutexes.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/StreamTestHelpers.hpp"
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+class TrickleInputSource : public InputSource
+{
+public :
+    TrickleInputSource(const std::string& data, const XMLSize_t chunkSize) :
+        fData(data)
+        , fChunkSize(chunkSize)
+    {
+    }
+
+    virtual BinInputStream* makeStream() const
+    {
+        return new TrickleInputStream(fData, fChunkSize, 0);
+    }
+
+private :
+    const std::string   fData;
+    const XMLSize_t     fChunkSize;
+};
+
+//
+//  A stream whose second read takes a while, which the read ahead thread
+//  makes straight away. It records whether it was destroyed while that
+//  read was still going on.
+//
+struct StallState
+{
+    StallState() : fReadStarted(false), fReadFinished(false), fDeleted(false), fDeletedDuringRead(false)
+    {
+    }
+
+    XMLMutex    fMutex;
+    bool        fReadStarted;
+    bool        fReadFinished;
+    bool        fDeleted;
+    bool        fDeletedDuringRead;
+};
+
+static void spin(const clock_t ticks)
+{
+    const clock_t start = clock();
+    while (clock() - start < ticks)
+        ;
+}
+
+class StallingInputStream : public BinInputStream
+{
+public :
+    StallingInputStream(StallState& state) :
+        fState(state)
+        , fReads(0)
+    {
+    }
+
+    ~StallingInputStream()
+    {
+        XMLMutexLock lock(&fState.fMutex);
+        fState.fDeleted = true;
+        fState.fDeletedDuringRead = fState.fReadStarted && !fState.fReadFinished;
+    }
+
+    virtual XMLFilePos curPos() const
+    {
+        return 0;
+    }
+
+    virtual XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead)
+    {
+        fReads++;
+        if (fReads == 2)
+        {
+            {
+                XMLMutexLock lock(&fState.fMutex);
+                fState.fReadStarted = true;
+            }
+            spin(CLOCKS_PER_SEC / 5);
+            XMLMutexLock lock(&fState.fMutex);
+            fState.fReadFinished = true;
+        }
+        memset(toFill, 'x', maxToRead);
+        return maxToRead;
+    }
+
+    virtual const XMLCh* getContentType() const
+    {
+        return 0;
+    }
+
+private :
+    StallState&     fState;
+    unsigned int    fReads;
+};
+
+static bool checkRead(const char* const label, const std::string& data, const XMLSize_t chunkSize,
+                      const XMLSize_t blockSize, const unsigned int blockCount, const XMLSize_t readSize)
+{
+    BinReadAheadInputStream stream
+    (
+        new TrickleInputStream(data, chunkSize, 0), blockSize, blockCount
+    );
+
+    std::string result;
+    XMLByte buffer[4096];
+    while (true)
+    {
+        const XMLSize_t bytesRead = stream.readBytes(buffer, readSize);
+        if (!bytesRead)
+            break;
+        result.append((const char*)buffer, bytesRead);
+        if (stream.curPos() != result.size())
+        {
+            std::cout << "Wrong position after reading: " << label << std::endl;
+            return false;
+        }
+    }
+
+    if (result != data)
+    {
+        std::cout << "Wrong data read: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkError()
+{
+    const std::string data = makeDocument(200);
+    const XMLSize_t failAt = data.size() / 2;
+    BinReadAheadInputStream stream(new TrickleInputStream(data, 100, failAt), 512, 2);
+
+    XMLSize_t total = 0;
+    XMLByte buffer[1000];
+    try
+    {
+        while (stream.readBytes(buffer, sizeof(buffer)))
+            ;
+    }
+    catch (const IOException&)
+    {
+        total = (XMLSize_t)stream.curPos();
+    }
+
+    if (total != failAt)
+    {
+        std::cout << "The stream's error was not thrown after its data" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkCancel()
+{
+    // Stop after a little of the data, while the rest is being read ahead
+    const std::string data = makeDocument(2000);
+    for (unsigned int round = 0; round < 20; round++)
+    {
+        BinReadAheadInputStream stream(new TrickleInputStream(data, 10, 0), 64, 3);
+        XMLByte buffer[100];
+        for (unsigned int index = 0; index < round; index++)
+            stream.readBytes(buffer, sizeof(buffer));
+    }
+    return true;
+}
+
+static bool checkCancelInRead()
+{
+    StallState state;
+    {
+        BinReadAheadInputStream stream(new StallingInputStream(state), 64, 2);
+        XMLByte buffer[64];
+        stream.readBytes(buffer, sizeof(buffer));
+
+        // Without thread support the second read is never made
+        const clock_t start = clock();
+        while (clock() - start < CLOCKS_PER_SEC * 2)
+        {
+            XMLMutexLock lock(&state.fMutex);
+            if (state.fReadStarted)
+                break;
+        }
+        if (!state.fReadStarted)
+            return true;
+    }
+
+    if (!state.fDeleted || !state.fReadFinished || state.fDeletedDuringRead)
+    {
+        std::cout << "The stream was not destroyed after the read in progress" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool parse(InputSource& src, CountHandler& handler, const bool readAhead)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    parser->setFeature(XMLUni::fgXercesReadAhead, readAhead);
+    if (parser->getFeature(XMLUni::fgXercesReadAhead) != readAhead)
+    {
+        delete parser;
+        return false;
+    }
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        delete parser;
+        return false;
+    }
+    delete parser;
+    return true;
+}
+
+static bool checkParse(const char* const label, const std::string& doc)
+{
+    const char* const fileName = "ReadAheadTest.xml";
+    FILE* file = fopen(fileName, "wb");
+    if (!file)
+    {
+        std::cout << "Could not write " << fileName << std::endl;
+        return false;
+    }
+    fwrite(doc.data(), 1, doc.size(), file);
+    fclose(file);
+
+    XMLCh* path = XMLString::transcode(fileName);
+    LocalFileInputSource fileSrc(path);
+    XMLString::release(&path);
+
+    CountHandler plainCounts;
+    CountHandler readAheadCounts;
+    const bool parsed = parse(fileSrc, plainCounts, false) && parse(fileSrc, readAheadCounts, true);
+    remove(fileName);
+    if (!parsed)
+    {
+        std::cout << "Parse failed: " << label << std::endl;
+        return false;
+    }
+
+    if (!plainCounts.sameCounts(readAheadCounts))
+    {
+        std::cout << "Different results with read ahead: " << label << std::endl;
+        return false;
+    }
+
+    // Other sources are not read ahead, but must still parse the same
+    CountHandler trickleCounts;
+    TrickleInputSource trickleSrc(doc, 777);
+    CountHandler memCounts;
+    MemBufInputSource memSrc((const XMLByte*)doc.data(), doc.size(), "memory");
+    if (!parse(trickleSrc, trickleCounts, true) || (trickleCounts.fElements != plainCounts.fElements)
+    ||  !parse(memSrc, memCounts, true) || (memCounts.fElements != plainCounts.fElements))
+    {
+        std::cout << "Different results with read ahead from other sources: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        const std::string data = makeDocument(500);
+        ok = checkRead("one block", data, 4096, 64 * 1024, 1, 4096) && ok;
+        ok = checkRead("small blocks", data, 100, 256, 2, 4096) && ok;
+        ok = checkRead("small reads", data, 4096, 1024, 4, 7) && ok;
+        ok = checkRead("empty", std::string(), 100, 1024, 4, 100) && ok;
+        ok = checkError() && ok;
+        ok = checkCancel() && ok;
+        ok = checkCancelInRead() && ok;
+        ok = checkParse("well-formed", data) && ok;
+        ok = checkParse("malformed", data.substr(0, data.size() - 20)) && ok;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All read ahead tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that the reader buffer size and the
+//  adaptive reader buffer flag of the SAX and DOM parsers reach the
+//  readers. Each reader allocates its buffers in one block, which is
+//  the largest block a parse of a small document allocates, so the
+//  parsers are given a memory manager that records the largest block.
+//  A fixed size buffer takes the size it is given; an adaptive one
+//  starts small and only grows to that size for a large document. The
+//  events reported must not depend on the buffer size.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/MemoryManager.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  Keeps track of the largest block allocated.
+//
+class LargestBlockManager : public MemoryManager
+{
+public :
+    LargestBlockManager() :
+        fLargest(0)
+    {
+    }
+
+    MemoryManager* getExceptionMemoryManager()
+    {
+        return XMLPlatformUtils::fgMemoryManager;
+    }
+
+    void* allocate(XMLSize_t size)
+    {
+        if (size > fLargest)
+            fLargest = size;
+        return XMLPlatformUtils::fgMemoryManager->allocate(size);
+    }
+
+    void deallocate(void* p)
+    {
+        XMLPlatformUtils::fgMemoryManager->deallocate(p);
+    }
+
+    XMLSize_t   fLargest;
+};
+
+//
+//  Counts the elements and characters reported.
+//
+class CountHandler : public DefaultHandler
+{
+public :
+    CountHandler() :
+        fElements(0)
+        , fChars(0)
+    {
+    }
+
+    void startElement(const XMLCh* const, const XMLCh* const, const XMLCh* const, const Attributes&)
+    {
+        fElements++;
+    }
+
+    void characters(const XMLCh* const, const XMLSize_t length)
+    {
+        fChars += length;
+    }
+
+    XMLSize_t   fElements;
+    XMLSize_t   fChars;
+};
+
+// The size of a reader's buffers for a given buffer size, in bytes: the
+// characters and their sizes. The raw bytes of an in-memory source are
+// read where they are.
+static XMLSize_t readerBlockSize(const XMLSize_t bufferSize)
+{
+    return bufferSize * (sizeof(XMLCh) + 1);
+}
+
+static std::string makeDocument(const unsigned int count)
+{
+    std::string doc = "<root>";
+    for (unsigned int index = 0; index < count; index++)
+    {
+        char item[64];
+        sprintf(item, "<item n='%u'>some text %u</item>\n", index, index);
+        doc += item;
+    }
+    doc += "</root>";
+    return doc;
+}
+
+static bool checkSAX(const char* const name, const std::string& doc, const XMLSize_t bufferSize,
+                     const bool adaptive, const XMLSize_t minLargest, const XMLSize_t maxLargest,
+                     const CountHandler& expected)
+{
+    LargestBlockManager manager;
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader(&manager);
+    CountHandler handler;
+    parser->setContentHandler(&handler);
+    if (bufferSize)
+        parser->setProperty(XMLUni::fgXercesReaderBufferSize, const_cast<XMLSize_t*>(&bufferSize));
+    parser->setFeature(XMLUni::fgXercesAdaptiveReaderBuffer, adaptive);
+
+    bool ok = true;
+    const XMLSize_t* property = (const XMLSize_t*)parser->getProperty(XMLUni::fgXercesReaderBufferSize);
+    if (bufferSize && *property != bufferSize)
+    {
+        std::cout << name << ": the reader buffer size property is " << *property
+                  << " instead of " << bufferSize << std::endl;
+        ok = false;
+    }
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "readerbuffer", false, &manager);
+    src.setCopyBufToStream(false);
+    manager.fLargest = 0;
+    parser->parse(src);
+    delete parser;
+
+    if (manager.fLargest < minLargest || manager.fLargest > maxLargest)
+    {
+        std::cout << name << ": the largest block is " << manager.fLargest << " bytes, not between "
+                  << minLargest << " and " << maxLargest << std::endl;
+        ok = false;
+    }
+    if (expected.fElements && (handler.fElements != expected.fElements || handler.fChars != expected.fChars))
+    {
+        std::cout << name << ": reported " << handler.fElements << " elements and " << handler.fChars
+                  << " characters instead of " << expected.fElements << " and " << expected.fChars << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+static bool checkDOM(const char* const name, const std::string& doc, const XMLSize_t bufferSize,
+                     const bool adaptive, const XMLSize_t minLargest, const XMLSize_t maxLargest)
+{
+    LargestBlockManager manager;
+    XercesDOMParser* parser = new XercesDOMParser(0, &manager);
+    parser->setReaderBufferSize(bufferSize);
+    parser->setAdaptiveReaderBuffer(adaptive);
+
+    bool ok = true;
+    if (parser->getReaderBufferSize() != bufferSize || parser->getAdaptiveReaderBuffer() != adaptive)
+    {
+        std::cout << name << ": the parser does not keep the reader buffer settings" << std::endl;
+        ok = false;
+    }
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "readerbuffer", false, &manager);
+    src.setCopyBufToStream(false);
+    manager.fLargest = 0;
+    parser->parse(src);
+    delete parser;
+
+    if (manager.fLargest < minLargest || manager.fLargest > maxLargest)
+    {
+        std::cout << name << ": the largest block is " << manager.fLargest << " bytes, not between "
+                  << minLargest << " and " << maxLargest << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cout << "Error during initialization: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    const XMLSize_t defaultSize = 16 * 1024;
+    const XMLSize_t largeSize = 256 * 1024;
+    const XMLSize_t huge = 64 * 1024 * 1024;
+    const std::string smallDoc = makeDocument(10);
+    const std::string largeDoc = makeDocument(100000);
+
+    bool ok = true;
+    try
+    {
+        // Get the events to expect from a parse with the default settings
+        CountHandler expectSmall;
+        CountHandler expectLarge;
+        {
+            SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+            MemBufInputSource smallSrc((const XMLByte*)smallDoc.data(), smallDoc.size(), "small", false);
+            parser->setContentHandler(&expectSmall);
+            parser->parse(smallSrc);
+            MemBufInputSource largeSrc((const XMLByte*)largeDoc.data(), largeDoc.size(), "large", false);
+            parser->setContentHandler(&expectLarge);
+            parser->parse(largeSrc);
+            delete parser;
+        }
+
+        ok = checkSAX("SAX default", smallDoc, 0, false,
+                      readerBlockSize(defaultSize), readerBlockSize(defaultSize) * 2, expectSmall) && ok;
+        ok = checkSAX("SAX large buffer", smallDoc, largeSize, false,
+                      readerBlockSize(largeSize), huge, expectSmall) && ok;
+        ok = checkSAX("SAX small buffer", largeDoc, 2048, false,
+                      0, readerBlockSize(defaultSize) - 1, expectLarge) && ok;
+        ok = checkSAX("SAX adaptive, small document", smallDoc, largeSize, true,
+                      0, readerBlockSize(defaultSize) - 1, expectSmall) && ok;
+        ok = checkSAX("SAX adaptive, large document", largeDoc, largeSize, true,
+                      readerBlockSize(largeSize), huge, expectLarge) && ok;
+
+        ok = checkDOM("DOM large buffer", smallDoc, largeSize, false,
+                      readerBlockSize(largeSize), huge) && ok;
+        ok = checkDOM("DOM adaptive, small document", smallDoc, largeSize, true,
+                      0, readerBlockSize(defaultSize) - 1) && ok;
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cout << "Error during parsing: " << msg << std::endl;
+        XMLString::release(&msg);
+        ok = false;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 1;
+
+    std::cout << "All reader buffer tests passed" << std::endl;
+    return 0;
+}
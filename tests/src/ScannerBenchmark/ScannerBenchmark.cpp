@@ -0,0 +1,328 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This program times SAX2 parses, with namespaces on and validation
+//  off, using the IGXMLScanner, the WFXMLScanner and the NSXMLScanner.
+//  It is not run as part of the tests; build a release library and run
+//  it by hand to compare the scanners.
+//
+//  Without file arguments it parses two generated documents held in
+//  memory: a feed whose elements mostly use prefixes, and a document
+//  that declares and uses many namespaces. Each document is parsed a
+//  number of times with each scanner and the best time is reported.
+//  The scanners must report the same number of elements and errors.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  Counts what the parser reports, so that the scanners can be compared
+//  and so that the events are not optimized away.
+//
+struct Counts
+{
+    Counts() : fElements(0), fAttributes(0), fCharacters(0), fErrors(0)
+    {
+    }
+
+    XMLSize_t fElements;
+    XMLSize_t fAttributes;
+    XMLSize_t fCharacters;
+    XMLSize_t fErrors;
+};
+
+class CountHandler : public DefaultHandler
+{
+public :
+    void startElement(const XMLCh* const, const XMLCh* const, const XMLCh* const, const Attributes& attrs)
+    {
+        fCounts.fElements++;
+        fCounts.fAttributes += attrs.getLength();
+    }
+
+    void characters(const XMLCh* const, const XMLSize_t length)
+    {
+        fCounts.fCharacters += length;
+    }
+
+    void error(const SAXParseException&)
+    {
+        fCounts.fErrors++;
+    }
+
+    void fatalError(const SAXParseException&)
+    {
+        fCounts.fErrors++;
+    }
+
+    Counts fCounts;
+};
+
+static void usage()
+{
+    std::cout << "\nUsage:\n"
+            "    ScannerBenchmark [options] [XML file ...]\n\n"
+            "This program parses each XML file, or two generated documents if\n"
+            "none are given, with the IGXMLScanner, WFXMLScanner and NSXMLScanner\n"
+            "and prints the best time of several parses for each scanner.\n\n"
+            "Options:\n"
+            "    -n=xxx      Number of parses with each scanner. Defaults to 10.\n"
+            "    -m=xxx      Size of the generated feed document in MB. Defaults to 18.\n"
+            "    -?          Show this help.\n"
+         << std::endl;
+}
+
+//
+//  A feed of entries whose elements and attributes mostly have prefixes,
+//  with sibling elements that repeat the same names.
+//
+static std::string makeFeed(const XMLSize_t megabytes)
+{
+    std::string doc =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<atom:feed xmlns:atom=\"http://www.w3.org/2005/Atom\"\n"
+        "           xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+        "           xmlns:media=\"http://search.yahoo.com/mrss/\"\n"
+        "           xmlns:geo=\"http://www.w3.org/2003/01/geo/wgs84_pos#\">\n";
+
+    char entry[1024];
+    for (unsigned int index = 0; doc.size() < megabytes * 1024 * 1024; index++)
+    {
+        sprintf
+        (
+            entry
+            , "  <atom:entry>\n"
+              "    <atom:id>urn:uuid:%08u-feed-entry</atom:id>\n"
+              "    <atom:title type=\"text\">Entry number %u</atom:title>\n"
+              "    <atom:link rel=\"alternate\" href=\"http://example.org/%u\"/>\n"
+              "    <atom:link rel=\"enclosure\" href=\"http://example.org/%u.jpg\"/>\n"
+              "    <atom:updated>2016-10-17T12:00:00Z</atom:updated>\n"
+              "    <dc:creator>Author %u</dc:creator>\n"
+              "    <dc:subject>Subject %u</dc:subject>\n"
+              "    <media:content url=\"http://example.org/%u.jpg\" media:medium=\"image\" width=\"640\"/>\n"
+              "    <geo:lat>%u.25</geo:lat><geo:long>%u.75</geo:long>\n"
+              "    <atom:summary>Some text about entry %u &amp; its contents.</atom:summary>\n"
+              "  </atom:entry>\n"
+            , index, index, index, index, index % 97, index % 13, index, index % 90, index % 180, index
+        );
+        doc += entry;
+    }
+    doc += "</atom:feed>\n";
+    return doc;
+}
+
+//
+//  A document whose elements declare namespaces and rebind prefixes, so
+//  that prefixes map to different URIs at different depths.
+//
+static std::string makeManyNamespaces(const unsigned int count)
+{
+    std::string doc = "<?xml version=\"1.0\"?>\n<root xmlns=\"urn:default\" xmlns:a=\"urn:a\" xmlns:b=\"urn:b\">\n";
+
+    char group[1024];
+    for (unsigned int index = 0; index < count; index++)
+    {
+        sprintf
+        (
+            group
+            , "  <a:group xmlns:c=\"urn:c:%u\" b:id=\"%u\">\n"
+              "    <c:item a:n=\"1\" b:n=\"1\">one</c:item>\n"
+              "    <c:item a:n=\"2\" b:n=\"2\">two</c:item>\n"
+              "    <b:list xmlns:a=\"urn:other:%u\"><a:x/><a:x/><a:x c:v=\"%u\"/></b:list>\n"
+              "    <plain attr=\"value\"><a:leaf>text</a:leaf></plain>\n"
+              "  </a:group>\n"
+            , index % 50, index, index % 7, index
+        );
+        doc += group;
+    }
+    doc += "</root>\n";
+    return doc;
+}
+
+static unsigned long parse(const std::string& doc, const XMLCh* const scannerName, CountHandler& handler)
+{
+    SAX2XMLReader* parser = XMLReaderFactory::createXMLReader();
+    parser->setProperty(XMLUni::fgXercesScannerName, const_cast<XMLCh*>(scannerName));
+    parser->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);
+    parser->setFeature(XMLUni::fgSAX2CoreValidation, false);
+    parser->setFeature(XMLUni::fgXercesSchema, false);
+    parser->setFeature(XMLUni::fgXercesLoadExternalDTD, false);
+    parser->setContentHandler(&handler);
+    parser->setErrorHandler(&handler);
+
+    MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "benchmark", false);
+    src.setCopyBufToStream(false);
+
+    const unsigned long startMillis = XMLPlatformUtils::getCurrentMillis();
+    try
+    {
+        parser->parse(src);
+    }
+    catch (const XMLException&)
+    {
+        handler.fCounts.fErrors++;
+    }
+    const unsigned long endMillis = XMLPlatformUtils::getCurrentMillis();
+
+    delete parser;
+    return endMillis - startMillis;
+}
+
+static bool benchmark(const char* const label, const std::string& doc, const unsigned int runs)
+{
+    static const XMLCh* const scanners[] =
+    {
+        XMLUni::fgIGXMLScanner
+        , XMLUni::fgWFXMLScanner
+        , XMLUni::fgNSXMLScanner
+    };
+    const unsigned int scannerCount = sizeof(scanners) / sizeof(scanners[0]);
+
+    std::cout << label << " (" << doc.size() / 1024 << " KB):" << std::endl;
+
+    //
+    //  The scanners take turns, so that anything else slowing the machine
+    //  down for a while affects them all alike.
+    //
+    unsigned long best[scannerCount];
+    Counts counts[scannerCount];
+    for (unsigned int run = 0; run < runs; run++)
+    {
+        for (unsigned int scannerIndex = 0; scannerIndex < scannerCount; scannerIndex++)
+        {
+            CountHandler handler;
+            const unsigned long millis = parse(doc, scanners[scannerIndex], handler);
+            if (!run || millis < best[scannerIndex])
+                best[scannerIndex] = millis;
+            counts[scannerIndex] = handler.fCounts;
+        }
+    }
+
+    bool ok = true;
+    for (unsigned int scannerIndex = 0; scannerIndex < scannerCount; scannerIndex++)
+    {
+        const Counts& cur = counts[scannerIndex];
+        char* name = XMLString::transcode(scanners[scannerIndex]);
+        std::cout << "    " << name << ": " << best[scannerIndex] << " ms (" << cur.fElements << " elems, "
+                  << cur.fAttributes << " attrs, " << cur.fCharacters << " chars, "
+                  << cur.fErrors << " errors)" << std::endl;
+        XMLString::release(&name);
+
+        if ((cur.fElements != counts[0].fElements) || (cur.fErrors != counts[0].fErrors))
+        {
+            std::cout << "    The scanners reported different results" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argC, char* argV[])
+{
+    unsigned int runs = 10;
+    XMLSize_t megabytes = 18;
+
+    int argInd;
+    for (argInd = 1; argInd < argC; argInd++)
+    {
+        if (argV[argInd][0] != '-')
+            break;
+
+        if (!strcmp(argV[argInd], "-?"))
+        {
+            usage();
+            return 2;
+        }
+        else if (!strncmp(argV[argInd], "-n=", 3))
+        {
+            runs = (unsigned int)atoi(&argV[argInd][3]);
+        }
+        else if (!strncmp(argV[argInd], "-m=", 3))
+        {
+            megabytes = (XMLSize_t)atoi(&argV[argInd][3]);
+        }
+        else
+        {
+            std::cout << "Unknown option '" << argV[argInd] << "'" << std::endl;
+            usage();
+            return 2;
+        }
+    }
+    if (!runs)
+        runs = 1;
+
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cout << "Error during initialization: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    if (argInd == argC)
+    {
+        ok = benchmark("prefixed feed", makeFeed(megabytes), runs) && ok;
+        ok = benchmark("many namespaces", makeManyNamespaces(20000), runs) && ok;
+    }
+    else
+    {
+        for (; argInd < argC; argInd++)
+        {
+            std::ifstream file(argV[argInd], std::ios::in | std::ios::binary);
+            if (!file)
+            {
+                std::cout << "Cannot open " << argV[argInd] << std::endl;
+                ok = false;
+                continue;
+            }
+            std::ostringstream content;
+            content << file.rdbuf();
+            ok = benchmark(argV[argInd], content.str(), runs) && ok;
+        }
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    return ok ? 0 : 1;
+}
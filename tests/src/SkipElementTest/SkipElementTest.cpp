@@ -0,0 +1,363 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that skipping elements from SAX2 with
+//  skipElement(), or from a DOMLSParserFilter with FILTER_REJECT, gives
+//  the same results as ignoring the events of those elements, with each
+//  of the scanners, with and without validation, and in a push parse.
+//  The errors after skipped content must still have the right lines.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/dom/DOMLSParserFilter.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/Wrapper4InputSource.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "../common/EventTestHelpers.hpp"
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+static const XMLCh gSkipName[] =
+{
+    chLatin_s, chLatin_k, chLatin_i, chLatin_p, chNull
+};
+
+//
+//  Writes down the SAX2 events, leaving out those within the elements
+//  named 'skip'. It either asks the reader to skip them, or just ignores
+//  them itself. Errors are written down with their columns, since those
+//  must not move when content is skipped.
+//
+class SkipHandler : public RecordHandler
+{
+public :
+    SkipHandler(SAX2XMLReader* const reader, const bool useSkip) :
+        fReader(reader)
+        , fUseSkip(useSkip)
+        , fDepth(0)
+        , fSkipDepth(0)
+    {
+    }
+
+    void startElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname, const Attributes& attrs)
+    {
+        fDepth++;
+        if (ignoring())
+            return;
+
+        RecordHandler::startElement(uri, localname, qname, attrs);
+
+        if (XMLString::equals(localname, gSkipName))
+        {
+            fEvents += "...";
+            if (fUseSkip)
+                fReader->skipElement();
+            else
+                fSkipDepth = fDepth;
+        }
+    }
+
+    void endElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname)
+    {
+        if (ignoring())
+        {
+            if (fDepth-- != fSkipDepth)
+                return;
+            fSkipDepth = 0;
+        }
+        else
+            fDepth--;
+
+        RecordHandler::endElement(uri, localname, qname);
+    }
+
+    void characters(const XMLCh* const chars, const XMLSize_t length)
+    {
+        if (!ignoring())
+            RecordHandler::characters(chars, length);
+    }
+
+    void ignorableWhitespace(const XMLCh* const chars, const XMLSize_t length)
+    {
+        characters(chars, length);
+    }
+
+    void processingInstruction(const XMLCh* const target, const XMLCh* const data)
+    {
+        if (!ignoring())
+            RecordHandler::processingInstruction(target, data);
+    }
+
+    void comment(const XMLCh* const, const XMLSize_t)
+    {
+        if (!ignoring())
+            fEvents += "<!-->";
+    }
+
+    void error(const SAXParseException& e)
+    {
+        appendError("!E", e);
+    }
+
+    void fatalError(const SAXParseException& e)
+    {
+        appendError("!F", e);
+    }
+
+private :
+    bool ignoring() const
+    {
+        return fSkipDepth && !fUseSkip;
+    }
+
+    void appendError(const char* const kind, const SAXParseException& e)
+    {
+        char location[64];
+        sprintf(location, "%s%u:%u", kind, (unsigned int)e.getLineNumber(), (unsigned int)e.getColumnNumber());
+        fEvents += location;
+    }
+
+    SAX2XMLReader*  fReader;
+    bool            fUseSkip;
+    XMLSize_t       fDepth;
+    XMLSize_t       fSkipDepth;
+};
+
+//
+//  Rejects the elements named 'skip'.
+//
+class RejectFilter : public DOMLSParserFilter
+{
+public :
+    virtual FilterAction acceptNode(DOMNode*) { return DOMLSParserFilter::FILTER_ACCEPT; }
+    virtual FilterAction startElement(DOMElement* node)
+    {
+        if (XMLString::equals(node->getNodeName(), gSkipName))
+            return DOMLSParserFilter::FILTER_REJECT;
+        return DOMLSParserFilter::FILTER_ACCEPT;
+    }
+    virtual DOMNodeFilter::ShowType getWhatToShow() const { return DOMNodeFilter::SHOW_ALL; }
+};
+
+static const char* gTestDocs[] =
+{
+    // Markup in the skipped content which could be taken for tags
+    "<?xml version='1.0'?>\n"
+    "<!DOCTYPE root [\n"
+    "  <!ELEMENT root ANY>\n"
+    "  <!ELEMENT keep ANY>\n"
+    "  <!ELEMENT skip ANY>\n"
+    "  <!ELEMENT x ANY>\n"
+    "  <!ATTLIST keep n CDATA #IMPLIED>\n"
+    "  <!ATTLIST x a CDATA #IMPLIED>\n"
+    "  <!ENTITY e '<x>e</x>'>\n"
+    "]>\n"
+    "<root>\n"
+    "<keep n='1'>a<skip><x a='/>'/>b<skip>c</skip><?pi d?></skip>e</keep>\n"
+    "<skip/>"
+    "<skip>\n<x a=\"/skip>\"></x><![CDATA[</skip>]]><!-- </skip> --><?pi </skip>?>?>\n"
+    "&#60;/skip>&lt;<x\n/>\r\n</skip>"
+    "<keep n='2'>g&e;<!-- c --></keep>\n"
+    "</root>\n"
+
+    // Skipping the root element
+    , "<skip>\n<a>\n<b/>\n</a>\n</skip>\n<!-- after -->"
+
+    // Errors after the skipped content
+    , "<root>\n<skip>\n\n<x>\n  </x>\n</skip>\n</oops>"
+    , "<root><skip>\r\n<a>\r\n</a>\r\n</skip>\r\n\xC3\xA9</root>junk"
+};
+
+static void parseEvents(const std::string& doc, const XMLCh* const scannerName, const bool validate, const bool useSkip, const bool usePush, std::string& events)
+{
+    SAX2XMLReader* reader = XMLReaderFactory::createXMLReader();
+    reader->setProperty(XMLUni::fgXercesScannerName, const_cast<XMLCh*>(scannerName));
+    reader->setFeature(XMLUni::fgSAX2CoreValidation, validate);
+    reader->setFeature(XMLUni::fgXercesDynamic, false);
+
+    SkipHandler handler(reader, useSkip);
+    reader->setContentHandler(&handler);
+    reader->setErrorHandler(&handler);
+    reader->setLexicalHandler(&handler);
+    try
+    {
+        if (usePush)
+        {
+            // Feed it in small chunks, so that tags are split across them
+            for (std::string::size_type offset = 0; offset < doc.size(); offset += 5)
+            {
+                const std::string::size_type count = (doc.size() - offset < 5) ? doc.size() - offset : 5;
+                reader->feed((const XMLByte*)doc.data() + offset, count);
+            }
+            reader->finish();
+        }
+        else
+        {
+            MemBufInputSource src((const XMLByte*)doc.data(), doc.size(), "");
+            reader->parse(src);
+        }
+    }
+    catch (const XMLException&)
+    {
+        handler.fEvents += "!X";
+    }
+    delete reader;
+
+    events = handler.fEvents;
+}
+
+static bool checkSAX2(const char* const label, const std::string& doc, const XMLCh* const scannerName, const bool validate)
+{
+    std::string expected;
+    parseEvents(doc, scannerName, validate, false, false, expected);
+
+    for (unsigned int usePush = 0; usePush < 2; usePush++)
+    {
+        std::string events;
+        parseEvents(doc, scannerName, validate, true, usePush != 0, events);
+        if (events != expected)
+        {
+            std::cout << "Different events: " << label << (validate ? ", validating" : "")
+                      << (usePush ? ", push" : "") << std::endl
+                      << "  ignored: " << expected << std::endl
+                      << "  skipped: " << events << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool checkNotScanned()
+{
+    //
+    //  When not validating, the skipped content is not scanned at all, so
+    //  the undeclared entity in it must not be found.
+    //
+    const std::string doc = "<root><skip>&undeclared;</skip></root>";
+    std::string events;
+    parseEvents(doc, XMLUni::fgIGXMLScanner, false, true, false, events);
+    if (events != "<{}root><{}skip>...</skip></root>$")
+    {
+        std::cout << "Skipped content was scanned: " << events << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool checkDOM(const bool validate)
+{
+    static const XMLCh gLS[] = { chLatin_L, chLatin_S, chNull };
+    DOMImplementation* impl = DOMImplementationRegistry::getDOMImplementation(gLS);
+    DOMLSParser* parser = ((DOMImplementationLS*)impl)->createLSParser(DOMImplementationLS::MODE_SYNCHRONOUS, 0);
+    parser->getDomConfig()->setParameter(XMLUni::fgDOMValidate, validate);
+
+    RejectFilter filter;
+    parser->setFilter(&filter);
+
+    MemBufInputSource src((const XMLByte*)gTestDocs[0], strlen(gTestDocs[0]), "");
+    Wrapper4InputSource input(&src, false);
+
+    bool ok = false;
+    try
+    {
+        DOMDocument* doc = parser->parse(&input);
+        if (doc)
+        {
+            char* text = XMLString::transcode(doc->getDocumentElement()->getTextContent());
+            ok = (doc->getElementsByTagName(gSkipName)->getLength() == 0)
+                 && (strcmp(text, "\nae\nge\n") == 0);
+            XMLString::release(&text);
+        }
+    }
+    catch (const XMLException&)
+    {
+    }
+    catch (const DOMException&)
+    {
+    }
+    parser->release();
+
+    if (!ok)
+        std::cout << "Rejecting elements from the DOM went wrong" << (validate ? ", validating" : "") << std::endl;
+    return ok;
+}
+
+int main()
+{
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        const XMLCh* const scanners[] =
+        {
+            XMLUni::fgIGXMLScanner
+            , XMLUni::fgWFXMLScanner
+            , XMLUni::fgNSXMLScanner
+            , XMLUni::fgSGXMLScanner
+            , XMLUni::fgDGXMLScanner
+        };
+
+        for (unsigned int docIndex = 0; docIndex < sizeof(gTestDocs) / sizeof(gTestDocs[0]); docIndex++)
+        {
+            char label[32];
+            sprintf(label, "document %u", docIndex);
+            for (unsigned int index = 0; index < sizeof(scanners) / sizeof(scanners[0]); index++)
+            {
+                ok = checkSAX2(label, gTestDocs[docIndex], scanners[index], false) && ok;
+                ok = checkSAX2(label, gTestDocs[docIndex], scanners[index], true) && ok;
+            }
+        }
+
+        ok = checkNotScanned() && ok;
+        ok = checkDOM(false) && ok;
+        ok = checkDOM(true) && ok;
+    }
+
+    XMLPlatformUtils::Terminate();
+
+    if (!ok)
+        return 2;
+    std::cout << "All skip element tests passed" << std::endl;
+    return 0;
+}
@@ -45,6 +45,7 @@
 #include <xercesc/framework/StdOutFormatTarget.hpp>
 #include <xercesc/framework/XMLGrammarPoolImpl.hpp>
 #include <xercesc/internal/MemoryManagerImpl.hpp>
+#include <xercesc/internal/ThreadCachingMemoryManager.hpp>
 #include <xercesc/util/OutOfMemoryException.hpp>
 
 void clearFileInfoMemory();
@@ -231,6 +232,7 @@ struct RunInfo
     bool                            doNamespaces;
     bool                            doInitialParse;
     bool                            doNamespacePrefixes;  // SAX2
+    bool                            threadCaching;
     SAXParser::ValSchemes           valScheme;
     int                             numThreads;
     int                             totalTime;
@@ -836,6 +838,7 @@ void parseCommandLine(int argc, char **argv)
     gRunInfo.doNamespaces = false;
     gRunInfo.doInitialParse = false;
     gRunInfo.doNamespacePrefixes = false;
+    gRunInfo.threadCaching = false;
 
     gRunInfo.valScheme = SAXParser::Val_Auto;
     gRunInfo.numThreads = 2;
@@ -896,6 +899,17 @@ void parseCommandLine(int argc, char **argv)
                     throw 1;
                 }
             }
+            else if (!strncmp(argv[argnum], "-memmgr=", 8)) {
+                const char* const parm = &argv[argnum][8];
+                if (strcmp(parm, "default") == 0)
+                    gRunInfo.threadCaching = false;
+                else if (strcmp(parm, "threadcaching") == 0)
+                    gRunInfo.threadCaching = true;
+                else {
+                    fprintf(stderr, "Unrecognized -memmgr option \"%s\"\n", parm);
+                    throw 1;
+                }
+            }
             else if (strcmp(argv[argnum], "-init") == 0)
                 gRunInfo.doInitialParse = true;
             else if (strcmp(argv[argnum], "-reuse") == 0)
@@ -988,6 +1002,7 @@ void parseCommandLine(int argc, char **argv)
             "     -parses nnn    Run for nnn parses instead of time.  Default is to use time\n"
             "     -dump          Dump DOM tree on error.\n"
             "     -mem           Read files into memory once only, and parse them from there.\n"
+            "     -memmgr=xxx    Memory manager [default | threadcaching].  Default is DEFAULT.\n"
             "     -gc            Enable grammar caching (i.e. grammar cached and used in subsequent parses). Defaults to off.\n"
             "     -init          Perform an initial parse of the file(s) before starting up the individual threads.\n\n"
             );
@@ -1177,9 +1192,13 @@ int main (int argc, char **argv)
     //
     // Initialize the XML system.
     //
+    ThreadCachingMemoryManager* threadCachingMemMgr = 0;
+    if (gRunInfo.threadCaching)
+        threadCachingMemMgr = new ThreadCachingMemoryManager();
+
     try
     {
-         XMLPlatformUtils::Initialize();
+         XMLPlatformUtils::Initialize(XMLUni::fgXercescDefaultLocale, 0, 0, threadCachingMemMgr);
     }
     catch (...)
     {
@@ -1364,10 +1383,21 @@ int main (int argc, char **argv)
         delete gpMemMgr;
     }
 
-    XMLPlatformUtils::Terminate();
+    if (threadCachingMemMgr && gRunInfo.quiet == false) {
+        ThreadCachingMemoryManager::Statistics stats;
+        threadCachingMemMgr->getStatistics(stats);
+        printf("%lu allocations (%lu large), %lu deallocations (%lu by another thread),\n"
+               "%lu thread caches, %lu bytes in slabs.\n",
+               (unsigned long)stats.fAllocations, (unsigned long)stats.fLargeAllocations,
+               (unsigned long)stats.fDeallocations, (unsigned long)stats.fRemoteDeallocations,
+               (unsigned long)stats.fThreadCaches, (unsigned long)stats.fSlabSize);
+    }
 
     clearFileInfoMemory();
 
+    XMLPlatformUtils::Terminate();
+    delete threadCachingMemMgr;
+
     delete [] gThreadInfo;
 
     printf("Test Run Successfully\n");
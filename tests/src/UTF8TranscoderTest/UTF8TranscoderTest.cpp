@@ -0,0 +1,294 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//---------------------------------------------------------------------
+//
+//  This test program checks that the vectorized ASCII path of the
+//  UTF-8 transcoder produces exactly the same characters, char sizes,
+//  byte counts and errors as the scalar path, and reports the time
+//  taken by each of them over a mostly-ASCII document.
+//
+//  The scalar path is selected by clearing XMLPlatformUtils::fgSSE2ok
+//  for the duration of a run.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/util/XMLUTF8Transcoder.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+static const XMLSize_t kCharBufSize = 16 * 1024;
+static const XMLSize_t kRawBufSize  = 48 * 1024;
+
+//
+//  The result of decoding a complete byte buffer the way XMLReader does,
+//  one raw block at a time into a fixed size char buffer.
+//
+struct DecodeResult
+{
+    std::vector<XMLCh>          chars;
+    std::vector<unsigned char>  sizes;
+    XMLSize_t                   bytesEaten;
+    int                         errorCode;
+};
+
+static void decode(const std::string& src, const bool useSSE2, DecodeResult& result
+                   , const XMLSize_t maxChars = kCharBufSize)
+{
+    const bool savedSSE2 = XMLPlatformUtils::fgSSE2ok;
+    XMLPlatformUtils::fgSSE2ok = useSSE2;
+
+    XMLUTF8Transcoder transcoder(XMLUni::fgUTF8EncodingString, kCharBufSize);
+    XMLCh charBuf[kCharBufSize];
+    unsigned char sizeBuf[kCharBufSize];
+
+    result.chars.clear();
+    result.sizes.clear();
+    result.bytesEaten = 0;
+    result.errorCode = 0;
+
+    const XMLByte* srcData = (const XMLByte*)src.data();
+    try
+    {
+        while (result.bytesEaten < src.size())
+        {
+            XMLSize_t avail = src.size() - result.bytesEaten;
+            if (avail > kRawBufSize)
+                avail = kRawBufSize;
+
+            XMLSize_t eaten = 0;
+            const XMLSize_t count = transcoder.transcodeFrom
+            (
+                srcData + result.bytesEaten
+                , avail
+                , charBuf
+                , maxChars
+                , eaten
+                , sizeBuf
+            );
+            if (!count)
+                break;
+
+            result.chars.insert(result.chars.end(), charBuf, charBuf + count);
+            result.sizes.insert(result.sizes.end(), sizeBuf, sizeBuf + count);
+            result.bytesEaten += eaten;
+        }
+    }
+    catch (const XMLException& toCatch)
+    {
+        result.errorCode = toCatch.getCode();
+    }
+
+    XMLPlatformUtils::fgSSE2ok = savedSSE2;
+}
+
+static bool sameResult(const DecodeResult& scalar, const DecodeResult& vector)
+{
+    return scalar.chars == vector.chars
+        && scalar.sizes == vector.sizes
+        && scalar.bytesEaten == vector.bytesEaten
+        && scalar.errorCode == vector.errorCode;
+}
+
+//
+//  Builds a document of roughly the requested size that is mostly ASCII
+//  markup, with 2, 3 and 4 byte sequences scattered through it.
+//
+static std::string makeDocument(const XMLSize_t size)
+{
+    static const char* const pieces[] =
+    {
+        "<record id=\"42\" kind=\"plain\">Lorem ipsum dolor sit amet</record>\n"
+        , "    <name>Caf\xC3\xA9 d\xC3\xA9j\xC3\xA0 vu</name>\n"
+        , "    <price currency=\"EUR\">12 \xE2\x82\xAC</price>\n"
+        , "    <note>consectetur adipiscing elit, sed do eiusmod tempor</note>\n"
+        , "    <emoji>\xF0\x9F\x98\x80</emoji>\n"
+        , "    <text>incididunt ut labore et dolore magna aliqua</text>\n"
+    };
+    const XMLSize_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+
+    std::string doc;
+    doc.reserve(size + 128);
+    for (XMLSize_t index = 0; doc.size() < size; index++)
+    {
+        // Mostly ASCII, with a multi-byte piece every few lines
+        const XMLSize_t pick = (index % 7 == 3) ? (index / 7) % pieceCount : (index % 2) * 3;
+        doc += pieces[pick];
+    }
+    return doc;
+}
+
+static bool checkEquivalence(const char* const label, const std::string& src)
+{
+    DecodeResult scalar;
+    DecodeResult vector;
+    decode(src, false, scalar);
+    decode(src, true, vector);
+
+    if (!sameResult(scalar, vector))
+    {
+        std::cout << "Mismatch between scalar and SSE2 decoding: " << label << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool runConformanceTests()
+{
+    bool ok = true;
+
+    // Every alignment of a multi-byte sequence relative to a 16 byte block
+    static const char* const sequences[] =
+    {
+        "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\x7F"
+    };
+    for (XMLSize_t seq = 0; seq < sizeof(sequences) / sizeof(sequences[0]); seq++)
+    {
+        for (XMLSize_t prefix = 0; prefix < 40; prefix++)
+        {
+            std::string src(prefix, 'a');
+            src += sequences[seq];
+            src += std::string(40 - prefix, 'b');
+            ok = checkEquivalence("aligned sequence", src) && ok;
+        }
+    }
+
+    // Malformed input must fail in the same way at the same place
+    static const char* const malformed[] =
+    {
+        "\xC3\x28", "\xC0\xAF", "\xE0\x9F\x80", "\xED\xA0\x80"
+        , "\xF0\x8F\x80\x80", "\xF4\x90\x80\x80", "\xF8\x88\x80\x80\x80", "\x80"
+    };
+    for (XMLSize_t bad = 0; bad < sizeof(malformed) / sizeof(malformed[0]); bad++)
+    {
+        for (XMLSize_t prefix = 0; prefix < 40; prefix += 7)
+        {
+            std::string src(prefix, 'x');
+            src += malformed[bad];
+            src += std::string(24, 'y');
+            ok = checkEquivalence("malformed sequence", src) && ok;
+        }
+    }
+
+    // Output buffer boundaries that split ASCII runs and surrogate pairs
+    ok = checkEquivalence("large document", makeDocument(3 * kRawBufSize + 17)) && ok;
+
+    //
+    //  A surrogate pair that does not fit at the end of the char buffer
+    //  must be left for the next call, not dropped.
+    //
+    std::string pairs;
+    for (XMLSize_t index = 0; index < 16; index++)
+    {
+        pairs += std::string(index % 3, 'a');
+        pairs += "\xF0\x9F\x98\x80";
+    }
+    DecodeResult whole;
+    decode(pairs, false, whole);
+    for (XMLSize_t maxChars = 2; maxChars < 8; maxChars++)
+    {
+        DecodeResult split;
+        decode(pairs, false, split, maxChars);
+        if (!sameResult(whole, split) || (split.bytesEaten != pairs.size()))
+        {
+            std::cout << "Surrogate pair lost at the end of a " << maxChars
+                      << " char buffer" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static unsigned long timeDecode(const std::string& src, const bool useSSE2, const unsigned int iterations)
+{
+    DecodeResult result;
+    const unsigned long startMillis = XMLPlatformUtils::getCurrentMillis();
+    for (unsigned int index = 0; index < iterations; index++)
+        decode(src, useSSE2, result);
+    return XMLPlatformUtils::getCurrentMillis() - startMillis;
+}
+
+static void usage()
+{
+    std::cout << "\nUsage:\n"
+                 "    UTF8TranscoderTest [-size=nnn] [-iterations=nnn]\n\n"
+                 "This program checks the SSE2 UTF-8 decoding path against the\n"
+                 "scalar one and reports the time each of them takes.\n\n"
+                 "Options:\n"
+                 "    -size=nnn       Size of the benchmark document in KB. Default is 1024.\n"
+                 "    -iterations=nnn Number of times the document is decoded. Default is 10.\n"
+                 "    -?              Show this help.\n"
+              << std::endl;
+}
+
+int main(int argC, char* argV[])
+{
+    XMLSize_t sizeKB = 1024;
+    unsigned int iterations = 10;
+
+    for (int argInd = 1; argInd < argC; argInd++)
+    {
+        if (!strncmp(argV[argInd], "-size=", 6))
+            sizeKB = (XMLSize_t)atol(argV[argInd] + 6);
+        else if (!strncmp(argV[argInd], "-iterations=", 12))
+            iterations = (unsigned int)atoi(argV[argInd] + 12);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    try
+    {
+        XMLPlatformUtils::Initialize();
+    }
+    catch (const XMLException& toCatch)
+    {
+        char* msg = XMLString::transcode(toCatch.getMessage());
+        std::cerr << "Error during initialization of xerces-c: " << msg << std::endl;
+        XMLString::release(&msg);
+        return 1;
+    }
+
+    int errorCode = 0;
+    if (!runConformanceTests())
+        errorCode = 2;
+    else
+    {
+        const std::string doc = makeDocument(sizeKB * 1024);
+        const unsigned long scalarMillis = timeDecode(doc, false, iterations);
+        const unsigned long vectorMillis = XMLPlatformUtils::fgSSE2ok
+            ? timeDecode(doc, true, iterations) : scalarMillis;
+
+        std::cout << "Scalar decode: " << scalarMillis << " ms\n"
+                  << "SSE2 decode: " << vectorMillis << " ms" << std::endl;
+    }
+
+    XMLPlatformUtils::Terminate();
+    return errorCode;
+}
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_EVENTTESTHELPERS_HPP)
+#define XERCESC_INCLUDE_GUARD_EVENTTESTHELPERS_HPP
+
+//---------------------------------------------------------------------
+//
+//  Helpers for the tests which compare the events of different parses
+//  of the same document: functions to write down strings and character
+//  data, and a handler that writes down the SAX2 events.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+
+#include <string>
+
+XERCES_CPP_NAMESPACE_USE
+
+inline void appendString(std::string& target, const XMLCh* const toAppend)
+{
+    if (!toAppend)
+    {
+        target += "(null)";
+        return;
+    }
+
+    char* str = XMLString::transcode(toAppend);
+    target += str;
+    XMLString::release(&str);
+}
+
+//
+//  Writes down character data, with anything outside of ASCII as a '#',
+//  so that it does not depend on the local code page.
+//
+inline void appendChars(std::string& target, const XMLCh* const chars, const XMLSize_t length)
+{
+    for (XMLSize_t index = 0; index < length; index++)
+        target += (chars[index] < 0x80) ? (char)chars[index] : '#';
+}
+
+//
+//  Writes down the document's events, so that two parses can be compared.
+//  Character data is recorded without its boundaries, since those depend
+//  on how the input happens to be buffered. Tests that need more of the
+//  events, or fewer, derive from it.
+//
+class RecordHandler : public DefaultHandler
+{
+public :
+    RecordHandler() : fElements(0)
+    {
+    }
+
+    void startElement(const XMLCh* const uri, const XMLCh* const, const XMLCh* const qname, const Attributes& attrs)
+    {
+        fElements++;
+        fEvents += "<{";
+        appendString(fEvents, uri);
+        fEvents += "}";
+        appendString(fEvents, qname);
+        for (XMLSize_t index = 0; index < attrs.getLength(); index++)
+        {
+            fEvents += " ";
+            appendString(fEvents, attrs.getQName(index));
+            fEvents += "=";
+            appendString(fEvents, attrs.getValue(index));
+        }
+        fEvents += ">";
+    }
+
+    void endElement(const XMLCh* const, const XMLCh* const, const XMLCh* const qname)
+    {
+        fEvents += "</";
+        appendString(fEvents, qname);
+        fEvents += ">";
+    }
+
+    void characters(const XMLCh* const chars, const XMLSize_t length)
+    {
+        appendChars(fEvents, chars, length);
+    }
+
+    void processingInstruction(const XMLCh* const target, const XMLCh* const data)
+    {
+        fEvents += "<?";
+        appendString(fEvents, target);
+        fEvents += " ";
+        appendString(fEvents, data);
+    }
+
+    void endDocument()
+    {
+        fEvents += "$";
+    }
+
+    void error(const SAXParseException& e)
+    {
+        fEvents += "!E";
+        fEvents += (char)('0' + e.getLineNumber() % 10);
+    }
+
+    void fatalError(const SAXParseException& e)
+    {
+        fEvents += "!F";
+        fEvents += (char)('0' + e.getLineNumber() % 10);
+    }
+
+    XMLSize_t   fElements;
+    std::string fEvents;
+};
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * $Id$
+ */
+
+#if !defined(XERCESC_INCLUDE_GUARD_STREAMTESTHELPERS_HPP)
+#define XERCESC_INCLUDE_GUARD_STREAMTESTHELPERS_HPP
+
+//---------------------------------------------------------------------
+//
+//  Helpers for the tests of the input stream decorators: a stream over
+//  a string that hands out its data a little at a time, a handler that
+//  sums up a parse's events, and a document to parse.
+//
+//---------------------------------------------------------------------
+
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/IOException.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+
+#include <string>
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+//
+//  A stream over a string that hands out at most a few bytes at a time,
+//  and optionally throws once a given amount has been read, like a slow
+//  or broken source would.
+//
+class TrickleInputStream : public BinInputStream
+{
+public :
+    TrickleInputStream(const std::string& data, const XMLSize_t chunkSize, const XMLSize_t failAt = 0) :
+        fData(data)
+        , fChunkSize(chunkSize)
+        , fFailAt(failAt)
+        , fPos(0)
+    {
+    }
+
+    virtual XMLFilePos curPos() const
+    {
+        return fPos;
+    }
+
+    virtual XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead)
+    {
+        if (fFailAt && fPos >= fFailAt)
+            ThrowXML(IOException, XMLExcepts::File_CouldNotReadFromFile);
+
+        XMLSize_t toRead = fData.size() - fPos;
+        if (toRead > fChunkSize)
+            toRead = fChunkSize;
+        if (toRead > maxToRead)
+            toRead = maxToRead;
+        if (fFailAt && fPos + toRead > fFailAt)
+            toRead = fFailAt - fPos;
+
+        memcpy(toFill, fData.data() + fPos, toRead);
+        fPos += toRead;
+        return toRead;
+    }
+
+    virtual const XMLCh* getContentType() const
+    {
+        return 0;
+    }
+
+private :
+    const std::string   fData;
+    const XMLSize_t     fChunkSize;
+    const XMLSize_t     fFailAt;
+    XMLSize_t           fPos;
+};
+
+//
+//  Sums up the document's events, so that two parses can be compared.
+//
+class CountHandler : public DefaultHandler
+{
+public :
+    CountHandler() : fElements(0), fAttributes(0), fCharacters(0), fErrors(0)
+    {
+    }
+
+    void startElement(const XMLCh* const, const XMLCh* const, const XMLCh* const, const Attributes& attrs)
+    {
+        fElements++;
+        fAttributes += attrs.getLength();
+    }
+
+    void characters(const XMLCh* const, const XMLSize_t length)
+    {
+        fCharacters += length;
+    }
+
+    void fatalError(const SAXParseException&)
+    {
+        fErrors++;
+    }
+
+    bool sameCounts(const CountHandler& other) const
+    {
+        return (fElements == other.fElements)
+            && (fAttributes == other.fAttributes)
+            && (fCharacters == other.fCharacters)
+            && (fErrors == other.fErrors);
+    }
+
+    XMLSize_t fElements;
+    XMLSize_t fAttributes;
+    XMLSize_t fCharacters;
+    XMLSize_t fErrors;
+};
+
+//
+//  A document with the given number of records, each with attributes
+//  and text.
+//
+inline std::string makeDocument(const XMLSize_t records)
+{
+    std::string doc = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<records>\n";
+    for (XMLSize_t index = 0; index < records; index++)
+    {
+        doc += "  <record id=\"";
+        doc += char('0' + (index % 10));
+        doc += "\" kind=\"plain\">Lorem ipsum dolor sit amet, consectetur adipiscing elit</record>\n";
+    }
+    doc += "</records>\n";
+    return doc;
+}
+
+#endif